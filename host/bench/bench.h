@@ -0,0 +1,174 @@
+#ifndef HOST_BENCH_H
+#define HOST_BENCH_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "host_control.h"
+
+/**
+ * Host benchmarks
+ *
+ * Every suite is a function registered with BENCH_SUITE. It measures
+ * with Bench::run() (a loop of identical operations) or runEach() (one
+ * untimed setup per operation), or computes its own figures and hands
+ * them to record(). Each result is ns, heap allocations and bytes
+ * allocated per operation; host_bench compares them with
+ * bench_baseline.txt. Lines added with note() are printed only; fail()
+ * is for results that are wrong rather than slow.
+ *
+ * Allocations are counted on the calling thread, so a suite that starts
+ * threads reports their figures itself.
+ */
+
+namespace bench {
+
+struct Result {
+    std::string name;
+    double nsPerOp;
+    double allocsPerOp;
+    double bytesPerOp;
+};
+
+// Keep the optimiser from dropping a result nobody reads
+template <typename T>
+inline void keep(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+inline uint64_t nowNs() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+class Bench {
+public:
+    explicit Bench(bool quick) : quick(quick) {}
+
+    // --quick runs a twentieth of the operations (ctest)
+    uint64_t scale(uint64_t ops) const {
+        return quick ? std::max<uint64_t>(ops / 20, 1) : ops;
+    }
+
+    bool isQuick() const { return quick; }
+
+    /**
+     * Time `ops` calls of body(i) as one loop, after a short warm-up so
+     * that buffers which grow once are not counted
+     */
+    template <typename Body>
+    void run(const char* name, uint64_t ops, Body body) {
+        ops = scale(ops);
+        for (uint64_t i = 0; i < std::min<uint64_t>(ops, WARM_UP); i++) body(i);
+
+        host::AllocCounters before = host::allocCounters();
+        uint64_t start = nowNs();
+        for (uint64_t i = 0; i < ops; i++) body(i);
+        uint64_t elapsed = nowNs() - start;
+        host::AllocCounters after = host::allocCounters();
+
+        record(name, (double)elapsed / ops,
+               (double)(after.allocs - before.allocs) / ops,
+               (double)(after.bytes - before.bytes) / ops);
+    }
+
+    /**
+     * Like run(), but setup(i) runs untimed and uncounted before each
+     * body(i). For operations of a microsecond or more.
+     */
+    template <typename Setup, typename Body>
+    void runEach(const char* name, uint64_t ops, Setup setup, Body body) {
+        ops = scale(ops);
+        for (uint64_t i = 0; i < std::min<uint64_t>(ops, WARM_UP); i++) {
+            setup(i);
+            body(i);
+        }
+
+        uint64_t elapsed = 0;
+        uint64_t allocs = 0;
+        uint64_t bytes = 0;
+        for (uint64_t i = 0; i < ops; i++) {
+            setup(i);
+            host::AllocCounters before = host::allocCounters();
+            uint64_t start = nowNs();
+            body(i);
+            elapsed += nowNs() - start;
+            host::AllocCounters after = host::allocCounters();
+            allocs += after.allocs - before.allocs;
+            bytes += after.bytes - before.bytes;
+        }
+
+        record(name, (double)elapsed / ops, (double)allocs / ops, (double)bytes / ops);
+    }
+
+    void record(const char* name, double nsPerOp, double allocsPerOp, double bytesPerOp) {
+        results.push_back({ name, nsPerOp, allocsPerOp, bytesPerOp });
+        printf("  %-44s %12.1f ns/op %8.2f allocs/op %10.1f bytes/op\n",
+               name, nsPerOp, allocsPerOp, bytesPerOp);
+        fflush(stdout);
+    }
+
+    template <typename... Args>
+    void note(const char* format, Args... args) {
+        printf("    ");
+        printf(format, args...);
+        printf("\n");
+        fflush(stdout);
+    }
+
+    // A wrong result, as opposed to a slow one: host_bench exits non-zero
+    template <typename... Args>
+    void fail(const char* format, Args... args) {
+        printf("  FAIL  ");
+        printf(format, args...);
+        printf("\n");
+        fflush(stdout);
+        failures++;
+    }
+
+    const std::vector<Result>& all() const { return results; }
+    int failed() const { return failures; }
+
+private:
+    static const uint64_t WARM_UP = 64;
+
+    bool quick;
+    int failures = 0;
+    std::vector<Result> results;
+};
+
+typedef void (*SuiteFunction)(Bench& bench);
+
+struct Suite {
+    const char* name;
+    SuiteFunction run;
+};
+
+inline std::vector<Suite>& suites() {
+    static std::vector<Suite> registered;
+    return registered;
+}
+
+struct Registrar {
+    Registrar(const char* name, SuiteFunction run) { suites().push_back({ name, run }); }
+};
+
+// Percentile of a sample set (sorts it)
+inline uint64_t percentile(std::vector<uint64_t>& samples, double fraction) {
+    if (samples.empty()) return 0;
+    std::sort(samples.begin(), samples.end());
+    size_t index = (size_t)(fraction * (samples.size() - 1) + 0.5);
+    return samples[std::min(index, samples.size() - 1)];
+}
+
+}
+
+#define BENCH_SUITE(name)                                                   \
+    static void bench_##name(bench::Bench& bench);                          \
+    static bench::Registrar registrar_##name(#name, bench_##name);          \
+    static void bench_##name(bench::Bench& bench)
+
+#endif
@@ -0,0 +1,110 @@
+// dsp_filters.h per sample: each stage alone, then the chains config.h
+// gives the sensor fields, on a noisy reading with spikes
+
+#include "bench.h"
+#include "host_harness.h"
+#include "dsp_filters.h"
+#include <math.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace {
+
+const int SIGNAL_LENGTH = 4096;
+
+// A slow wave plus noise and one spike in 64, as a gas reading in Q16
+struct Signal {
+    int32_t fixed[SIGNAL_LENGTH];
+    float real[SIGNAL_LENGTH];
+    uint32_t adc[SIGNAL_LENGTH];
+    double ghz = 0;
+
+    Signal() {
+        uint32_t noise = 12345;
+        for (int i = 0; i < SIGNAL_LENGTH; i++) {
+            noise = noise * 1664525u + 1013904223u;
+            float value = 600.0f + 40.0f * sinf(i * 0.01f) + (float)((noise >> 16) % 100) / 10.0f;
+            if (i % 64 == 17) value += 300.0f;
+            real[i] = value;
+            fixed[i] = toFixed(value);
+            adc[i] = (noise >> 20) & ((1 << ADC_RESOLUTION) - 1);
+        }
+    }
+};
+
+// Host cycles per ns, from the x86 time stamp counter; 0 elsewhere
+double cyclesPerNs() {
+#if defined(__x86_64__) || defined(__i386__)
+    uint64_t startNs = bench::nowNs();
+    uint64_t startTsc = __rdtsc();
+    while (bench::nowNs() - startNs < 20000000) {}
+    return (double)(__rdtsc() - startTsc) / (double)(bench::nowNs() - startNs);
+#else
+    return 0;
+#endif
+}
+
+void noteCycles(bench::Bench& bench, double ghz) {
+    if (ghz > 0) bench.note("%.1f cycles/sample", bench.all().back().nsPerOp * ghz);
+}
+
+template <typename Filter>
+void runStage(bench::Bench& bench, const char* name, const Signal& signal) {
+    Filter filter;
+    bench.run(name, 4000000, [&](uint64_t i) {
+        bench::keep(filter.apply(signal.fixed[i % SIGNAL_LENGTH]));
+    });
+    noteCycles(bench, signal.ghz);
+}
+
+template <typename Chain>
+void runChain(bench::Bench& bench, const char* name, const Signal& signal) {
+    Chain chain;
+    bench.run(name, 4000000, [&](uint64_t i) {
+        bench::keep(chain.apply(signal.real[i % SIGNAL_LENGTH]));
+    });
+    noteCycles(bench, signal.ghz);
+
+    // Held at a constant, every chain must settle on it
+    Chain settled;
+    float out = 0;
+    for (int i = 0; i < 200; i++) out = settled.apply(412.5f);
+    if (fabsf(out - 412.5f) > 0.01f) bench.fail("%s: settles on %.3f for a constant 412.5", name, out);
+}
+
+}
+
+BENCH_SUITE(dsp) {
+    static Signal signal;
+    signal.ghz = cyclesPerNs();
+    if (signal.ghz > 0) bench.note("cycles at the host's %.2f GHz time stamp counter", signal.ghz);
+    bench.note("window %d, alpha 2^-%d, q/r %d in Q16, CIC 4^%d order %d",
+               FILTER_MEDIAN_WINDOW, FILTER_EMA_SHIFT, FILTER_KALMAN_Q_OVER_R_Q16,
+               ADC_OVERSAMPLE_BITS, ADC_CIC_ORDER);
+
+    runStage<MedianFilter<FILTER_MEDIAN_WINDOW>>(bench, "MedianFilter", signal);
+    runStage<EmaFilter<FILTER_EMA_SHIFT>>(bench, "EmaFilter", signal);
+    runStage<Kalman1D<FILTER_KALMAN_Q_OVER_R_Q16>>(bench, "Kalman1D", signal);
+
+    // The ADC sampler's decimator, per input conversion
+    {
+        CicDecimator<2 * ADC_OVERSAMPLE_BITS, ADC_CIC_ORDER> cic;
+        uint32_t out = 0;
+        uint32_t outputs = 0;
+        bench.run("CicDecimator, ADC sampler", 4000000, [&](uint64_t i) {
+            outputs += cic.apply(signal.adc[i % SIGNAL_LENGTH], out);
+            bench::keep(out);
+        });
+        noteCycles(bench, signal.ghz);
+        bench.note("%u outputs", outputs);
+    }
+
+    // Float in, float out, as the sensors call them
+    runChain<FilterChain<FILTER_NONE>>(bench, "FilterChain none", signal);
+    runChain<FilterChain<FILTER_MEDIAN>>(bench, "FilterChain median", signal);
+    runChain<FilterChain<FILTER_EMA>>(bench, "FilterChain EMA", signal);
+    runChain<FilterChain<FILTER_MEDIAN | FILTER_EMA>>(bench, "FilterChain median+EMA", signal);
+    runChain<FilterChain<FILTER_MEDIAN | FILTER_KALMAN>>(bench, "FilterChain median+Kalman", signal);
+    runChain<FilterChain<FILTER_MEDIAN | FILTER_EMA | FILTER_KALMAN>>(bench, "FilterChain median+EMA+Kalman", signal);
+}
@@ -0,0 +1,137 @@
+// The four paths the on-device perf probes watch (perf_monitor.h)
+
+#include "bench.h"
+#include "host_harness.h"
+
+// A full reading, as the sensor task publishes it
+static void fillSample(SharedSensorData& data, uint32_t i) {
+    data.ze40_tvoc_ppb = 412.0f + (i % 7);
+    data.ze40_tvoc_ppm = data.ze40_tvoc_ppb / 1000.0f;
+    data.ze40_dac_voltage = 0.83f;
+    data.ze40_dac_ppm = 0.41f;
+    data.ze40_uart_valid = true;
+    data.ze40_analog_valid = true;
+    data.ze40_preheat_complete = true;
+    data.zphs01b_pm1 = 8;
+    data.zphs01b_pm25 = 12 + (i % 3);
+    data.zphs01b_pm10 = 17;
+    data.zphs01b_co2 = 612;
+    data.zphs01b_voc = 1;
+    data.zphs01b_ch2o = 0.012f;
+    data.zphs01b_co = 0.4f;
+    data.zphs01b_o3 = 0.02f;
+    data.zphs01b_no2 = 0.01f;
+    data.zphs01b_temperature = 23.4f;
+    data.zphs01b_humidity = 41.5f;
+    data.zphs01b_valid = true;
+    data.mr007_voltage = 0.41f;
+    data.mr007_raw = 509;
+    data.mr007_lel = 1.3f;
+    data.mr007_valid = true;
+    data.me4so2_voltage = 0.62f;
+    data.me4so2_raw = 770;
+    data.me4so2_current = 0.031f;
+    data.me4so2_so2 = 0.15f;
+    data.me4so2_valid = true;
+    strcpy(data.ip_address, "192.168.1.50");
+    data.network_ready = true;
+    data.last_update = millis();
+}
+
+static void publishSample(uint32_t i) {
+    SharedSensorData data;
+    fillSample(data, i);
+    HostHarness::publishReading(data, millis());
+}
+
+// ZE40 initiative upload frame: 0xFF 0x17 0x04 0x00 ppb(2) full scale(2) checksum
+static void ze40Frame(uint8_t frame[9], uint16_t ppb) {
+    const uint8_t head[8] = { 0xFF, 0x17, 0x04, 0x00, (uint8_t)(ppb >> 8), (uint8_t)ppb, 0x07, 0xD0 };
+    memcpy(frame, head, 8);
+    uint8_t sum = 0;
+    for (int i = 1; i <= 7; i++) sum += frame[i];
+    frame[8] = (uint8_t)(~sum + 1);
+}
+
+BENCH_SUITE(hot_paths) {
+    HostHarness::bootFirmware();
+    ze40Sensor.init();
+    publishSample(0);
+
+    // DjangoClient::buildJSONPayload: the live upload body
+    {
+        SharedSensorData data;
+        fillSample(data, 0);
+        static char buffer[UPLINK_PAYLOAD_BUFFER_SIZE];
+        size_t length = 0;
+        bench.run("buildJSONPayload", 20000, [&](uint64_t i) {
+            data.zphs01b_pm25 = 12 + (i % 3);
+            length = HostHarness::buildJSONPayload(data, millis(), buffer, sizeof(buffer));
+            bench::keep(length);
+        });
+        bench.note("%zu byte body", length);
+    }
+
+    // BufferManager::saveData: one record into the ring log, sector
+    // erases included as they fall; emptied untimed when nearly full
+    {
+        SharedSensorData data;
+        fillSample(data, 0);
+        bench.runEach("BufferManager::saveData", 20000,
+            [](uint64_t) {
+                if (BufferManager::isAlmostFull()) BufferManager::clearBuffer();
+            },
+            [&](uint64_t i) {
+                bench::keep(BufferManager::saveData(data, 1700000000 + (uint32_t)i));
+            });
+        BufferManager::clearBuffer();
+    }
+
+    // SensorWebServer::handleHTTPRequest for an authenticated GET /data:
+    // the request is already parsed, the socket accepted untimed. The
+    // clock moves a second per request so the rate limit never trips.
+    {
+        size_t responseBytes = 0;
+        bench.runEach("handleHTTPRequest GET /data", 5000,
+            [](uint64_t) {
+                host::advanceMs(1000);
+                host::peerConnect(host::ETHERNET);
+            },
+            [](uint64_t) {
+                WebConnection* conn = HostHarness::webAccept("GET", "/data", "", API_ACCESS_TOKEN);
+                if (conn != nullptr) HostHarness::webHandle(*conn);
+            });
+        int socket = host::peerConnect(host::ETHERNET);
+        WebConnection* conn = HostHarness::webAccept("GET", "/data", "", API_ACCESS_TOKEN);
+        if (conn != nullptr) HostHarness::webHandle(*conn);
+        responseBytes = host::peerReceived(socket).size();
+        bench.note("%zu byte response, %d connection(s) left open",
+                   responseBytes, HostHarness::webActiveClients());
+    }
+
+    // The same request end to end: accept, read and parse, answer, close
+    {
+        static const std::string request = std::string("GET /data HTTP/1.1\r\nHost: sensor\r\nX-API-Token: ") +
+                                           API_ACCESS_TOKEN + "\r\n\r\n";
+        bench.runEach("GET /data, accept to close", 5000,
+            [](uint64_t) {
+                host::advanceMs(1000);
+                host::peerConnect(host::ETHERNET, request);
+            },
+            [](uint64_t) {
+                webServer.handleEthernetClient();
+            });
+    }
+
+    // ZE40Sensor::processByte: one 9-byte frame per 9 calls, each frame
+    // queued for the sensor task and taken off again
+    {
+        static uint8_t stream[9 * 16];
+        for (int f = 0; f < 16; f++) ze40Frame(stream + 9 * f, (uint16_t)(400 + f));
+        uint32_t frames = 0;
+        bench.run("ZE40Sensor::processByte", 2000000, [&](uint64_t i) {
+            if (HostHarness::ze40ProcessByte(stream[i % sizeof(stream)])) frames += HostHarness::ze40TakeFrames();
+        });
+        bench.note("%u frames", frames);
+    }
+}
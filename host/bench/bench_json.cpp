@@ -0,0 +1,212 @@
+// JsonWriter against the String concatenation it replaced, building the
+// same upload document: the baseline's DjangoClient::buildJSONPayload(),
+// kept here as it was apart from taking the reading as an argument
+
+#include "bench.h"
+#include "host_harness.h"
+#include "json_writer.h"
+
+namespace {
+
+SharedSensorData reading() {
+    SharedSensorData d;
+    d.ze40_tvoc_ppb = 412.0f;
+    d.ze40_tvoc_ppm = 0.412f;
+    d.ze40_dac_voltage = 0.83f;
+    d.ze40_dac_ppm = 0.41f;
+    d.ze40_uart_valid = true;
+    d.zphs01b_pm1 = 8;
+    d.zphs01b_pm25 = 12;
+    d.zphs01b_pm10 = 17;
+    d.zphs01b_co2 = 612;
+    d.zphs01b_voc = 1;
+    d.zphs01b_ch2o = 0.012f;
+    d.zphs01b_co = 0.4f;
+    d.zphs01b_o3 = 0.02f;
+    d.zphs01b_no2 = 0.01f;
+    d.zphs01b_temperature = 23.4f;
+    d.zphs01b_humidity = 41.5f;
+    d.zphs01b_valid = true;
+    d.mr007_voltage = 0.41f;
+    d.mr007_raw = 509;
+    d.mr007_lel = 1.3f;
+    d.mr007_valid = true;
+    d.me4so2_voltage = 0.62f;
+    d.me4so2_raw = 770;
+    d.me4so2_current = 0.031f;
+    d.me4so2_so2 = 0.15f;
+    d.me4so2_valid = true;
+    strcpy(d.ip_address, "192.168.1.50");
+    return d;
+}
+
+String legacyPayload(const SharedSensorData& localData) {
+    String json = "{";
+
+    // ZE40 Data
+    json += "\"ze40\":{";
+    json += "\"tvoc_ppb\":" + String(localData.ze40_tvoc_ppb) + ",";
+    json += "\"tvoc_ppm\":" + String(localData.ze40_tvoc_ppm, 3) + ",";
+    json += "\"dac_voltage\":" + String(localData.ze40_dac_voltage, 2) + ",";
+    json += "\"dac_ppm\":" + String(localData.ze40_dac_ppm, 3) + ",";
+    json += "\"uart_data_valid\":" + String(localData.ze40_uart_valid ? "true" : "false") + ",";
+    json += "\"analog_data_valid\":true";
+    json += "},";
+
+    // ZPHS01B Air Quality Data
+    if (localData.zphs01b_valid) {
+        json += "\"air_quality\":{";
+        json += "\"pm1\":" + String(localData.zphs01b_pm1) + ",";
+        json += "\"pm25\":" + String(localData.zphs01b_pm25) + ",";
+        json += "\"pm10\":" + String(localData.zphs01b_pm10) + ",";
+        json += "\"co2\":" + String(localData.zphs01b_co2) + ",";
+        json += "\"voc\":" + String(localData.zphs01b_voc) + ",";
+        json += "\"ch2o\":" + String(localData.zphs01b_ch2o) + ",";
+        json += "\"co\":" + String(localData.zphs01b_co, 1) + ",";
+        json += "\"o3\":" + String(localData.zphs01b_o3, 2) + ",";
+        json += "\"no2\":" + String(localData.zphs01b_no2, 3) + ",";
+        json += "\"temperature\":" + String(localData.zphs01b_temperature, 1) + ",";
+        json += "\"humidity\":" + String(localData.zphs01b_humidity);
+        json += "},";
+    } else {
+        json += "\"air_quality\":null,";
+    }
+
+    // MR007 Data
+    if (localData.mr007_valid) {
+        json += "\"mr007\":{";
+        json += "\"voltage\":" + String(localData.mr007_voltage, 3) + ",";
+        json += "\"rawValue\":" + String(localData.mr007_raw) + ",";
+        json += "\"lel_concentration\":" + String(localData.mr007_lel, 1);
+        json += "},";
+    } else {
+        json += "\"mr007\":null,";
+    }
+
+    // ME4-SO2 Data
+    if (localData.me4so2_valid) {
+        json += "\"me4_so2\":{";
+        json += "\"voltage\":" + String(localData.me4so2_voltage, 4) + ",";
+        json += "\"rawValue\":" + String(localData.me4so2_raw) + ",";
+        json += "\"current_ua\":" + String(localData.me4so2_current, 2) + ",";
+        json += "\"so2_concentration\":" + String(localData.me4so2_so2, 2);
+        json += "},";
+    } else {
+        json += "\"me4_so2\":null,";
+    }
+
+    // Network Info
+    json += "\"ip_address\":\"" + String(localData.ip_address) + "\",";
+    json += "\"network_mode\":\"eth\"";
+
+    json += "}";
+
+    return json;
+}
+
+// The same document through JsonWriter
+size_t writerPayload(const SharedSensorData& d, char* buffer, size_t capacity) {
+    JsonWriter w(buffer, capacity);
+    w.beginObject();
+
+    w.key("ze40");
+    w.beginObject();
+    w.member("tvoc_ppb", d.ze40_tvoc_ppb, 2);
+    w.member("tvoc_ppm", d.ze40_tvoc_ppm, 3);
+    w.member("dac_voltage", d.ze40_dac_voltage, 2);
+    w.member("dac_ppm", d.ze40_dac_ppm, 3);
+    w.member("uart_data_valid", d.ze40_uart_valid);
+    w.member("analog_data_valid", true);
+    w.endObject();
+
+    w.key("air_quality");
+    if (d.zphs01b_valid) {
+        w.beginObject();
+        w.member("pm1", d.zphs01b_pm1, 2);
+        w.member("pm25", d.zphs01b_pm25, 2);
+        w.member("pm10", d.zphs01b_pm10, 2);
+        w.member("co2", d.zphs01b_co2, 2);
+        w.member("voc", d.zphs01b_voc, 2);
+        w.member("ch2o", d.zphs01b_ch2o, 2);
+        w.member("co", d.zphs01b_co, 1);
+        w.member("o3", d.zphs01b_o3, 2);
+        w.member("no2", d.zphs01b_no2, 3);
+        w.member("temperature", d.zphs01b_temperature, 1);
+        w.member("humidity", d.zphs01b_humidity, 2);
+        w.endObject();
+    } else {
+        w.null();
+    }
+
+    w.key("mr007");
+    if (d.mr007_valid) {
+        w.beginObject();
+        w.member("voltage", d.mr007_voltage, 3);
+        w.member("rawValue", d.mr007_raw);
+        w.member("lel_concentration", d.mr007_lel, 1);
+        w.endObject();
+    } else {
+        w.null();
+    }
+
+    w.key("me4_so2");
+    if (d.me4so2_valid) {
+        w.beginObject();
+        w.member("voltage", d.me4so2_voltage, 4);
+        w.member("rawValue", d.me4so2_raw);
+        w.member("current_ua", d.me4so2_current, 2);
+        w.member("so2_concentration", d.me4so2_so2, 2);
+        w.endObject();
+    } else {
+        w.null();
+    }
+
+    w.member("ip_address", (const char*)d.ip_address);
+    w.member("network_mode", "eth");
+    w.endObject();
+    return w.ok() ? w.length() : 0;
+}
+
+}
+
+BENCH_SUITE(json) {
+    SharedSensorData d = reading();
+    static char buffer[UPLINK_PAYLOAD_BUFFER_SIZE];
+
+    size_t legacyLength = 0;
+    bench.run("payload, String concatenation", 20000, [&](uint64_t i) {
+        d.zphs01b_pm25 = 12 + (i % 3);
+        String json = legacyPayload(d);
+        legacyLength = json.length();
+        bench::keep(legacyLength);
+    });
+    bench.note("%zu bytes", legacyLength);
+
+    size_t writerLength = 0;
+    bench.run("payload, JsonWriter", 20000, [&](uint64_t i) {
+        d.zphs01b_pm25 = 12 + (i % 3);
+        writerLength = writerPayload(d, buffer, sizeof(buffer));
+        bench::keep(writerLength);
+    });
+    bench.note("%zu bytes", writerLength);
+
+    // Both must write the same document
+    d.zphs01b_pm25 = 12;
+    String legacy = legacyPayload(d);
+    writerPayload(d, buffer, sizeof(buffer));
+    if (strcmp(legacy.c_str(), buffer) != 0) {
+        bench.fail("JsonWriter and String documents differ:\n    %s\n    %s", legacy.c_str(), buffer);
+    }
+
+    // One float member, the unit both spend most of their time on
+    bench.run("float member, String(value, 3)", 200000, [&](uint64_t i) {
+        String member = "\"voltage\":" + String(0.412f + (i & 7) * 0.001f, 3) + ",";
+        bench::keep(member.length());
+    });
+    bench.run("float member, JsonWriter", 200000, [&](uint64_t i) {
+        JsonWriter w(buffer, sizeof(buffer));
+        w.beginObject();
+        w.member("voltage", 0.412f + (i & 7) * 0.001f, 3);
+        bench::keep(w.length());
+    });
+}
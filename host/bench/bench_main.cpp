@@ -0,0 +1,128 @@
+// host_bench: run the host benchmarks and compare them with a baseline
+//
+//   host_bench                          run every suite
+//   host_bench --suite hot_paths        only suites whose name contains this
+//   host_bench --quick                  a twentieth of the operations
+//   host_bench --write FILE             save the results as a baseline
+//   host_bench --check FILE [--strict]  compare with a baseline
+//
+// A check fails when a result allocates more often or more bytes per
+// operation than the baseline. Time only fails it with --strict, at
+// more than TIME_TOLERANCE times the baseline: ns/op depends on the
+// machine, allocations do not.
+
+#include "bench.h"
+#include <stdlib.h>
+#include <string.h>
+#include <map>
+
+static const double TIME_TOLERANCE = 3.0;
+
+static bool writeBaseline(const char* path, const std::vector<bench::Result>& results) {
+    FILE* file = fopen(path, "w");
+    if (file == nullptr) {
+        printf("Cannot write %s\n", path);
+        return false;
+    }
+    fprintf(file, "# host_bench baseline: name ns/op allocs/op bytes/op\n");
+    fprintf(file, "# Regenerate with host_bench --write (RelWithDebInfo build)\n");
+    for (const bench::Result& r : results) {
+        fprintf(file, "%s\t%.1f\t%.2f\t%.1f\n", r.name.c_str(), r.nsPerOp, r.allocsPerOp, r.bytesPerOp);
+    }
+    fclose(file);
+    printf("Wrote %zu results to %s\n", results.size(), path);
+    return true;
+}
+
+static bool readBaseline(const char* path, std::map<std::string, bench::Result>& out) {
+    FILE* file = fopen(path, "r");
+    if (file == nullptr) {
+        printf("Cannot read %s\n", path);
+        return false;
+    }
+    char line[512];
+    while (fgets(line, sizeof(line), file)) {
+        if (line[0] == '#' || line[0] == '\n') continue;
+        char* tab = strchr(line, '\t');
+        if (tab == nullptr) continue;
+        *tab = '\0';
+        bench::Result r;
+        r.name = line;
+        if (sscanf(tab + 1, "%lf %lf %lf", &r.nsPerOp, &r.allocsPerOp, &r.bytesPerOp) != 3) continue;
+        out[r.name] = r;
+    }
+    fclose(file);
+    return true;
+}
+
+static int checkBaseline(const char* path, const std::vector<bench::Result>& results, bool strict) {
+    std::map<std::string, bench::Result> baseline;
+    if (!readBaseline(path, baseline)) return 1;
+
+    int failures = 0;
+    printf("\nAgainst %s:\n", path);
+    for (const bench::Result& r : results) {
+        auto it = baseline.find(r.name);
+        if (it == baseline.end()) {
+            printf("  NEW   %s (not in the baseline)\n", r.name.c_str());
+            continue;
+        }
+        const bench::Result& b = it->second;
+        if (r.allocsPerOp > b.allocsPerOp + 0.01) {
+            printf("  FAIL  %s: %.2f allocs/op, baseline %.2f\n", r.name.c_str(), r.allocsPerOp, b.allocsPerOp);
+            failures++;
+        }
+        if (r.bytesPerOp > b.bytesPerOp * 1.05 + 1.0) {
+            printf("  FAIL  %s: %.1f bytes/op, baseline %.1f\n", r.name.c_str(), r.bytesPerOp, b.bytesPerOp);
+            failures++;
+        }
+        if (r.nsPerOp > b.nsPerOp * TIME_TOLERANCE) {
+            printf("  %s  %s: %.1f ns/op, baseline %.1f\n", strict ? "FAIL" : "SLOW",
+                   r.name.c_str(), r.nsPerOp, b.nsPerOp);
+            if (strict) failures++;
+        }
+    }
+    printf(failures == 0 ? "  OK\n" : "  %d regression(s)\n", failures);
+    return failures == 0 ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    const char* filter = nullptr;
+    const char* writePath = nullptr;
+    const char* checkPath = nullptr;
+    bool quick = false;
+    bool strict = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--suite") == 0 && i + 1 < argc) filter = argv[++i];
+        else if (strcmp(argv[i], "--write") == 0 && i + 1 < argc) writePath = argv[++i];
+        else if (strcmp(argv[i], "--check") == 0 && i + 1 < argc) checkPath = argv[++i];
+        else if (strcmp(argv[i], "--quick") == 0) quick = true;
+        else if (strcmp(argv[i], "--strict") == 0) strict = true;
+        else {
+            printf("usage: %s [--suite NAME] [--quick] [--write FILE] [--check FILE [--strict]]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    std::vector<bench::Suite> selected;
+    for (const bench::Suite& suite : bench::suites()) {
+        if (filter == nullptr || strstr(suite.name, filter) != nullptr) selected.push_back(suite);
+    }
+    std::sort(selected.begin(), selected.end(),
+              [](const bench::Suite& a, const bench::Suite& b) { return strcmp(a.name, b.name) < 0; });
+
+    bench::Bench bench(quick);
+    for (const bench::Suite& suite : selected) {
+        printf("%s\n", suite.name);
+        suite.run(bench);
+    }
+
+    if (bench.failed() > 0) {
+        printf("%d suite check(s) failed\n", bench.failed());
+        return 1;
+    }
+    if (writePath != nullptr && !writeBaseline(writePath, bench.all())) return 1;
+    if (checkPath != nullptr) return checkBaseline(checkPath, bench.all(), strict);
+    return 0;
+}
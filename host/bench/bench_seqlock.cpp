@@ -0,0 +1,143 @@
+// SharedSensorData seqlock under contention: one writer publishing a
+// sample to every ring back to back while reader threads take
+// snapshots, which read the newest sample of each ring (shared_data.cpp)
+
+#include "bench.h"
+#include "host_harness.h"
+#include <atomic>
+#include <thread>
+
+namespace {
+
+struct ThreadFigures {
+    std::vector<uint64_t> latencies;
+    uint64_t allocs = 0;
+    uint64_t bytes = 0;
+    uint64_t torn = 0;
+};
+
+// Every sample the writer pushes carries the same counter, so a
+// snapshot that mixes two updates is caught
+void writeUpdate(uint32_t counter) {
+    float v = (float)(counter & 0xFFFFF);
+    SharedSensorData d;
+    d.ze40_tvoc_ppb = v;
+    d.ze40_dac_voltage = v;
+    d.zphs01b_pm1 = v;
+    d.zphs01b_pm25 = v;
+    d.zphs01b_pm10 = v;
+    d.zphs01b_co2 = v;
+    d.zphs01b_temperature = v;
+    d.zphs01b_humidity = v;
+    d.mr007_raw = (int)(counter & 0xFFFFF);
+    d.me4so2_raw = (int)(counter & 0xFFFFF);
+    HostHarness::publishReading(d, 1000 + counter);
+}
+
+bool consistent(const SharedSensorData& d) {
+    float v = d.ze40_tvoc_ppb;
+    return d.ze40_dac_voltage == v && d.zphs01b_pm1 == v && d.zphs01b_pm25 == v &&
+           d.zphs01b_pm10 == v && d.zphs01b_co2 == v && d.zphs01b_temperature == v &&
+           d.zphs01b_humidity == v && d.mr007_raw == (int)v && d.me4so2_raw == (int)v &&
+           ((d.last_update - 1000) & 0xFFFFF) == (unsigned long)v;
+}
+
+void runContention(bench::Bench& bench, int readers, uint64_t updates) {
+    std::atomic<bool> done{false};
+    std::atomic<int> ready{0};
+    std::vector<ThreadFigures> readerFigures(readers);
+    ThreadFigures writerFigures;
+    writerFigures.latencies.reserve(updates);
+
+    std::vector<std::thread> threads;
+    for (int r = 0; r < readers; r++) {
+        threads.emplace_back([&, r]() {
+            ThreadFigures& f = readerFigures[r];
+            f.latencies.reserve(1 << 20);
+            ready++;
+            SharedSensorData local;
+            host::AllocCounters before = host::allocCounters();
+            while (!done.load(std::memory_order_relaxed)) {
+                uint64_t start = bench::nowNs();
+                snapshotData(local);
+                uint64_t elapsed = bench::nowNs() - start;
+                if (f.latencies.size() < f.latencies.capacity()) f.latencies.push_back(elapsed);
+                if (!consistent(local)) f.torn++;
+            }
+            host::AllocCounters after = host::allocCounters();
+            f.allocs = after.allocs - before.allocs;
+            f.bytes = after.bytes - before.bytes;
+        });
+    }
+    while (ready.load() < readers) std::this_thread::yield();
+
+    host::AllocCounters before = host::allocCounters();
+    for (uint64_t i = 0; i < updates; i++) {
+        uint64_t start = bench::nowNs();
+        writeUpdate((uint32_t)i);
+        writerFigures.latencies.push_back(bench::nowNs() - start);
+    }
+    host::AllocCounters after = host::allocCounters();
+    done = true;
+    for (std::thread& t : threads) t.join();
+
+    // Readers: every snapshot from every thread
+    std::vector<uint64_t> reads;
+    uint64_t readAllocs = 0;
+    uint64_t readBytes = 0;
+    uint64_t torn = 0;
+    for (ThreadFigures& f : readerFigures) {
+        reads.insert(reads.end(), f.latencies.begin(), f.latencies.end());
+        readAllocs += f.allocs;
+        readBytes += f.bytes;
+        torn += f.torn;
+    }
+    uint64_t readSum = 0;
+    for (uint64_t ns : reads) readSum += ns;
+    double readOps = reads.empty() ? 1.0 : (double)reads.size();
+
+    uint64_t writeSum = 0;
+    for (uint64_t ns : writerFigures.latencies) writeSum += ns;
+
+    char name[64];
+    snprintf(name, sizeof(name), "snapshotData, %d reader(s) + writer", readers);
+    bench.record(name, readSum / readOps, readAllocs / readOps, readBytes / readOps);
+    bench.note("%zu snapshots: p50 %llu ns, p99 %llu ns, max %llu ns, %llu torn",
+               reads.size(),
+               (unsigned long long)bench::percentile(reads, 0.50),
+               (unsigned long long)bench::percentile(reads, 0.99),
+               (unsigned long long)bench::percentile(reads, 1.0),
+               (unsigned long long)torn);
+    if (torn > 0) bench.fail("%s: %llu torn snapshots", name, (unsigned long long)torn);
+
+    snprintf(name, sizeof(name), "data update, %d reader(s) running", readers);
+    bench.record(name, (double)writeSum / updates,
+                 (double)(after.allocs - before.allocs) / updates,
+                 (double)(after.bytes - before.bytes) / updates);
+    bench.note("%llu updates: p50 %llu ns, p99 %llu ns, max %llu ns",
+               (unsigned long long)updates,
+               (unsigned long long)bench::percentile(writerFigures.latencies, 0.50),
+               (unsigned long long)bench::percentile(writerFigures.latencies, 0.99),
+               (unsigned long long)bench::percentile(writerFigures.latencies, 1.0));
+}
+
+}
+
+BENCH_SUITE(seqlock) {
+    HostHarness::bootFirmware();
+
+    // Uncontended costs first
+    SharedSensorData local;
+    bench.run("snapshotData, uncontended", 2000000, [&](uint64_t) {
+        bench::keep(snapshotData(local));
+    });
+    bench.run("data update, uncontended", 2000000, [](uint64_t i) {
+        writeUpdate((uint32_t)i);
+    });
+
+    // Host threads can be preempted inside the writer's critical section,
+    // which an ESP32 core cannot; that shows up in the max, not the p99
+    bench.note("%u hardware thread(s) on this host", std::thread::hardware_concurrency());
+    runContention(bench, 1, bench.scale(200000));
+    runContention(bench, 3, bench.scale(200000));
+}
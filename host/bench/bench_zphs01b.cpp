@@ -0,0 +1,95 @@
+// ZPHS01BSensor::processByte() replaying a day of readings, clean and
+// with one frame in four damaged, and how long the parser takes to get
+// back in step after each damaged frame (tests/zphs01b_stream.h)
+
+#include "bench.h"
+#include "host_harness.h"
+#include "zphs01b_stream.h"
+
+using namespace zphs01b_stream;
+
+// Line time of a byte at SENSOR_BAUD_RATE, 8N1
+static const double BYTE_MS = 10.0 * 1000.0 / SENSOR_BAUD_RATE;
+
+// Feed the whole capture `ops` bytes at a time, taking frames off as the
+// sensor task would
+static void runReplay(bench::Bench& bench, const char* name, const UartCapture& capture, uint64_t ops) {
+    const std::vector<uint8_t>& bytes = capture.bytes();
+    uint32_t frames = 0;
+    HostHarness::zphs01bResetParser();
+    bench.run(name, ops, [&](uint64_t i) {
+        if (HostHarness::zphs01bProcessByte(bytes[i % bytes.size()])) frames += HostHarness::zphs01bTakeFrames();
+    });
+    double nsPerByte = bench.all().back().nsPerOp;
+    bench.note("%u frames, %.0f bytes/s (%.4f%% of a core at %d baud)",
+               frames, 1e9 / nsPerByte, 100.0 * nsPerByte * (SENSOR_BAUD_RATE / 10) / 1e9, SENSOR_BAUD_RATE);
+}
+
+BENCH_SUITE(zphs01b_replay) {
+    HostHarness::bootFirmware();
+    zphs01bSensor.init();
+
+    // 17280 readings: a day at ZPHS01B_READ_INTERVAL
+    const uint32_t READINGS = 86400 * 1000 / ZPHS01B_READ_INTERVAL;
+    UartCapture clean(READINGS);
+    UartCapture damaged(READINGS);
+    damaged.damageRandomly(4, 2024);
+    damaged.render(2024);
+
+    runReplay(bench, "ZPHS01B processByte, clean day", clean, 4000000);
+    runReplay(bench, "ZPHS01B processByte, 1 in 4 damaged", damaged, 4000000);
+
+    // Recovery: from the first byte of a damaged frame to the next frame
+    // out of the parser that the sensor really sent. The floor is the
+    // rest of the damage plus one intact frame.
+    HostHarness::zphs01bResetParser();
+    const std::vector<FrameRecord>& sent = damaged.frames();
+    const std::vector<uint8_t>& bytes = damaged.bytes();
+    std::vector<uint64_t> recoveryBytes;
+    std::vector<uint64_t> overFloor;
+    size_t record = 0;
+    size_t pendingDamage = SIZE_MAX;
+    uint32_t phantoms = 0;
+    UartFrame frame;
+    for (size_t at = 0; at < bytes.size(); at++) {
+        while (record + 1 < sent.size() && sent[record + 1].start <= at) record++;
+        if (sent[record].damage != INTACT && sent[record].start == at) pendingDamage = record;
+
+        if (!HostHarness::zphs01bProcessByte(bytes[at])) continue;
+        while (HostHarness::zphs01bPopFrame(frame)) {
+            if (pendingDamage == SIZE_MAX) continue;
+            // Which frame of the next few was this?
+            size_t match = pendingDamage;
+            while (match < sent.size() && match < pendingDamage + 4 &&
+                   memcmp(frame.bytes, sent[match].bytes, RESPONSE_LENGTH) != 0) {
+                match++;
+            }
+            if (match == sent.size() || match == pendingDamage + 4) {
+                phantoms++;
+                continue;
+            }
+            uint64_t taken = at + 1 - sent[pendingDamage].start;
+            size_t firstWhole = pendingDamage;
+            while (firstWhole < sent.size() && !UartCapture::delivers(sent[firstWhole].damage)) firstWhole++;
+            uint64_t floor = (firstWhole < sent.size() ? sent[firstWhole].end : at + 1) - sent[pendingDamage].start;
+            recoveryBytes.push_back(taken);
+            overFloor.push_back(taken > floor ? taken - floor : 0);
+            pendingDamage = SIZE_MAX;
+        }
+    }
+    HostHarness::zphs01bTakeFrames();
+
+    uint64_t late = 0;
+    for (uint64_t extra : overFloor) late += extra > 0;
+    bench.note("%zu recoveries: p50 %llu bytes (%.0f ms), p99 %llu bytes (%.0f ms), max %llu bytes (%.0f ms)",
+               recoveryBytes.size(),
+               (unsigned long long)bench::percentile(recoveryBytes, 0.50), bench::percentile(recoveryBytes, 0.50) * BYTE_MS,
+               (unsigned long long)bench::percentile(recoveryBytes, 0.99), bench::percentile(recoveryBytes, 0.99) * BYTE_MS,
+               (unsigned long long)bench::percentile(recoveryBytes, 1.0), bench::percentile(recoveryBytes, 1.0) * BYTE_MS);
+    bench.note("%llu recoveries later than the first intact frame (max %llu bytes over), %u phantom frames",
+               (unsigned long long)late, (unsigned long long)bench::percentile(overFloor, 1.0), phantoms);
+    if (late > phantoms) {
+        bench.fail("ZPHS01B resync: %llu late recoveries but only %u phantom frames to explain them",
+                   (unsigned long long)late, phantoms);
+    }
+}
@@ -0,0 +1,48 @@
+// host_web_server: the firmware's web server on 127.0.0.1, for
+// tools/web_bench.py
+//
+//   host_web_server [PORT]             default 8080
+//   python3 tools/web_bench.py 127.0.0.1 --port 8080 --token <API_ACCESS_TOKEN>
+//
+// Runs the Ethernet task's loop on the real clock, publishing a reading
+// a second. Connections take W5500 sockets (MAX_SOCK_NUM, 2 KB TX each)
+// as on the device. The per-IP rate limit is cleared every pass, because
+// every bench client comes from the same address and the bench measures
+// the server, not the limiter.
+
+#include "host_harness.h"
+#include <stdlib.h>
+
+int main(int argc, char** argv) {
+    uint16_t port = argc > 1 ? (uint16_t)atoi(argv[1]) : 8080;
+
+    HostHarness::bootFirmware();
+    host::useRealClock();
+    if (!host::listenTcp(port)) {
+        printf("Cannot listen on 127.0.0.1:%u\n", port);
+        return 1;
+    }
+    printf("Serving on http://127.0.0.1:%u (API token %s)\n", port, API_ACCESS_TOKEN);
+    fflush(stdout);
+
+    SharedSensorData d;
+    d.ze40_uart_valid = true;
+    d.zphs01b_valid = true;
+    d.network_ready = true;
+    strcpy(d.ip_address, "127.0.0.1");
+
+    unsigned long lastReading = 0;
+    while (true) {
+        if (millis() - lastReading >= 1000) {
+            lastReading = millis();
+            d.ze40_tvoc_ppb = 400.0f + (lastReading / 1000) % 50;
+            d.zphs01b_co2 = 600.0f + (lastReading / 1000) % 200;
+            HostHarness::publishReading(d, lastReading / 1000);
+        }
+        HostHarness::webResetRateLimit();
+
+        // As TaskManager's Ethernet task does
+        bool busy = webServer.handleEthernetClient();
+        vTaskDelay(busy ? 1 : 10 / portTICK_PERIOD_MS);
+    }
+}
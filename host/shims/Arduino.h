@@ -0,0 +1,70 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+/**
+ * Host stand-in for the ESP32 Arduino core
+ *
+ * Enough of the core, FreeRTOS and ESP-IDF for the firmware in main/ to
+ * compile and run on Linux. Hardware the tests do not drive (GPIO, ADC,
+ * SPI, mDNS) is inert; the clock, UARTs, sockets and flash partition
+ * are simulated and can be steered through host_control.h.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "freertos/queue.h"
+#include "esp_heap_caps.h"
+#include "WString.h"
+#include "Print.h"
+#include "Stream.h"
+#include "IPAddress.h"
+#include "Client.h"
+#include "Udp.h"
+#include "HardwareSerial.h"
+
+#define PROGMEM
+#define IRAM_ATTR
+#define DRAM_ATTR
+#define FPSTR(p) (reinterpret_cast<const char*>(p))
+#define F(s) (s)
+#define PSTR(s) (s)
+#define memcpy_P memcpy
+#define strlen_P strlen
+#define strcmp_P strcmp
+#define pgm_read_byte(p) (*(const uint8_t*)(p))
+
+#define HIGH 0x1
+#define LOW 0x0
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+uint16_t analogRead(uint8_t pin);
+void analogReadResolution(uint8_t bits);
+void analogSetAttenuation(int attenuation);
+
+bool psramFound();
+uint32_t esp_random();
+
+#endif
@@ -0,0 +1,21 @@
+#ifndef HOST_ESPMDNS_H
+#define HOST_ESPMDNS_H
+
+#include <stdint.h>
+
+class MDNSResponder {
+public:
+    bool begin(const char* hostName) { (void)hostName; return true; }
+    bool addService(const char* service, const char* proto, uint16_t port) {
+        (void)service; (void)proto; (void)port;
+        return true;
+    }
+    bool addServiceTxt(const char* service, const char* proto, const char* key, const char* value) {
+        (void)service; (void)proto; (void)key; (void)value;
+        return true;
+    }
+};
+
+extern MDNSResponder MDNS;
+
+#endif
@@ -0,0 +1,103 @@
+#ifndef HOST_ETHERNET_H
+#define HOST_ETHERNET_H
+
+#include "Arduino.h"
+
+#define MAX_SOCK_NUM 8          // Hardware sockets on the W5500
+
+#define DHCP_CHECK_NONE 0
+#define DHCP_CHECK_RENEW_FAIL 1
+#define DHCP_CHECK_RENEW_OK 2
+
+/**
+ * W5500 stand-in
+ *
+ * Every client, listening server and UDP socket takes one of the
+ * MAX_SOCK_NUM hardware sockets, as on the chip; opening one more
+ * fails, and so does a DHCP renewal in maintain(). Sockets are the
+ * simulated or real ones of host_control.h.
+ */
+
+class EthernetClient : public Client {
+public:
+    EthernetClient() {}
+    explicit EthernetClient(int socket) : sock(socket) {}
+
+    int connect(IPAddress ip, uint16_t port) override;
+    int connect(const char* host, uint16_t port) override;
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t* buffer, size_t size) override;
+    int available() override;
+    int read() override;
+    int read(uint8_t* buffer, size_t size) override;
+    int peek() override;
+    void flush() override {}
+    void stop() override;
+    uint8_t connected() override;
+    operator bool() override { return sock >= 0; }
+    int availableForWrite() override;
+    using Print::write;
+
+    uint8_t status();
+    IPAddress remoteIP();
+    uint16_t remotePort();
+    uint8_t getSocketNumber() const { return sock < 0 ? MAX_SOCK_NUM : (uint8_t)sock; }
+    void setConnectionTimeout(uint16_t timeoutMs) { (void)timeoutMs; }
+    bool operator==(const EthernetClient& other) const { return sock == other.sock; }
+    bool operator!=(const EthernetClient& other) const { return sock != other.sock; }
+
+private:
+    int sock = -1;
+};
+
+class EthernetServer {
+public:
+    explicit EthernetServer(uint16_t port) : port(port) {}
+    void begin();
+    EthernetClient accept();
+    EthernetClient available() { return accept(); }
+
+private:
+    uint16_t port;
+    bool listening = false;     // Holds a hardware socket for the next SYN
+};
+
+class EthernetUDP : public UDP {
+public:
+    ~EthernetUDP() { stop(); }
+    uint8_t begin(uint16_t port) override;
+    void stop() override;
+    int beginPacket(IPAddress ip, uint16_t port) override;
+    int beginPacket(const char* host, uint16_t port) override;
+    int endPacket() override;
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t* buffer, size_t size) override;
+    int parsePacket() override;
+    int available() override;
+    int read() override;
+    int read(unsigned char* buffer, size_t length) override;
+    int read(char* buffer, size_t length) override { return read((unsigned char*)buffer, length); }
+    int peek() override;
+    void flush() override {}
+    IPAddress remoteIP() override { return remote; }
+    uint16_t remotePort() override { return remotePortNumber; }
+    using Print::write;
+
+private:
+    int sock = -1;
+    IPAddress remote;
+    uint16_t remotePortNumber = 0;
+};
+
+class EthernetClass {
+public:
+    void init(uint8_t csPin) { (void)csPin; }
+    int begin(uint8_t* mac, unsigned long timeoutMs = 60000, unsigned long responseTimeoutMs = 4000);
+    int maintain();
+    IPAddress localIP();
+    IPAddress dnsServerIP();
+};
+
+extern EthernetClass Ethernet;
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef HOST_HARDWARESERIAL_H
+#define HOST_HARDWARESERIAL_H
+
+#include <functional>
+#include <mutex>
+#include <deque>
+#include <string>
+#include "Stream.h"
+
+#define SERIAL_8N1 0x800001c
+
+typedef std::function<void(void)> OnReceiveCb;
+
+/**
+ * HardwareSerial
+ *
+ * UART 0 is the console: writes go to stdout when host_serial_echo is
+ * set, and are dropped otherwise. Other ports are loopback devices for
+ * tests, which push received bytes with hostUartFeed() (host_control.h)
+ * and read back what the firmware transmitted.
+ */
+class HardwareSerial : public Stream {
+public:
+    explicit HardwareSerial(int uartNum);
+    ~HardwareSerial();
+
+    void begin(unsigned long baud, uint32_t config = SERIAL_8N1, int8_t rxPin = -1, int8_t txPin = -1);
+    void end() {}
+    void onReceive(OnReceiveCb function, bool onlyOnTimeout = false);
+    bool setRxTimeout(uint8_t symbols) { (void)symbols; return true; }
+    void setRxFIFOFull(uint8_t bytes) { (void)bytes; }
+    size_t setRxBufferSize(size_t size) { return size; }
+
+    int available() override;
+    int read() override;
+    int peek() override;
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+    operator bool() const { return true; }
+
+    // Test side: queue received bytes and run the receive callback
+    void feed(const uint8_t* bytes, size_t length);
+    std::string takeTransmitted();
+    int number() const { return uartNum; }
+
+private:
+    int uartNum;
+    std::mutex lock;
+    std::deque<uint8_t> rx;
+    std::string tx;
+    OnReceiveCb onReceiveCb;
+};
+
+extern HardwareSerial Serial;
+
+#endif
@@ -0,0 +1,93 @@
+#ifndef HOST_WSTRING_H
+#define HOST_WSTRING_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * String
+ *
+ * Host copy of the Arduino String. Storage follows the ESP32 core so
+ * allocation counts match the device: up to SSO_CAPACITY characters
+ * live inside the object, longer strings go to the heap and grow to
+ * exactly the length asked for, one realloc() per concatenation.
+ */
+class String {
+public:
+    static const unsigned int SSO_CAPACITY = 11;   // 12-byte inline buffer on a 32-bit core
+
+    String(const char* cstr = "");
+    String(const String& other);
+    String(String&& other);
+    explicit String(char c);
+    explicit String(int value, unsigned char base = 10);
+    explicit String(unsigned int value, unsigned char base = 10);
+    explicit String(long value, unsigned char base = 10);
+    explicit String(unsigned long value, unsigned char base = 10);
+    explicit String(long long value, unsigned char base = 10);
+    explicit String(unsigned long long value, unsigned char base = 10);
+    explicit String(float value, unsigned int decimals = 2);
+    explicit String(double value, unsigned int decimals = 2);
+    ~String();
+
+    String& operator=(const String& other);
+    String& operator=(String&& other);
+    String& operator=(const char* cstr);
+
+    bool reserve(unsigned int size);
+    unsigned int length() const { return len; }
+    bool isEmpty() const { return len == 0; }
+    const char* c_str() const { return buffer(); }
+
+    bool concat(const char* cstr, unsigned int length);
+    bool concat(const char* cstr);
+    bool concat(const String& other) { return concat(other.buffer(), other.len); }
+    bool concat(char c) { return concat(&c, 1); }
+
+    String& operator+=(const String& other) { concat(other); return *this; }
+    String& operator+=(const char* cstr) { concat(cstr); return *this; }
+    String& operator+=(char c) { concat(c); return *this; }
+    template <typename T> String& operator+=(T value) { concat(String(value)); return *this; }
+
+    bool operator==(const String& other) const;
+    bool operator==(const char* cstr) const;
+    bool operator!=(const String& other) const { return !(*this == other); }
+    bool operator!=(const char* cstr) const { return !(*this == cstr); }
+    bool equalsIgnoreCase(const String& other) const;
+    bool startsWith(const String& prefix) const;
+    bool startsWith(const char* prefix) const { return startsWith(String(prefix)); }
+    bool endsWith(const String& suffix) const;
+    bool endsWith(const char* suffix) const { return endsWith(String(suffix)); }
+
+    char operator[](unsigned int index) const { return index < len ? buffer()[index] : 0; }
+    char charAt(unsigned int index) const { return (*this)[index]; }
+    int indexOf(char c, unsigned int from = 0) const;
+    int indexOf(const char* needle, unsigned int from = 0) const;
+    int indexOf(const String& needle, unsigned int from = 0) const { return indexOf(needle.c_str(), from); }
+    String substring(unsigned int from) const { return substring(from, len); }
+    String substring(unsigned int from, unsigned int to) const;
+
+    long toInt() const;
+    float toFloat() const;
+    void trim();
+    void toLowerCase();
+    void toUpperCase();
+
+private:
+    char* buffer() { return heap ? heap : inlineBuffer; }
+    const char* buffer() const { return heap ? heap : inlineBuffer; }
+    void assign(const char* cstr, unsigned int length);
+    void release();
+
+    char* heap = nullptr;
+    unsigned int capacity = SSO_CAPACITY;
+    unsigned int len = 0;
+    char inlineBuffer[SSO_CAPACITY + 1] = {0};
+};
+
+String operator+(const String& lhs, const String& rhs);
+String operator+(const String& lhs, const char* rhs);
+String operator+(const char* lhs, const String& rhs);
+String operator+(const String& lhs, char rhs);
+
+#endif
@@ -0,0 +1,101 @@
+#ifndef HOST_WIFI_H
+#define HOST_WIFI_H
+
+#include "Arduino.h"
+
+typedef enum { WIFI_OFF = 0, WIFI_STA = 1, WIFI_AP = 2, WIFI_AP_STA = 3 } wifi_mode_t;
+typedef enum { WL_IDLE_STATUS = 0, WL_NO_SSID_AVAIL = 1, WL_CONNECTED = 3, WL_CONNECT_FAILED = 4, WL_DISCONNECTED = 6 } wl_status_t;
+
+/**
+ * WiFi stand-in
+ *
+ * Sockets are those of host_control.h without a socket budget. Like
+ * the ESP32 core, WiFiClient does not report availableForWrite();
+ * a write larger than the simulated lwIP send buffer is counted as
+ * one that would have blocked the calling task.
+ */
+
+class WiFiClient : public Client {
+public:
+    WiFiClient() {}
+    explicit WiFiClient(int socket) : sock(socket) {}
+
+    int connect(IPAddress ip, uint16_t port) override;
+    int connect(IPAddress ip, uint16_t port, int32_t timeoutMs) { (void)timeoutMs; return connect(ip, port); }
+    int connect(const char* host, uint16_t port) override;
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t* buffer, size_t size) override;
+    int available() override;
+    int read() override;
+    int read(uint8_t* buffer, size_t size) override;
+    int peek() override;
+    void flush() override {}
+    void stop() override;
+    uint8_t connected() override;
+    operator bool() override { return sock >= 0; }
+    using Print::write;
+
+    IPAddress remoteIP();
+    uint16_t remotePort();
+    int setNoDelay(bool noDelay) { (void)noDelay; return 0; }
+    int fd() const { return sock; }
+    bool operator==(const WiFiClient& other) const { return sock == other.sock; }
+
+private:
+    int sock = -1;
+};
+
+class WiFiServer {
+public:
+    explicit WiFiServer(uint16_t port) : port(port) {}
+    void begin() {}
+    WiFiClient accept();
+    WiFiClient available() { return accept(); }
+    bool hasClient();
+
+private:
+    uint16_t port;
+};
+
+class WiFiUDP : public UDP {
+public:
+    uint8_t begin(uint16_t port) override { (void)port; return 0; }
+    void stop() override {}
+    int beginPacket(IPAddress ip, uint16_t port) override { (void)ip; (void)port; return 0; }
+    int beginPacket(const char* host, uint16_t port) override { (void)host; (void)port; return 0; }
+    int endPacket() override { return 0; }
+    size_t write(uint8_t c) override { (void)c; return 0; }
+    size_t write(const uint8_t* buffer, size_t size) override { (void)buffer; (void)size; return 0; }
+    int parsePacket() override { return 0; }
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int read(unsigned char* buffer, size_t length) override { (void)buffer; (void)length; return 0; }
+    int read(char* buffer, size_t length) override { (void)buffer; (void)length; return 0; }
+    int peek() override { return -1; }
+    void flush() override {}
+    IPAddress remoteIP() override { return IPAddress(); }
+    uint16_t remotePort() override { return 0; }
+    using Print::write;
+};
+
+class WiFiClass {
+public:
+    bool mode(wifi_mode_t m) { currentMode = m; return true; }
+    wifi_mode_t getMode() { return currentMode; }
+    wl_status_t begin(const char* ssid, const char* passphrase = nullptr);
+    bool disconnect(bool wifiOff = false, bool eraseAp = false) { (void)wifiOff; (void)eraseAp; return true; }
+    wl_status_t status();
+    bool softAP(const char* ssid, const char* passphrase = nullptr) { (void)ssid; (void)passphrase; return true; }
+    IPAddress localIP() { return IPAddress(127, 0, 0, 1); }
+    IPAddress softAPIP() { return IPAddress(192, 168, 4, 1); }
+    IPAddress dnsIP(uint8_t index = 0) { (void)index; return IPAddress(0, 0, 0, 0); }
+    uint8_t* macAddress(uint8_t* mac);
+    int hostByName(const char* host, IPAddress& result);
+
+private:
+    wifi_mode_t currentMode = WIFI_OFF;
+};
+
+extern WiFiClass WiFi;
+
+#endif
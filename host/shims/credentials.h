@@ -0,0 +1,8 @@
+#ifndef HOST_CREDENTIALS_H
+#define HOST_CREDENTIALS_H
+
+// main/credentials.cpp supplies the values; on the device this header
+// is the user's copy of credentials_template.h
+#include "credentials_template.h"
+
+#endif
@@ -0,0 +1,10 @@
+#ifndef HOST_ADC_CALI_H
+#define HOST_ADC_CALI_H
+
+#include "esp_err.h"
+
+typedef struct adc_cali_scheme_t* adc_cali_handle_t;
+
+esp_err_t adc_cali_raw_to_voltage(adc_cali_handle_t handle, int raw, int* voltage);
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef HOST_FREERTOS_H
+#define HOST_FREERTOS_H
+
+/**
+ * FreeRTOS on host threads
+ *
+ * Tasks are std::threads, mutexes and queues are built on the standard
+ * library, and a portMUX critical section is a recursive spinlock so
+ * that two tasks genuinely contend for it as the two ESP32 cores do.
+ * Ticks are milliseconds of the host clock (host_control.h).
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef void (*TaskFunction_t)(void*);
+
+struct HostTask;
+struct HostSemaphore;
+struct HostQueue;
+typedef HostTask* TaskHandle_t;
+typedef HostSemaphore* SemaphoreHandle_t;
+typedef HostQueue* QueueHandle_t;
+
+struct portMUX_TYPE {
+    std::atomic<int> owner{0};      // Host thread ID + 1, 0 when free
+    uint32_t count = 0;             // Nesting depth of the owner
+};
+
+#define portMUX_INITIALIZER_UNLOCKED {}
+
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define pdTICKS_TO_MS(ticks) ((uint32_t)(ticks))
+#define portTICK_PERIOD_MS 1
+#define portMAX_DELAY ((TickType_t)0xffffffffUL)
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS pdTRUE
+#define pdFAIL pdFALSE
+#define errQUEUE_FULL 0
+#define portNUM_PROCESSORS 2
+#define tskNO_AFFINITY 0x7FFFFFFF
+#define configMAX_PRIORITIES 25
+
+void vPortEnterCritical(portMUX_TYPE* mux);
+void vPortExitCritical(portMUX_TYPE* mux);
+BaseType_t xPortGetCoreID();
+BaseType_t xPortInIsrContext();
+
+#define portENTER_CRITICAL(mux) vPortEnterCritical(mux)
+#define portEXIT_CRITICAL(mux) vPortExitCritical(mux)
+#define portENTER_CRITICAL_ISR(mux) vPortEnterCritical(mux)
+#define portEXIT_CRITICAL_ISR(mux) vPortExitCritical(mux)
+#define portENTER_CRITICAL_SAFE(mux) vPortEnterCritical(mux)
+#define portEXIT_CRITICAL_SAFE(mux) vPortExitCritical(mux)
+#define portYIELD_FROM_ISR(woken) (void)(woken)
+
+#endif
@@ -0,0 +1,114 @@
+#include "host_control.h"
+#include <malloc.h>
+#include <atomic>
+
+// Counting wrappers around glibc's allocator. They live in the
+// executable, so they replace malloc and friends for every caller,
+// operator new included.
+
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void* ptr);
+}
+
+struct ThreadCounters {
+    uint64_t allocs;
+    uint64_t bytes;
+    uint64_t frees;
+};
+
+static thread_local ThreadCounters counters;
+static std::atomic<size_t> liveBytes{0};
+static std::atomic<size_t> peakBytes{0};
+
+static void noteAlloc(void* ptr, size_t requested) {
+    if (ptr == nullptr) return;
+    counters.allocs++;
+    counters.bytes += requested;
+    size_t live = liveBytes.fetch_add(malloc_usable_size(ptr)) + malloc_usable_size(ptr);
+    size_t peak = peakBytes.load(std::memory_order_relaxed);
+    while (live > peak && !peakBytes.compare_exchange_weak(peak, live)) {
+    }
+}
+
+static void noteFree(void* ptr) {
+    if (ptr == nullptr) return;
+    counters.frees++;
+    liveBytes.fetch_sub(malloc_usable_size(ptr));
+}
+
+extern "C" void* malloc(size_t size) {
+    void* ptr = __libc_malloc(size);
+    noteAlloc(ptr, size);
+    return ptr;
+}
+
+extern "C" void* calloc(size_t count, size_t size) {
+    void* ptr = __libc_calloc(count, size);
+    noteAlloc(ptr, count * size);
+    return ptr;
+}
+
+extern "C" void* realloc(void* ptr, size_t size) {
+    if (ptr == nullptr) return malloc(size);
+    if (size == 0) {
+        free(ptr);
+        return nullptr;
+    }
+    size_t before = malloc_usable_size(ptr);
+    void* grown = __libc_realloc(ptr, size);
+    if (grown == nullptr) return nullptr;
+    counters.allocs++;
+    counters.bytes += size;
+    liveBytes.fetch_sub(before);
+    size_t live = liveBytes.fetch_add(malloc_usable_size(grown)) + malloc_usable_size(grown);
+    size_t peak = peakBytes.load(std::memory_order_relaxed);
+    while (live > peak && !peakBytes.compare_exchange_weak(peak, live)) {
+    }
+    return grown;
+}
+
+extern "C" void* memalign(size_t alignment, size_t size) {
+    void* ptr = __libc_memalign(alignment, size);
+    noteAlloc(ptr, size);
+    return ptr;
+}
+
+extern "C" void* aligned_alloc(size_t alignment, size_t size) {
+    return memalign(alignment, size);
+}
+
+extern "C" int posix_memalign(void** out, size_t alignment, size_t size) {
+    void* ptr = memalign(alignment, size);
+    if (ptr == nullptr) return 12;  // ENOMEM
+    *out = ptr;
+    return 0;
+}
+
+extern "C" void free(void* ptr) {
+    noteFree(ptr);
+    __libc_free(ptr);
+}
+
+namespace host {
+
+AllocCounters allocCounters() {
+    return { counters.allocs, counters.bytes, counters.frees };
+}
+
+size_t heapInUse() {
+    return liveBytes;
+}
+
+size_t heapPeak() {
+    return peakBytes;
+}
+
+void resetHeapPeak() {
+    peakBytes = liveBytes.load();
+}
+
+}
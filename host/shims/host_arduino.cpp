@@ -0,0 +1,554 @@
+#include "Arduino.h"
+#include "SPI.h"
+#include "ESPmDNS.h"
+#include "host_control.h"
+#include <stdarg.h>
+#include <ctype.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <map>
+
+SPIClass SPI;
+MDNSResponder MDNS;
+
+// ---- Clock ---------------------------------------------------------------
+
+static const auto clockEpoch = std::chrono::steady_clock::now();
+static std::atomic<bool> clockManual{false};
+static std::atomic<uint64_t> manualUs{0};
+
+static uint64_t nowUs() {
+    if (clockManual) return manualUs;
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now() - clockEpoch).count();
+}
+
+unsigned long millis() { return (unsigned long)(uint32_t)(nowUs() / 1000); }
+unsigned long micros() { return (unsigned long)(uint32_t)nowUs(); }
+
+void delay(unsigned long ms) { vTaskDelay(pdMS_TO_TICKS(ms)); }
+
+void delayMicroseconds(unsigned int us) {
+    if (clockManual) {
+        manualUs += us;
+    } else {
+        std::this_thread::sleep_for(std::chrono::microseconds(us));
+    }
+}
+
+void yield() { std::this_thread::yield(); }
+
+namespace host {
+
+void useManualClock(uint32_t startMs) {
+    manualUs = (uint64_t)startMs * 1000;
+    clockManual = true;
+}
+
+void useRealClock() { clockManual = false; }
+bool manualClock() { return clockManual; }
+void advanceMs(uint32_t ms) { manualUs += (uint64_t)ms * 1000; }
+void advanceUs(uint64_t us) { manualUs += us; }
+
+}
+
+// ---- GPIO and analog -------------------------------------------------------
+
+static uint16_t analogValues[64];
+static uint8_t pinLevels[64];
+
+void pinMode(uint8_t pin, uint8_t mode) { (void)pin; (void)mode; }
+void digitalWrite(uint8_t pin, uint8_t value) { if (pin < 64) pinLevels[pin] = value; }
+int digitalRead(uint8_t pin) { return pin < 64 ? pinLevels[pin] : LOW; }
+uint16_t analogRead(uint8_t pin) { return pin < 64 ? analogValues[pin] : 0; }
+void analogReadResolution(uint8_t bits) { (void)bits; }
+void analogSetAttenuation(int attenuation) { (void)attenuation; }
+
+bool psramFound() { return true; }
+
+uint32_t esp_random() {
+    // xorshift32; reproducible runs are worth more here than entropy
+    static std::atomic<uint32_t> state{0x9E3779B9u};
+    uint32_t x = state.load();
+    uint32_t next;
+    do {
+        next = x;
+        next ^= next << 13;
+        next ^= next >> 17;
+        next ^= next << 5;
+    } while (!state.compare_exchange_weak(x, next));
+    return next;
+}
+
+namespace host {
+
+void setAnalog(uint8_t pin, uint16_t raw) {
+    if (pin < 64) analogValues[pin] = raw;
+}
+
+}
+
+// ---- String ----------------------------------------------------------------
+
+String::String(const char* cstr) {
+    if (cstr) assign(cstr, strlen(cstr));
+}
+
+String::String(const String& other) { assign(other.buffer(), other.len); }
+
+String::String(String&& other) {
+    if (other.heap) {
+        heap = other.heap;
+        capacity = other.capacity;
+        len = other.len;
+        other.heap = nullptr;
+        other.capacity = SSO_CAPACITY;
+        other.len = 0;
+        other.inlineBuffer[0] = '\0';
+    } else {
+        assign(other.inlineBuffer, other.len);
+    }
+}
+
+String::String(char c) { assign(&c, 1); }
+
+static void formatInteger(String& s, unsigned long long magnitude, bool negative, unsigned char base) {
+    char digits[70];
+    char* p = digits + sizeof(digits) - 1;
+    *p = '\0';
+    if (base < 2) base = 10;
+    do {
+        unsigned d = magnitude % base;
+        *--p = (char)(d < 10 ? '0' + d : 'a' + d - 10);
+        magnitude /= base;
+    } while (magnitude);
+    if (negative) *--p = '-';
+    s = p;
+}
+
+String::String(int value, unsigned char base) : String((long long)value, base) {}
+String::String(unsigned int value, unsigned char base) : String((unsigned long long)value, base) {}
+String::String(long value, unsigned char base) : String((long long)value, base) {}
+String::String(unsigned long value, unsigned char base) : String((unsigned long long)value, base) {}
+
+String::String(long long value, unsigned char base) {
+    bool negative = value < 0 && base == 10;
+    unsigned long long magnitude = negative ? 0ULL - (unsigned long long)value : (unsigned long long)value;
+    formatInteger(*this, magnitude, negative, base);
+}
+
+String::String(unsigned long long value, unsigned char base) {
+    formatInteger(*this, value, false, base);
+}
+
+String::String(float value, unsigned int decimals) : String((double)value, decimals) {}
+
+String::String(double value, unsigned int decimals) {
+    // dtostrf(), as the core uses
+    char text[64];
+    snprintf(text, sizeof(text), "%.*f", (int)decimals, value);
+    assign(text, strlen(text));
+}
+
+String::~String() { release(); }
+
+String& String::operator=(const String& other) {
+    if (this != &other) assign(other.buffer(), other.len);
+    return *this;
+}
+
+String& String::operator=(String&& other) {
+    if (this == &other) return *this;
+    if (other.heap) {
+        release();
+        heap = other.heap;
+        capacity = other.capacity;
+        len = other.len;
+        other.heap = nullptr;
+        other.capacity = SSO_CAPACITY;
+        other.len = 0;
+        other.inlineBuffer[0] = '\0';
+    } else {
+        assign(other.inlineBuffer, other.len);
+    }
+    return *this;
+}
+
+String& String::operator=(const char* cstr) {
+    if (cstr) {
+        assign(cstr, strlen(cstr));
+    } else {
+        len = 0;
+        buffer()[0] = '\0';
+    }
+    return *this;
+}
+
+void String::release() {
+    free(heap);
+    heap = nullptr;
+    capacity = SSO_CAPACITY;
+    len = 0;
+    inlineBuffer[0] = '\0';
+}
+
+bool String::reserve(unsigned int size) {
+    if (size <= capacity) return true;
+
+    // Exact growth, as String::changeBuffer() does on the device
+    char* grown = (char*)realloc(heap, size + 1);
+    if (grown == nullptr) return false;
+    if (heap == nullptr) memcpy(grown, inlineBuffer, len + 1);
+    heap = grown;
+    capacity = size;
+    return true;
+}
+
+void String::assign(const char* cstr, unsigned int length) {
+    if (!reserve(length)) {
+        release();
+        return;
+    }
+    memmove(buffer(), cstr, length);
+    len = length;
+    buffer()[len] = '\0';
+}
+
+bool String::concat(const char* cstr, unsigned int length) {
+    if (cstr == nullptr) return false;
+    if (length == 0) return true;
+    unsigned int total = len + length;
+
+    // cstr may point into our own buffer, which reserve() can move
+    if (cstr >= buffer() && cstr < buffer() + len) {
+        size_t offset = cstr - buffer();
+        if (!reserve(total)) return false;
+        memmove(buffer() + len, buffer() + offset, length);
+    } else {
+        if (!reserve(total)) return false;
+        memcpy(buffer() + len, cstr, length);
+    }
+    len = total;
+    buffer()[len] = '\0';
+    return true;
+}
+
+bool String::concat(const char* cstr) {
+    return cstr ? concat(cstr, strlen(cstr)) : false;
+}
+
+bool String::operator==(const String& other) const {
+    return len == other.len && memcmp(buffer(), other.buffer(), len) == 0;
+}
+
+bool String::operator==(const char* cstr) const {
+    if (cstr == nullptr) return len == 0;
+    return strcmp(buffer(), cstr) == 0;
+}
+
+bool String::equalsIgnoreCase(const String& other) const {
+    return len == other.len && strncasecmp(buffer(), other.buffer(), len) == 0;
+}
+
+bool String::startsWith(const String& prefix) const {
+    return prefix.len <= len && memcmp(buffer(), prefix.buffer(), prefix.len) == 0;
+}
+
+bool String::endsWith(const String& suffix) const {
+    return suffix.len <= len && memcmp(buffer() + len - suffix.len, suffix.buffer(), suffix.len) == 0;
+}
+
+int String::indexOf(char c, unsigned int from) const {
+    if (from >= len) return -1;
+    const char* found = (const char*)memchr(buffer() + from, c, len - from);
+    return found ? (int)(found - buffer()) : -1;
+}
+
+int String::indexOf(const char* needle, unsigned int from) const {
+    if (needle == nullptr || from > len) return -1;
+    const char* found = strstr(buffer() + from, needle);
+    return found ? (int)(found - buffer()) : -1;
+}
+
+String String::substring(unsigned int from, unsigned int to) const {
+    if (from > to) std::swap(from, to);
+    if (from >= len) return String();
+    if (to > len) to = len;
+    String out;
+    out.assign(buffer() + from, to - from);
+    return out;
+}
+
+long String::toInt() const { return atol(buffer()); }
+float String::toFloat() const { return (float)atof(buffer()); }
+
+void String::trim() {
+    char* b = buffer();
+    unsigned int start = 0;
+    while (start < len && isspace((unsigned char)b[start])) start++;
+    unsigned int end = len;
+    while (end > start && isspace((unsigned char)b[end - 1])) end--;
+    memmove(b, b + start, end - start);
+    len = end - start;
+    b[len] = '\0';
+}
+
+void String::toLowerCase() {
+    for (unsigned int i = 0; i < len; i++) buffer()[i] = (char)tolower((unsigned char)buffer()[i]);
+}
+
+void String::toUpperCase() {
+    for (unsigned int i = 0; i < len; i++) buffer()[i] = (char)toupper((unsigned char)buffer()[i]);
+}
+
+String operator+(const String& lhs, const String& rhs) {
+    String out(lhs);
+    out.concat(rhs);
+    return out;
+}
+
+String operator+(const String& lhs, const char* rhs) {
+    String out(lhs);
+    out.concat(rhs);
+    return out;
+}
+
+String operator+(const char* lhs, const String& rhs) {
+    // StringSumHelper: the literal is copied into a String first
+    String out(lhs);
+    out.concat(rhs);
+    return out;
+}
+
+String operator+(const String& lhs, char rhs) {
+    String out(lhs);
+    out.concat(rhs);
+    return out;
+}
+
+// ---- Print and Stream ------------------------------------------------------
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+    size_t n = 0;
+    while (size--) {
+        if (write(*buffer++) == 0) break;
+        n++;
+    }
+    return n;
+}
+
+size_t Print::printf(const char* format, ...) {
+    char local[256];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(local, sizeof(local), format, args);
+    va_end(args);
+    if (length < 0) return 0;
+    if ((size_t)length < sizeof(local)) return write((const uint8_t*)local, length);
+
+    char* big = (char*)malloc(length + 1);
+    if (big == nullptr) return 0;
+    va_start(args, format);
+    vsnprintf(big, length + 1, format, args);
+    va_end(args);
+    size_t n = write((const uint8_t*)big, length);
+    free(big);
+    return n;
+}
+
+size_t Print::print(long value, int base) {
+    if (base == 10) {
+        char text[24];
+        snprintf(text, sizeof(text), "%ld", value);
+        return write(text);
+    }
+    return print((unsigned long)value, base);
+}
+
+size_t Print::print(unsigned long value, int base) {
+    return print((unsigned long long)value, base);
+}
+
+size_t Print::print(long long value, int base) {
+    if (base == 10) {
+        char text[24];
+        snprintf(text, sizeof(text), "%lld", value);
+        return write(text);
+    }
+    return print((unsigned long long)value, base);
+}
+
+size_t Print::print(unsigned long long value, int base) {
+    char digits[70];
+    char* p = digits + sizeof(digits) - 1;
+    *p = '\0';
+    if (base < 2) base = 10;
+    do {
+        unsigned d = value % base;
+        *--p = (char)(d < 10 ? '0' + d : 'A' + d - 10);
+        value /= base;
+    } while (value);
+    return write(p);
+}
+
+size_t Print::print(double value, int digits) {
+    if (isnan(value)) return write("nan");
+    if (isinf(value)) return write(value > 0 ? "inf" : "-inf");
+    char text[64];
+    snprintf(text, sizeof(text), "%.*f", digits, value);
+    return write(text);
+}
+
+int Stream::timedRead() {
+    unsigned long start = millis();
+    do {
+        int c = read();
+        if (c >= 0) return c;
+        yield();
+    } while (!host::manualClock() && millis() - start < timeout);
+    return -1;
+}
+
+size_t Stream::readBytes(uint8_t* buffer, size_t length) {
+    size_t count = 0;
+    while (count < length) {
+        int c = timedRead();
+        if (c < 0) break;
+        buffer[count++] = (uint8_t)c;
+    }
+    return count;
+}
+
+String Stream::readStringUntil(char terminator) {
+    String out;
+    int c = timedRead();
+    while (c >= 0 && c != terminator) {
+        out += (char)c;
+        c = timedRead();
+    }
+    return out;
+}
+
+// ---- IPAddress -------------------------------------------------------------
+
+IPAddress::IPAddress(uint32_t address) {
+    memcpy(bytes, &address, 4);
+}
+
+IPAddress::operator uint32_t() const {
+    uint32_t address;
+    memcpy(&address, bytes, 4);
+    return address;
+}
+
+bool IPAddress::fromString(const char* address) {
+    unsigned parts[4];
+    char tail;
+    if (address == nullptr ||
+        sscanf(address, "%u.%u.%u.%u%c", &parts[0], &parts[1], &parts[2], &parts[3], &tail) != 4) {
+        return false;
+    }
+    for (int i = 0; i < 4; i++) {
+        if (parts[i] > 255) return false;
+    }
+    for (int i = 0; i < 4; i++) bytes[i] = (uint8_t)parts[i];
+    return true;
+}
+
+String IPAddress::toString() const {
+    char text[16];
+    snprintf(text, sizeof(text), "%u.%u.%u.%u", bytes[0], bytes[1], bytes[2], bytes[3]);
+    return String(text);
+}
+
+size_t IPAddress::printTo(Print& p) const {
+    char text[16];
+    snprintf(text, sizeof(text), "%u.%u.%u.%u", bytes[0], bytes[1], bytes[2], bytes[3]);
+    return p.write(text);
+}
+
+// ---- HardwareSerial --------------------------------------------------------
+
+static std::mutex uartRegistryLock;
+static std::map<int, HardwareSerial*> uartRegistry;
+static std::atomic<bool> serialEcho{getenv("HOST_SERIAL") != nullptr};
+
+HardwareSerial Serial(0);
+
+HardwareSerial::HardwareSerial(int uartNum) : uartNum(uartNum) {
+    std::lock_guard<std::mutex> guard(uartRegistryLock);
+    uartRegistry[uartNum] = this;
+}
+
+HardwareSerial::~HardwareSerial() {
+    std::lock_guard<std::mutex> guard(uartRegistryLock);
+    auto it = uartRegistry.find(uartNum);
+    if (it != uartRegistry.end() && it->second == this) uartRegistry.erase(it);
+}
+
+void HardwareSerial::begin(unsigned long baud, uint32_t config, int8_t rxPin, int8_t txPin) {
+    (void)baud; (void)config; (void)rxPin; (void)txPin;
+}
+
+void HardwareSerial::onReceive(OnReceiveCb function, bool onlyOnTimeout) {
+    (void)onlyOnTimeout;
+    onReceiveCb = function;
+}
+
+int HardwareSerial::available() {
+    std::lock_guard<std::mutex> guard(lock);
+    return (int)rx.size();
+}
+
+int HardwareSerial::read() {
+    std::lock_guard<std::mutex> guard(lock);
+    if (rx.empty()) return -1;
+    uint8_t c = rx.front();
+    rx.pop_front();
+    return c;
+}
+
+int HardwareSerial::peek() {
+    std::lock_guard<std::mutex> guard(lock);
+    return rx.empty() ? -1 : rx.front();
+}
+
+size_t HardwareSerial::write(uint8_t c) { return write(&c, 1); }
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+    if (uartNum == 0) {
+        if (serialEcho) fwrite(buffer, 1, size, stdout);
+        return size;
+    }
+    std::lock_guard<std::mutex> guard(lock);
+    tx.append((const char*)buffer, size);
+    return size;
+}
+
+void HardwareSerial::feed(const uint8_t* bytes, size_t length) {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        rx.insert(rx.end(), bytes, bytes + length);
+    }
+    if (onReceiveCb) onReceiveCb();
+}
+
+std::string HardwareSerial::takeTransmitted() {
+    std::lock_guard<std::mutex> guard(lock);
+    std::string out;
+    out.swap(tx);
+    return out;
+}
+
+namespace host {
+
+void setSerialEcho(bool echo) { serialEcho = echo; }
+
+HardwareSerial* uart(int number) {
+    std::lock_guard<std::mutex> guard(uartRegistryLock);
+    auto it = uartRegistry.find(number);
+    return it == uartRegistry.end() ? nullptr : it->second;
+}
+
+}
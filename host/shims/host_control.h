@@ -0,0 +1,111 @@
+#ifndef HOST_CONTROL_H
+#define HOST_CONTROL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <functional>
+#include <string>
+#include "IPAddress.h"
+
+class HardwareSerial;
+
+/**
+ * Test and benchmark side of the host shims
+ *
+ * The firmware only sees the Arduino, FreeRTOS and ESP-IDF APIs; this
+ * header is how host programs drive what sits behind them.
+ */
+namespace host {
+
+// ---- Clock ---------------------------------------------------------------
+
+/**
+ * Freeze millis()/micros() at startMs. From then on time only moves
+ * through advanceMs()/advanceUs() and vTaskDelay(), which then returns
+ * at once with the clock moved on by the delay.
+ */
+void useManualClock(uint32_t startMs = 1000);
+void useRealClock();
+bool manualClock();
+void advanceMs(uint32_t ms);
+void advanceUs(uint64_t us);
+
+// ---- Console, UARTs, analog inputs ---------------------------------------
+
+void setSerialEcho(bool echo);              // Off by default; HOST_SERIAL=1 turns it on
+HardwareSerial* uart(int number);           // Last port constructed for that UART
+void setAnalog(uint8_t pin, uint16_t raw);  // What analogRead(pin) returns
+
+// ---- Heap ------------------------------------------------------------------
+
+/**
+ * malloc/calloc/realloc/free (and so new/delete) are counted per
+ * thread. bytes is what was asked for; a realloc counts as one
+ * allocation of its new size.
+ */
+struct AllocCounters {
+    uint64_t allocs;
+    uint64_t bytes;
+    uint64_t frees;
+};
+
+AllocCounters allocCounters();
+size_t heapInUse();             // Live bytes over all threads
+size_t heapPeak();              // Highest heapInUse() since resetHeapPeak()
+void resetHeapPeak();
+
+// ---- Flash -----------------------------------------------------------------
+
+void flashReset();              // Every partition back to erased (0xFF)
+uint32_t flashEraseCount();     // Sectors erased since start
+
+// ---- Sockets ---------------------------------------------------------------
+
+enum Link : uint8_t { ETHERNET, WIFI };
+
+/**
+ * Simulated sockets. The firmware side is an EthernetClient or
+ * WiFiClient; the test plays the peer through the socket ID.
+ */
+
+// A peer connects to the firmware's server on this link; the accept()
+// that takes it sees `request` already received. Returns the socket ID.
+int peerConnect(Link link, const std::string& request = "");
+
+// The firmware connects out: return false to refuse the connection,
+// otherwise set up the socket (e.g. with setPollHandler()). Cleared
+// with a null handler.
+void setConnectHandler(std::function<bool(int socket, IPAddress ip, uint16_t port)> handler);
+
+// Run on every firmware available()/read()/connected() of the socket,
+// i.e. the peer's chance to answer what it has been sent
+void setPollHandler(int socket, std::function<void(int socket)> handler);
+
+void peerSend(int socket, const std::string& bytes);
+void peerClose(int socket);                 // FIN after what was sent is read
+void peerReset(int socket);                 // RST: pending bytes are lost
+std::string peerReceived(int socket);       // Everything the firmware wrote
+std::string peerTake(int socket);           // ... and forget it
+bool firmwareClosed(int socket);            // The firmware called stop()
+
+// Bytes the firmware may write before the peer reads (W5500 TX buffer
+// or lwIP send buffer); peerRead() frees them again
+void setSendWindow(int socket, size_t bytes);
+void peerRead(int socket, size_t bytes);
+size_t blockedWrites(int socket);           // Writes larger than the window
+
+// W5500 hardware sockets in use, and failed DHCP renewals for want of one
+uint8_t ethernetSocketsInUse();
+uint32_t dhcpRenewFailures();
+void setDnsAnswer(IPAddress address);       // Answer to every EthernetUDP DNS query
+
+/**
+ * Serve the Ethernet server from a real TCP port on 127.0.0.1 as well,
+ * so that tools/web_bench.py can be pointed at a host build. Sockets
+ * from it count against MAX_SOCK_NUM like simulated ones.
+ */
+bool listenTcp(uint16_t port);
+
+}
+
+#endif
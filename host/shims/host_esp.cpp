@@ -0,0 +1,361 @@
+#include "esp_err.h"
+#include "esp_heap_caps.h"
+#include "esp_partition.h"
+#include "esp_rom_crc.h"
+#include "esp_adc/adc_continuous.h"
+#include "esp_adc/adc_cali_scheme.h"
+#include "mbedtls/base64.h"
+#include "mbedtls/sha1.h"
+#include "host_control.h"
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+const char* esp_err_to_name(esp_err_t code) {
+    switch (code) {
+        case ESP_OK: return "ESP_OK";
+        case ESP_FAIL: return "ESP_FAIL";
+        case ESP_ERR_NO_MEM: return "ESP_ERR_NO_MEM";
+        case ESP_ERR_INVALID_ARG: return "ESP_ERR_INVALID_ARG";
+        case ESP_ERR_INVALID_STATE: return "ESP_ERR_INVALID_STATE";
+        case ESP_ERR_INVALID_SIZE: return "ESP_ERR_INVALID_SIZE";
+        case ESP_ERR_NOT_FOUND: return "ESP_ERR_NOT_FOUND";
+        case ESP_ERR_NOT_SUPPORTED: return "ESP_ERR_NOT_SUPPORTED";
+        case ESP_ERR_TIMEOUT: return "ESP_ERR_TIMEOUT";
+        default: return "UNKNOWN ERROR";
+    }
+}
+
+// ---- Heap ------------------------------------------------------------------
+
+// Internal RAM plus 8 MB of PSRAM, as on the ESP32-S3 module
+static const size_t SIMULATED_HEAP_BYTES = 320 * 1024 + 8 * 1024 * 1024;
+
+void* heap_caps_malloc(size_t size, uint32_t caps) {
+    (void)caps;
+    return malloc(size);
+}
+
+void* heap_caps_calloc(size_t count, size_t size, uint32_t caps) {
+    (void)caps;
+    return calloc(count, size);
+}
+
+void heap_caps_free(void* ptr) {
+    free(ptr);
+}
+
+size_t heap_caps_get_free_size(uint32_t caps) {
+    (void)caps;
+    size_t used = host::heapInUse();
+    return used < SIMULATED_HEAP_BYTES ? SIMULATED_HEAP_BYTES - used : 0;
+}
+
+size_t heap_caps_get_largest_free_block(uint32_t caps) {
+    return heap_caps_get_free_size(caps);
+}
+
+size_t heap_caps_get_minimum_free_size(uint32_t caps) {
+    (void)caps;
+    size_t peak = host::heapPeak();
+    return peak < SIMULATED_HEAP_BYTES ? SIMULATED_HEAP_BYTES - peak : 0;
+}
+
+// ---- Flash partitions ------------------------------------------------------
+
+struct HostPartition {
+    esp_partition_t info;
+    std::vector<uint8_t> data;
+};
+
+// The data partitions of main/partitions.csv that the firmware opens
+static HostPartition partitions[] = {
+    { { ESP_PARTITION_TYPE_DATA, (esp_partition_subtype_t)0x40, 0x370000, 0x80000, 4096, "buflog", false }, {} },
+};
+
+static std::mutex flashLock;
+static std::atomic<uint32_t> sectorsErased{0};
+
+static HostPartition* lookup(const esp_partition_t* partition) {
+    for (HostPartition& p : partitions) {
+        if (&p.info == partition) return &p;
+    }
+    return nullptr;
+}
+
+static void ensureErased(HostPartition& p) {
+    if (p.data.size() != p.info.size) p.data.assign(p.info.size, 0xFF);
+}
+
+const esp_partition_t* esp_partition_find_first(esp_partition_type_t type,
+                                                esp_partition_subtype_t subtype, const char* label) {
+    std::lock_guard<std::mutex> guard(flashLock);
+    for (HostPartition& p : partitions) {
+        if (type != ESP_PARTITION_TYPE_ANY && p.info.type != type) continue;
+        if (subtype != ESP_PARTITION_SUBTYPE_ANY && p.info.subtype != subtype) continue;
+        if (label != nullptr && strcmp(label, p.info.label) != 0) continue;
+        ensureErased(p);
+        return &p.info;
+    }
+    return nullptr;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t* partition, size_t offset, void* dst, size_t size) {
+    HostPartition* p = lookup(partition);
+    if (p == nullptr || offset + size > p->info.size) return ESP_ERR_INVALID_ARG;
+    std::lock_guard<std::mutex> guard(flashLock);
+    memcpy(dst, &p->data[offset], size);
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_write(const esp_partition_t* partition, size_t offset, const void* src, size_t size) {
+    HostPartition* p = lookup(partition);
+    if (p == nullptr || offset + size > p->info.size) return ESP_ERR_INVALID_ARG;
+    std::lock_guard<std::mutex> guard(flashLock);
+    const uint8_t* bytes = (const uint8_t*)src;
+    for (size_t i = 0; i < size; i++) {
+        p->data[offset + i] &= bytes[i];
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t* partition, size_t offset, size_t size) {
+    HostPartition* p = lookup(partition);
+    if (p == nullptr || offset + size > p->info.size) return ESP_ERR_INVALID_ARG;
+    if (offset % p->info.erase_size != 0 || size % p->info.erase_size != 0) return ESP_ERR_INVALID_SIZE;
+    std::lock_guard<std::mutex> guard(flashLock);
+    memset(&p->data[offset], 0xFF, size);
+    sectorsErased += size / p->info.erase_size;
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_mmap(const esp_partition_t* partition, size_t offset, size_t size,
+                             esp_partition_mmap_memory_t memory, const void** outPtr,
+                             esp_partition_mmap_handle_t* outHandle) {
+    (void)memory;
+    HostPartition* p = lookup(partition);
+    if (p == nullptr || offset + size > p->info.size) return ESP_ERR_INVALID_ARG;
+    *outPtr = &p->data[offset];
+    if (outHandle) *outHandle = 1;
+    return ESP_OK;
+}
+
+void esp_partition_munmap(esp_partition_mmap_handle_t handle) {
+    (void)handle;
+}
+
+namespace host {
+
+void flashReset() {
+    std::lock_guard<std::mutex> guard(flashLock);
+    for (HostPartition& p : partitions) {
+        p.data.assign(p.info.size, 0xFF);
+    }
+}
+
+uint32_t flashEraseCount() {
+    return sectorsErased;
+}
+
+}
+
+uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t* buffer, uint32_t length) {
+    crc = ~crc;
+    while (length--) {
+        crc ^= *buffer++;
+        for (int k = 0; k < 8; k++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+        }
+    }
+    return ~crc;
+}
+
+// ---- ADC -------------------------------------------------------------------
+
+esp_err_t adc_continuous_new_handle(const adc_continuous_handle_cfg_t* config, adc_continuous_handle_t* handle) {
+    (void)config;
+    *handle = nullptr;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t adc_continuous_config(adc_continuous_handle_t handle, const adc_continuous_config_t* config) {
+    (void)handle; (void)config;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t adc_continuous_register_event_callbacks(adc_continuous_handle_t handle,
+                                                  const adc_continuous_evt_cbs_t* callbacks, void* userData) {
+    (void)handle; (void)callbacks; (void)userData;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t adc_continuous_start(adc_continuous_handle_t handle) {
+    (void)handle;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t adc_continuous_stop(adc_continuous_handle_t handle) {
+    (void)handle;
+    return ESP_OK;
+}
+
+esp_err_t adc_continuous_read(adc_continuous_handle_t handle, uint8_t* buffer, uint32_t length,
+                              uint32_t* outLength, uint32_t timeoutMs) {
+    (void)handle; (void)buffer; (void)length; (void)timeoutMs;
+    *outLength = 0;
+    return ESP_ERR_TIMEOUT;
+}
+
+esp_err_t adc_continuous_deinit(adc_continuous_handle_t handle) {
+    (void)handle;
+    return ESP_OK;
+}
+
+esp_err_t adc_continuous_io_to_channel(int ioNum, adc_unit_t* unit, adc_channel_t* channel) {
+    // ESP32-S3: GPIO 1-10 are ADC1 channels 0-9
+    if (ioNum < 1 || ioNum > 10) return ESP_ERR_INVALID_ARG;
+    *unit = ADC_UNIT_1;
+    *channel = (adc_channel_t)(ioNum - 1);
+    return ESP_OK;
+}
+
+esp_err_t adc_cali_create_scheme_curve_fitting(const adc_cali_curve_fitting_config_t* config,
+                                               adc_cali_handle_t* handle) {
+    (void)config;
+    *handle = nullptr;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t adc_cali_raw_to_voltage(adc_cali_handle_t handle, int raw, int* voltage) {
+    (void)handle;
+    // Linear 0-3.3 V over 12 bits in place of the eFuse curve
+    *voltage = raw * 3300 / 4095;
+    return ESP_OK;
+}
+
+// ---- mbedtls ---------------------------------------------------------------
+
+static const char BASE64_ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+int mbedtls_base64_encode(unsigned char* dst, size_t dlen, size_t* olen, const unsigned char* src, size_t slen) {
+    size_t needed = 4 * ((slen + 2) / 3) + 1;
+    if (dst == nullptr || dlen < needed) {
+        *olen = needed;
+        return MBEDTLS_ERR_BASE64_BUFFER_TOO_SMALL;
+    }
+
+    size_t out = 0;
+    for (size_t i = 0; i < slen; i += 3) {
+        uint32_t chunk = (uint32_t)src[i] << 16;
+        if (i + 1 < slen) chunk |= (uint32_t)src[i + 1] << 8;
+        if (i + 2 < slen) chunk |= src[i + 2];
+        dst[out++] = BASE64_ALPHABET[(chunk >> 18) & 0x3F];
+        dst[out++] = BASE64_ALPHABET[(chunk >> 12) & 0x3F];
+        dst[out++] = (i + 1 < slen) ? BASE64_ALPHABET[(chunk >> 6) & 0x3F] : '=';
+        dst[out++] = (i + 2 < slen) ? BASE64_ALPHABET[chunk & 0x3F] : '=';
+    }
+    dst[out] = '\0';
+    *olen = out;
+    return 0;
+}
+
+static int base64Value(unsigned char c) {
+    if (c >= 'A' && c <= 'Z') return c - 'A';
+    if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+    if (c >= '0' && c <= '9') return c - '0' + 52;
+    if (c == '+') return 62;
+    if (c == '/') return 63;
+    return -1;
+}
+
+int mbedtls_base64_decode(unsigned char* dst, size_t dlen, size_t* olen, const unsigned char* src, size_t slen) {
+    size_t symbols = 0;
+    size_t padding = 0;
+    for (size_t i = 0; i < slen; i++) {
+        if (src[i] == '=') {
+            if (++padding > 2) return MBEDTLS_ERR_BASE64_INVALID_CHARACTER;
+            continue;
+        }
+        if (padding > 0 || base64Value(src[i]) < 0) return MBEDTLS_ERR_BASE64_INVALID_CHARACTER;
+        symbols++;
+    }
+    if ((symbols + padding) % 4 != 0) return MBEDTLS_ERR_BASE64_INVALID_CHARACTER;
+
+    size_t needed = symbols * 6 / 8;
+    if (dst == nullptr || dlen < needed) {
+        *olen = needed;
+        return MBEDTLS_ERR_BASE64_BUFFER_TOO_SMALL;
+    }
+
+    uint32_t bits = 0;
+    int count = 0;
+    size_t out = 0;
+    for (size_t i = 0; i < slen && src[i] != '='; i++) {
+        bits = (bits << 6) | (uint32_t)base64Value(src[i]);
+        if (++count == 4) {
+            dst[out++] = (bits >> 16) & 0xFF;
+            dst[out++] = (bits >> 8) & 0xFF;
+            dst[out++] = bits & 0xFF;
+            bits = 0;
+            count = 0;
+        }
+    }
+    if (count == 3) {
+        dst[out++] = (bits >> 10) & 0xFF;
+        dst[out++] = (bits >> 2) & 0xFF;
+    } else if (count == 2) {
+        dst[out++] = (bits >> 4) & 0xFF;
+    }
+    *olen = out;
+    return 0;
+}
+
+static uint32_t rotl(uint32_t x, int n) {
+    return (x << n) | (x >> (32 - n));
+}
+
+int mbedtls_sha1(const unsigned char* input, size_t ilen, unsigned char output[20]) {
+    uint32_t h[5] = { 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0 };
+    uint64_t bitLength = (uint64_t)ilen * 8;
+    size_t total = ((ilen + 8) / 64 + 1) * 64;
+
+    for (size_t block = 0; block < total; block += 64) {
+        uint8_t chunk[64];
+        for (size_t i = 0; i < 64; i++) {
+            size_t at = block + i;
+            if (at < ilen) chunk[i] = input[at];
+            else if (at == ilen) chunk[i] = 0x80;
+            else if (at >= total - 8) chunk[i] = (uint8_t)(bitLength >> (8 * (total - 1 - at)));
+            else chunk[i] = 0;
+        }
+
+        uint32_t w[80];
+        for (int i = 0; i < 16; i++) {
+            w[i] = (uint32_t)chunk[4 * i] << 24 | (uint32_t)chunk[4 * i + 1] << 16 |
+                   (uint32_t)chunk[4 * i + 2] << 8 | chunk[4 * i + 3];
+        }
+        for (int i = 16; i < 80; i++) w[i] = rotl(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+        for (int i = 0; i < 80; i++) {
+            uint32_t f, k;
+            if (i < 20) { f = (b & c) | (~b & d); k = 0x5A827999; }
+            else if (i < 40) { f = b ^ c ^ d; k = 0x6ED9EBA1; }
+            else if (i < 60) { f = (b & c) | (b & d) | (c & d); k = 0x8F1BBCDC; }
+            else { f = b ^ c ^ d; k = 0xCA62C1D6; }
+            uint32_t t = rotl(a, 5) + f + e + k + w[i];
+            e = d; d = c; c = rotl(b, 30); b = a; a = t;
+        }
+        h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e;
+    }
+
+    for (int i = 0; i < 5; i++) {
+        output[4 * i] = h[i] >> 24;
+        output[4 * i + 1] = h[i] >> 16;
+        output[4 * i + 2] = h[i] >> 8;
+        output[4 * i + 3] = h[i];
+    }
+    return 0;
+}
@@ -0,0 +1,301 @@
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "freertos/queue.h"
+#include "Arduino.h"
+#include "host_control.h"
+#include <pthread.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct HostTask {
+    std::mutex lock;
+    std::condition_variable wake;
+    uint32_t notifications = 0;
+    TaskFunction_t code = nullptr;
+    void* parameters = nullptr;
+    BaseType_t core = 0;
+};
+
+struct HostSemaphore {
+    std::timed_mutex mutex;
+};
+
+struct HostQueue {
+    std::mutex lock;
+    std::condition_variable changed;
+    std::vector<uint8_t> storage;   // length * itemSize, allocated once as on the device
+    UBaseType_t length;
+    UBaseType_t itemSize;
+    UBaseType_t head = 0;
+    UBaseType_t count = 0;
+};
+
+static std::atomic<int> nextThreadId{1};
+static thread_local int threadId = 0;
+static thread_local HostTask* currentTask = nullptr;
+
+static int hostThreadId() {
+    if (threadId == 0) threadId = nextThreadId++;
+    return threadId;
+}
+
+static std::chrono::milliseconds ticksToDuration(TickType_t ticks) {
+    return std::chrono::milliseconds(ticks);
+}
+
+// ---- Critical sections -----------------------------------------------------
+
+void vPortEnterCritical(portMUX_TYPE* mux) {
+    int self = hostThreadId();
+    if (mux->owner.load(std::memory_order_relaxed) == self) {
+        mux->count++;
+        return;
+    }
+
+    int spins = 0;
+    int expected = 0;
+    while (!mux->owner.compare_exchange_weak(expected, self, std::memory_order_acquire)) {
+        expected = 0;
+        // A host thread can be preempted inside the section, which an
+        // ESP32 core cannot; give the owner a chance to run
+        if (++spins > 64) std::this_thread::yield();
+    }
+    mux->count = 1;
+}
+
+void vPortExitCritical(portMUX_TYPE* mux) {
+    if (--mux->count == 0) {
+        mux->owner.store(0, std::memory_order_release);
+    }
+}
+
+BaseType_t xPortGetCoreID() {
+    return currentTask ? currentTask->core : 0;
+}
+
+BaseType_t xPortInIsrContext() {
+    return pdFALSE;
+}
+
+// ---- Tasks -----------------------------------------------------------------
+
+static HostTask* taskSelf() {
+    if (currentTask == nullptr) {
+        // The main thread and foreign threads get a handle on first use
+        currentTask = new HostTask();
+    }
+    return currentTask;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t code, const char* name, uint32_t stackDepth,
+                                   void* parameters, UBaseType_t priority,
+                                   TaskHandle_t* created, BaseType_t coreId) {
+    (void)name; (void)stackDepth; (void)priority;
+    HostTask* task = new HostTask();
+    task->code = code;
+    task->parameters = parameters;
+    task->core = (coreId == tskNO_AFFINITY) ? 0 : coreId;
+    if (created) *created = task;
+
+    std::thread([task]() {
+        currentTask = task;
+        task->code(task->parameters);
+    }).detach();
+    return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t task) {
+    if (task == nullptr || task == currentTask) {
+        // Only a task deleting itself is supported; the handle stays
+        // valid so pending notifications do not touch freed memory
+        pthread_exit(nullptr);
+    }
+}
+
+void vTaskDelay(TickType_t ticks) {
+    if (host::manualClock()) {
+        host::advanceMs(ticks);
+        std::this_thread::yield();
+        return;
+    }
+    if (ticks == 0) {
+        std::this_thread::yield();
+        return;
+    }
+    std::this_thread::sleep_for(ticksToDuration(ticks));
+}
+
+TickType_t xTaskGetTickCount() {
+    return (TickType_t)millis();
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle() {
+    return taskSelf();
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task) {
+    (void)task;
+    return 0;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticksToWait) {
+    HostTask* self = taskSelf();
+    std::unique_lock<std::mutex> guard(self->lock);
+
+    if (self->notifications == 0 && ticksToWait > 0) {
+        if (host::manualClock()) {
+            // Nobody else moves a manual clock; wait in real time but
+            // charge the whole timeout if nothing arrives
+            bool woken = self->wake.wait_for(guard, std::chrono::milliseconds(ticksToWait == portMAX_DELAY ? 1000 : 10),
+                                             [self]() { return self->notifications > 0; });
+            if (!woken) host::advanceMs(ticksToWait == portMAX_DELAY ? 1000 : ticksToWait);
+        } else if (ticksToWait == portMAX_DELAY) {
+            self->wake.wait(guard, [self]() { return self->notifications > 0; });
+        } else {
+            self->wake.wait_for(guard, ticksToDuration(ticksToWait), [self]() { return self->notifications > 0; });
+        }
+    }
+
+    uint32_t value = self->notifications;
+    if (value > 0) self->notifications = clearOnExit ? 0 : value - 1;
+    return value;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+    if (task == nullptr) return pdFAIL;
+    {
+        std::lock_guard<std::mutex> guard(task->lock);
+        task->notifications++;
+    }
+    task->wake.notify_all();
+    return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* higherPriorityTaskWoken) {
+    xTaskNotifyGive(task);
+    if (higherPriorityTaskWoken) *higherPriorityTaskWoken = pdFALSE;
+}
+
+// ---- Semaphores ------------------------------------------------------------
+
+SemaphoreHandle_t xSemaphoreCreateMutex() {
+    return new HostSemaphore();
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticksToWait) {
+    if (semaphore == nullptr) return pdFALSE;
+    if (ticksToWait == portMAX_DELAY) {
+        semaphore->mutex.lock();
+        return pdTRUE;
+    }
+    if (semaphore->mutex.try_lock()) return pdTRUE;
+    if (ticksToWait == 0) return pdFALSE;
+    return semaphore->mutex.try_lock_for(ticksToDuration(ticksToWait)) ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore) {
+    if (semaphore == nullptr) return pdFALSE;
+    semaphore->mutex.unlock();
+    return pdTRUE;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t semaphore) {
+    delete semaphore;
+}
+
+// ---- Queues ----------------------------------------------------------------
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+    if (length == 0) return nullptr;
+    HostQueue* queue = new HostQueue();
+    queue->length = length;
+    queue->itemSize = itemSize;
+    queue->storage.resize((size_t)length * itemSize);
+    return queue;
+}
+
+static bool waitFor(HostQueue* queue, std::unique_lock<std::mutex>& guard, TickType_t ticksToWait,
+                    bool wantSpace) {
+    auto ready = [queue, wantSpace]() {
+        return wantSpace ? queue->count < queue->length : queue->count > 0;
+    };
+    if (ready()) return true;
+    if (ticksToWait == 0) return false;
+    if (ticksToWait == portMAX_DELAY) {
+        queue->changed.wait(guard, ready);
+        return true;
+    }
+    return queue->changed.wait_for(guard, ticksToDuration(ticksToWait), ready);
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t ticksToWait) {
+    if (queue == nullptr) return errQUEUE_FULL;
+    std::unique_lock<std::mutex> guard(queue->lock);
+    if (!waitFor(queue, guard, ticksToWait, true)) return errQUEUE_FULL;
+
+    UBaseType_t tail = (queue->head + queue->count) % queue->length;
+    memcpy(&queue->storage[(size_t)tail * queue->itemSize], item, queue->itemSize);
+    queue->count++;
+    guard.unlock();
+    queue->changed.notify_all();
+    return pdTRUE;
+}
+
+BaseType_t xQueueSendToBack(QueueHandle_t queue, const void* item, TickType_t ticksToWait) {
+    return xQueueSend(queue, item, ticksToWait);
+}
+
+BaseType_t xQueueSendFromISR(QueueHandle_t queue, const void* item, BaseType_t* higherPriorityTaskWoken) {
+    if (higherPriorityTaskWoken) *higherPriorityTaskWoken = pdFALSE;
+    return xQueueSend(queue, item, 0);
+}
+
+BaseType_t xQueueOverwrite(QueueHandle_t queue, const void* item) {
+    if (queue == nullptr) return pdFALSE;
+    {
+        std::lock_guard<std::mutex> guard(queue->lock);
+        if (queue->count == queue->length) {
+            queue->head = (queue->head + 1) % queue->length;
+            queue->count--;
+        }
+        UBaseType_t tail = (queue->head + queue->count) % queue->length;
+        memcpy(&queue->storage[(size_t)tail * queue->itemSize], item, queue->itemSize);
+        queue->count++;
+    }
+    queue->changed.notify_all();
+    return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t ticksToWait) {
+    if (queue == nullptr) return pdFALSE;
+    std::unique_lock<std::mutex> guard(queue->lock);
+    if (!waitFor(queue, guard, ticksToWait, false)) return pdFALSE;
+
+    memcpy(item, &queue->storage[(size_t)queue->head * queue->itemSize], queue->itemSize);
+    queue->head = (queue->head + 1) % queue->length;
+    queue->count--;
+    guard.unlock();
+    queue->changed.notify_all();
+    return pdTRUE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) {
+    if (queue == nullptr) return 0;
+    std::lock_guard<std::mutex> guard(queue->lock);
+    return queue->count;
+}
+
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t queue) {
+    if (queue == nullptr) return 0;
+    std::lock_guard<std::mutex> guard(queue->lock);
+    return queue->length - queue->count;
+}
+
+void vQueueDelete(QueueHandle_t queue) {
+    delete queue;
+}
@@ -0,0 +1,672 @@
+#include "Ethernet.h"
+#include "WiFi.h"
+#include "host_control.h"
+#include "lwip/sockets.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <linux/sockios.h>
+#include <deque>
+#include <mutex>
+#include <string>
+
+EthernetClass Ethernet;
+WiFiClass WiFi;
+
+/**
+ * One simulated socket. The firmware reads `rx` and writes `tx`; the
+ * test is the peer at the other end. A real socket (listenTcp()) keeps
+ * `fd` and goes straight to the kernel instead.
+ */
+struct HostSocket {
+    bool used = false;
+    host::Link link = host::ETHERNET;
+    bool udp = false;
+    bool firmwareOpen = false;      // Accepted or connected, stop() not yet called
+    bool pending = false;           // Waiting for the firmware's accept()
+    bool peerClosed = false;
+    bool peerReset = false;
+    std::string rx;
+    size_t rxRead = 0;
+    std::string tx;
+    size_t window = 0;              // Free space in the send buffer
+    size_t blocked = 0;
+    IPAddress remote;
+    uint16_t remotePort = 0;
+    std::function<void(int)> poll;
+    int fd = -1;
+};
+
+static const size_t MAX_SOCKETS = 64;
+static const size_t W5500_TX_BUFFER = 2048;     // 16 KB split over 8 sockets
+static const size_t LWIP_SEND_BUFFER = 5744;    // CONFIG_LWIP_TCP_SND_BUF_DEFAULT
+
+static std::recursive_mutex netLock;
+static HostSocket sockets[MAX_SOCKETS];
+static std::deque<int> pendingAccepts[2];
+static std::function<bool(int, IPAddress, uint16_t)> connectHandler;
+static uint8_t ethernetListeners = 0;           // Listening hardware sockets
+static uint32_t renewFailures = 0;
+static IPAddress dnsAnswer(127, 0, 0, 1);
+static int listenFd = -1;
+
+static uint8_t ethernetInUse() {
+    uint8_t count = ethernetListeners;
+    for (const HostSocket& s : sockets) {
+        if (s.used && s.link == host::ETHERNET && s.firmwareOpen) count++;
+    }
+    return count;
+}
+
+// Free slot for a new socket: never used, else one both ends are done
+// with, else any the firmware has closed (the test has had its look)
+static int claimSocket(host::Link link) {
+    int reusable = -1;
+    for (size_t i = 0; i < MAX_SOCKETS && reusable < 0; i++) {
+        if (!sockets[i].used) reusable = (int)i;
+    }
+    for (int pass = 0; pass < 2 && reusable < 0; pass++) {
+        for (size_t i = 0; i < MAX_SOCKETS; i++) {
+            const HostSocket& s = sockets[i];
+            if (s.firmwareOpen || s.pending || s.fd >= 0) continue;
+            if (pass == 0 && !(s.peerClosed || s.peerReset)) continue;
+            reusable = (int)i;
+            break;
+        }
+    }
+    if (reusable < 0) return -1;
+
+    // Keep the buffers' capacity so a benchmark's steady state does not
+    // count the shim's own allocations
+    HostSocket& s = sockets[reusable];
+    std::string rx = std::move(s.rx);
+    std::string tx = std::move(s.tx);
+    s = HostSocket();
+    s.rx = std::move(rx);
+    s.tx = std::move(tx);
+    s.rx.clear();
+    s.tx.clear();
+    s.used = true;
+    s.link = link;
+    s.window = link == host::ETHERNET ? W5500_TX_BUFFER : LWIP_SEND_BUFFER;
+    return reusable;
+}
+
+// A socket the firmware opens itself; on Ethernet it needs a free
+// hardware socket
+static int allocateSocket(host::Link link) {
+    if (link == host::ETHERNET && ethernetInUse() >= MAX_SOCK_NUM) return -1;
+    int id = claimSocket(link);
+    if (id >= 0) sockets[id].firmwareOpen = true;
+    return id;
+}
+
+static HostSocket* find(int id) {
+    if (id < 0 || (size_t)id >= MAX_SOCKETS || !sockets[id].used) return nullptr;
+    return &sockets[id];
+}
+
+// Pull whatever the kernel has for a real socket into rx
+static void pumpReal(HostSocket& s) {
+    if (s.fd < 0) return;
+    char buffer[2048];
+    while (true) {
+        ssize_t n = recv(s.fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+        if (n > 0) {
+            s.rx.append(buffer, n);
+            continue;
+        }
+        if (n == 0) s.peerClosed = true;
+        else if (errno != EAGAIN && errno != EWOULDBLOCK) s.peerReset = true;
+        break;
+    }
+}
+
+static void pollPeer(int id) {
+    HostSocket* s = find(id);
+    if (s == nullptr) return;
+    if (s->fd >= 0) {
+        pumpReal(*s);
+    } else if (s->poll) {
+        auto handler = s->poll;
+        handler(id);
+    }
+}
+
+static int socketAvailable(int id) {
+    std::lock_guard<std::recursive_mutex> guard(netLock);
+    pollPeer(id);
+    HostSocket* s = find(id);
+    if (s == nullptr || !s->firmwareOpen || s->peerReset) return 0;
+    return (int)(s->rx.size() - s->rxRead);
+}
+
+static int socketRead(int id, uint8_t* buffer, size_t size) {
+    std::lock_guard<std::recursive_mutex> guard(netLock);
+    pollPeer(id);
+    HostSocket* s = find(id);
+    if (s == nullptr || !s->firmwareOpen || s->peerReset) return -1;
+    size_t count = std::min(size, s->rx.size() - s->rxRead);
+    if (count == 0) return -1;
+    memcpy(buffer, s->rx.data() + s->rxRead, count);
+    s->rxRead += count;
+    if (s->rxRead == s->rx.size()) {
+        s->rx.clear();
+        s->rxRead = 0;
+    }
+    return (int)count;
+}
+
+static int socketPeek(int id) {
+    std::lock_guard<std::recursive_mutex> guard(netLock);
+    HostSocket* s = find(id);
+    if (s == nullptr || s->rxRead >= s->rx.size()) return -1;
+    return (uint8_t)s->rx[s->rxRead];
+}
+
+static size_t realWindow(HostSocket& s) {
+    int queued = 0;
+    ioctl(s.fd, SIOCOUTQ, &queued);
+    return queued < (int)W5500_TX_BUFFER ? W5500_TX_BUFFER - queued : 0;
+}
+
+static size_t socketWrite(int id, const uint8_t* buffer, size_t size, bool blocking) {
+    std::lock_guard<std::recursive_mutex> guard(netLock);
+    HostSocket* s = find(id);
+    if (s == nullptr || !s->firmwareOpen || s->peerReset) return 0;
+
+    if (s->fd >= 0) {
+        // W5500 semantics: take what fits in the TX buffer, never wait
+        size_t room = realWindow(*s);
+        size_t count = std::min(size, room);
+        if (count == 0) return 0;
+        ssize_t n = send(s->fd, buffer, count, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK) s->peerReset = true;
+            return 0;
+        }
+        return (size_t)n;
+    }
+
+    if (s->peerClosed && s->link == host::WIFI) {
+        s->peerReset = true;
+        return 0;
+    }
+    if (size > s->window) {
+        if (blocking) {
+            // lwIP, or the Ethernet library polling the W5500's free space,
+            // would hold the caller until the peer had read enough
+            s->blocked++;
+        } else {
+            size = s->window;
+        }
+    }
+    s->tx.append((const char*)buffer, size);
+    s->window = size > s->window ? 0 : s->window - size;
+    return size;
+}
+
+static uint8_t socketConnected(int id) {
+    std::lock_guard<std::recursive_mutex> guard(netLock);
+    pollPeer(id);
+    HostSocket* s = find(id);
+    if (s == nullptr || !s->firmwareOpen || s->peerReset) return 0;
+    return !s->peerClosed || s->rxRead < s->rx.size();
+}
+
+static void socketStop(int id) {
+    std::lock_guard<std::recursive_mutex> guard(netLock);
+    HostSocket* s = find(id);
+    if (s == nullptr) return;
+    s->firmwareOpen = false;
+    if (s->fd >= 0) {
+        // The W5500 sends FIN whatever is left unread. Linux would answer
+        // close() with RST if the request (say, of a client refused with
+        // 503) were still queued, and the peer would lose the reply.
+        char discard[512];
+        while (recv(s->fd, discard, sizeof(discard), MSG_DONTWAIT) > 0) {}
+        close(s->fd);
+        s->fd = -1;
+        s->peerClosed = true;
+    }
+}
+
+static int socketConnect(host::Link link, IPAddress ip, uint16_t port) {
+    std::lock_guard<std::recursive_mutex> guard(netLock);
+    int id = allocateSocket(link);
+    if (id < 0) return -1;
+    sockets[id].remote = ip;
+    sockets[id].remotePort = port;
+    if (!connectHandler || !connectHandler(id, ip, port)) {
+        sockets[id].firmwareOpen = false;
+        sockets[id].peerReset = true;
+        return -1;
+    }
+    return id;
+}
+
+// Take one connection waiting on the real listening socket
+static void acceptReal() {
+    if (listenFd < 0) return;
+    int fd = accept(listenFd, nullptr, nullptr);
+    if (fd < 0) return;
+    int id = claimSocket(host::ETHERNET);
+    if (id < 0) {
+        close(fd);
+        return;
+    }
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    sockets[id].fd = fd;
+    sockets[id].remote = IPAddress(127, 0, 0, 1);
+    sockets[id].pending = true;
+    pendingAccepts[host::ETHERNET].push_back(id);
+}
+
+// ---- Ethernet --------------------------------------------------------------
+
+int EthernetClient::connect(IPAddress ip, uint16_t port) {
+    if (sock >= 0) stop();
+    sock = socketConnect(host::ETHERNET, ip, port);
+    return sock >= 0;
+}
+
+int EthernetClient::connect(const char* host, uint16_t port) {
+    IPAddress ip;
+    if (!ip.fromString(host)) ip = dnsAnswer;
+    return connect(ip, port);
+}
+
+size_t EthernetClient::write(const uint8_t* buffer, size_t size) { return socketWrite(sock, buffer, size, true); }
+int EthernetClient::available() { return socketAvailable(sock); }
+int EthernetClient::read() { uint8_t c; return socketRead(sock, &c, 1) == 1 ? c : -1; }
+int EthernetClient::read(uint8_t* buffer, size_t size) { return socketRead(sock, buffer, size); }
+int EthernetClient::peek() { return socketPeek(sock); }
+void EthernetClient::stop() {
+    // The socket number is released with the socket, as on the chip
+    socketStop(sock);
+    sock = -1;
+}
+uint8_t EthernetClient::connected() { return socketConnected(sock); }
+
+int EthernetClient::availableForWrite() {
+    std::lock_guard<std::recursive_mutex> guard(netLock);
+    HostSocket* s = find(sock);
+    if (s == nullptr || !s->firmwareOpen) return 0;
+    return (int)(s->fd >= 0 ? realWindow(*s) : s->window);
+}
+
+uint8_t EthernetClient::status() {
+    return connected() ? 0x17 : 0x00;   // SnSR::ESTABLISHED / CLOSED
+}
+
+IPAddress EthernetClient::remoteIP() {
+    std::lock_guard<std::recursive_mutex> guard(netLock);
+    HostSocket* s = find(sock);
+    return s ? s->remote : IPAddress();
+}
+
+uint16_t EthernetClient::remotePort() {
+    std::lock_guard<std::recursive_mutex> guard(netLock);
+    HostSocket* s = find(sock);
+    return s ? s->remotePort : 0;
+}
+
+void EthernetServer::begin() {
+    std::lock_guard<std::recursive_mutex> guard(netLock);
+    if (listening) return;
+    if (ethernetInUse() >= MAX_SOCK_NUM) return;
+    ethernetListeners++;
+    listening = true;
+}
+
+EthernetClient EthernetServer::accept() {
+    std::lock_guard<std::recursive_mutex> guard(netLock);
+
+    // Connections only arrive on a listening socket, which then becomes
+    // the client socket; another one is opened for the next SYN if the
+    // chip has one left. Without one, real peers wait in the backlog.
+    if (!listening) begin();
+    if (!listening) return EthernetClient();
+    auto& pending = pendingAccepts[host::ETHERNET];
+    if (pending.empty()) acceptReal();
+    if (pending.empty()) return EthernetClient();
+
+    int id = pending.front();
+    pending.pop_front();
+    ethernetListeners--;
+    listening = false;
+    sockets[id].pending = false;
+    sockets[id].firmwareOpen = true;
+    begin();
+    return EthernetClient(id);
+}
+
+uint8_t EthernetUDP::begin(uint16_t port) {
+    (void)port;
+    std::lock_guard<std::recursive_mutex> guard(netLock);
+    if (sock >= 0) stop();
+    sock = allocateSocket(host::ETHERNET);
+    if (sock < 0) return 0;
+    sockets[sock].udp = true;
+    return 1;
+}
+
+void EthernetUDP::stop() {
+    if (sock < 0) return;
+    std::lock_guard<std::recursive_mutex> guard(netLock);
+    sockets[sock].firmwareOpen = false;
+    sockets[sock].peerClosed = true;
+    sock = -1;
+}
+
+int EthernetUDP::beginPacket(IPAddress ip, uint16_t port) {
+    if (sock < 0) return 0;
+    std::lock_guard<std::recursive_mutex> guard(netLock);
+    sockets[sock].tx.clear();
+    sockets[sock].remote = ip;
+    sockets[sock].remotePort = port;
+    return 1;
+}
+
+int EthernetUDP::beginPacket(const char* host, uint16_t port) {
+    IPAddress ip;
+    if (!ip.fromString(host)) return 0;
+    return beginPacket(ip, port);
+}
+
+size_t EthernetUDP::write(const uint8_t* buffer, size_t size) {
+    if (sock < 0) return 0;
+    std::lock_guard<std::recursive_mutex> guard(netLock);
+    sockets[sock].tx.append((const char*)buffer, size);
+    return size;
+}
+
+int EthernetUDP::endPacket() {
+    if (sock < 0) return 0;
+    std::lock_guard<std::recursive_mutex> guard(netLock);
+    HostSocket& s = sockets[sock];
+    if (s.remotePort != 53 || s.tx.size() < 12) return 1;
+
+    // Play the DNS server: echo the question, answer with one A record
+    std::string answer = s.tx;
+    answer[2] = (char)0x81;
+    answer[3] = (char)0x80;
+    answer[7] = 1;
+    const uint8_t record[] = {
+        0xC0, 0x0C, 0x00, 0x01, 0x00, 0x01, 0x00, 0x00, 0x01, 0x2C, 0x00, 0x04,
+        dnsAnswer[0], dnsAnswer[1], dnsAnswer[2], dnsAnswer[3],
+    };
+    answer.append((const char*)record, sizeof(record));
+    s.rx = answer;
+    s.rxRead = 0;
+    return 1;
+}
+
+int EthernetUDP::parsePacket() {
+    if (sock < 0) return 0;
+    std::lock_guard<std::recursive_mutex> guard(netLock);
+    HostSocket& s = sockets[sock];
+    remote = s.remote;
+    remotePortNumber = s.remotePort;
+    return (int)(s.rx.size() - s.rxRead);
+}
+
+int EthernetUDP::available() { return parsePacket(); }
+
+int EthernetUDP::read() {
+    unsigned char c;
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+int EthernetUDP::read(unsigned char* buffer, size_t length) {
+    if (sock < 0) return 0;
+    std::lock_guard<std::recursive_mutex> guard(netLock);
+    HostSocket& s = sockets[sock];
+    size_t count = std::min(length, s.rx.size() - s.rxRead);
+    memcpy(buffer, s.rx.data() + s.rxRead, count);
+    s.rxRead += count;
+    return (int)count;
+}
+
+int EthernetUDP::peek() {
+    return socketPeek(sock);
+}
+
+int EthernetClass::begin(uint8_t* mac, unsigned long timeoutMs, unsigned long responseTimeoutMs) {
+    (void)mac; (void)timeoutMs; (void)responseTimeoutMs;
+    return 1;
+}
+
+int EthernetClass::maintain() {
+    std::lock_guard<std::recursive_mutex> guard(netLock);
+    // A renewal needs a UDP socket for the DHCP exchange
+    if (ethernetInUse() >= MAX_SOCK_NUM) {
+        renewFailures++;
+        return DHCP_CHECK_RENEW_FAIL;
+    }
+    return DHCP_CHECK_NONE;
+}
+
+IPAddress EthernetClass::localIP() { return IPAddress(127, 0, 0, 1); }
+IPAddress EthernetClass::dnsServerIP() { return IPAddress(127, 0, 0, 53); }
+
+// ---- WiFi ------------------------------------------------------------------
+
+int WiFiClient::connect(IPAddress ip, uint16_t port) {
+    if (sock >= 0) stop();
+    sock = socketConnect(host::WIFI, ip, port);
+    return sock >= 0;
+}
+
+int WiFiClient::connect(const char* host, uint16_t port) {
+    IPAddress ip;
+    if (!ip.fromString(host)) ip = dnsAnswer;
+    return connect(ip, port);
+}
+
+size_t WiFiClient::write(const uint8_t* buffer, size_t size) { return socketWrite(sock, buffer, size, true); }
+
+// lwIP with MSG_DONTWAIT: EAGAIN when the send buffer is full, and only
+// what fits is taken
+int lwip_send(int s, const void* data, size_t size, int flags) {
+    std::lock_guard<std::recursive_mutex> guard(netLock);
+    HostSocket* h = find(s);
+    if (h == nullptr || !h->firmwareOpen || h->peerReset) {
+        errno = ECONNRESET;
+        return -1;
+    }
+    bool wait = !(flags & MSG_DONTWAIT);
+    if (!wait && h->window == 0 && size > 0) {
+        errno = EAGAIN;
+        return -1;
+    }
+    size_t n = socketWrite(s, (const uint8_t*)data, size, wait);
+    if (n == 0 && size > 0) {
+        errno = ECONNRESET;
+        return -1;
+    }
+    return (int)n;
+}
+int WiFiClient::available() { return socketAvailable(sock); }
+int WiFiClient::read() { uint8_t c; return socketRead(sock, &c, 1) == 1 ? c : -1; }
+int WiFiClient::read(uint8_t* buffer, size_t size) { return socketRead(sock, buffer, size); }
+int WiFiClient::peek() { return socketPeek(sock); }
+void WiFiClient::stop() {
+    socketStop(sock);
+    sock = -1;
+}
+uint8_t WiFiClient::connected() { return socketConnected(sock); }
+
+IPAddress WiFiClient::remoteIP() {
+    std::lock_guard<std::recursive_mutex> guard(netLock);
+    HostSocket* s = find(sock);
+    return s ? s->remote : IPAddress();
+}
+
+uint16_t WiFiClient::remotePort() {
+    std::lock_guard<std::recursive_mutex> guard(netLock);
+    HostSocket* s = find(sock);
+    return s ? s->remotePort : 0;
+}
+
+WiFiClient WiFiServer::accept() {
+    std::lock_guard<std::recursive_mutex> guard(netLock);
+    auto& pending = pendingAccepts[host::WIFI];
+    if (pending.empty()) return WiFiClient();
+    int id = pending.front();
+    pending.pop_front();
+    sockets[id].pending = false;
+    sockets[id].firmwareOpen = true;
+    return WiFiClient(id);
+}
+
+bool WiFiServer::hasClient() {
+    std::lock_guard<std::recursive_mutex> guard(netLock);
+    return !pendingAccepts[host::WIFI].empty();
+}
+
+wl_status_t WiFiClass::begin(const char* ssid, const char* passphrase) {
+    (void)ssid; (void)passphrase;
+    return WL_DISCONNECTED;
+}
+
+wl_status_t WiFiClass::status() {
+    return WL_DISCONNECTED;
+}
+
+uint8_t* WiFiClass::macAddress(uint8_t* mac) {
+    static const uint8_t HOST_MAC[6] = {0x02, 0x00, 0x00, 0xAB, 0xCD, 0xEF};
+    memcpy(mac, HOST_MAC, 6);
+    return mac;
+}
+
+int WiFiClass::hostByName(const char* host, IPAddress& result) {
+    if (result.fromString(host)) return 1;
+    result = dnsAnswer;
+    return 1;
+}
+
+// ---- Test side -------------------------------------------------------------
+
+namespace host {
+
+int peerConnect(Link link, const std::string& request) {
+    std::lock_guard<std::recursive_mutex> guard(netLock);
+    // No hardware socket yet: the chip commits one when the firmware
+    // accepts (see EthernetServer::accept())
+    int id = claimSocket(link);
+    if (id < 0) return -1;
+    HostSocket& s = sockets[id];
+    s.remote = IPAddress(192, 168, 1, 100 + (uint8_t)id);
+    s.remotePort = 40000 + (uint16_t)id;
+    s.rx = request;
+    s.pending = true;
+    pendingAccepts[link].push_back(id);
+    return id;
+}
+
+void setConnectHandler(std::function<bool(int, IPAddress, uint16_t)> handler) {
+    std::lock_guard<std::recursive_mutex> guard(netLock);
+    connectHandler = handler;
+}
+
+void setPollHandler(int socket, std::function<void(int)> handler) {
+    std::lock_guard<std::recursive_mutex> guard(netLock);
+    if (HostSocket* s = find(socket)) s->poll = handler;
+}
+
+void peerSend(int socket, const std::string& bytes) {
+    std::lock_guard<std::recursive_mutex> guard(netLock);
+    if (HostSocket* s = find(socket)) s->rx += bytes;
+}
+
+void peerClose(int socket) {
+    std::lock_guard<std::recursive_mutex> guard(netLock);
+    if (HostSocket* s = find(socket)) s->peerClosed = true;
+}
+
+void peerReset(int socket) {
+    std::lock_guard<std::recursive_mutex> guard(netLock);
+    if (HostSocket* s = find(socket)) {
+        s->peerReset = true;
+        s->rx.clear();
+        s->rxRead = 0;
+    }
+}
+
+std::string peerReceived(int socket) {
+    std::lock_guard<std::recursive_mutex> guard(netLock);
+    HostSocket* s = find(socket);
+    return s ? s->tx : std::string();
+}
+
+std::string peerTake(int socket) {
+    std::lock_guard<std::recursive_mutex> guard(netLock);
+    std::string out;
+    if (HostSocket* s = find(socket)) out.swap(s->tx);
+    return out;
+}
+
+bool firmwareClosed(int socket) {
+    std::lock_guard<std::recursive_mutex> guard(netLock);
+    HostSocket* s = find(socket);
+    return s == nullptr || !s->firmwareOpen;
+}
+
+void setSendWindow(int socket, size_t bytes) {
+    std::lock_guard<std::recursive_mutex> guard(netLock);
+    if (HostSocket* s = find(socket)) s->window = bytes;
+}
+
+void peerRead(int socket, size_t bytes) {
+    std::lock_guard<std::recursive_mutex> guard(netLock);
+    if (HostSocket* s = find(socket)) s->window += bytes;
+}
+
+size_t blockedWrites(int socket) {
+    std::lock_guard<std::recursive_mutex> guard(netLock);
+    HostSocket* s = find(socket);
+    return s ? s->blocked : 0;
+}
+
+uint8_t ethernetSocketsInUse() {
+    std::lock_guard<std::recursive_mutex> guard(netLock);
+    return ethernetInUse();
+}
+
+uint32_t dhcpRenewFailures() {
+    std::lock_guard<std::recursive_mutex> guard(netLock);
+    return renewFailures;
+}
+
+void setDnsAnswer(IPAddress address) {
+    std::lock_guard<std::recursive_mutex> guard(netLock);
+    dnsAnswer = address;
+}
+
+bool listenTcp(uint16_t port) {
+    std::lock_guard<std::recursive_mutex> guard(netLock);
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return false;
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(fd, (sockaddr*)&address, sizeof(address)) != 0 || listen(fd, 64) != 0) {
+        close(fd);
+        return false;
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    listenFd = fd;
+    return true;
+}
+
+}
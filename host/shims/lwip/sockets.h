@@ -0,0 +1,11 @@
+#ifndef HOST_LWIP_SOCKETS_H
+#define HOST_LWIP_SOCKETS_H
+
+#include <errno.h>
+#include <stddef.h>
+#include <sys/socket.h>
+
+// On the shim's simulated sockets: WiFiClient::fd() is the socket
+int lwip_send(int s, const void* data, size_t size, int flags);
+
+#endif
@@ -0,0 +1,76 @@
+#!/usr/bin/env python3
+"""
+Decode the firmware's CBOR with the Django app's own decoder
+
+Runs `test_cbor_writer --records`, which prints each value and each
+upload body in both encodings, and checks that sensors/cbor.py (and,
+for bodies, reading_from_cbor) turns the CBOR into exactly what the
+JSON says. Registered with ctest as cbor_django_decode:
+
+    python3 host/tests/check_cbor_records.py _gate_build/test_cbor_writer
+"""
+
+import json
+import os
+import subprocess
+import sys
+
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), '..', '..',
+                                'smartsensors_Application_1.0.0', 'smartsensors_django'))
+from sensors import cbor  # noqa: E402
+from sensors.sensor_schema import reading_from_cbor  # noqa: E402
+
+
+def main():
+    output = subprocess.run([sys.argv[1], '--records'], check=True,
+                            capture_output=True, text=True).stdout
+    values = records = failures = 0
+
+    for line in output.splitlines():
+        kind, _, rest = line.partition(' ')
+        if kind == 'VALUE':
+            decimals, text, encoded = rest.split(' ')
+            decimals = min(int(decimals), 6)
+            decoded = cbor.loads(bytes.fromhex(encoded))
+            expected = json.loads(text)
+            if isinstance(decoded, float) and abs(expected) * 10 ** decimals >= 2 ** 24:
+                # Past a float's 24 bits JsonWriter prints rounding noise, and a
+                # single can't hold the digits; the value must still agree
+                ok = abs(decoded - expected) <= abs(expected) * 2 ** -22 + 0.5 * 10 ** -decimals
+            else:
+                # Floats arrive as half/single; rounded like the JSON text
+                if isinstance(decoded, float):
+                    decoded = round(decoded, decimals)
+                ok = decoded == expected and type(decoded) is type(expected)
+            values += 1
+        elif kind == 'RECORD':
+            if rest == 'overflow':
+                print('FAIL payload does not fit UPLINK_PAYLOAD_BUFFER_SIZE')
+                failures += 1
+                continue
+            text, encoded = rest.rsplit(' ', 1)
+            decoded = reading_from_cbor(cbor.loads(bytes.fromhex(encoded)))
+            expected = json.loads(text)
+            ok = decoded == expected
+            records += 1
+        else:
+            continue
+
+        if not ok:
+            failures += 1
+            print(f'FAIL {kind}: JSON {text}')
+            print(f'     CBOR decodes to {json.dumps(decoded)}')
+
+    print(f'{values} values, {records} upload bodies decoded')
+    if values == 0 or records == 0:
+        print('FAIL nothing to check')
+        return 1
+    if failures:
+        print(f'{failures} check(s) failed')
+        return 1
+    print('OK')
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,208 @@
+#ifndef HOST_HARNESS_H
+#define HOST_HARNESS_H
+
+#include <Arduino.h>
+#include <string.h>
+#include "host_control.h"
+#include "config.h"
+#include "shared_data.h"
+#include "sensor_history.h"
+#include "rolling_stats.h"
+#include "buffer_manager.h"
+#include "network_manager.h"
+#include "web_server.h"
+#include "django_client.h"
+#include "cbor_writer.h"
+#include "ze40_sensor.h"
+#include "zphs01b_sensor.h"
+
+/**
+ * HostHarness
+ *
+ * Reaches into the firmware for host tests and benchmarks. The classes
+ * it needs name it as a friend; everything else goes through their
+ * public API like the tasks on the device do.
+ */
+class HostHarness {
+public:
+    /**
+     * Bring up what the sensor and Ethernet tasks would, on a manual
+     * clock so that the start-up delays cost nothing. Safe to call twice.
+     */
+    static void bootFirmware() {
+        static bool booted = false;
+        if (booted) return;
+        booted = true;
+
+        host::useManualClock();
+        initSharedData();
+        sensorHistory.init();
+        #ifdef ROLLING_STATS_ENABLED
+        rollingStats.init();
+        #endif
+        BufferManager::init();
+        networkManager.initEthernet();
+        webServer.init();
+    }
+
+    /**
+     * Publish a reading the way the sensors do: one sample per ring,
+     * inside the seqlock, so snapshotData() returns it
+     */
+    static void publishReading(const SharedSensorData& d, uint32_t timestamp) {
+        ZE40Sample ze40 = { timestamp, d.ze40_tvoc_ppb };
+        ZE40DacSample dac = { timestamp, d.ze40_dac_voltage, d.ze40_dac_ppm };
+        ZPHS01BSample air = { timestamp, d.zphs01b_pm1, d.zphs01b_pm25, d.zphs01b_pm10, d.zphs01b_co2,
+                              d.zphs01b_voc, d.zphs01b_ch2o, d.zphs01b_co, d.zphs01b_o3, d.zphs01b_no2,
+                              d.zphs01b_temperature, d.zphs01b_humidity };
+        MR007Sample lel = { timestamp, d.mr007_voltage, d.mr007_raw, d.mr007_lel };
+        ME4SO2Sample so2 = { timestamp, d.me4so2_voltage, d.me4so2_raw, d.me4so2_current, d.me4so2_so2 };
+
+        beginDataUpdate();
+        sensorHistory.ze40.push(ze40);
+        sensorHistory.ze40Dac.push(dac);
+        sensorHistory.zphs01b.push(air);
+        sensorHistory.mr007.push(lel);
+        sensorHistory.me4so2.push(so2);
+        endDataUpdate();
+    }
+
+    // ---- DjangoClient ------------------------------------------------------
+
+    static size_t buildJSONPayload(const SharedSensorData& data, uint32_t capturedAt,
+                                   char* buffer, size_t capacity) {
+        return DjangoClient::buildJSONPayload(data, capturedAt, buffer, capacity);
+    }
+
+    static size_t buildCBORPayload(const SharedSensorData& data, uint32_t capturedAt,
+                                   uint8_t* buffer, size_t capacity) {
+        return DjangoClient::buildCBORPayload(data, capturedAt, buffer, capacity);
+    }
+
+    // ---- CborWriter --------------------------------------------------------
+
+    static int32_t cborHalf(float f) {
+        return CborWriter::toHalf(f);
+    }
+
+    // Replay the backlog as the uplink task does once live sends succeed
+    static void uplinkDrainBacklog() {
+        DjangoClient::linkHealthy = true;
+        DjangoClient::drainBacklog();
+    }
+
+    // One POST of a ready JSON body, as a live reading goes out
+    static bool uplinkPost(const char* json) {
+        PostBody body = { json, strlen(json), 0, 0, false };
+        return DjangoClient::sendHTTPPOST(body);
+    }
+
+    static uint32_t uplinkStaleRetries() {
+        return DjangoClient::uplinkStats.staleRetries;
+    }
+
+    static uint32_t uplinkOversized() {
+        return DjangoClient::uplinkStats.oversized;
+    }
+
+    static void uplinkUseCBOR(bool cbor) {
+        DjangoClient::cborRejected = !cbor;
+    }
+
+    // ---- UART parsers ------------------------------------------------------
+
+    static bool ze40ProcessByte(uint8_t byte) {
+        return ze40Sensor.processByte(byte);
+    }
+
+    static bool zphs01bProcessByte(uint8_t byte) {
+        return zphs01bSensor.processByte(byte);
+    }
+
+    // Take the frames the parsers queued, as processData() would, without
+    // publishing them. Returns how many there were.
+    static uint32_t ze40TakeFrames() {
+        return takeFrames(ze40Sensor.rxFrames);
+    }
+
+    static uint32_t zphs01bTakeFrames() {
+        return takeFrames(zphs01bSensor.rxFrames);
+    }
+
+    static bool zphs01bPopFrame(UartFrame& frame) {
+        return zphs01bSensor.rxFrames.pop(frame);
+    }
+
+    struct ParserCounters {
+        uint32_t framesOk;
+        uint32_t checksumErrors;
+        uint32_t resyncs;
+        uint32_t bytesDiscarded;
+        uint32_t maxResyncBytes;
+    };
+
+    static ParserCounters zphs01bCounters() {
+        const ZPHS01BSensor::ParserState& p = zphs01bSensor.parser;
+        return { p.framesOk, p.checksumErrors, p.resyncs, p.bytesDiscarded, p.maxResyncBytes };
+    }
+
+    static void zphs01bResetParser() {
+        zphs01bSensor.parser = ZPHS01BSensor::ParserState();
+    }
+
+    // ---- SensorWebServer ---------------------------------------------------
+
+    /**
+     * Accept a connection the test opened with host::peerConnect() and
+     * fill in the request as readRequest() would have parsed it
+     * @return The connection, ready for handleHTTPRequest(), or nullptr
+     */
+    static WebConnection* webAccept(const char* method, const char* path,
+                                    const char* query = "", const char* apiToken = "") {
+        EthernetClient client = webServer.ethServer->accept();
+        if (!client) return nullptr;
+        WebConnection* conn = webServer.claimSlot(true);
+        if (conn == nullptr) {
+            client.stop();
+            return nullptr;
+        }
+        conn->ethClient = client;
+        conn->client = &conn->ethClient;
+        webServer.startConnection(*conn);
+
+        conn->requestLineSeen = true;
+        strncpy(conn->method, method, sizeof(conn->method) - 1);
+        strncpy(conn->path, path, sizeof(conn->path) - 1);
+        strncpy(conn->query, query, sizeof(conn->query) - 1);
+        strncpy(conn->apiToken, apiToken, sizeof(conn->apiToken) - 1);
+        return conn;
+    }
+
+    static void webHandle(WebConnection& conn) {
+        webServer.handleHTTPRequest(conn);
+    }
+
+    static int webActiveClients() {
+        return webServer.activeClients;
+    }
+
+    static uint32_t webPushesDropped() {
+        return webServer.wsDropped;
+    }
+
+    // Forget every client's request count (host_web_server: all of
+    // web_bench.py's clients share one address)
+    static void webResetRateLimit() {
+        WebAuthManager::rateLimitRecordCount = 0;
+    }
+
+private:
+    static uint32_t takeFrames(UartFrameQueue& queue) {
+        uint32_t count = 0;
+        UartFrame frame;
+        while (queue.pop(frame)) count++;
+        return count;
+    }
+};
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+#include <stdio.h>
+#include <string>
+
+/**
+ * Minimal checks for the host tests
+ *
+ * Each test is its own executable registered with ctest. A failed
+ * CHECK prints where it was and the test carries on; main() returns
+ * testResult(), so ctest reports the executable as failed.
+ */
+
+namespace hosttest {
+
+inline int& failures() {
+    static int count = 0;
+    return count;
+}
+
+inline bool check(bool ok, const char* expression, const char* file, int line) {
+    if (!ok) {
+        failures()++;
+        printf("FAIL %s:%d: %s\n", file, line, expression);
+    }
+    return ok;
+}
+
+inline std::string describe(const std::string& value) { return "\"" + value + "\""; }
+inline std::string describe(const char* value) { return value ? "\"" + std::string(value) + "\"" : "null"; }
+template <typename T> std::string describe(const T& value) { return std::to_string(value); }
+
+template <typename A, typename B>
+bool checkEqual(const A& actual, const B& expected, const char* expression, const char* file, int line) {
+    if (actual == expected) return true;
+    failures()++;
+    printf("FAIL %s:%d: %s\n", file, line, expression);
+    printf("     got:      %s\n     expected: %s\n", describe(actual).c_str(), describe(expected).c_str());
+    return false;
+}
+
+}
+
+#define CHECK(expression) hosttest::check((expression), #expression, __FILE__, __LINE__)
+#define CHECK_EQ(actual, expected) \
+    hosttest::checkEqual((actual), (expected), #actual " == " #expected, __FILE__, __LINE__)
+
+// Print a section heading, so a failure can be placed in the output
+#define TEST_CASE(name) printf("-- %s\n", name)
+
+inline int testResult() {
+    if (hosttest::failures() == 0) {
+        printf("OK\n");
+        return 0;
+    }
+    printf("%d check(s) failed\n", hosttest::failures());
+    return 1;
+}
+
+#endif
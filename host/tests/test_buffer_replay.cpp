@@ -0,0 +1,195 @@
+// Replaying a full flash buffer: streamEntries() and the BufferCursor
+// API must deliver every entry, as well-formed JSON or CBOR, with RAM
+// use that does not grow with the backlog
+
+#include "host_test.h"
+#include "host_harness.h"
+#include "counting_print.h"
+#include <pthread.h>
+#include <vector>
+
+// Checks the JSON array it is given as it streams past, without keeping
+// it: brackets balance, strings close, and top-level elements are counted
+class JsonArrayCheck : public Print {
+public:
+    size_t write(uint8_t c) override {
+        bytes++;
+        if (inString) {
+            if (escaped) escaped = false;
+            else if (c == '\\') escaped = true;
+            else if (c == '"') inString = false;
+            return 1;
+        }
+        switch (c) {
+            case '"': inString = true; break;
+            case '[': case '{':
+                if (depth == 1 && !inElement) { elements++; inElement = true; }
+                depth++;
+                break;
+            case ']': case '}':
+                depth--;
+                if (depth < 0) broken = true;
+                if (depth == 1) inElement = false;
+                break;
+            case ',':
+                if (depth == 1) inElement = false;
+                break;
+            default:
+                if (depth == 1 && !inElement) { elements++; inElement = true; }
+                break;
+        }
+        return 1;
+    }
+
+    size_t write(const uint8_t* data, size_t length) override {
+        for (size_t i = 0; i < length; i++) write(data[i]);
+        return length;
+    }
+
+    bool complete() const { return !broken && depth == 0 && !inString && bytes > 0; }
+
+    size_t bytes = 0;
+    size_t elements = 0;
+
+private:
+    int depth = 0;
+    bool inString = false;
+    bool escaped = false;
+    bool inElement = false;
+    bool broken = false;
+};
+
+struct RamUse {
+    size_t heap;        // Peak heap above what was live at the start
+    size_t stack;       // Deepest stack, over what an empty call takes
+};
+
+// Runs a function on a thread whose stack is painted first, then reports
+// how deep it went (the tasks have fixed stacks) and the heap peak
+static RamUse ramUse(void (*body)()) {
+    static uint8_t stack[256 * 1024];
+    static void (*run)() = nullptr;
+    static size_t heapPeak = 0;
+
+    auto measure = [](void (*function)()) -> size_t {
+        memset(stack, 0xA5, sizeof(stack));
+        run = function;
+        pthread_attr_t attr;
+        pthread_attr_init(&attr);
+        pthread_attr_setstack(&attr, stack, sizeof(stack));
+        pthread_t thread;
+        pthread_create(&thread, &attr, [](void*) -> void* {
+            size_t before = host::heapInUse();
+            host::resetHeapPeak();
+            run();
+            heapPeak = host::heapPeak() - before;
+            return nullptr;
+        }, nullptr);
+        pthread_join(thread, nullptr);
+        pthread_attr_destroy(&attr);
+
+        size_t untouched = 0;
+        while (untouched < sizeof(stack) && stack[untouched] == 0xA5) untouched++;
+        return sizeof(stack) - untouched;
+    };
+
+    size_t idle = measure([]() {});
+    size_t used = measure(body);
+    return { heapPeak, used > idle ? used - idle : 0 };
+}
+
+static SharedSensorData reading(uint32_t i) {
+    SharedSensorData d;
+    d.ze40_tvoc_ppb = 400.0f + (i % 50);
+    d.ze40_uart_valid = true;
+    d.zphs01b_pm25 = (float)(i % 40);
+    d.zphs01b_co2 = 600.0f + (i % 200);
+    d.zphs01b_temperature = 22.5f;
+    d.zphs01b_valid = true;
+    d.mr007_lel = 0.1f * (i % 10);
+    d.mr007_valid = (i % 3) != 0;
+    d.me4so2_so2 = 0.05f;
+    d.me4so2_valid = true;
+    strcpy(d.ip_address, "192.168.1.50");
+    d.network_ready = true;
+    return d;
+}
+
+// The streams run on the Ethernet and uplink tasks; this leaves them
+// most of their stack (host frames are larger than Xtensa ones)
+static const size_t STACK_BUDGET = 4096;
+
+static size_t entries = 0;
+static JsonArrayCheck jsonCheck;
+static CountingPrint cborCount;
+static size_t jsonStreamed = 0;
+static size_t cborStreamed = 0;
+
+int main() {
+    HostHarness::bootFirmware();
+    BufferManager::clearBuffer();
+
+    TEST_CASE("fill the buffer until it refuses a record");
+    char longJson[600];
+    memset(longJson, 'x', sizeof(longJson));
+    memcpy(longJson, "{\"note\":\"", 9);
+    memcpy(longJson + sizeof(longJson) - 2, "\"}", 2);
+    for (uint32_t i = 0;; i++) {
+        bool saved;
+        if (i % 100 == 50) saved = BufferManager::saveJSON(longJson, sizeof(longJson));    // Spans records
+        else saved = BufferManager::saveData(reading(i), 1700000000 + i * 60);
+        if (!saved) break;
+        entries++;
+        host::advanceMs(60);
+    }
+    printf("     %zu entries, %u%% full\n", entries, BufferManager::getUsagePercent());
+    CHECK(entries > 1000);
+    CHECK_EQ(BufferManager::getEntryCount(), entries);
+    CHECK(BufferManager::getUsagePercent() >= 99);
+
+    TEST_CASE("streamEntries() delivers the whole buffer without touching the heap");
+    RamUse json = ramUse([]() { jsonStreamed = BufferManager::streamEntries(jsonCheck); });
+    printf("     %zu bytes of JSON: peak heap +%zu bytes, stack %zu bytes\n", jsonCheck.bytes, json.heap, json.stack);
+    CHECK_EQ(jsonStreamed, entries);
+    CHECK_EQ(jsonCheck.elements, entries);
+    CHECK(jsonCheck.complete());
+    CHECK_EQ(json.heap, (size_t)0);
+    CHECK(json.stack < STACK_BUDGET);
+
+    TEST_CASE("streamCBOREntries() likewise");
+    RamUse cbor = ramUse([]() { cborStreamed = BufferManager::streamCBOREntries(cborCount); });
+    printf("     %zu bytes of CBOR: peak heap +%zu bytes, stack %zu bytes\n", cborCount.count(), cbor.heap, cbor.stack);
+    CHECK_EQ(cborStreamed, entries);
+    CHECK(cborCount.count() > 0 && cborCount.count() < jsonCheck.bytes);
+    CHECK_EQ(cbor.heap, (size_t)0);
+    CHECK(cbor.stack < STACK_BUDGET);
+
+    TEST_CASE("cursor replay in upload batches drains the buffer");
+    size_t heapBefore = host::heapInUse();
+    host::resetHeapPeak();
+    size_t replayed = 0;
+    size_t nulls = 0;
+    while (BufferManager::hasData()) {
+        BufferCursor cursor = BufferManager::openCursor(BACKLOG_BATCH_SIZE);
+        size_t batch = 0;
+        char record[JSON_PAYLOAD_BUFFER_SIZE];
+        while (true) {
+            JsonWriter writer(record, sizeof(record));
+            if (!BufferManager::writeNext(cursor, writer)) break;
+            CHECK(writer.ok());
+            if (writer.length() == 4 && memcmp(record, "null", 4) == 0) nulls++;
+            batch++;
+        }
+        if (!CHECK(batch > 0)) break;
+        BufferManager::removeEntries(batch);
+        replayed += batch;
+    }
+    size_t cursorHeap = host::heapPeak() - heapBefore;
+    printf("     %zu entries in batches of %d: peak heap +%zu bytes\n", replayed, BACKLOG_BATCH_SIZE, cursorHeap);
+    CHECK_EQ(replayed, entries);
+    CHECK_EQ(nulls, (size_t)0);
+    CHECK_EQ(BufferManager::getEntryCount(), (size_t)0);
+    CHECK_EQ(cursorHeap, (size_t)0);
+
+    return testResult();
+}
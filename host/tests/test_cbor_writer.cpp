@@ -0,0 +1,248 @@
+// CborWriter against the encodings in RFC 8949 Appendix A: integers of
+// every head size, negative ones included, half floats (subnormals too)
+// and the fallback to single, and floats rounded exactly as JsonWriter
+// prints them, 0-decimal ones as integers.
+//
+// With --records it prints the same values and whole upload bodies in
+// both encodings instead, for check_cbor_records.py: the Django side's
+// decoder must turn each CBOR body into what its JSON twin says.
+
+#include "host_test.h"
+#include "host_harness.h"
+#include "cbor_writer.h"
+#include "json_writer.h"
+#include <float.h>
+#include <math.h>
+#include <functional>
+
+static std::string hex(const uint8_t* data, size_t length) {
+    static const char DIGITS[] = "0123456789abcdef";
+    std::string out;
+    for (size_t i = 0; i < length; i++) {
+        out += DIGITS[data[i] >> 4];
+        out += DIGITS[data[i] & 0xF];
+    }
+    return out;
+}
+
+static std::string cbor(const std::function<void(CborWriter&)>& write) {
+    uint8_t buffer[64];
+    CborWriter w(buffer, sizeof(buffer));
+    write(w);
+    return w.ok() ? hex(w.data(), w.length()) : "overflow";
+}
+
+static std::string cborFloat(float v, uint8_t decimals) {
+    return cbor([&](CborWriter& w) { w.value(v, decimals); });
+}
+
+static std::string cborLong(long v) {
+    return cbor([&](CborWriter& w) { w.value(v); });
+}
+
+// One value in both encodings
+static void printValue(float v, uint8_t decimals) {
+    char json[32];
+    JsonWriter j(json, sizeof(json));
+    j.value(v, decimals);
+    json[j.length()] = '\0';
+    printf("VALUE %u %s %s\n", decimals, json, cborFloat(v, decimals).c_str());
+}
+
+static void printRecord(const SharedSensorData& d, uint32_t capturedAt) {
+    char json[UPLINK_PAYLOAD_BUFFER_SIZE];
+    uint8_t body[UPLINK_PAYLOAD_BUFFER_SIZE];
+    size_t jsonLength = HostHarness::buildJSONPayload(d, capturedAt, json, sizeof(json));
+    size_t cborLength = HostHarness::buildCBORPayload(d, capturedAt, body, sizeof(body));
+    if (jsonLength == 0 || cborLength == 0) {
+        printf("RECORD overflow\n");
+        return;
+    }
+    printf("RECORD %.*s %s\n", (int)jsonLength, json, hex(body, cborLength).c_str());
+}
+
+static SharedSensorData allValid() {
+    SharedSensorData d;
+    d.ze40_tvoc_ppb = 412.0f;
+    d.ze40_tvoc_ppm = 0.412f;
+    d.ze40_dac_voltage = 0.83f;
+    d.ze40_dac_ppm = 0.415f;
+    d.ze40_uart_valid = true;
+    d.ze40_analog_valid = true;
+    d.zphs01b_pm1 = 3;
+    d.zphs01b_pm25 = 7;
+    d.zphs01b_pm10 = 12;
+    d.zphs01b_co2 = 640;
+    d.zphs01b_voc = 1;
+    d.zphs01b_ch2o = 0.02f;
+    d.zphs01b_co = 0.4f;
+    d.zphs01b_o3 = 0.03f;
+    d.zphs01b_no2 = 0.012f;
+    d.zphs01b_temperature = 21.3f;
+    d.zphs01b_humidity = 44;
+    d.zphs01b_valid = true;
+    d.mr007_voltage = 0.412f;
+    d.mr007_raw = 512;
+    d.mr007_lel = 2.5f;
+    d.mr007_valid = true;
+    d.me4so2_voltage = 0.1234f;
+    d.me4so2_raw = 153;
+    d.me4so2_current = 1.25f;
+    d.me4so2_so2 = 0.37f;
+    d.me4so2_valid = true;
+    strcpy(d.ip_address, "192.168.1.50");
+    d.network_ready = true;
+    return d;
+}
+
+static void printRecords() {
+    static const float VALUES[] = { 0.0f, -0.0f, 1.0f, 1.5f, -4.0f, 65504.0f, 65520.0f, 100000.0f,
+                                    21.3f, -12.75f, 0.1f, 3e9f, FLT_MAX, -FLT_MAX,
+                                    5.9604645e-8f, 6.1035156e-5f, 8.940697e-8f, -5.9604645e-8f,
+                                    0.00005f, 2.5f, -2.5f, 0.49999997f, -0.4f, 999999936.0f, 123456.789f,
+                                    NAN, INFINITY };
+    for (float v : VALUES) {
+        for (uint8_t decimals : { 0, 1, 2, 4, 6, 9 }) printValue(v, decimals);
+    }
+
+    // Before any sample: every sample_age_ms is -1
+    SharedSensorData d = allValid();
+    printRecord(d, millis());
+
+    HostHarness::publishReading(d, millis());
+    host::advanceMs(2500);
+    printRecord(d, millis());
+    printRecord(d, millis() - 12000);       // Queued a while: age_s
+
+    SharedSensorData cold = allValid();
+    cold.zphs01b_temperature = -12.5f;
+    cold.zphs01b_humidity = 0;
+    cold.zphs01b_co2 = 65535;
+    cold.me4so2_current = -0.37f;
+    cold.me4so2_raw = -5;
+    cold.me4so2_voltage = 0.0001f;
+    cold.me4so2_so2 = 0;
+    cold.mr007_lel = 99.95f;
+    printRecord(cold, millis());
+
+    SharedSensorData partial = allValid();
+    partial.zphs01b_valid = false;
+    partial.me4so2_valid = false;
+    partial.ze40_uart_valid = false;
+    printRecord(partial, millis());
+
+    #ifdef ROLLING_STATS_ENABLED
+    // Statistics in every window for some fields, only the longer ones for others
+    for (uint32_t i = 0; i < 40; i++) {
+        rollingStats.add(ROLLING_mr007_lel, millis(), 2.0f + (i % 7) * 0.35f);
+        rollingStats.add(ROLLING_zphs01b_temperature, millis(), -3.0f + i * 0.4f);
+        host::advanceMs(1700);
+    }
+    rollingStats.add(ROLLING_me4so2_so2, millis(), 0.37f);
+    host::advanceMs(90000);
+    rollingStats.add(ROLLING_zphs01b_co2, millis(), 640.0f);
+    printRecord(allValid(), millis());
+    #endif
+}
+
+int main(int argc, char** argv) {
+    HostHarness::bootFirmware();
+    if (argc > 1 && strcmp(argv[1], "--records") == 0) {
+        printRecords();
+        return 0;
+    }
+
+    TEST_CASE("unsigned integers: every head size");
+    CHECK_EQ(cborLong(0), std::string("00"));
+    CHECK_EQ(cborLong(23), std::string("17"));
+    CHECK_EQ(cborLong(24), std::string("1818"));
+    CHECK_EQ(cborLong(100), std::string("1864"));
+    CHECK_EQ(cborLong(1000), std::string("1903e8"));
+    CHECK_EQ(cborLong(1000000), std::string("1a000f4240"));
+    CHECK_EQ(cbor([](CborWriter& w) { w.value(4294967295UL); }), std::string("1affffffff"));
+
+    TEST_CASE("negative integers are -1 - n, at every head size");
+    CHECK_EQ(cborLong(-1), std::string("20"));
+    CHECK_EQ(cborLong(-10), std::string("29"));
+    CHECK_EQ(cborLong(-24), std::string("37"));
+    CHECK_EQ(cborLong(-25), std::string("3818"));
+    CHECK_EQ(cborLong(-100), std::string("3863"));
+    CHECK_EQ(cborLong(-256), std::string("38ff"));
+    CHECK_EQ(cborLong(-257), std::string("390100"));
+    CHECK_EQ(cborLong(-1000), std::string("3903e7"));
+    CHECK_EQ(cborLong(-65536), std::string("39ffff"));
+    CHECK_EQ(cborLong(-65537), std::string("3a00010000"));
+    CHECK_EQ(cborLong(-2147483647L - 1), std::string("3a7fffffff"));
+
+    TEST_CASE("floats: half when exact, else single");
+    CHECK_EQ(cborFloat(0.0f, 2), std::string("f90000"));
+    CHECK_EQ(cborFloat(1.0f, 2), std::string("f93c00"));
+    CHECK_EQ(cborFloat(1.5f, 2), std::string("f93e00"));
+    CHECK_EQ(cborFloat(-4.0f, 2), std::string("f9c400"));
+    CHECK_EQ(cborFloat(65504.0f, 2), std::string("f97bff"));
+    CHECK_EQ(cborFloat(65536.0f, 2), std::string("fa47800000"));   // Past half's range
+    CHECK_EQ(cborFloat(100000.0f, 2), std::string("fa47c35000"));
+    CHECK_EQ(cborFloat(-4.1f, 1), std::string("fac0833333"));
+    CHECK_EQ(cborFloat(NAN, 2), std::string("f6"));
+    CHECK_EQ(cborFloat(INFINITY, 2), std::string("f6"));
+    CHECK_EQ(cborFloat(-INFINITY, 0), std::string("f6"));
+    CHECK_EQ(cborFloat(FLT_MAX, 2), std::string("f6"));             // JsonWriter's null too
+    CHECK_EQ(cborFloat(-1e9f, 0), std::string("f6"));
+    CHECK_EQ(cborFloat(999999936.0f, 0), std::string("1a3b9ac9c0"));   // Largest below 1e9
+
+    TEST_CASE("half precision bits, subnormals included (RFC 8949 Appendix A)");
+    CHECK_EQ(HostHarness::cborHalf(0.0f), 0x0000);
+    CHECK_EQ(HostHarness::cborHalf(-0.0f), 0x8000);
+    CHECK_EQ(HostHarness::cborHalf(65504.0f), 0x7BFF);
+    CHECK_EQ(HostHarness::cborHalf(ldexpf(1, -14)), 0x0400);       // Smallest normal
+    CHECK_EQ(HostHarness::cborHalf(ldexpf(1, -15)), 0x0200);
+    CHECK_EQ(HostHarness::cborHalf(ldexpf(1023, -24)), 0x03FF);    // Largest subnormal
+    CHECK_EQ(HostHarness::cborHalf(ldexpf(1, -24)), 0x0001);       // Smallest
+    CHECK_EQ(HostHarness::cborHalf(-ldexpf(1, -24)), 0x8001);
+    CHECK_EQ(HostHarness::cborHalf(ldexpf(3, -25)), -1);           // Needs a bit half lacks
+    CHECK_EQ(HostHarness::cborHalf(ldexpf(1, -25)), -1);           // Below half's range
+    CHECK_EQ(HostHarness::cborHalf(ldexpf(1, 16)), -1);            // Above it
+    CHECK_EQ(HostHarness::cborHalf(ldexpf(2047, -11)), 0x3BFF);    // All 11 bits
+    CHECK_EQ(HostHarness::cborHalf(ldexpf(4095, -12)), -1);        // One bit too many
+    // Rounded to at most 6 decimals, nothing in the subnormal range is left
+    CHECK_EQ(cborFloat(ldexpf(1, -24), 6), std::string("f90000"));
+    CHECK_EQ(cborFloat(ldexpf(1, -16), 6), std::string("fa377ba882"));   // 0.000015
+
+    TEST_CASE("rounded as JsonWriter prints: half up, at most 6 decimals");
+    CHECK_EQ(cborFloat(21.34f, 1), std::string("fa41aa6666"));          // 21.3
+    CHECK_EQ(cborFloat(21.46f, 1), std::string("f94d60"));              // 21.5
+    CHECK_EQ(cborFloat(0.499f, 2), std::string("f93800"));              // 0.5
+    CHECK_EQ(cborFloat(0.00004f, 4), std::string("f90000"));            // 0
+    CHECK_EQ(cborFloat(-0.00004f, 4), std::string("f90000"));           // 0, not -0
+    CHECK_EQ(cborFloat(ldexpf(1, -20), 9), cborFloat(ldexpf(1, -20), 6));
+
+    TEST_CASE("0 decimals: an integer, rounded half away from zero");
+    CHECK_EQ(cborFloat(21.6f, 0), std::string("16"));
+    CHECK_EQ(cborFloat(2.5f, 0), std::string("03"));
+    CHECK_EQ(cborFloat(-3.5f, 0), std::string("23"));
+    CHECK_EQ(cborFloat(-0.4f, 0), std::string("00"));
+    CHECK_EQ(cborFloat(0.49999997f, 0), std::string("01"));          // As the JSON text has it
+    CHECK_EQ(cborFloat(65535.0f, 0), std::string("19ffff"));
+    CHECK_EQ(cborFloat(-1000.0f, 0), std::string("3903e7"));
+    CHECK_EQ(cborFloat(1e6f, 0), std::string("1a000f4240"));
+
+    TEST_CASE("containers, text and simple values");
+    CHECK_EQ(cbor([](CborWriter& w) { w.beginArray(); w.endArray(); }), std::string("9fff"));
+    CHECK_EQ(cbor([](CborWriter& w) { w.beginObject(); w.member(3, 1.5f, 1); w.endObject(); }),
+             std::string("bf03f93e00ff"));
+    CHECK_EQ(cbor([](CborWriter& w) { w.value(""); w.value("IETF"); }), std::string("606449455446"));
+    CHECK_EQ(cbor([](CborWriter& w) { w.value(false); w.value(true); w.null(); }), std::string("f4f5f6"));
+
+    TEST_CASE("a whole upload body fits the buffer in both encodings");
+    SharedSensorData d = allValid();
+    char json[UPLINK_PAYLOAD_BUFFER_SIZE];
+    uint8_t body[UPLINK_PAYLOAD_BUFFER_SIZE];
+    size_t jsonLength = HostHarness::buildJSONPayload(d, millis(), json, sizeof(json));
+    size_t cborLength = HostHarness::buildCBORPayload(d, millis(), body, sizeof(body));
+    printf("     %zu bytes of JSON, %zu of CBOR\n", jsonLength, cborLength);
+    CHECK(jsonLength > 0);
+    CHECK(cborLength > 0 && cborLength < jsonLength);
+    CHECK(cborLength > 0 && body[0] == 0xBF && body[cborLength - 1] == 0xFF);
+
+    return testResult();
+}
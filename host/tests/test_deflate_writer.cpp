@@ -0,0 +1,152 @@
+// DeflateWriter round trips through zlib's inflate, in both framings:
+// empty input, sensor JSON long enough to slide the window many times,
+// runs that need 258-byte matches, matches at the edge of the window,
+// incompressible data, and the same input split into odd write sizes
+
+#include "host_test.h"
+#include "host_harness.h"
+#include "deflate_writer.h"
+#include <string>
+#include <zlib.h>
+
+class StringSink : public Print {
+public:
+    size_t write(uint8_t c) override { bytes.push_back((char)c); return 1; }
+    size_t write(const uint8_t* data, size_t length) override {
+        bytes.append((const char*)data, length);
+        return length;
+    }
+    std::string bytes;
+};
+
+static DeflateWriter deflater;
+
+static std::string compress(const std::string& input, DeflateWriter::Format format, size_t step = 0) {
+    StringSink sink;
+    deflater.begin(sink, format);
+    if (step == 0) {
+        deflater.write((const uint8_t*)input.data(), input.size());
+    } else {
+        // Write sizes cycle through 1..step, so chunk edges land everywhere
+        size_t at = 0;
+        for (size_t n = 1; at < input.size(); n = n % step + 1) {
+            size_t chunk = std::min(n, input.size() - at);
+            deflater.write((const uint8_t*)input.data() + at, chunk);
+            at += chunk;
+        }
+    }
+    deflater.finish();
+    CHECK_EQ(deflater.bytesIn(), input.size());
+    CHECK_EQ(deflater.bytesOut(), sink.bytes.size());
+    return sink.bytes;
+}
+
+// zlib checks the header, the CRC-32 or Adler-32 and the gzip length
+static bool inflateAll(const std::string& compressed, DeflateWriter::Format format, std::string& out) {
+    z_stream z;
+    memset(&z, 0, sizeof(z));
+    if (inflateInit2(&z, format == DeflateWriter::GZIP ? 16 + MAX_WBITS : MAX_WBITS) != Z_OK) return false;
+    z.next_in = (Bytef*)compressed.data();
+    z.avail_in = (uInt)compressed.size();
+    char chunk[4096];
+    int status;
+    do {
+        z.next_out = (Bytef*)chunk;
+        z.avail_out = sizeof(chunk);
+        status = inflate(&z, Z_NO_FLUSH);
+        out.append(chunk, sizeof(chunk) - z.avail_out);
+    } while (status == Z_OK);
+    bool whole = status == Z_STREAM_END && z.avail_in == 0;
+    if (!whole) printf("     inflate: %d %s\n", status, z.msg ? z.msg : "");
+    inflateEnd(&z);
+    return whole;
+}
+
+// Both framings, bulk and in small writes, must give the same bytes back;
+// returns the gzip size
+static size_t roundTrip(const std::string& input) {
+    size_t gzipSize = 0;
+    for (DeflateWriter::Format format : { DeflateWriter::GZIP, DeflateWriter::ZLIB }) {
+        std::string bulk = compress(input, format);
+        std::string out;
+        CHECK(inflateAll(bulk, format, out));
+        CHECK(out == input);
+        CHECK(compress(input, format, 7) == bulk);
+        if (format == DeflateWriter::GZIP) gzipSize = bulk.size();
+    }
+    return gzipSize;
+}
+
+static std::string noise(size_t length, uint32_t seed) {
+    std::string s(length, '\0');
+    for (char& c : s) {
+        seed = seed * 1664525u + 1013904223u;
+        c = (char)(seed >> 24);
+    }
+    return s;
+}
+
+// Framing overhead: gzip header and trailer, the block header and
+// end-of-block code, padding
+static const size_t GZIP_OVERHEAD = 10 + 8 + 2;
+
+int main() {
+    HostHarness::bootFirmware();
+
+    TEST_CASE("empty input");
+    CHECK(roundTrip("") <= GZIP_OVERHEAD);
+
+    TEST_CASE("sensor JSON sliding the window many times");
+    std::string json = "[";
+    for (int i = 0; json.size() < 24 * DEFLATE_WINDOW_SIZE; i++) {
+        char entry[160];
+        snprintf(entry, sizeof(entry),
+                 "%s{\"age_s\":%d,\"ze40\":{\"tvoc_ppb\":%d.%02d},\"air_quality\":{\"pm25\":%d,\"co2\":%d}}",
+                 i ? "," : "", i * 60, 400 + i % 37, i % 100, 10 + i % 9, 600 + i % 211);
+        json += entry;
+    }
+    json += "]";
+    size_t jsonSize = roundTrip(json);
+    printf("     %zu bytes of JSON -> %zu\n", json.size(), jsonSize);
+    CHECK(jsonSize < json.size() / 3);
+
+    TEST_CASE("a run takes 258-byte matches");
+    std::string run(10000, 'a');
+    size_t runSize = roundTrip(run);
+    // One literal, then a length-258/distance-1 pair (8 + 5 bits) per 258 bytes
+    size_t pairs = (run.size() - 1 + 257) / 258;
+    printf("     %zu byte run -> %zu (%zu pairs)\n", run.size(), runSize, pairs);
+    CHECK(runSize <= GZIP_OVERHEAD + 1 + (pairs * 13 + 7) / 8 + 1);
+
+    TEST_CASE("258-byte matches at a long distance");
+    std::string block = noise(600, 1);
+    std::string repeated;
+    for (int i = 0; i < 40; i++) repeated += block;
+    size_t repeatedSize = roundTrip(repeated);
+    printf("     600 bytes x 40 -> %zu\n", repeatedSize);
+    CHECK(repeatedSize < 600 + 600);
+
+    TEST_CASE("matches at the far edge of the window and just past it");
+    for (size_t period : { (size_t)DEFLATE_WINDOW_SIZE - 1, (size_t)DEFLATE_WINDOW_SIZE, (size_t)DEFLATE_WINDOW_SIZE + 1 }) {
+        std::string base = noise(period, (uint32_t)period);
+        std::string input = base + base + base + base.substr(0, 300);
+        size_t size = roundTrip(input);
+        printf("     period %zu -> %zu\n", period, size);
+        // Repeats within the window compress; ones beyond it cannot
+        if (period < DEFLATE_WINDOW_SIZE) CHECK(size < 2 * period);
+    }
+
+    TEST_CASE("incompressible input");
+    std::string random = noise(5 * DEFLATE_WINDOW_SIZE + 123, 99);
+    size_t randomSize = roundTrip(random);
+    printf("     %zu random bytes -> %zu\n", random.size(), randomSize);
+    // Fixed-code literals are 8 or 9 bits
+    CHECK(randomSize <= GZIP_OVERHEAD + (random.size() * 9 + 7) / 8);
+
+    TEST_CASE("a reused writer starts clean");
+    std::string first = compress(json, DeflateWriter::GZIP);
+    compress(random, DeflateWriter::ZLIB);
+    CHECK(compress(json, DeflateWriter::GZIP) == first);
+
+    return testResult();
+}
@@ -0,0 +1,234 @@
+// HistoryQuery over known series in the MR007 ring: BUCKETS and LTTB
+// checked point by point against a direct implementation of what
+// history_query.h describes, with samples on bucket edges, empty
+// buckets, LTTB's pass-through, and a range that starts before boot
+
+#include "host_test.h"
+#include "host_harness.h"
+#include "history_query.h"
+#include <math.h>
+#include <vector>
+
+struct Sample {
+    uint32_t t;
+    float v;
+};
+
+static std::vector<Sample> pushed;
+
+static void push(uint32_t t, float v) {
+    MR007Sample s = { t, 0.0f, 0, v };
+    beginDataUpdate();
+    sensorHistory.mr007.push(s);
+    endDataUpdate();
+    pushed.push_back({ t, v });
+}
+
+// Everything pushed with from <= t <= to, in wrapping millis() order
+static std::vector<Sample> inRange(uint32_t from, uint32_t to) {
+    std::vector<Sample> out;
+    for (const Sample& s : pushed) {
+        if ((int32_t)(s.t - from) >= 0 && (int32_t)(s.t - to) <= 0) out.push_back(s);
+    }
+    return out;
+}
+
+static std::vector<HistoryQuery::Point> run(HistoryQuery::Mode mode, uint32_t from, uint32_t to, uint16_t points) {
+    std::vector<HistoryQuery::Point> out;
+    HistoryQuery q;
+    if (!CHECK(q.begin("mr007", "lel_concentration", mode, from, to, points))) return out;
+    CHECK_EQ(q.getSamples(), (uint32_t)inRange(from, to).size());
+    HistoryQuery::Point p;
+    while (q.next(p) && out.size() <= HISTORY_MAX_POINTS) out.push_back(p);
+    return out;
+}
+
+// BUCKETS: `points` buckets of ceil(span / points) ms from `from`; a
+// bucket with samples gives its start, average, min, max and count
+static std::vector<HistoryQuery::Point> referenceBuckets(uint32_t from, uint32_t to, uint16_t points) {
+    std::vector<HistoryQuery::Point> out;
+    uint32_t span = to - from + 1;
+    uint32_t width = (span + points - 1) / points;
+    for (uint32_t offset = 0; offset < span; offset += width) {
+        uint32_t last = offset + width - 1 < span ? offset + width - 1 : span - 1;
+        std::vector<Sample> in = inRange(from + offset, from + last);
+        if (in.empty()) continue;
+        HistoryQuery::Point p = { from + offset, 0, in[0].v, in[0].v, (uint32_t)in.size() };
+        float sum = 0;
+        for (const Sample& s : in) {
+            sum += s.v;
+            p.min = fminf(p.min, s.v);
+            p.max = fmaxf(p.max, s.v);
+        }
+        p.value = sum / in.size();
+        out.push_back(p);
+    }
+    return out;
+}
+
+// LTTB as in Steinarsson's thesis, on the time between the first and
+// last samples split into points - 2 buckets of ceil(span / buckets) ms
+static std::vector<Sample> referenceLttb(uint32_t from, uint32_t to, uint16_t points) {
+    std::vector<Sample> in = inRange(from, to);
+    if (in.size() <= points) return in;
+
+    size_t buckets = points - 2;
+    uint32_t start = in.front().t + 1;
+    uint32_t span = in.back().t - in.front().t - 1;
+    uint32_t width = (span + buckets - 1) / buckets;
+    std::vector<std::vector<Sample>> bucket(buckets);
+    for (size_t i = 1; i + 1 < in.size(); i++) bucket[(in[i].t - start) / width].push_back(in[i]);
+
+    std::vector<Sample> out = { in.front() };
+    for (size_t b = 0; b < buckets; b++) {
+        if (bucket[b].empty()) continue;
+        double ct = (double)in.back().t;
+        double cv = in.back().v;
+        for (size_t next = b + 1; next < buckets; next++) {
+            if (bucket[next].empty()) continue;
+            double sumT = 0;
+            double sumV = 0;
+            for (const Sample& s : bucket[next]) {
+                sumT += s.t;
+                sumV += s.v;
+            }
+            ct = sumT / bucket[next].size();
+            cv = sumV / bucket[next].size();
+            break;
+        }
+        const Sample& a = out.back();
+        double best = -1;
+        Sample chosen = bucket[b][0];
+        for (const Sample& s : bucket[b]) {
+            double area = fabs((a.t - ct) * (s.v - a.v) - (a.t - (double)s.t) * (cv - a.v));
+            if (area > best) {
+                best = area;
+                chosen = s;
+            }
+        }
+        out.push_back(chosen);
+    }
+    out.push_back(in.back());
+    return out;
+}
+
+static void checkBuckets(uint32_t from, uint32_t to, uint16_t points) {
+    std::vector<HistoryQuery::Point> got = run(HistoryQuery::BUCKETS, from, to, points);
+    std::vector<HistoryQuery::Point> want = referenceBuckets(from, to, points);
+    CHECK_EQ(got.size(), want.size());
+    for (size_t i = 0; i < got.size() && i < want.size(); i++) {
+        CHECK_EQ(got[i].timestamp, want[i].timestamp);
+        CHECK_EQ(got[i].count, want[i].count);
+        CHECK_EQ(got[i].min, want[i].min);
+        CHECK_EQ(got[i].max, want[i].max);
+        CHECK_EQ(got[i].value, want[i].value);
+    }
+}
+
+static void checkLttb(uint32_t from, uint32_t to, uint16_t points) {
+    std::vector<HistoryQuery::Point> got = run(HistoryQuery::LTTB, from, to, points);
+    std::vector<Sample> want = referenceLttb(from, to, points);
+    CHECK_EQ(got.size(), want.size());
+    for (size_t i = 0; i < got.size() && i < want.size(); i++) {
+        CHECK_EQ(got[i].timestamp, want[i].t);
+        CHECK_EQ(got[i].value, want[i].v);
+        CHECK_EQ(got[i].count, 1u);
+    }
+}
+
+// Irregular but repeatable, so LTTB's choices are not ties
+static float wave(uint32_t i) {
+    return 20.0f + 10.0f * sinf(i * 0.37f) + 3.0f * sinf(i * 2.9f) + (float)((i * 7919u) % 13) * 0.25f;
+}
+
+int main() {
+    HostHarness::bootFirmware();
+    printf("     MR007 ring holds %zu samples\n", sensorHistory.mr007.getCapacity());
+
+    TEST_CASE("a range that starts before boot (from wraps below 0)");
+    uint32_t boot = millis();
+    for (uint32_t i = 0; i < 50; i++) push(boot + i * 100, wave(i));
+    uint32_t now = boot + 50 * 100;
+    uint32_t hourAgo = now - HISTORY_SECONDS * 1000;
+    CHECK((int32_t)hourAgo < 0);
+    std::vector<HistoryQuery::Point> all = run(HistoryQuery::BUCKETS, hourAgo, now, HISTORY_DEFAULT_POINTS);
+    uint32_t counted = 0;
+    for (const HistoryQuery::Point& p : all) counted += p.count;
+    CHECK_EQ(counted, 50u);
+    checkBuckets(hourAgo, now, HISTORY_DEFAULT_POINTS);
+    checkLttb(hourAgo, now, 12);
+    checkLttb(hourAgo, now, 50);
+
+    TEST_CASE("BUCKETS: samples on every bucket edge go to the bucket they start");
+    uint32_t t0 = boot + 100000;
+    for (uint32_t i = 0; i < 100; i++) push(t0 + i * 100, wave(i + 1000));
+    std::vector<HistoryQuery::Point> tens = run(HistoryQuery::BUCKETS, t0, t0 + 9999, 10);
+    CHECK_EQ(tens.size(), (size_t)10);
+    for (size_t i = 0; i < tens.size(); i++) {
+        CHECK_EQ(tens[i].timestamp, t0 + (uint32_t)i * 1000);
+        CHECK_EQ(tens[i].count, 10u);
+    }
+    checkBuckets(t0, t0 + 9999, 10);
+    checkBuckets(t0, t0 + 9999, 3);         // Uneven split; the last bucket is short
+    checkBuckets(t0, t0 + 9999, 7);
+    checkBuckets(t0 + 50, t0 + 9900, 9);    // Both ends on a sample
+    checkBuckets(t0, t0 + 9999, 1);
+
+    TEST_CASE("BUCKETS: the range end is inclusive, one ms later is not");
+    std::vector<HistoryQuery::Point> edge = run(HistoryQuery::BUCKETS, t0 + 100, t0 + 200, 1);
+    CHECK(edge.size() == 1 && edge[0].count == 2);
+    edge = run(HistoryQuery::BUCKETS, t0 + 101, t0 + 199, 1);
+    CHECK(edge.empty());
+
+    TEST_CASE("BUCKETS: empty buckets give no point");
+    uint32_t t1 = t0 + 20000;
+    for (uint32_t i = 0; i < 10; i++) push(t1 + i * 100, 1.0f + i);
+    for (uint32_t i = 0; i < 10; i++) push(t1 + 5000 + i * 100, 50.0f + i);
+    std::vector<HistoryQuery::Point> gap = run(HistoryQuery::BUCKETS, t1, t1 + 5999, 6);
+    CHECK_EQ(gap.size(), (size_t)2);
+    if (gap.size() == 2) {
+        CHECK_EQ(gap[0].timestamp, t1);
+        CHECK_EQ(gap[0].value, 5.5f);
+        CHECK_EQ(gap[1].timestamp, t1 + 5000);
+        CHECK_EQ(gap[1].min, 50.0f);
+        CHECK_EQ(gap[1].max, 59.0f);
+    }
+    checkBuckets(t1, t1 + 5999, 6);
+    CHECK(run(HistoryQuery::BUCKETS, t1 + 1000, t1 + 4999, 4).empty());
+
+    TEST_CASE("LTTB: no more samples than points come back as they are");
+    std::vector<HistoryQuery::Point> same = run(HistoryQuery::LTTB, t0, t0 + 9999, 100);
+    std::vector<Sample> want = inRange(t0, t0 + 9999);
+    CHECK_EQ(same.size(), want.size());
+    for (size_t i = 0; i < same.size() && i < want.size(); i++) {
+        CHECK_EQ(same[i].timestamp, want[i].t);
+        CHECK_EQ(same[i].value, want[i].v);
+        CHECK_EQ(same[i].min, want[i].v);
+        CHECK_EQ(same[i].max, want[i].v);
+    }
+    CHECK_EQ(run(HistoryQuery::LTTB, t0, t0 + 9999, 1000).size(), (size_t)100);
+
+    TEST_CASE("LTTB: the reference implementation's choice in every bucket");
+    checkLttb(t0, t0 + 9999, 10);
+    checkLttb(t0, t0 + 9999, 25);
+    checkLttb(t0, t0 + 9999, 99);
+    checkLttb(t0, t1 + 5999, 8);            // Buckets across the gap are empty
+    checkLttb(t0 + 50, t0 + 9950, 3);       // One bucket between first and last
+
+    TEST_CASE("LTTB: a single spike survives");
+    uint32_t t2 = t1 + 20000;
+    for (uint32_t i = 0; i < 300; i++) push(t2 + i * 100, i == 137 ? 90.0f : 10.0f + (i % 3) * 0.1f);
+    std::vector<HistoryQuery::Point> spike = run(HistoryQuery::LTTB, t2, t2 + 29999, 20);
+    CHECK_EQ(spike.size(), (size_t)20);
+    bool kept = false;
+    for (const HistoryQuery::Point& p : spike) kept = kept || (p.timestamp == t2 + 13700 && p.value == 90.0f);
+    CHECK(kept);
+    checkLttb(t2, t2 + 29999, 20);
+
+    TEST_CASE("unknown series");
+    HistoryQuery q;
+    CHECK(!q.begin("mr007", "no_such_field", HistoryQuery::BUCKETS, t0, t2, 10));
+    CHECK(!q.begin("ze40", "ppm", HistoryQuery::LTTB, t0, t2, 10));
+
+    return testResult();
+}
@@ -0,0 +1,183 @@
+// RollingStats fed a known sequence across slice boundaries: every
+// window's count, min, max, mean and standard deviation checked after
+// each reading against a direct computation over the slices
+// rolling_stats.h says the window covers, slices reused a full window
+// later, windows emptying once their readings expire, and the
+// writeRollingStats() output in both encodings
+
+#include "host_test.h"
+#include "host_harness.h"
+#include "cbor_writer.h"
+#include "json_writer.h"
+#include <math.h>
+#include <vector>
+
+struct Reading {
+    uint32_t t;
+    float v;
+};
+
+static std::vector<Reading> fed;
+
+static void feed(uint32_t t, float v) {
+    rollingStats.add(ROLLING_zphs01b_co2, t, v);
+    fed.push_back({ t, v });
+}
+
+static uint32_t sliceMs(uint8_t window) {
+    return RollingStats::windowSeconds(window) * 1000 / ROLLING_BUCKETS;
+}
+
+// Readings in the slice `now` falls in and the ROLLING_BUCKETS - 1 before it
+static std::vector<Reading> inWindow(uint8_t window, uint32_t now) {
+    std::vector<Reading> out;
+    uint32_t current = now / sliceMs(window);
+    for (const Reading& r : fed) {
+        if (current - r.t / sliceMs(window) < ROLLING_BUCKETS) out.push_back(r);
+    }
+    return out;
+}
+
+// Readings taken less than `ms` before now
+static uint32_t youngerThan(uint32_t ms, uint32_t now) {
+    uint32_t count = 0;
+    for (const Reading& r : fed) count += now - r.t < ms;
+    return count;
+}
+
+static bool near(float got, double want) {
+    return fabs(got - want) <= 1e-4 * fmax(1.0, fabs(want));
+}
+
+static void checkWindows(uint32_t now) {
+    for (uint8_t window = 0; window < RollingStats::windowCount(); window++) {
+        std::vector<Reading> in = inWindow(window, now);
+        RollingSummary s;
+        bool any = rollingStats.get(ROLLING_zphs01b_co2, window, now, s);
+        CHECK_EQ(any, !in.empty());
+        CHECK_EQ(s.count, (uint32_t)in.size());
+
+        // The window slides a slice at a time: it always covers the last
+        // window - slice ms and never reaches a full window back
+        uint32_t span = RollingStats::windowSeconds(window) * 1000;
+        CHECK(s.count >= youngerThan(span - sliceMs(window), now));
+        CHECK(s.count <= youngerThan(span, now));
+        if (in.empty()) continue;
+
+        double sum = 0;
+        float min = in[0].v;
+        float max = in[0].v;
+        for (const Reading& r : in) {
+            sum += r.v;
+            min = fminf(min, r.v);
+            max = fmaxf(max, r.v);
+        }
+        double mean = sum / in.size();
+        double squares = 0;
+        for (const Reading& r : in) squares += (r.v - mean) * (r.v - mean);
+        double stddev = in.size() > 1 ? sqrt(squares / (in.size() - 1)) : 0.0;
+
+        CHECK_EQ(s.min, min);
+        CHECK_EQ(s.max, max);
+        if (!near(s.mean, mean) || !near(s.stddev, stddev)) {
+            CHECK(near(s.mean, mean));
+            CHECK(near(s.stddev, stddev));
+            printf("     window %u at %u: mean %f (want %f), stddev %f (want %f)\n",
+                   window, now, s.mean, mean, s.stddev, stddev);
+        }
+    }
+}
+
+static std::string json(uint32_t now) {
+    char buffer[512];
+    JsonWriter w(buffer, sizeof(buffer));
+    w.beginObject();
+    writeRollingStats(w, now);
+    w.endObject();
+    return std::string(buffer, w.length());
+}
+
+static std::string cbor(uint32_t now) {
+    static const char DIGITS[] = "0123456789abcdef";
+    uint8_t buffer[256];
+    CborWriter w(buffer, sizeof(buffer));
+    w.beginObject();
+    writeRollingStats(w, now);
+    w.endObject();
+    std::string out;
+    for (size_t i = 0; w.ok() && i < w.length(); i++) {
+        out += DIGITS[buffer[i] >> 4];
+        out += DIGITS[buffer[i] & 0xF];
+    }
+    return w.ok() ? out : "overflow";
+}
+
+// Irregular but repeatable, around a CO2 level
+static float wave(uint32_t i) {
+    return 600.0f + 40.0f * sinf(i * 0.21f) + 15.0f * sinf(i * 1.7f) + (float)((i * 7919u) % 17);
+}
+
+int main() {
+    HostHarness::bootFirmware();
+
+    TEST_CASE("writeRollingStats: JSON and CBOR shape");
+    CHECK_EQ(json(1000), std::string("{\"stats\":{\"windows_s\":[60,300,3600]}}"));
+    for (int i = 1; i <= 4; i++) rollingStats.add(ROLLING_mr007_lel, 1000, (float)i);
+    // Mean and stddev one decimal past the field's, min and max at it
+    CHECK_EQ(json(1000), std::string("{\"stats\":{\"windows_s\":[60,300,3600],\"mr007\":{\"lel_concentration\":["
+                                     "[2.50,1.0,4.0,1.29,4],[2.50,1.0,4.0,1.29,4],[2.50,1.0,4.0,1.29,4]]}}}"));
+    // {8: {0: [60, 300, 3600], 18: {2: [[2.5, 1.0, 4.0, 1.29, 4], ...]}}}
+    CHECK_EQ(cbor(1000), std::string("bf08bf009f183c19012c190e10ff12bf029f"
+                                     "9ff94100f93c00f94400fa3fa51eb804ff"
+                                     "9ff94100f93c00f94400fa3fa51eb804ff"
+                                     "9ff94100f93c00f94400fa3fa51eb804ff"
+                                     "ffffffff"));
+
+    TEST_CASE("writeRollingStats: expired windows are null, then the field goes");
+    CHECK_EQ(json(61000), std::string("{\"stats\":{\"windows_s\":[60,300,3600],\"mr007\":{\"lel_concentration\":["
+                                      "null,[2.50,1.0,4.0,1.29,4],[2.50,1.0,4.0,1.29,4]]}}}"));
+    CHECK_EQ(cbor(301000), std::string("bf08bf009f183c19012c190e10ff12bf029f"
+                                       "f6f6"
+                                       "9ff94100f93c00f94400fa3fa51eb804ff"
+                                       "ffffffff"));
+    CHECK_EQ(json(3601000), std::string("{\"stats\":{\"windows_s\":[60,300,3600]}}"));
+
+    TEST_CASE("a known sequence across slice boundaries, checked after every reading");
+    // 700 ms apart, so readings land at every offset into a slice; long
+    // enough for the 5 min window to slide all the way
+    uint32_t start = 4000000 + 1234;
+    for (uint32_t i = 0; i < 600; i++) {
+        uint32_t t = start + i * 700;
+        feed(t, wave(i));
+        checkWindows(t);
+        checkWindows(t + 350);
+    }
+    uint32_t last = fed.back().t;
+
+    TEST_CASE("one reading a full window later starts the reused slice afresh");
+    feed(last + 60000, 1000.0f);
+    RollingSummary s;
+    CHECK(rollingStats.get(ROLLING_zphs01b_co2, 0, last + 60000, s));
+    CHECK_EQ(s.count, 1u);
+    CHECK_EQ(s.mean, 1000.0f);
+    CHECK_EQ(s.stddev, 0.0f);
+    checkWindows(last + 60000);
+    last += 60000;
+
+    TEST_CASE("NaN readings are ignored");
+    rollingStats.add(ROLLING_zphs01b_co2, last, NAN);
+    checkWindows(last);
+
+    TEST_CASE("each window empties once its last reading is a window old");
+    for (uint8_t window = 0; window < RollingStats::windowCount(); window++) {
+        uint32_t expiry = last - last % sliceMs(window) + ROLLING_BUCKETS * sliceMs(window);
+        CHECK(rollingStats.get(ROLLING_zphs01b_co2, window, expiry - 1, s));
+        CHECK(!rollingStats.get(ROLLING_zphs01b_co2, window, expiry, s));
+        CHECK_EQ(s.count, 0u);
+        checkWindows(expiry - 1);
+        checkWindows(expiry);
+    }
+    CHECK_EQ(json(last + 3600000), std::string("{\"stats\":{\"windows_s\":[60,300,3600]}}"));
+
+    return testResult();
+}
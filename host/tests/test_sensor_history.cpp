@@ -0,0 +1,83 @@
+// Readings come from the history rings: ZE40 UART and DAC samples are
+// kept apart, and snapshotData() reports only what was measured
+
+#include "host_test.h"
+#include "host_harness.h"
+#include "history_query.h"
+
+int main() {
+    HostHarness::bootFirmware();
+    SharedSensorData d;
+
+    TEST_CASE("no samples yet");
+    CHECK(snapshotData(d));
+    CHECK(!d.ze40_uart_valid);
+    CHECK(!d.ze40_analog_valid);
+    CHECK(!d.zphs01b_valid);
+    CHECK(!d.mr007_valid);
+    CHECK(!d.me4so2_valid);
+
+    TEST_CASE("a DAC read does not make a UART reading");
+    host::advanceMs(1000);
+    uint32_t dacAt = millis();
+    ZE40DacSample dac = { dacAt, 0.83f, 0.41f };
+    beginDataUpdate();
+    sensorHistory.ze40Dac.push(dac);
+    endDataUpdate();
+    CHECK(snapshotData(d));
+    CHECK(d.ze40_analog_valid);
+    CHECK(!d.ze40_uart_valid);
+    CHECK_EQ(d.ze40_dac_ppm, 0.41f);
+    CHECK_EQ(sensorHistory.ze40.size(), 0u);
+
+    TEST_CASE("a UART frame does not repeat the DAC reading");
+    host::advanceMs(1000);
+    uint32_t uartAt = millis();
+    ZE40Sample ze40 = { uartAt, 412.0f };
+    beginDataUpdate();
+    sensorHistory.ze40.push(ze40);
+    endDataUpdate();
+    CHECK(snapshotData(d));
+    CHECK(d.ze40_uart_valid);
+    CHECK_EQ(d.ze40_tvoc_ppb, 412.0f);
+    CHECK_EQ(d.ze40_tvoc_ppm, 0.412f);
+    CHECK_EQ(d.ze40_dac_ppm, 0.41f);
+    CHECK_EQ(sensorHistory.ze40Dac.size(), 1u);
+    CHECK_EQ((uint32_t)d.last_update, uartAt);
+
+    TEST_CASE("/history reads each ZE40 series from its own ring");
+    HistoryQuery q;
+    HistoryQuery::Point p;
+    CHECK(q.begin("ze40", "dac_ppm", HistoryQuery::BUCKETS, dacAt - 500, uartAt + 500, 1));
+    CHECK(q.next(p));
+    CHECK_EQ(p.count, 1u);
+    CHECK_EQ(p.value, 0.41f);
+    CHECK(q.begin("ze40", "tvoc_ppb", HistoryQuery::BUCKETS, dacAt - 500, uartAt + 500, 1));
+    CHECK(q.next(p));
+    CHECK_EQ(p.count, 1u);
+    CHECK_EQ(p.value, 412.0f);
+
+    TEST_CASE("the snapshot follows the newest sample of every ring");
+    host::advanceMs(1000);
+    {
+        SharedSensorData reading;
+        reading.ze40_tvoc_ppb = 500.0f;
+        reading.ze40_dac_voltage = 0.9f;
+        reading.ze40_dac_ppm = 0.5f;
+        reading.zphs01b_pm25 = 13;
+        reading.zphs01b_co2 = 640;
+        reading.mr007_lel = 1.5f;
+        reading.me4so2_so2 = 0.2f;
+        HostHarness::publishReading(reading, millis());
+    }
+    CHECK(snapshotData(d));
+    CHECK(d.ze40_uart_valid && d.ze40_analog_valid && d.zphs01b_valid && d.mr007_valid && d.me4so2_valid);
+    CHECK_EQ(d.ze40_tvoc_ppb, 500.0f);
+    CHECK_EQ(d.ze40_dac_ppm, 0.5f);
+    CHECK_EQ(d.zphs01b_co2, 640);
+    CHECK_EQ(d.mr007_lel, 1.5f);
+    CHECK_EQ(d.me4so2_so2, 0.2f);
+    CHECK_EQ((uint32_t)d.last_update, (uint32_t)millis());
+
+    return testResult();
+}
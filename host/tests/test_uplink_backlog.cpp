@@ -0,0 +1,125 @@
+// Backlog replay POSTs: the sizing pass, the compression pass and the
+// send must write the same bytes, even when the connect takes long
+// enough for the entries' "age_s" to change width. A live sample too
+// large to send is buffered and replays without its statistics.
+
+#include "host_test.h"
+#include "host_harness.h"
+#include "uplink_peer.h"
+
+static SharedSensorData reading(uint32_t i) {
+    SharedSensorData d;
+    d.ze40_tvoc_ppb = 400.0f + i;
+    d.ze40_uart_valid = true;
+    d.zphs01b_pm25 = 12;
+    d.zphs01b_co2 = 610;
+    d.zphs01b_valid = true;
+    strcpy(d.ip_address, "192.168.1.50");
+    d.network_ready = true;
+    return d;
+}
+
+// Fill two batches recorded at the same second, then move the clock so
+// that they are 9 s old: one digit in JSON, one byte in CBOR. A 16 s
+// connect would make them 25 s old: two digits, two bytes.
+static void bufferTwoBatches() {
+    BufferManager::clearBuffer();
+    uint32_t recorded = millis() / 1000;
+    for (uint32_t i = 0; i < 2 * BACKLOG_BATCH_SIZE; i++) {
+        CHECK(BufferManager::saveData(reading(i), recorded));
+    }
+    host::advanceMs((recorded + 9) * 1000 - millis() + 500);
+}
+
+static void checkBodies(UplinkPeer& peer, bool cbor) {
+    CHECK_EQ(peer.requests.size(), (size_t)BACKLOG_BATCHES_PER_DRAIN);
+    for (const UplinkPeer::Request& request : peer.requests) {
+        CHECK_EQ(request.cbor, cbor);
+        CHECK_EQ(request.body.size(), request.contentLength);
+
+        std::string body = request.body;
+        if (request.gzip) {
+            body.clear();
+            CHECK(UplinkPeer::inflateBody(request.body, body));
+        }
+        if (cbor) {
+            // Indefinite-length array, each entry's age_s (key, 9) one byte
+            CHECK(!body.empty() && (uint8_t)body.front() == 0x9F && (uint8_t)body.back() == 0xFF);
+        } else {
+            // The first batch is dated when it was sized, before the
+            // connect; the second after the first was acknowledged
+            CHECK(!body.empty() && body.front() == '[' && body.back() == ']');
+            std::string age = &request == &peer.requests.front() ? "\"age_s\":9," : "\"age_s\":25,";
+            size_t ages = 0;
+            for (size_t at = body.find("\"age_s\":"); at != std::string::npos; at = body.find("\"age_s\":", at + 1)) {
+                ages++;
+                CHECK_EQ(body.substr(at, age.size()), age);
+            }
+            CHECK_EQ(ages, (size_t)BACKLOG_BATCH_SIZE);
+        }
+    }
+}
+
+int main() {
+    HostHarness::bootFirmware();
+    DjangoClient::setServerURL("http://10.0.0.2:8000/api/sensors");
+
+    UplinkPeer peer;
+    peer.connectDelayMs = 16000;
+    peer.install();
+
+    TEST_CASE("JSON batch, 16 s connect");
+    HostHarness::uplinkUseCBOR(false);
+    bufferTwoBatches();
+    HostHarness::uplinkDrainBacklog();
+    checkBodies(peer, false);
+    CHECK_EQ(peer.connects, 1);
+    CHECK_EQ(BufferManager::getEntryCount(), (size_t)0);
+
+    #ifdef UPLINK_CBOR_ENABLED
+    TEST_CASE("CBOR batch, 16 s connect");
+    HostHarness::uplinkUseCBOR(true);
+    peer.requests.clear();
+    peer.connects = 0;
+    DjangoClient::setServerURL("http://10.0.0.2:8000/api/sensors");     // Drops the kept-alive socket
+    bufferTwoBatches();
+    HostHarness::uplinkDrainBacklog();
+    checkBodies(peer, true);
+    CHECK_EQ(peer.connects, 1);
+    CHECK_EQ(BufferManager::getEntryCount(), (size_t)0);
+    #endif
+
+    #ifdef ROLLING_STATS_ENABLED
+    TEST_CASE("a live sample too large for the payload buffer is buffered and replays");
+    // Nine-digit statistics for every field in every window overflow the JSON body
+    HostHarness::uplinkUseCBOR(false);
+    for (uint8_t field = 0; field < ROLLING_FIELD_COUNT; field++) {
+        rollingStats.add((RollingField)field, millis(), -987654321.0f);
+        rollingStats.add((RollingField)field, millis(), -123456789.0f);
+    }
+    char json[UPLINK_PAYLOAD_BUFFER_SIZE];
+    CHECK_EQ(HostHarness::buildJSONPayload(reading(0), millis(), json, sizeof(json)), (size_t)0);
+    BufferManager::clearBuffer();
+    peer.requests.clear();
+    DjangoClient::sendSensorData(reading(0), millis());
+    CHECK(peer.requests.empty());
+    CHECK_EQ(BufferManager::getEntryCount(), (size_t)1);
+    CHECK_EQ(HostHarness::uplinkOversized(), 1u);
+
+    HostHarness::uplinkDrainBacklog();
+    CHECK_EQ(peer.requests.size(), (size_t)1);
+    if (!peer.requests.empty()) {
+        std::string body = peer.requests[0].body;
+        if (peer.requests[0].gzip) {
+            body.clear();
+            CHECK(UplinkPeer::inflateBody(peer.requests[0].body, body));
+        }
+        CHECK(body.find("\"tvoc_ppb\":400") != std::string::npos);
+        CHECK(body.find("\"stats\"") == std::string::npos);
+    }
+    CHECK_EQ(BufferManager::getEntryCount(), (size_t)0);
+    #endif
+
+    peer.uninstall();
+    return testResult();
+}
@@ -0,0 +1,52 @@
+// UplinkQueue overflow: with UPLINK_POLICY_SPILL a full queue never
+// writes flash from push() (the sensor task); pop() on the uplink task
+// files the samples it has fallen behind on, oldest first
+
+#include "host_test.h"
+#include "host_harness.h"
+#include "uplink_queue.h"
+
+static SharedSensorData reading(uint32_t i) {
+    SharedSensorData d;
+    d.ze40_tvoc_ppb = (float)i;
+    d.ze40_uart_valid = true;
+    return d;
+}
+
+static uint32_t popped(UplinkQueue& queue) {
+    UplinkSample sample;
+    if (!CHECK(queue.pop(sample))) return UINT32_MAX;
+    return (uint32_t)sample.data.ze40_tvoc_ppb;
+}
+
+int main() {
+    HostHarness::bootFirmware();
+
+    #if UPLINK_QUEUE_POLICY == UPLINK_POLICY_SPILL
+    static UplinkQueue queue;
+    BufferManager::clearBuffer();
+
+    TEST_CASE("a full queue holds the latest sample without touching flash");
+    for (uint32_t i = 0; i < UPLINK_QUEUE_DEPTH; i++) CHECK(queue.push(reading(i)));
+    for (uint32_t i = UPLINK_QUEUE_DEPTH; i < UPLINK_QUEUE_DEPTH + 3; i++) CHECK(!queue.push(reading(i)));
+    CHECK_EQ(queue.depth(), (size_t)UPLINK_QUEUE_DEPTH);
+    CHECK_EQ(BufferManager::getEntryCount(), (size_t)0);
+
+    TEST_CASE("pop() spills until fewer than UPLINK_SPILL_DEPTH wait behind");
+    uint32_t live = UPLINK_QUEUE_DEPTH - UPLINK_SPILL_DEPTH;
+    CHECK_EQ(popped(queue), live);
+    CHECK_EQ(BufferManager::getEntryCount(), (size_t)live);
+    CHECK_EQ(queue.depth(), (size_t)(UPLINK_SPILL_DEPTH - 1));
+
+    TEST_CASE("the held sample goes ahead of the next push");
+    CHECK(queue.push(reading(100)));
+    while (queue.depth() > 2) popped(queue);
+    CHECK_EQ(popped(queue), (uint32_t)(UPLINK_QUEUE_DEPTH + 2));
+    CHECK_EQ(popped(queue), (uint32_t)100);
+    UplinkSample none;
+    CHECK(!queue.pop(none));
+    CHECK_EQ(BufferManager::getEntryCount(), (size_t)live + 1);     // The oldest of the five went to flash
+    #endif
+
+    return testResult();
+}
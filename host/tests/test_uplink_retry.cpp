@@ -0,0 +1,74 @@
+// Kept-alive uplink retries: a request on a reused socket is sent again
+// on a fresh one only when the server closed or reset it before sending
+// a byte of response. A timeout or a half-sent response is a failure,
+// since the server may already have the request.
+
+#include "host_test.h"
+#include "host_harness.h"
+#include "uplink_peer.h"
+
+static const char* BODY = "{\"ze40\":{\"tvoc_ppb\":412}}";
+
+// Opens the kept-alive socket with one answered request, then has the
+// peer answer the next one as `second` and the rest with OK
+static bool postAfterWarmup(UplinkPeer& peer, UplinkPeer::Reply second) {
+    peer.requests.clear();
+    peer.connects = 0;
+    DjangoClient::setServerURL("http://10.0.0.2:8000/api/sensors");     // Drops the kept-alive socket
+    peer.reply = [second](size_t index) { return index == 1 ? second : UplinkPeer::OK; };
+    CHECK(HostHarness::uplinkPost(BODY));
+    return HostHarness::uplinkPost(BODY);
+}
+
+int main() {
+    HostHarness::bootFirmware();
+
+    UplinkPeer peer;
+    peer.install();
+
+    #ifdef HTTP_KEEPALIVE_ENABLED
+    TEST_CASE("reused socket closed before answering: retried once");
+    uint32_t retries = HostHarness::uplinkStaleRetries();
+    CHECK(postAfterWarmup(peer, UplinkPeer::CLOSE));
+    CHECK_EQ(peer.requests.size(), (size_t)3);
+    CHECK_EQ(peer.connects, 2);
+    CHECK_EQ(HostHarness::uplinkStaleRetries(), retries + 1);
+
+    TEST_CASE("reused socket reset before answering: retried once");
+    retries = HostHarness::uplinkStaleRetries();
+    CHECK(postAfterWarmup(peer, UplinkPeer::RESET));
+    CHECK_EQ(peer.requests.size(), (size_t)3);
+    CHECK_EQ(peer.connects, 2);
+    CHECK_EQ(HostHarness::uplinkStaleRetries(), retries + 1);
+
+    TEST_CASE("reused socket that times out: not retried");
+    retries = HostHarness::uplinkStaleRetries();
+    uint32_t start = millis();
+    CHECK(!postAfterWarmup(peer, UplinkPeer::SILENT));
+    CHECK(millis() - start >= HTTP_RESPONSE_TIMEOUT);
+    CHECK_EQ(peer.requests.size(), (size_t)2);
+    CHECK_EQ(peer.connects, 1);
+    CHECK_EQ(HostHarness::uplinkStaleRetries(), retries);
+
+    TEST_CASE("reused socket closed partway through the response: not retried");
+    retries = HostHarness::uplinkStaleRetries();
+    CHECK(!postAfterWarmup(peer, UplinkPeer::PARTIAL));
+    CHECK_EQ(peer.requests.size(), (size_t)2);
+    CHECK_EQ(peer.connects, 1);
+    CHECK_EQ(HostHarness::uplinkStaleRetries(), retries);
+    #endif
+
+    TEST_CASE("fresh socket closed before answering: not retried");
+    peer.requests.clear();
+    peer.connects = 0;
+    DjangoClient::setServerURL("http://10.0.0.2:8000/api/sensors");
+    peer.reply = [](size_t) { return UplinkPeer::CLOSE; };
+    uint32_t staleBefore = HostHarness::uplinkStaleRetries();
+    CHECK(!HostHarness::uplinkPost(BODY));
+    CHECK_EQ(peer.requests.size(), (size_t)1);
+    CHECK_EQ(peer.connects, 1);
+    CHECK_EQ(HostHarness::uplinkStaleRetries(), staleBefore);
+
+    peer.uninstall();
+    return testResult();
+}
@@ -0,0 +1,102 @@
+// The dashboard page as a browser fetches it: gzip body that inflates to
+// web/index.html (so web_page.h is not stale), a Content-Length that
+// matches, the ETag answered with 304 in every If-None-Match form, and
+// nothing of the page without credentials
+
+#include "host_test.h"
+#include "host_harness.h"
+#include "web_page.h"
+#include "uplink_peer.h"
+#include <fstream>
+#include <sstream>
+#include <mbedtls/base64.h>
+
+static std::string basicAuth() {
+    std::string user = std::string(WEB_ADMIN_USERNAME) + ":" + WEB_ADMIN_PASSWORD;
+    unsigned char encoded[128];
+    size_t length = 0;
+    mbedtls_base64_encode(encoded, sizeof(encoded), &length, (const unsigned char*)user.data(), user.size());
+    return "Authorization: Basic " + std::string((const char*)encoded, length) + "\r\n";
+}
+
+// One request on its own connection, served to the end
+static std::string fetch(const std::string& headers) {
+    int socket = host::peerConnect(host::ETHERNET, "GET / HTTP/1.1\r\nHost: sensor\r\n" + headers + "\r\n");
+    for (int pass = 0; pass < 100 && (pass == 0 || !host::firmwareClosed(socket)); pass++) {
+        webServer.handleEthernetClient();
+        host::setSendWindow(socket, 2048);
+    }
+    CHECK(host::firmwareClosed(socket));
+    return host::peerReceived(socket);
+}
+
+static std::string header(const std::string& response, const std::string& name) {
+    size_t at = response.find("\r\n" + name + ": ");
+    if (at == std::string::npos) return "";
+    at += name.size() + 4;
+    return response.substr(at, response.find("\r\n", at) - at);
+}
+
+static std::string body(const std::string& response) {
+    size_t at = response.find("\r\n\r\n");
+    return at == std::string::npos ? "" : response.substr(at + 4);
+}
+
+static std::string readFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    std::ostringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
+
+int main() {
+    HostHarness::bootFirmware();
+    std::string sourceDir = __FILE__;
+    sourceDir.erase(sourceDir.rfind("/host/tests/"));
+
+    TEST_CASE("200 with the gzipped page, inflating to web/index.html");
+    std::string page = fetch(basicAuth());
+    CHECK(page.compare(0, 15, "HTTP/1.1 200 OK") == 0);
+    CHECK_EQ(header(page, "Content-Encoding"), std::string("gzip"));
+    CHECK_EQ(header(page, "Content-Length"), std::to_string(MAIN_PAGE_GZIP_LENGTH));
+    CHECK_EQ(header(page, "ETag"), std::string(MAIN_PAGE_ETAG));
+    CHECK_EQ(header(page, "Vary"), std::string("Accept-Encoding"));
+    CHECK(header(page, "Cache-Control").find("max-age=") != std::string::npos);
+    CHECK_EQ(body(page).size(), (size_t)MAIN_PAGE_GZIP_LENGTH);
+    std::string html;
+    CHECK(UplinkPeer::inflateBody(body(page), html));
+    std::string source = readFile(sourceDir + "/main/web/index.html");
+    CHECK(!source.empty());
+    CHECK_EQ(html.size(), (size_t)MAIN_PAGE_SOURCE_LENGTH);
+    CHECK(html == source);      // Otherwise rerun tools/build_web_page.py
+
+    TEST_CASE("If-None-Match with the current tag: 304, no body");
+    const char* matching[] = {
+        "If-None-Match: " MAIN_PAGE_ETAG "\r\n",
+        "If-None-Match: W/" MAIN_PAGE_ETAG "\r\n",
+        "If-None-Match: \"0000000000000000\", " MAIN_PAGE_ETAG "\r\n",
+        "If-None-Match: *\r\n",
+    };
+    for (const char* condition : matching) {
+        std::string response = fetch(basicAuth() + condition);
+        CHECK(response.compare(0, 27, "HTTP/1.1 304 Not Modified\r\n") == 0);
+        CHECK_EQ(header(response, "ETag"), std::string(MAIN_PAGE_ETAG));
+        CHECK(body(response).empty());
+    }
+    printf("     304 is %zu bytes against %zu for the page\n",
+           fetch(basicAuth() + matching[0]).size(), page.size());
+
+    TEST_CASE("a stale tag gets the whole page again");
+    std::string stale = fetch(basicAuth() + "If-None-Match: \"0000000000000000\"\r\n");
+    CHECK(stale == page);
+
+    TEST_CASE("without credentials: 401, even with the current tag");
+    for (const std::string& headers : { std::string(), std::string("If-None-Match: " MAIN_PAGE_ETAG "\r\n") }) {
+        std::string response = fetch(headers);
+        CHECK(response.compare(0, 12, "HTTP/1.1 401") == 0);
+        CHECK(response.find(MAIN_PAGE_ETAG) == std::string::npos);
+        CHECK(response.size() < MAIN_PAGE_GZIP_LENGTH);
+    }
+
+    return testResult();
+}
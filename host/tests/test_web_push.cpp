@@ -0,0 +1,185 @@
+// WebSocket push with clients on both interfaces. pushUpdates() runs on
+// the Ethernet task and, for WiFi clients, on the sensor task: whichever
+// takes a reading, the other interface's clients must get it too, and
+// with both running at once every frame must arrive whole and in order.
+// A WiFi client that stops reading costs the sensor task nothing.
+
+#include "host_test.h"
+#include "host_harness.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+static int wsConnect(host::Link link) {
+    std::string request = std::string("GET /ws HTTP/1.1\r\nHost: sensor\r\n"
+                                      "Upgrade: websocket\r\nConnection: Upgrade\r\n"
+                                      "Sec-WebSocket-Version: 13\r\n"
+                                      "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+                                      "X-API-Token: ") + API_ACCESS_TOKEN + "\r\n\r\n";
+    return host::peerConnect(link, request);
+}
+
+struct Pushed {
+    uint32_t seq;
+    bool full;
+};
+
+// Text frames after the 101 response; anything malformed fails the check
+static std::vector<Pushed> pushedFrames(int socket) {
+    std::vector<Pushed> frames;
+    std::string bytes = host::peerReceived(socket);
+    size_t at = bytes.find("\r\n\r\n");
+    if (!CHECK(bytes.compare(0, 12, "HTTP/1.1 101") == 0 && at != std::string::npos)) return frames;
+    at += 4;
+    while (at < bytes.size()) {
+        if (!CHECK(at + 2 <= bytes.size())) break;
+        uint8_t opcode = (uint8_t)bytes[at] & 0x0F;
+        size_t length = (uint8_t)bytes[at + 1] & 0x7F;
+        at += 2;
+        if (length == 126) {
+            if (!CHECK(at + 2 <= bytes.size())) break;
+            length = ((uint8_t)bytes[at] << 8) | (uint8_t)bytes[at + 1];
+            at += 2;
+        }
+        if (!CHECK(at + length <= bytes.size())) break;
+        std::string payload = bytes.substr(at, length);
+        at += length;
+        if (opcode != 0x1) continue;    // Pings
+
+        size_t seq = payload.find("\"seq\":");
+        if (!CHECK(payload.front() == '{' && payload.back() == '}' && seq != std::string::npos)) break;
+        frames.push_back({ (uint32_t)strtoul(payload.c_str() + seq + 6, nullptr, 10),
+                           payload.find("\"full\":true") != std::string::npos });
+    }
+    return frames;
+}
+
+// Every frame newer than the last; a delta only right after its base
+static bool inOrder(const std::vector<Pushed>& frames) {
+    for (size_t i = 0; i < frames.size(); i++) {
+        if (i == 0 && !frames[i].full) return false;
+        if (i > 0 && frames[i].seq <= frames[i - 1].seq) return false;
+        if (i > 0 && !frames[i].full && frames[i].seq != frames[i - 1].seq + 1) return false;
+    }
+    return true;
+}
+
+// The dashboard reads everything it was sent
+static void drain(std::initializer_list<int> sockets) {
+    for (int socket : sockets) host::setSendWindow(socket, 2048);
+}
+
+static SharedSensorData reading(uint32_t i) {
+    SharedSensorData d;
+    d.ze40_tvoc_ppb = 400.0f + i;
+    d.ze40_uart_valid = true;
+    d.zphs01b_co2 = 600.0f + i;
+    d.zphs01b_valid = true;
+    strcpy(d.ip_address, "192.168.1.50");
+    d.network_ready = true;
+    return d;
+}
+
+int main() {
+    HostHarness::bootFirmware();
+
+    TEST_CASE("the Ethernet task takes each reading; WiFi clients still get every push");
+    int eth = wsConnect(host::ETHERNET);
+    int wifi = wsConnect(host::WIFI);
+    const uint32_t READINGS = 8;
+    for (uint32_t i = 0; i < READINGS; i++) {
+        HostHarness::publishReading(reading(i), millis() / 1000);
+        host::advanceMs(WS_MIN_PUSH_INTERVAL_MS);
+        webServer.handleEthernetClient();
+        webServer.handleWiFiClient();
+        drain({ eth, wifi });
+    }
+    std::vector<Pushed> ethFrames = pushedFrames(eth);
+    std::vector<Pushed> wifiFrames = pushedFrames(wifi);
+    printf("     %zu frames on Ethernet, %zu on WiFi\n", ethFrames.size(), wifiFrames.size());
+    CHECK(ethFrames.size() >= READINGS - 1);
+    CHECK_EQ(wifiFrames.size(), ethFrames.size());
+    CHECK(inOrder(ethFrames));
+    CHECK(inOrder(wifiFrames));
+    size_t wifiDeltas = 0;
+    for (const Pushed& f : wifiFrames) wifiDeltas += !f.full;
+    CHECK_EQ(wifiDeltas, wifiFrames.size() - 1);
+
+    TEST_CASE("both tasks pushing at once: every frame whole and in order");
+    // WEB_MAX_WEBSOCKETS dashboards at a time
+    host::peerClose(eth);
+    host::peerClose(wifi);
+    webServer.handleEthernetClient();
+    webServer.handleWiFiClient();
+    CHECK_EQ(HostHarness::webActiveClients(), 0);
+    int eth2 = wsConnect(host::ETHERNET);
+    int wifi2 = wsConnect(host::WIFI);
+    std::atomic<bool> stop{false};
+    std::thread ethernetTask([&]() { while (!stop) webServer.handleEthernetClient(); });
+    std::thread sensorTask([&]() { while (!stop) webServer.handleWiFiClient(); });
+    for (uint32_t i = 0; i < 20; i++) {
+        HostHarness::publishReading(reading(100 + i), millis() / 1000);
+        host::advanceMs(WS_MIN_PUSH_INTERVAL_MS);
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        drain({ eth2, wifi2 });
+    }
+    stop = true;
+    ethernetTask.join();
+    sensorTask.join();
+    webServer.handleEthernetClient();
+    webServer.handleWiFiClient();
+    for (int socket : { eth2, wifi2 }) {
+        std::vector<Pushed> frames = pushedFrames(socket);
+        printf("     socket %d: %zu frames, last seq %u\n", socket, frames.size(),
+               frames.empty() ? 0 : frames.back().seq);
+        CHECK(frames.size() > 1);
+        CHECK(inOrder(frames));
+    }
+    CHECK_EQ(pushedFrames(eth2).back().seq, pushedFrames(wifi2).back().seq);
+
+    TEST_CASE("a WiFi dashboard that stops reading is skipped, never waited on");
+    host::peerClose(eth2);
+    host::peerClose(wifi2);
+    webServer.handleEthernetClient();
+    webServer.handleWiFiClient();
+    int awake = wsConnect(host::ETHERNET);
+    int asleep = wsConnect(host::WIFI);
+    webServer.handleEthernetClient();
+    webServer.handleWiFiClient();
+    drain({ awake, asleep });
+    size_t framesBefore = pushedFrames(asleep).size();
+    uint32_t droppedBefore = HostHarness::webPushesDropped();
+    host::setSendWindow(asleep, 0);
+    for (uint32_t i = 0; i < 6; i++) {
+        HostHarness::publishReading(reading(200 + i), millis() / 1000);
+        host::advanceMs(WS_MIN_PUSH_INTERVAL_MS);
+        webServer.handleWiFiClient();
+        webServer.handleEthernetClient();
+        drain({ awake });
+    }
+    CHECK_EQ(host::blockedWrites(asleep), (size_t)0);
+    CHECK_EQ(pushedFrames(asleep).size(), framesBefore);
+    CHECK(!host::firmwareClosed(asleep));
+    CHECK(HostHarness::webPushesDropped() > droppedBefore);
+    CHECK(pushedFrames(awake).size() >= 6);
+    CHECK(inOrder(pushedFrames(awake)));
+
+    TEST_CASE("awake again, it resyncs with a full frame");
+    host::setSendWindow(asleep, 2048);
+    webServer.handleWiFiClient();
+    std::vector<Pushed> resynced = pushedFrames(asleep);
+    CHECK_EQ(resynced.size(), framesBefore + 1);
+    CHECK(resynced.back().full);
+    CHECK_EQ(resynced.back().seq, pushedFrames(awake).back().seq);
+    CHECK(inOrder(resynced));
+
+    TEST_CASE("a frame the socket takes only part of closes the client");
+    host::setSendWindow(asleep, 10);
+    HostHarness::publishReading(reading(300), millis() / 1000);
+    host::advanceMs(WS_MIN_PUSH_INTERVAL_MS);
+    webServer.handleWiFiClient();
+    CHECK(host::firmwareClosed(asleep));
+    CHECK_EQ(host::blockedWrites(asleep), (size_t)0);
+
+    return testResult();
+}
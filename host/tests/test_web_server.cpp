@@ -0,0 +1,157 @@
+// SensorWebServer connection limits: the W5500 socket budget holds with
+// the uplink open and every slot taken, open dashboards leave slots for
+// HTTP, and a WiFi client is written at most WEB_WRITE_CHUNK per pass, so
+// lwIP never holds up the loop waiting for a slow reader, nor does a
+// /history response outgrow the room the W5500 has
+
+#include "host_test.h"
+#include "host_harness.h"
+#include "uplink_peer.h"
+#include "web_page.h"
+#include <mbedtls/base64.h>
+
+static std::string basicAuth() {
+    std::string user = std::string(WEB_ADMIN_USERNAME) + ":" + WEB_ADMIN_PASSWORD;
+    unsigned char encoded[128];
+    size_t length = 0;
+    mbedtls_base64_encode(encoded, sizeof(encoded), &length, (const unsigned char*)user.data(), user.size());
+    return std::string((const char*)encoded, length);
+}
+
+static std::string wsRequest() {
+    return std::string("GET /ws HTTP/1.1\r\nHost: sensor\r\n"
+                       "Upgrade: websocket\r\nConnection: Upgrade\r\n"
+                       "Sec-WebSocket-Version: 13\r\n"
+                       "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+                       "X-API-Token: ") + API_ACCESS_TOKEN + "\r\n\r\n";
+}
+
+int main() {
+    HostHarness::bootFirmware();
+    DjangoClient::setServerURL("http://10.0.0.2:8000/api/sensors");
+
+    TEST_CASE("every slot taken with the uplink open: the rest get 503, DNS still gets a socket");
+    UplinkPeer uplink;
+    uplink.install();
+    CHECK(HostHarness::uplinkPost("{}"));
+    int clients[MAX_CONCURRENT_CONNECTIONS + 2];
+    for (int& socket : clients) socket = host::peerConnect(host::ETHERNET);
+    webServer.handleEthernetClient();
+    CHECK_EQ(HostHarness::webActiveClients(), MAX_CONCURRENT_CONNECTIONS);
+    for (int i = 0; i < MAX_CONCURRENT_CONNECTIONS + 2; i++) {
+        bool refused = i >= MAX_CONCURRENT_CONNECTIONS;
+        CHECK_EQ(host::peerReceived(clients[i]).find("503") != std::string::npos, refused);
+        CHECK_EQ(host::firmwareClosed(clients[i]), refused);
+    }
+    // Listener, uplink and the slots; one for DNS and one for a 503 spare
+    printf("     %u of %d W5500 sockets in use\n", host::ethernetSocketsInUse(), MAX_SOCK_NUM);
+    CHECK_EQ(host::ethernetSocketsInUse(), 2 + MAX_CONCURRENT_CONNECTIONS);
+    EthernetUDP dns;
+    CHECK(dns.begin(53) == 1);
+    dns.stop();
+
+    // Nothing was asked for; the idle slots time out
+    host::advanceMs(WEB_REQUEST_TIMEOUT + 1);
+    webServer.handleEthernetClient();
+    CHECK_EQ(HostHarness::webActiveClients(), 0);
+    uplink.uninstall();
+
+    TEST_CASE("every WebSocket slot taken: /data is still served");
+    int dashboards[WEB_MAX_WEBSOCKETS + 1];
+    for (int& socket : dashboards) socket = host::peerConnect(host::ETHERNET, wsRequest());
+    webServer.handleEthernetClient();
+    for (int i = 0; i <= WEB_MAX_WEBSOCKETS; i++) {
+        std::string reply = host::peerReceived(dashboards[i]);
+        CHECK(reply.compare(0, 12, i < WEB_MAX_WEBSOCKETS ? "HTTP/1.1 101" : "HTTP/1.1 503") == 0);
+    }
+    std::string poll = std::string("GET /data HTTP/1.1\r\nHost: sensor\r\nX-API-Token: ") + API_ACCESS_TOKEN + "\r\n\r\n";
+    int data = host::peerConnect(host::ETHERNET, poll);
+    webServer.handleEthernetClient();
+    CHECK(host::peerReceived(data).compare(0, 15, "HTTP/1.1 200 OK") == 0);
+    CHECK(host::firmwareClosed(data));
+    for (int i = 0; i < WEB_MAX_WEBSOCKETS; i++) host::peerClose(dashboards[i]);
+    webServer.handleEthernetClient();
+    CHECK_EQ(HostHarness::webActiveClients(), 0);
+
+    TEST_CASE("the page goes to a slow WiFi client a chunk per pass, never blocking");
+    std::string request = "GET / HTTP/1.1\r\nHost: sensor\r\nAuthorization: Basic " + basicAuth() + "\r\n\r\n";
+    int wifi = host::peerConnect(host::WIFI, request);
+    host::setSendWindow(wifi, 2000);
+    size_t received = 0;
+    size_t bodyBefore = 0;
+    size_t largestPass = 0;
+    int passes = 0;
+    // Until the firmware has accepted the socket and closed it again
+    while ((passes == 0 || !host::firmwareClosed(wifi)) && passes < 100) {
+        webServer.handleWiFiClient();
+        std::string sofar = host::peerReceived(wifi);
+        // Body bytes only; the headers go out on the pass that routes the request
+        size_t headerEnd = sofar.find("\r\n\r\n");
+        size_t body = headerEnd == std::string::npos ? 0 : sofar.size() - headerEnd - 4;
+        if (body - bodyBefore > largestPass) largestPass = body - bodyBefore;
+        bodyBefore = body;
+        host::peerRead(wifi, sofar.size() - received);
+        received = sofar.size();
+        passes++;
+    }
+    std::string response = host::peerReceived(wifi);
+    size_t headerEnd = response.find("\r\n\r\n");
+    printf("     %zu bytes in %d passes, at most %zu per pass\n", response.size(), passes, largestPass);
+    CHECK(response.compare(0, 15, "HTTP/1.1 200 OK") == 0);
+    CHECK(headerEnd != std::string::npos &&
+          response.compare(headerEnd + 4, std::string::npos,
+                           (const char*)MAIN_PAGE_GZIP, MAIN_PAGE_GZIP_LENGTH) == 0);
+    CHECK(largestPass <= WEB_WRITE_CHUNK);
+    CHECK_EQ(host::blockedWrites(wifi), (size_t)0);
+
+    TEST_CASE("/history never writes more than the socket has room for");
+    // Four-decimal voltages make the widest BUCKETS rows; a pass gets
+    // little more than WEB_WRITE_CHUNK of room, fewer than 16 of them
+    host::advanceMs(700000);
+    for (uint32_t i = 0; i < 300; i++) {
+        ME4SO2Sample sample = { millis() - 600000 + i * 2000, -0.1234f - i * 0.0011f, 0, 0, 0 };
+        beginDataUpdate();
+        sensorHistory.me4so2.push(sample);
+        endDataUpdate();
+    }
+    std::string query = std::string("GET /history?sensor=me4_so2&field=voltage&from=600&to=0&points=300 HTTP/1.1\r\n"
+                                    "Host: sensor\r\nX-API-Token: ") + API_ACCESS_TOKEN + "\r\n\r\n";
+    int eth = host::peerConnect(host::ETHERNET, query);
+    const size_t room = WEB_WRITE_CHUNK + 80;
+    received = 0;
+    size_t largestWrite = 0;
+    passes = 0;
+    while ((passes == 0 || !host::firmwareClosed(eth)) && passes < 200) {
+        webServer.handleEthernetClient();
+        std::string sofar = host::peerReceived(eth);
+        // The first pass routes the request and writes the preamble
+        if (passes > 0 && sofar.size() - received > largestWrite) largestWrite = sofar.size() - received;
+        received = sofar.size();
+        host::setSendWindow(eth, room);
+        passes++;
+    }
+    response = host::peerReceived(eth);
+    printf("     %zu bytes in %d passes, at most %zu per pass\n", response.size(), passes, largestWrite);
+    CHECK(host::firmwareClosed(eth));
+    CHECK(largestWrite <= room);
+    CHECK_EQ(host::blockedWrites(eth), (size_t)0);
+
+    // Every sample is counted in a bucket, and the body ends cleanly
+    std::string body;
+    size_t at = response.find("\r\n\r\n") + 4;
+    while (at < response.size()) {
+        size_t length = strtoul(response.c_str() + at, nullptr, 16);
+        at = response.find("\r\n", at) + 2;
+        body.append(response, at, length);
+        at += length + 2;
+    }
+    unsigned long counted = 0;
+    size_t rowEnd = body.find("\"points\":[");
+    while ((rowEnd = body.find(']', rowEnd + 1)) != std::string::npos && body[rowEnd - 1] != ']') {
+        counted += strtoul(body.c_str() + body.rfind(',', rowEnd) + 1, nullptr, 10);
+    }
+    CHECK_EQ(counted, 300ul);
+    CHECK(body.size() > 3 && body.compare(body.size() - 3, 3, "]]}") == 0);
+
+    return testResult();
+}
@@ -0,0 +1,134 @@
+// ZPHS01BSensor::processByte() on clean and damaged streams: every frame
+// the sensor got across is parsed, and the parser is back in step by the
+// first intact frame after the damage. The only way to lose an intact
+// frame is a false header in the damage passing the checksum.
+
+#include "host_test.h"
+#include "host_harness.h"
+#include "zphs01b_stream.h"
+
+using namespace zphs01b_stream;
+
+struct ReplayResult {
+    uint32_t parsed;        // Frames out of the parser
+    uint32_t lost;          // Frames that went out intact but did not come out
+    uint32_t phantoms;      // Frames out of the parser that were never sent
+};
+
+// Feed a stream and match what comes out against what was sent. A
+// damaged frame may still come out whole (a stray byte that happens to
+// equal the checksum it displaced); a phantom is a false header whose
+// 1-in-256 checksum happened to match.
+static ReplayResult replay(const UartCapture& stream) {
+    ReplayResult result = {0, 0, 0};
+    const std::vector<FrameRecord>& sent = stream.frames();
+    size_t next = 0;
+    UartFrame frame;
+    for (uint8_t byte : stream.bytes()) {
+        if (!HostHarness::zphs01bProcessByte(byte)) continue;
+        while (HostHarness::zphs01bPopFrame(frame)) {
+            result.parsed++;
+            size_t match = next;
+            while (match < sent.size() && match < next + 4 &&
+                   memcmp(frame.bytes, sent[match].bytes, RESPONSE_LENGTH) != 0) {
+                match++;
+            }
+            if (match == sent.size() || match == next + 4) {
+                result.phantoms++;
+                continue;
+            }
+            for (; next < match; next++) result.lost += UartCapture::delivers(sent[next].damage);
+            next = match + 1;
+        }
+    }
+    for (; next < sent.size(); next++) result.lost += UartCapture::delivers(sent[next].damage);
+    return result;
+}
+
+int main() {
+    HostHarness::bootFirmware();
+    zphs01bSensor.init();
+
+    TEST_CASE("a clean stream parses without a discarded byte");
+    {
+        HostHarness::zphs01bResetParser();
+        UartCapture stream(500);
+        ReplayResult r = replay(stream);
+        CHECK_EQ(r.parsed, 500u);
+        CHECK_EQ(r.lost, 0u);
+        HostHarness::ParserCounters c = HostHarness::zphs01bCounters();
+        CHECK_EQ(c.framesOk, 500u);
+        CHECK_EQ(c.checksumErrors, 0u);
+        CHECK_EQ(c.bytesDiscarded, 0u);
+    }
+
+    TEST_CASE("each kind of damage costs only the damaged frame, phantoms aside");
+    for (int kind = DROP_BYTE; kind < DAMAGE_KINDS; kind++) {
+        for (uint32_t seed = 0; seed < 200; seed++) {
+            HostHarness::zphs01bResetParser();
+            UartCapture stream(4, seed * 4);
+            stream.damage(1, (Damage)kind);
+            stream.render(seed);
+            ReplayResult r = replay(stream);
+            if (!CHECK(r.lost <= r.phantoms)) {
+                printf("     %s, seed %u\n", damageName((Damage)kind), seed);
+                break;
+            }
+        }
+    }
+
+    TEST_CASE("a corrupt payload byte is one checksum error and one resync");
+    {
+        HostHarness::zphs01bResetParser();
+        uint8_t frames[3][RESPONSE_LENGTH];
+        for (int f = 0; f < 3; f++) buildFrame(frames[f], 20 + f);
+        frames[1][9] ^= 0x10;
+        int parsed = 0;
+        for (int f = 0; f < 3; f++) {
+            for (int b = 0; b < RESPONSE_LENGTH; b++) {
+                if (HostHarness::zphs01bProcessByte(frames[f][b])) parsed += HostHarness::zphs01bTakeFrames();
+            }
+        }
+        CHECK_EQ(parsed, 2);
+        HostHarness::ParserCounters c = HostHarness::zphs01bCounters();
+        CHECK_EQ(c.framesOk, 2u);
+        CHECK_EQ(c.checksumErrors, 1u);
+        CHECK_EQ(c.resyncs, 1u);
+        CHECK_EQ(c.bytesDiscarded, (uint32_t)RESPONSE_LENGTH);
+        CHECK_EQ(c.maxResyncBytes, (uint32_t)RESPONSE_LENGTH);
+    }
+
+    TEST_CASE("a long replay with one frame in four damaged");
+    {
+        HostHarness::zphs01bResetParser();
+        UartCapture stream(5000);
+        stream.damageRandomly(4, 1234);
+        stream.render(1234);
+        ReplayResult r = replay(stream);
+        printf("     %u frames sent whole, %u parsed, %u lost, %u phantom\n",
+               stream.delivered(), r.parsed, r.lost, r.phantoms);
+        CHECK(r.lost <= r.phantoms);
+        CHECK(r.phantoms * 100 <= stream.delivered());
+        CHECK_EQ(HostHarness::zphs01bCounters().framesOk, r.parsed);
+    }
+
+    TEST_CASE("a partial frame is dropped after FRAME_TIMEOUT of silence");
+    {
+        HostHarness::zphs01bResetParser();
+        uint8_t first[RESPONSE_LENGTH];
+        uint8_t second[RESPONSE_LENGTH];
+        buildFrame(first, 10);
+        buildFrame(second, 11);
+        for (int b = 0; b < 10; b++) HostHarness::zphs01bProcessByte(first[b]);
+        host::advanceMs(FRAME_TIMEOUT + 1);
+        bool parsed = false;
+        for (int b = 0; b < RESPONSE_LENGTH; b++) parsed = HostHarness::zphs01bProcessByte(second[b]);
+        CHECK(parsed);
+        UartFrame frame;
+        CHECK(HostHarness::zphs01bPopFrame(frame));
+        CHECK(memcmp(frame.bytes, second, RESPONSE_LENGTH) == 0);
+        CHECK_EQ(HostHarness::zphs01bCounters().bytesDiscarded, 10u);
+    }
+
+    return testResult();
+}
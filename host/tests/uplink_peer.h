@@ -0,0 +1,131 @@
+#ifndef UPLINK_PEER_H
+#define UPLINK_PEER_H
+
+#include <stdlib.h>
+#include <string.h>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+#include <zlib.h>
+#include "host_control.h"
+
+/**
+ * UplinkPeer
+ *
+ * Plays the Django server for DjangoClient on the simulated sockets.
+ * Every connection the firmware opens is accepted (after
+ * connectDelayMs on the manual clock), each complete request is kept
+ * in `requests`, and answered as reply() decides.
+ */
+class UplinkPeer {
+public:
+    struct Request {
+        std::string head;           // Request line and headers
+        std::string body;           // As sent (compressed or not)
+        size_t contentLength;
+        bool gzip;
+        bool cbor;
+        int socket;
+    };
+
+    enum Reply {
+        OK,             // 200, connection kept open
+        CLOSE,          // FIN without a response
+        RESET,          // RST without a response
+        PARTIAL,        // Half a status line, then FIN
+        SILENT          // Never answers
+    };
+
+    uint32_t connectDelayMs = 0;
+    std::function<Reply(size_t index)> reply = [](size_t) { return OK; };
+
+    std::vector<Request> requests;
+    int connects = 0;
+
+    void install() {
+        host::setConnectHandler([this](int socket, IPAddress, uint16_t) {
+            connects++;
+            host::advanceMs(connectDelayMs);
+            pending[socket].clear();
+            host::setPollHandler(socket, [this](int s) { poll(s); });
+            return true;
+        });
+    }
+
+    void uninstall() {
+        host::setConnectHandler(nullptr);
+    }
+
+    /**
+     * Undo Content-Encoding: gzip
+     * @return false if the body is not exactly one gzip stream
+     */
+    static bool inflateBody(const std::string& body, std::string& out) {
+        z_stream z;
+        memset(&z, 0, sizeof(z));
+        if (inflateInit2(&z, 16 + MAX_WBITS) != Z_OK) return false;
+        z.next_in = (Bytef*)body.data();
+        z.avail_in = (uInt)body.size();
+        char chunk[4096];
+        int status;
+        do {
+            z.next_out = (Bytef*)chunk;
+            z.avail_out = sizeof(chunk);
+            status = inflate(&z, Z_NO_FLUSH);
+            out.append(chunk, sizeof(chunk) - z.avail_out);
+        } while (status == Z_OK);
+        bool whole = status == Z_STREAM_END && z.avail_in == 0;
+        inflateEnd(&z);
+        return whole;
+    }
+
+private:
+    std::map<int, std::string> pending;
+
+    void poll(int socket) {
+        std::string& in = pending[socket];
+        in += host::peerTake(socket);
+
+        while (true) {
+            size_t headEnd = in.find("\r\n\r\n");
+            if (headEnd == std::string::npos) return;
+            Request request;
+            request.head = in.substr(0, headEnd + 4);
+            request.contentLength = header(request.head, "Content-Length:");
+            if (in.size() < headEnd + 4 + request.contentLength) return;
+            request.body = in.substr(headEnd + 4, request.contentLength);
+            request.gzip = request.head.find("Content-Encoding: gzip") != std::string::npos;
+            request.cbor = request.head.find("application/cbor") != std::string::npos;
+            request.socket = socket;
+            in.erase(0, headEnd + 4 + request.contentLength);
+
+            Reply answer = reply(requests.size());
+            requests.push_back(request);
+            switch (answer) {
+                case OK:
+                    host::peerSend(socket, "HTTP/1.1 200 OK\r\nContent-Length: 0\r\nConnection: keep-alive\r\n\r\n");
+                    break;
+                case CLOSE:
+                    host::peerClose(socket);
+                    return;
+                case RESET:
+                    host::peerReset(socket);
+                    return;
+                case PARTIAL:
+                    host::peerSend(socket, "HTTP/1.1 2");
+                    host::peerClose(socket);
+                    return;
+                case SILENT:
+                    break;
+            }
+        }
+    }
+
+    static size_t header(const std::string& head, const char* name) {
+        size_t at = head.find(name);
+        return at == std::string::npos ? 0 : (size_t)strtoul(head.c_str() + at + strlen(name), nullptr, 10);
+    }
+};
+
+#endif
@@ -0,0 +1,207 @@
+#ifndef ZPHS01B_STREAM_H
+#define ZPHS01B_STREAM_H
+
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+#include "config.h"
+
+/**
+ * ZPHS01B UART streams for the parser test and benchmark
+ *
+ * A stream is the bytes the sensor would send over a run of readings,
+ * with a record of where every frame starts and whether it went out
+ * intact. The readings drift like an indoor room over a day (values and
+ * field layout as in processSensorData()), so the payload holds the
+ * 0xFF and 0x86 bytes a real capture does, not just quiet zeros.
+ *
+ * damage() and damageRandomly() spoil chosen frames the way a noisy line does: a byte
+ * lost, a bit flipped, a byte inserted, a frame cut short, a burst of
+ * noise. Everything is deterministic for a given seed.
+ */
+namespace zphs01b_stream {
+
+enum Damage : uint8_t {
+    INTACT,
+    DROP_BYTE,      // One byte of the frame is lost
+    FLIP_BIT,       // One bit of the frame is inverted
+    INSERT_BYTE,    // A stray byte appears inside the frame
+    TRUNCATE,       // The frame stops half way
+    NOISE,          // Random bytes, then the frame intact
+    DAMAGE_KINDS
+};
+
+inline const char* damageName(Damage damage) {
+    switch (damage) {
+        case INTACT:      return "intact";
+        case DROP_BYTE:   return "dropped byte";
+        case FLIP_BIT:    return "flipped bit";
+        case INSERT_BYTE: return "inserted byte";
+        case TRUNCATE:    return "truncated frame";
+        case NOISE:       return "noise burst";
+        default:          return "?";
+    }
+}
+
+struct FrameRecord {
+    uint32_t start;             // Offset of the first byte in the stream
+    uint32_t end;               // One past the last byte
+    Damage damage;
+    uint8_t bytes[RESPONSE_LENGTH];     // The frame as the sensor built it
+};
+
+// Small LCG, so that streams do not depend on the C library
+struct Random {
+    uint32_t state;
+    explicit Random(uint32_t seed) : state(seed) {}
+    uint32_t next() {
+        state = state * 1664525u + 1013904223u;
+        return state >> 8;
+    }
+    uint32_t below(uint32_t n) { return next() % n; }
+};
+
+/**
+ * Build reading i: the 0xFF 0x86 response to the read command
+ */
+inline void buildFrame(uint8_t frame[RESPONSE_LENGTH], uint32_t i) {
+    double t = i * (ZPHS01B_READ_INTERVAL / 1000.0) / 86400.0 * 2 * M_PI;
+    uint16_t pm25 = (uint16_t)(12 + 8 * sin(t) + (i % 5));
+    uint16_t values[] = {
+        (uint16_t)(pm25 * 2 / 3),                   // PM1.0
+        pm25,                                       // PM2.5
+        (uint16_t)(pm25 * 3 / 2),                   // PM10
+        (uint16_t)(600 + 250 * sin(t * 3) + (i % 7)),   // CO2 ppm
+    };
+    uint16_t temperature = (uint16_t)(234 + 25 * sin(t) + 500);     // (raw - 500) * 0.1 °C
+    uint16_t humidity = (uint16_t)(41 + 6 * cos(t));
+    uint16_t ch2o = (uint16_t)(12 + (i % 3));
+    uint16_t co = (uint16_t)(4 + (i % 2));                          // * 0.1 ppm
+    uint16_t o3 = (uint16_t)(2 + (i % 4));                          // * 0.01 ppm
+    uint16_t no2 = (uint16_t)(255 + (i % 2));                       // * 0.01 ppm; 0x00FF / 0x0100
+
+    memset(frame, 0, RESPONSE_LENGTH);
+    frame[0] = 0xFF;
+    frame[1] = 0x86;
+    for (int f = 0; f < 4; f++) {
+        frame[2 + 2 * f] = values[f] >> 8;
+        frame[3 + 2 * f] = values[f] & 0xFF;
+    }
+    frame[10] = (uint8_t)(i % 4);                                   // VOC grade
+    frame[11] = temperature >> 8;  frame[12] = temperature & 0xFF;
+    frame[13] = humidity >> 8;     frame[14] = humidity & 0xFF;
+    frame[15] = ch2o >> 8;         frame[16] = ch2o & 0xFF;
+    frame[17] = co >> 8;           frame[18] = co & 0xFF;
+    frame[19] = o3 >> 8;           frame[20] = o3 & 0xFF;
+    frame[21] = no2 >> 8;          frame[22] = no2 & 0xFF;
+
+    uint8_t sum = 0;
+    for (int b = 1; b < RESPONSE_LENGTH - 1; b++) sum += frame[b];
+    frame[RESPONSE_LENGTH - 1] = (uint8_t)(~sum + 1);
+}
+
+class UartCapture {
+public:
+    /**
+     * A run of `frames` readings starting at reading `first`, damage
+     * added with damage()
+     */
+    explicit UartCapture(uint32_t frames, uint32_t first = 0) {
+        records.resize(frames);
+        for (uint32_t i = 0; i < frames; i++) {
+            records[i].damage = INTACT;
+            buildFrame(records[i].bytes, first + i);
+        }
+        render(0);
+    }
+
+    // Damage frame `index`; takes effect at the next render()
+    void damage(uint32_t index, Damage kind) {
+        records[index].damage = kind;
+    }
+
+    // Damage about one frame in `every`, never two in a row, of kinds
+    // picked at random; takes effect at the next render()
+    void damageRandomly(uint32_t every, uint32_t seed) {
+        Random random(seed);
+        for (uint32_t i = 1; i < records.size(); i++) {
+            if (records[i - 1].damage == INTACT && random.below(every) == 0) {
+                records[i].damage = (Damage)(1 + random.below(DAMAGE_KINDS - 1));
+            }
+        }
+    }
+
+    /**
+     * Lay the frames out as bytes, applying their damage
+     */
+    void render(uint32_t seed) {
+        Random random(seed ^ 0x5EED);
+        data.clear();
+        for (FrameRecord& r : records) {
+            r.start = (uint32_t)data.size();
+            const uint8_t* f = r.bytes;
+            switch (r.damage) {
+                case INTACT:
+                    data.insert(data.end(), f, f + RESPONSE_LENGTH);
+                    break;
+                case DROP_BYTE: {
+                    uint32_t lost = random.below(RESPONSE_LENGTH);
+                    for (uint32_t b = 0; b < RESPONSE_LENGTH; b++) {
+                        if (b != lost) data.push_back(f[b]);
+                    }
+                    break;
+                }
+                case FLIP_BIT: {
+                    uint32_t at = data.size() + random.below(RESPONSE_LENGTH);
+                    data.insert(data.end(), f, f + RESPONSE_LENGTH);
+                    data[at] ^= (uint8_t)(1 << random.below(8));
+                    break;
+                }
+                case INSERT_BYTE: {
+                    uint32_t at = 1 + random.below(RESPONSE_LENGTH - 1);
+                    data.insert(data.end(), f, f + at);
+                    data.push_back(random.below(2) ? 0xFF : (uint8_t)random.next());
+                    data.insert(data.end(), f + at, f + RESPONSE_LENGTH);
+                    break;
+                }
+                case TRUNCATE:
+                    data.insert(data.end(), f, f + 1 + random.below(RESPONSE_LENGTH - 1));
+                    break;
+                case NOISE: {
+                    uint32_t count = 1 + random.below(3 * RESPONSE_LENGTH);
+                    for (uint32_t b = 0; b < count; b++) {
+                        // Header bytes turn up more often than chance on a real line
+                        uint32_t pick = random.below(8);
+                        data.push_back(pick == 0 ? 0xFF : pick == 1 ? 0x86 : (uint8_t)random.next());
+                    }
+                    data.insert(data.end(), f, f + RESPONSE_LENGTH);
+                    break;
+                }
+                default:
+                    break;
+            }
+            r.end = (uint32_t)data.size();
+        }
+    }
+
+    // A noise burst precedes an intact copy of its frame
+    static bool delivers(Damage damage) { return damage == INTACT || damage == NOISE; }
+
+    const std::vector<uint8_t>& bytes() const { return data; }
+    const std::vector<FrameRecord>& frames() const { return records; }
+
+    uint32_t delivered() const {
+        uint32_t count = 0;
+        for (const FrameRecord& r : records) count += delivers(r.damage);
+        return count;
+    }
+
+private:
+    std::vector<FrameRecord> records;
+    std::vector<uint8_t> data;
+};
+
+}
+
+#endif
@@ -0,0 +1,224 @@
+#include "adc_sampler.h"
+#include "config.h"
+#include <esp_adc/adc_cali_scheme.h>
+
+AdcSampler adcSampler;
+
+// Bytes read from the DMA pool per adc_continuous_read() call
+static const uint32_t DRAIN_CHUNK_BYTES = 256;
+
+// Conversions per decimated reading
+static const uint32_t DECIMATION = 1UL << (2 * ADC_OVERSAMPLE_BITS);
+
+// Decimator gain bits to drop so that ADC_OVERSAMPLE_BITS extra bits remain
+static const uint8_t DECIMATOR_SHIFT = 2 * ADC_OVERSAMPLE_BITS * ADC_CIC_ORDER - ADC_OVERSAMPLE_BITS;
+
+// Set by the driver when drain() fell behind and conversions were lost
+static volatile uint32_t poolOverflows = 0;
+
+static bool IRAM_ATTR onPoolOverflow(adc_continuous_handle_t handle,
+                                     const adc_continuous_evt_data_t* edata, void* userData) {
+    (void)handle;
+    (void)edata;
+    (void)userData;
+    poolOverflows = poolOverflows + 1;
+    return false;
+}
+
+static int pinFor(AdcChannelId id) {
+    switch (id) {
+        #ifdef ZE40_SENSOR_ENABLED
+        case ADC_CH_ZE40_DAC: return ZE40_DAC_PIN;
+        #endif
+        #ifdef MR007_SENSOR_ENABLED
+        case ADC_CH_MR007: return MR007_PIN;
+        #endif
+        #ifdef ME4_SO2_SENSOR_ENABLED
+        case ADC_CH_ME4_SO2: return ME4_SO2_PIN;
+        #endif
+        default: return -1;
+    }
+}
+
+bool AdcSampler::init() {
+    for (uint8_t i = 0; i < ADC_CHANNEL_COUNT; i++) {
+        channels[i] = Channel();
+    }
+
+    adc_digi_pattern_config_t pattern[ADC_CHANNEL_COUNT];
+    uint8_t patternCount = 0;
+
+    for (uint8_t i = 0; i < ADC_CHANNEL_COUNT; i++) {
+        Channel& ch = channels[i];
+        ch.pin = pinFor((AdcChannelId)i);
+        if (ch.pin < 0) continue;
+
+        adc_unit_t unit;
+        adc_channel_t adcChannel;
+        if (adc_continuous_io_to_channel(ch.pin, &unit, &adcChannel) != ESP_OK || unit != ADC_UNIT_1) {
+            DEBUG_PRINTF("✗ ADC: GPIO %d is not an ADC1 pin\n", ch.pin);
+            continue;
+        }
+        ch.adcChannel = (uint8_t)adcChannel;
+
+        pattern[patternCount].atten = ADC_ATTEN_DB_12;
+        pattern[patternCount].channel = ch.adcChannel;
+        pattern[patternCount].unit = ADC_UNIT_1;
+        pattern[patternCount].bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+        patternCount++;
+
+        #if ADC_CALI_SCHEME_CURVE_FITTING_SUPPORTED
+        adc_cali_curve_fitting_config_t caliConfig = {};
+        caliConfig.unit_id = ADC_UNIT_1;
+        caliConfig.chan = adcChannel;
+        caliConfig.atten = ADC_ATTEN_DB_12;
+        caliConfig.bitwidth = ADC_BITWIDTH_12;
+        if (adc_cali_create_scheme_curve_fitting(&caliConfig, &ch.cali) != ESP_OK) {
+            ch.cali = nullptr;
+        }
+        #endif
+
+        ch.configured = true;
+    }
+
+    if (patternCount == 0) return false;
+
+    adc_continuous_handle_cfg_t handleConfig = {};
+    handleConfig.max_store_buf_size = ADC_DMA_POOL_BYTES;
+    handleConfig.conv_frame_size = DRAIN_CHUNK_BYTES;
+
+    adc_continuous_config_t adcConfig = {};
+    adcConfig.pattern_num = patternCount;
+    adcConfig.adc_pattern = pattern;
+    adcConfig.sample_freq_hz = ADC_SAMPLE_RATE_HZ * patternCount;
+    adcConfig.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+    adcConfig.format = ADC_DIGI_OUTPUT_FORMAT_TYPE2;
+
+    adc_continuous_evt_cbs_t callbacks = {};
+    callbacks.on_pool_ovf = onPoolOverflow;
+
+    esp_err_t err = adc_continuous_new_handle(&handleConfig, &handle);
+    if (err == ESP_OK) err = adc_continuous_config(handle, &adcConfig);
+    if (err == ESP_OK) err = adc_continuous_register_event_callbacks(handle, &callbacks, nullptr);
+    if (err == ESP_OK) err = adc_continuous_start(handle);
+
+    if (err != ESP_OK) {
+        DEBUG_PRINTF("✗ ADC continuous mode failed (%s), using single-shot reads\n", esp_err_to_name(err));
+        if (handle != nullptr) {
+            adc_continuous_deinit(handle);
+            handle = nullptr;
+        }
+        return false;
+    }
+
+    running = true;
+    DEBUG_PRINTF("✓ ADC sampler: %u channels at %u Hz, %lu conversions per reading\n",
+                 patternCount, (unsigned)ADC_SAMPLE_RATE_HZ, (unsigned long)DECIMATION);
+    return true;
+}
+
+void AdcSampler::drain() {
+    if (!running) return;
+
+    uint8_t buffer[DRAIN_CHUNK_BYTES];
+    uint32_t length = 0;
+    uint32_t now = millis();
+
+    while (adc_continuous_read(handle, buffer, sizeof(buffer), &length, 0) == ESP_OK && length > 0) {
+        for (uint32_t offset = 0; offset + SOC_ADC_DIGI_RESULT_BYTES <= length; offset += SOC_ADC_DIGI_RESULT_BYTES) {
+            const adc_digi_output_data_t* result = (const adc_digi_output_data_t*)&buffer[offset];
+            uint8_t adcChannel = result->type2.channel;
+
+            Channel* ch = nullptr;
+            for (uint8_t i = 0; i < ADC_CHANNEL_COUNT; i++) {
+                if (channels[i].configured && channels[i].adcChannel == adcChannel) {
+                    ch = &channels[i];
+                    break;
+                }
+            }
+            if (ch == nullptr) {
+                foreignResults++;
+                continue;
+            }
+
+            ch->conversions++;
+            uint32_t oversampled;
+            if (ch->decimator.apply(result->type2.data, oversampled, DECIMATOR_SHIFT)) {
+                publish(*ch, oversampled, now);
+            }
+        }
+    }
+    drains++;
+}
+
+void AdcSampler::publish(Channel& ch, uint32_t oversampled, uint32_t now) {
+    uint32_t half = (1UL << ADC_OVERSAMPLE_BITS) >> 1;
+
+    ch.latest.timestamp = now;
+    ch.latest.oversampled = oversampled;
+    ch.latest.raw = (oversampled + half) >> ADC_OVERSAMPLE_BITS;
+    ch.latest.voltage = toVoltage(ch, oversampled);
+    ch.hasReading = true;
+    ch.readings++;
+}
+
+// The calibration curve takes whole 12-bit codes, so interpolate between
+// the two codes either side of the oversampled value
+float AdcSampler::toVoltage(const Channel& ch, uint32_t oversampled) const {
+    const uint32_t scale = 1UL << ADC_OVERSAMPLE_BITS;
+    int code = oversampled / scale;
+    float fraction = (float)(oversampled % scale) / scale;
+
+    if (ch.cali == nullptr) {
+        return (code + fraction) * (V_REF / (1 << ADC_RESOLUTION));
+    }
+
+    int lowMv = 0;
+    int highMv = 0;
+    adc_cali_raw_to_voltage(ch.cali, code, &lowMv);
+    adc_cali_raw_to_voltage(ch.cali, code + 1, &highMv);
+    return (lowMv + (highMv - lowMv) * fraction) / 1000.0f;
+}
+
+bool AdcSampler::read(AdcChannelId channel, AdcReading& out) {
+    if (channel >= ADC_CHANNEL_COUNT) return false;
+    Channel& ch = channels[channel];
+
+    if (!running) {
+        // Single-shot fallback: one conversion gives both raw and voltage
+        if (ch.pin < 0) return false;
+        int raw = analogRead(ch.pin);
+        out.timestamp = millis();
+        out.raw = raw;
+        out.oversampled = (uint32_t)raw << ADC_OVERSAMPLE_BITS;
+        out.voltage = raw * (V_REF / (1 << ADC_RESOLUTION));
+        return true;
+    }
+
+    if (!ch.hasReading) return false;
+    out = ch.latest;
+    return true;
+}
+
+void AdcSampler::report() const {
+    DEBUG_PRINTLN("┌─ ADC report ───────────────────────────────");
+    if (!running) {
+        DEBUG_PRINTLN("│ Continuous mode not running (single-shot fallback)");
+    } else {
+        static const char* const NAMES[ADC_CHANNEL_COUNT] = { "ZE40 DAC", "MR007", "ME4-SO2" };
+        for (uint8_t i = 0; i < ADC_CHANNEL_COUNT; i++) {
+            const Channel& ch = channels[i];
+            if (!ch.configured) continue;
+            DEBUG_PRINTF("│ %-8s GPIO %2d  %9lu conversions  %6lu readings  last %.4f V\n",
+                         NAMES[i], ch.pin,
+                         (unsigned long)ch.conversions,
+                         (unsigned long)ch.readings,
+                         ch.latest.voltage);
+        }
+        DEBUG_PRINTF("│ %lu drains, %lu pool overflows, %lu unexpected results\n",
+                     (unsigned long)drains,
+                     (unsigned long)poolOverflows,
+                     (unsigned long)foreignResults);
+    }
+    DEBUG_PRINTLN("└────────────────────────────────────────────");
+}
@@ -0,0 +1,106 @@
+#ifndef ADC_SAMPLER_H
+#define ADC_SAMPLER_H
+
+#include <Arduino.h>
+#include <esp_adc/adc_continuous.h>
+#include <esp_adc/adc_cali.h>
+#include "config.h"
+#include "dsp_filters.h"
+
+/**
+ * ADC Sampler
+ *
+ * Continuous-mode ADC acquisition for the analog sensor pins (ZE40 DAC,
+ * MR007, ME4-SO2). The ADC's digital controller scans every channel at
+ * ADC_SAMPLE_RATE_HZ and DMA writes the conversions into the driver's
+ * pool. No interrupt or API call happens per conversion.
+ *
+ * drain() runs as a sensor task job every ADC_DRAIN_INTERVAL. It empties
+ * the pool in bulk and feeds each channel's conversions through a CIC
+ * decimator of order ADC_CIC_ORDER. Every 4^ADC_OVERSAMPLE_BITS
+ * conversions a channel produces one decimated reading with
+ * ADC_OVERSAMPLE_BITS extra bits of resolution. The raw code and the
+ * calibrated voltage of a reading both come from the same decimator
+ * output, so they always describe the same instant.
+ *
+ * If the continuous driver cannot be started, read() falls back to a
+ * single analogRead() per call.
+ *
+ * Usage:
+ *   AdcReading reading;
+ *   if (adcSampler.read(ADC_CH_MR007, reading)) {
+ *       use(reading.raw, reading.voltage);
+ *   }
+ */
+enum AdcChannelId : uint8_t {
+    ADC_CH_ZE40_DAC = 0,
+    ADC_CH_MR007,
+    ADC_CH_ME4_SO2,
+    ADC_CHANNEL_COUNT
+};
+
+struct AdcReading {
+    uint32_t timestamp;     // millis() when the decimation window closed
+    uint32_t oversampled;   // ADC_RESOLUTION + ADC_OVERSAMPLE_BITS bit code
+    int32_t raw;            // Same value rounded to ADC_RESOLUTION bits
+    float voltage;          // Calibrated volts
+};
+
+class AdcSampler {
+public:
+    /**
+     * Configure and start continuous conversion on the enabled sensor pins
+     * @return true if the DMA engine is running
+     */
+    bool init();
+
+    /**
+     * Move all completed conversions out of the DMA pool and close any
+     * decimation window that is full (sensor task only)
+     */
+    void drain();
+
+    /**
+     * Latest decimated reading of a channel
+     * @param channel Channel to read
+     * @param out Filled with the reading
+     * @return false if the channel has not produced a reading yet
+     */
+    bool read(AdcChannelId channel, AdcReading& out);
+
+    /**
+     * Print conversion, reading and overflow counters
+     */
+    void report() const;
+
+private:
+    struct Channel {
+        int pin;
+        uint8_t adcChannel;
+        bool configured;
+        adc_cali_handle_t cali;
+
+        CicDecimator<2 * ADC_OVERSAMPLE_BITS, ADC_CIC_ORDER> decimator;
+
+        AdcReading latest;
+        bool hasReading;
+
+        // Statistics
+        uint32_t conversions;
+        uint32_t readings;
+    };
+
+    void publish(Channel& ch, uint32_t oversampled, uint32_t now);
+    float toVoltage(const Channel& ch, uint32_t oversampled) const;
+
+    Channel channels[ADC_CHANNEL_COUNT];
+    adc_continuous_handle_t handle = nullptr;
+    bool running = false;
+
+    uint32_t drains = 0;
+    uint32_t foreignResults = 0;
+};
+
+extern AdcSampler adcSampler;
+
+#endif
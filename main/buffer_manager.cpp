@@ -1,284 +1,360 @@
 #include "buffer_manager.h"
-#include <SPIFFS.h>
 #include "config.h"
+#include "perf_monitor.h"
+#include "sensor_schema.h"
+#include "json_writer.h"
+#include "cbor_writer.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
 
-const char* BufferManager::BUFFER_FILE = "/data_buffer.jsonl";
-const size_t BufferManager::MAX_BUFFER_SIZE = 512000;  // 500KB max
-const size_t BufferManager::MAX_ENTRIES = 2000;         // Reasonable limit
+RingLog BufferManager::ring;
+uint32_t BufferManager::bootSeq = 0;
+
+// Ring log entry types
+static const uint8_t RECORD_SENSOR = 1;     // Packed SharedSensorData fields
+static const uint8_t RECORD_JSON = 2;       // Pre-formatted JSON text
+static const uint8_t RECORD_CBOR = 3;       // Pre-encoded CBOR data item
+
+// RFC 8949 tag for JSON text embedded in CBOR
+static const uint32_t CBOR_TAG_EMBEDDED_JSON = 262;
+
+// Flag bits after the packed fields of a sensor record
+static const uint8_t FLAG_ZPHS01B_VALID = 0x01;
+static const uint8_t FLAG_MR007_VALID = 0x02;
+static const uint8_t FLAG_ME4SO2_VALID = 0x04;
+static const uint8_t FLAG_NETWORK_READY = 0x08;
+
+// Packed size of every schema field, then the flag byte and the IPv4 address
+#define BUFFER_FIELD_SIZE(name, member, decimals) + sizeof(SharedSensorData::member)
+#define BUFFER_GROUP_SIZE(name, valid, ring, FIELDS) FIELDS(BUFFER_FIELD_SIZE)
+static const size_t SENSOR_RECORD_BYTES = 0 SENSOR_SCHEMA_GROUPS(BUFFER_GROUP_SIZE) + 1 + 4;
+#undef BUFFER_GROUP_SIZE
+#undef BUFFER_FIELD_SIZE
+
+static_assert(SENSOR_RECORD_BYTES <= RingLog::BODY_SIZE, "sensor record must fit one ring log record");
+
+// Appends and consumes come from the uplink task (failed sends, queue
+// spill, replay); readers walk the mapped records without the lock
+static SemaphoreHandle_t writeMutex = nullptr;
+
+struct WriteLock {
+    WriteLock() { if (writeMutex) xSemaphoreTake(writeMutex, portMAX_DELAY); }
+    ~WriteLock() { if (writeMutex) xSemaphoreGive(writeMutex); }
+};
+
+static size_t packSensorRecord(const SharedSensorData& d, uint8_t* out) {
+    uint8_t* p = out;
+    
+    #define BUFFER_PACK_FIELD(name, member, decimals) \
+        memcpy(p, &d.member, sizeof(d.member));       \
+        p += sizeof(d.member);
+    #define BUFFER_PACK_GROUP(name, valid, ring, FIELDS) FIELDS(BUFFER_PACK_FIELD)
+    SENSOR_SCHEMA_GROUPS(BUFFER_PACK_GROUP)
+    #undef BUFFER_PACK_GROUP
+    #undef BUFFER_PACK_FIELD
+    
+    *p++ = (d.zphs01b_valid ? FLAG_ZPHS01B_VALID : 0) |
+           (d.mr007_valid ? FLAG_MR007_VALID : 0) |
+           (d.me4so2_valid ? FLAG_ME4SO2_VALID : 0) |
+           (d.network_ready ? FLAG_NETWORK_READY : 0);
+    
+    IPAddress ip;
+    ip.fromString(d.ip_address);
+    for (uint8_t i = 0; i < 4; i++) *p++ = ip[i];
+    
+    return p - out;
+}
+
+static void unpackSensorRecord(const uint8_t* in, SharedSensorData& d) {
+    const uint8_t* p = in;
+    
+    #define BUFFER_UNPACK_FIELD(name, member, decimals) \
+        memcpy(&d.member, p, sizeof(d.member));         \
+        p += sizeof(d.member);
+    #define BUFFER_UNPACK_GROUP(name, valid, ring, FIELDS) FIELDS(BUFFER_UNPACK_FIELD)
+    SENSOR_SCHEMA_GROUPS(BUFFER_UNPACK_GROUP)
+    #undef BUFFER_UNPACK_GROUP
+    #undef BUFFER_UNPACK_FIELD
+    
+    uint8_t flags = *p++;
+    d.zphs01b_valid = flags & FLAG_ZPHS01B_VALID;
+    d.mr007_valid = flags & FLAG_MR007_VALID;
+    d.me4so2_valid = flags & FLAG_ME4SO2_VALID;
+    d.network_ready = flags & FLAG_NETWORK_READY;
+    
+    snprintf(d.ip_address, sizeof(d.ip_address), "%u.%u.%u.%u", p[0], p[1], p[2], p[3]);
+}
 
 bool BufferManager::init() {
     DEBUG_PRINTLN("Initializing buffer manager...");
     
-    if (!SPIFFS.begin(true)) {
-        DEBUG_PRINTLN("✗ SPIFFS initialization failed");
+    writeMutex = xSemaphoreCreateMutex();
+    if (!ring.begin(BUFFER_LOG_PARTITION)) {
+        DEBUG_PRINTLN("✗ Buffer ring log initialization failed");
         return false;
     }
     
-    DEBUG_PRINTLN("✓ SPIFFS initialized");
-    
-    // Check total and used space
-    size_t totalBytes = SPIFFS.totalBytes();
-    size_t usedBytes = SPIFFS.usedBytes();
-    DEBUG_PRINT("  Total: ");
-    DEBUG_PRINT(totalBytes);
-    DEBUG_PRINT(" bytes, Used: ");
-    DEBUG_PRINT(usedBytes);
-    DEBUG_PRINTLN(" bytes");
-    
-    // Check if buffer file exists, if not create it
-    if (!SPIFFS.exists(BUFFER_FILE)) {
-        File f = SPIFFS.open(BUFFER_FILE, FILE_WRITE);
-        if (f) {
-            f.close();
-            DEBUG_PRINTLN("✓ Buffer file created: " + String(BUFFER_FILE));
-        } else {
-            DEBUG_PRINTLN("✗ Failed to create buffer file");
-            return false;
-        }
-    } else {
-        DEBUG_PRINTLN("✓ Buffer file exists: " + String(BUFFER_FILE));
-    }
+    // Records below this were stamped with a previous boot's millis()
+    bootSeq = ring.head();
+    
+    DEBUG_PRINT("✓ Buffer ring log ready: ");
+    DEBUG_PRINT(ring.entryCount());
+    DEBUG_PRINT(" entries, ");
+    DEBUG_PRINT(ring.capacityRecords());
+    DEBUG_PRINTLN(" records capacity");
     
     return true;
 }
 
 bool BufferManager::saveData(const SharedSensorData& data, unsigned long timestamp) {
-    if (!SPIFFS.exists(BUFFER_FILE)) {
-        DEBUG_PRINTLN("✗ Buffer file not found");
-        return false;
-    }
-    
-    // Check if we're at capacity
-    size_t entries = getEntryCount();
-    if (entries >= MAX_ENTRIES) {
-        DEBUG_PRINTLN("⚠ Buffer at max entries (" + String(MAX_ENTRIES) + "), not saving");
-        return false;
-    }
+    PERF_SCOPE(PERF_BUFFER_SAVE_DATA);
     
-    size_t currentSize = getBufferSize();
-    if (currentSize >= MAX_BUFFER_SIZE) {
-        DEBUG_PRINTLN("⚠ Buffer is full (" + String(MAX_BUFFER_SIZE) + " bytes), not saving");
+    if (!ring.isReady()) {
+        DEBUG_PRINTLN("✗ Buffer not initialized");
         return false;
     }
     
-    // Build JSON entry (same format as django_client.cpp)
-    String json = "{";
-    json += "\"timestamp\":" + String(timestamp > 0 ? timestamp : millis() / 1000) + ",";
-    
-    // ZE40 Data
-    json += "\"ze40\":{";
-    json += "\"tvoc_ppb\":" + String(data.ze40_tvoc_ppb) + ",";
-    json += "\"tvoc_ppm\":" + String(data.ze40_tvoc_ppm, 3) + ",";
-    json += "\"dac_voltage\":" + String(data.ze40_dac_voltage, 2) + ",";
-    json += "\"dac_ppm\":" + String(data.ze40_dac_ppm, 3) + ",";
-    json += "\"uart_data_valid\":" + String(data.ze40_uart_valid ? "true" : "false");
-    json += "},";
-    
-    // ZPHS01B Data
-    if (data.zphs01b_valid) {
-        json += "\"air_quality\":{";
-        json += "\"pm1\":" + String(data.zphs01b_pm1) + ",";
-        json += "\"pm25\":" + String(data.zphs01b_pm25) + ",";
-        json += "\"pm10\":" + String(data.zphs01b_pm10) + ",";
-        json += "\"co2\":" + String(data.zphs01b_co2) + ",";
-        json += "\"voc\":" + String(data.zphs01b_voc) + ",";
-        json += "\"ch2o\":" + String(data.zphs01b_ch2o) + ",";
-        json += "\"co\":" + String(data.zphs01b_co, 1) + ",";
-        json += "\"o3\":" + String(data.zphs01b_o3, 2) + ",";
-        json += "\"no2\":" + String(data.zphs01b_no2, 3) + ",";
-        json += "\"temperature\":" + String(data.zphs01b_temperature, 1) + ",";
-        json += "\"humidity\":" + String(data.zphs01b_humidity);
-        json += "},";
-    } else {
-        json += "\"air_quality\":null,";
-    }
-    
-    // MR007 Data
-    if (data.mr007_valid) {
-        json += "\"mr007\":{";
-        json += "\"voltage\":" + String(data.mr007_voltage, 3) + ",";
-        json += "\"rawValue\":" + String(data.mr007_raw) + ",";
-        json += "\"lel_concentration\":" + String(data.mr007_lel, 1);
-        json += "},";
-    } else {
-        json += "\"mr007\":null,";
-    }
+    uint8_t body[SENSOR_RECORD_BYTES];
+    size_t length = packSensorRecord(data, body);
+    uint32_t stamp = timestamp > 0 ? timestamp : millis() / 1000;
     
-    // ME4-SO2 Data
-    if (data.me4so2_valid) {
-        json += "\"me4_so2\":{";
-        json += "\"voltage\":" + String(data.me4so2_voltage, 4) + ",";
-        json += "\"rawValue\":" + String(data.me4so2_raw) + ",";
-        json += "\"current_ua\":" + String(data.me4so2_current, 2) + ",";
-        json += "\"so2_concentration\":" + String(data.me4so2_so2, 2);
-        json += "},";
-    } else {
-        json += "\"me4_so2\":null,";
+    WriteLock lock;
+    if (!ring.append(RECORD_SENSOR, SENSOR_SCHEMA_VERSION, stamp, body, length)) {
+        DEBUG_PRINTLN("⚠ Buffer is full, not saving");
+        return false;
     }
-    
-    // Network Info
-    json += "\"ip_address\":\"" + String(data.ip_address) + "\",";
-    json += "\"network_ready\":" + String(data.network_ready ? "true" : "false");
-    json += "}";
-    
-    return saveJSON(json);
+    return true;
 }
 
 bool BufferManager::saveJSON(const String& jsonData) {
-    if (!SPIFFS.exists(BUFFER_FILE)) {
-        DEBUG_PRINTLN("✗ Buffer file does not exist");
+    return saveJSON(jsonData.c_str(), jsonData.length());
+}
+
+bool BufferManager::saveJSON(const char* jsonData, size_t length) {
+    return saveRecord(RECORD_JSON, (const uint8_t*)jsonData, length);
+}
+
+bool BufferManager::saveCBOR(const uint8_t* cborData, size_t length) {
+    return saveRecord(RECORD_CBOR, cborData, length);
+}
+
+bool BufferManager::saveRecord(uint8_t type, const uint8_t* data, size_t length) {
+    if (!ring.isReady()) {
+        DEBUG_PRINTLN("✗ Buffer not initialized");
         return false;
     }
     
-    File f = SPIFFS.open(BUFFER_FILE, FILE_APPEND);
-    if (!f) {
-        DEBUG_PRINTLN("✗ Failed to open buffer file for writing");
+    WriteLock lock;
+    if (!ring.append(type, 0, millis() / 1000, data, length)) {
+        DEBUG_PRINTLN("⚠ Buffer is full or record too large, not saving");
         return false;
     }
     
-    size_t written = f.println(jsonData);  // Add newline to separate entries
-    f.close();
-    
     DEBUG_PRINT("✓ Buffered data: ");
-    DEBUG_PRINT(jsonData.length());
+    DEBUG_PRINT(length);
     DEBUG_PRINT(" bytes, Total entries: ");
-    DEBUG_PRINTLN(getEntryCount());
+    DEBUG_PRINTLN(ring.entryCount());
     
-    return written > 0;
+    return true;
 }
 
-String BufferManager::getBufferedEntries(size_t maxEntries) {
-    if (!SPIFFS.exists(BUFFER_FILE)) {
-        return "[]";
+BufferCursor BufferManager::openCursor(size_t maxEntries) {
+    return openCursor(maxEntries, millis());
+}
+
+BufferCursor BufferManager::openCursor(size_t maxEntries, uint32_t now) {
+    BufferCursor cursor;
+    cursor.seq = ring.tail();
+    cursor.remaining = (maxEntries == 0) ? SIZE_MAX : maxEntries;
+    cursor.now = now;
+    return cursor;
+}
+
+// Pre-encoded records pass through when their encoding matches the
+// writer. JSON text in a CBOR stream goes out as tagged embedded JSON;
+// CBOR cannot be turned into JSON here and is written as null.
+static void writeRecordBody(const RingLog& ring, const RingLog::Record* head, JsonWriter& writer) {
+    if (head->type != RECORD_JSON) {
+        writer.null();
+        return;
     }
-    
-    File f = SPIFFS.open(BUFFER_FILE, FILE_READ);
-    if (!f) {
-        return "[]";
+    writer.raw((const char*)head->body, head->length);
+    for (uint8_t i = 1; i < head->parts; i++) {
+        const RingLog::Record* part = ring.record(head->sequence + i);
+        writer.rawContinue((const char*)part->body, part->length);
     }
-    
-    String result = "[";
-    size_t count = 0;
-    bool first = true;
-    
-    while (f.available() && (maxEntries == 0 || count < maxEntries)) {
-        String line = f.readStringUntil('\n');
-        line.trim();
-        
-        if (line.length() > 0) {
-            if (!first) result += ",";
-            result += line;
-            first = false;
-            count++;
+}
+
+static void writeRecordBody(const RingLog& ring, const RingLog::Record* head, CborWriter& writer) {
+    if (head->type == RECORD_JSON) {
+        size_t length = 0;
+        for (uint8_t i = 0; i < head->parts; i++) {
+            length += ring.record(head->sequence + i)->length;
         }
+        writer.tag(CBOR_TAG_EMBEDDED_JSON);
+        writer.beginText(length);
+    }
+    for (uint8_t i = 0; i < head->parts; i++) {
+        const RingLog::Record* part = ring.record(head->sequence + i);
+        writer.raw(part->body, part->length);
     }
-    
-    f.close();
-    result += "]";
-    
-    return result;
 }
 
-size_t BufferManager::getEntryCount() {
-    if (!SPIFFS.exists(BUFFER_FILE)) {
-        return 0;
+template <typename Writer>
+bool BufferManager::writeEntry(BufferCursor& cursor, Writer& writer) {
+    if (cursor.remaining == 0) return false;
+    
+    const RingLog::Record* head = ring.nextEntry(cursor.seq);
+    if (head == nullptr) return false;
+    cursor.remaining--;
+    
+    if (head->type == RECORD_JSON || head->type == RECORD_CBOR) {
+        // Copied straight out of the mapped partition
+        writeRecordBody(ring, head, writer);
+        return true;
     }
     
-    File f = SPIFFS.open(BUFFER_FILE, FILE_READ);
-    if (!f) {
-        return 0;
+    if (head->type != RECORD_SENSOR || head->version != SENSOR_SCHEMA_VERSION) {
+        writer.null();
+        return true;
     }
     
+    SharedSensorData data;
+    unpackSensorRecord(head->body, data);
+    
+    // Sample ages are not stored; they are stale by the time it is sent.
+    // The cursor's clock is fixed, so a sizing pass and the send agree.
+    uint32_t now = cursor.now;
+    writer.beginObject();
+    writeSchemaId(writer);
+    writeSchemaMember(writer, "timestamp", SCHEMA_KEY_TIMESTAMP, (unsigned long)head->timestamp);
+    if (head->sequence >= bootSeq && head->timestamp <= now / 1000) {
+        writeSchemaMember(writer, "age_s", SCHEMA_KEY_AGE_S, (unsigned long)(now / 1000 - head->timestamp));
+    }
+    writeSensorGroups(writer, data, now, false);
+    writeSchemaMember(writer, "ip_address", SCHEMA_KEY_IP_ADDRESS, (const char*)data.ip_address);
+    writeSchemaMember(writer, "network_ready", SCHEMA_KEY_NETWORK_READY, data.network_ready);
+    writer.endObject();
+    return true;
+}
+
+bool BufferManager::hasNext(const BufferCursor& cursor) {
+    uint32_t seq = cursor.seq;
+    return cursor.remaining > 0 && ring.nextEntry(seq) != nullptr;
+}
+
+bool BufferManager::writeNext(BufferCursor& cursor, JsonWriter& writer) {
+    return writeEntry(cursor, writer);
+}
+
+bool BufferManager::writeNext(BufferCursor& cursor, CborWriter& writer) {
+    return writeEntry(cursor, writer);
+}
+
+size_t BufferManager::streamEntries(Print& out, size_t maxEntries) {
+    return streamEntries(out, maxEntries, millis());
+}
+
+size_t BufferManager::streamEntries(Print& out, size_t maxEntries, uint32_t now) {
+    PERF_SCOPE(PERF_BUFFER_STREAM);
+    
+    char chunk[JSON_STREAM_CHUNK_SIZE];
+    JsonWriter writer(out, chunk, sizeof(chunk));
+    BufferCursor cursor = openCursor(maxEntries, now);
     size_t count = 0;
-    while (f.available()) {
-        String line = f.readStringUntil('\n');
-        if (line.length() > 0) {
-            count++;
-        }
+    
+    writer.beginArray();
+    while (writeNext(cursor, writer)) {
+        count++;
     }
-    f.close();
+    writer.endArray();
+    writer.flush();
     
     return count;
 }
 
-size_t BufferManager::getCurrentBufferSize() {
-    if (!SPIFFS.exists(BUFFER_FILE)) {
-        return 0;
-    }
+size_t BufferManager::streamCBOREntries(Print& out, size_t maxEntries) {
+    return streamCBOREntries(out, maxEntries, millis());
+}
+
+size_t BufferManager::streamCBOREntries(Print& out, size_t maxEntries, uint32_t now) {
+    PERF_SCOPE(PERF_BUFFER_STREAM);
     
-    File f = SPIFFS.open(BUFFER_FILE, FILE_READ);
-    if (!f) {
-        return 0;
+    uint8_t chunk[JSON_STREAM_CHUNK_SIZE];
+    CborWriter writer(out, chunk, sizeof(chunk));
+    BufferCursor cursor = openCursor(maxEntries, now);
+    size_t count = 0;
+    
+    writer.beginArray();
+    while (writeNext(cursor, writer)) {
+        count++;
     }
+    writer.endArray();
+    writer.flush();
     
-    size_t size = f.size();
-    f.close();
+    return count;
+}
+
+String BufferManager::getBufferedEntries(size_t maxEntries) {
+    String result = "[";
+    BufferCursor cursor = openCursor(maxEntries);
+    size_t count = 0;
+    char json[JSON_PAYLOAD_BUFFER_SIZE];
     
-    return size;
+    while (true) {
+        JsonWriter writer(json, sizeof(json));
+        if (!writeNext(cursor, writer)) break;
+        
+        if (count > 0) result += ",";
+        if (writer.ok()) {
+            result.concat(json, writer.length());
+        } else {
+            result += "null";
+        }
+        count++;
+    }
+    
+    result += "]";
+    return result;
+}
+
+size_t BufferManager::getEntryCount() {
+    return ring.entryCount();
+}
+
+size_t BufferManager::capacityBytes() {
+    return ring.capacityRecords() * RingLog::RECORD_SIZE;
 }
 
 size_t BufferManager::getBufferSize() {
-    return getCurrentBufferSize();
+    return ring.usedRecords() * RingLog::RECORD_SIZE;
 }
 
 bool BufferManager::clearBuffer() {
-    if (SPIFFS.remove(BUFFER_FILE)) {
+    WriteLock lock;
+    if (ring.clear()) {
         DEBUG_PRINTLN("✓ Buffer cleared");
-        
-        // Recreate empty file
-        File f = SPIFFS.open(BUFFER_FILE, FILE_WRITE);
-        if (f) {
-            f.close();
-            return true;
-        }
-    } else {
-        DEBUG_PRINTLN("✗ Failed to clear buffer");
-        return false;
+        return true;
     }
+    DEBUG_PRINTLN("✗ Failed to clear buffer");
     return false;
 }
 
 bool BufferManager::removeEntries(size_t count) {
-    if (!SPIFFS.exists(BUFFER_FILE)) {
+    if (!ring.isReady()) {
         return false;
     }
     
-    File f = SPIFFS.open(BUFFER_FILE, FILE_READ);
-    if (!f) {
-        DEBUG_PRINTLN("✗ Failed to open buffer file");
-        return false;
+    size_t removed;
+    {
+        WriteLock lock;
+        removed = ring.consume(count);
     }
     
-    String tempContent = "";
-    size_t skipped = 0;
-    size_t totalLines = 0;
-    
-    while (f.available()) {
-        String line = f.readStringUntil('\n');
-        totalLines++;
-        
-        if (skipped < count) {
-            skipped++;
-        } else if (line.length() > 0) {
-            tempContent += line + "\n";
-        }
-    }
-    f.close();
-    
-    // Write back filtered content
-    f = SPIFFS.open(BUFFER_FILE, FILE_WRITE);
-    if (!f) {
-        DEBUG_PRINTLN("✗ Failed to open buffer file for writing");
-        return false;
-    }
-    
-    f.print(tempContent);
-    f.close();
-    
     DEBUG_PRINT("✓ Removed ");
-    DEBUG_PRINT(skipped);
+    DEBUG_PRINT(removed);
     DEBUG_PRINT(" entries (kept ");
-    DEBUG_PRINT(totalLines - skipped);
+    DEBUG_PRINT(ring.entryCount());
     DEBUG_PRINTLN(")");
     
     return true;
@@ -290,8 +366,8 @@ String BufferManager::getStatus() {
     uint8_t percentFull = getUsagePercent();
     
     String status = "Buffer Status:\n";
-    status += "  Entries: " + String(entries) + " / " + String(MAX_ENTRIES) + "\n";
-    status += "  Size: " + String(bytes) + " / " + String(MAX_BUFFER_SIZE) + " bytes\n";
+    status += "  Entries: " + String(entries) + " (" + String(ring.usedRecords()) + " / " + String(ring.capacityRecords()) + " records)\n";
+    status += "  Size: " + String(bytes) + " / " + String(capacityBytes()) + " bytes\n";
     status += "  Usage: " + String(percentFull) + "%\n";
     
     if (percentFull > 80) {
@@ -306,11 +382,15 @@ bool BufferManager::hasData() {
 }
 
 bool BufferManager::isAlmostFull() {
-    size_t bytes = getBufferSize();
-    return (bytes * 100 / MAX_BUFFER_SIZE) > 80;
+    return getUsagePercent() > 80;
 }
 
 uint8_t BufferManager::getUsagePercent() {
-    size_t bytes = getBufferSize();
-    return (bytes * 100) / MAX_BUFFER_SIZE;
+    size_t capacity = capacityBytes();
+    if (capacity == 0) return 0;
+    return (getBufferSize() * 100) / capacity;
+}
+
+void BufferManager::report() {
+    ring.report();
 }
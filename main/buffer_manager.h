@@ -3,31 +3,55 @@
 
 #include <Arduino.h>
 #include "shared_data.h"
+#include "ring_log.h"
+#include "json_writer.h"
+#include "cbor_writer.h"
+
+/**
+ * Read position in the buffer, oldest entry first
+ * Reading does not consume; call removeEntries() once the entries
+ * have been delivered. Entry ages are counted to `now`, fixed when the
+ * cursor is opened, so passes over the same entries write the same bytes.
+ */
+struct BufferCursor {
+    uint32_t seq;           // Ring log sequence of the next record
+    size_t remaining;       // Entries left to read (SIZE_MAX = no limit)
+    uint32_t now;           // millis() that "age_s" is counted to
+};
 
 /**
  * BufferManager
  * 
- * Handles persistent buffering of sensor data to SPIFFS.
+ * Handles persistent buffering of sensor data to flash.
  * When network is unavailable, data is saved to flash.
  * When network reconnects, data is retrieved and sent.
  * 
+ * Storage is a RingLog on the BUFFER_LOG_PARTITION partition. A sensor
+ * snapshot is kept as one 128-byte binary record (fields packed in
+ * sensor_schema.h order) and is turned back into JSON or CBOR only
+ * when read. Saving and removing entries cost O(1) flash writes.
+ * 
  * Usage:
  *   - Call init() in setup()
  *   - Call saveData() when network unavailable
- *   - Call getBufferedEntries() to retrieve buffered data
- *   - Call clearBuffer() after successful send
+ *   - Call streamEntries() (or openCursor()/writeNext()) to replay
+ *     buffered data in bounded RAM
+ *   - Call removeEntries() / clearBuffer() after successful send
  */
 class BufferManager {
 private:
-    static const char* BUFFER_FILE;      // "/data_buffer.jsonl"
-    static const size_t MAX_BUFFER_SIZE; // 500KB max
-    static const size_t MAX_ENTRIES;     // Max number of entries to buffer
+    static RingLog ring;
+    static uint32_t bootSeq;    // First ring log sequence written this boot
+    
+    static size_t capacityBytes();
+    static bool saveRecord(uint8_t type, const uint8_t* data, size_t length);
     
-    static size_t getCurrentBufferSize();
+    template <typename Writer>
+    static bool writeEntry(BufferCursor& cursor, Writer& writer);
     
 public:
     /**
-     * Initialize buffer manager and SPIFFS
+     * Initialize buffer manager and map the ring log partition
      * Call this once in setup()
      * @return true if initialization successful
      */
@@ -50,36 +74,120 @@ public:
      */
     static bool saveJSON(const String& jsonData);
     
+    /**
+     * Save an already-formatted JSON record from a fixed buffer
+     * @param jsonData Record bytes (no newline)
+     * @param length Record length
+     * @return true if saved successfully
+     */
+    static bool saveJSON(const char* jsonData, size_t length);
+    
+    /**
+     * Save an already-encoded CBOR data item from a fixed buffer
+     * Replayed as-is in a CBOR stream and as null in a JSON stream.
+     * @param cborData Encoded item (e.g. from CborWriter)
+     * @param length Item length
+     * @return true if saved successfully
+     */
+    static bool saveCBOR(const uint8_t* cborData, size_t length);
+    
     /**
      * Get all buffered entries as a JSON array
      * Format: [{"timestamp":..., "ze40":{...}}, {...}, ...]
+     * Builds the whole array on the heap, so keep maxEntries small;
+     * use streamEntries() to replay a large backlog.
      * @param maxEntries Maximum entries to retrieve (0 = all)
      * @return JSON array string, or "[]" if no data
      */
     static String getBufferedEntries(size_t maxEntries = 0);
     
     /**
-     * Get number of buffered entries (lines in file)
+     * Start reading at the oldest buffered entry
+     * @param maxEntries Maximum entries to read (0 = all)
+     */
+    static BufferCursor openCursor(size_t maxEntries = 0);
+    
+    /**
+     * Start reading at the oldest buffered entry, with ages counted to
+     * `now`. Give every pass over one batch (sizing, compressing,
+     * sending) the same `now` and they write identical bytes.
+     * @param maxEntries Maximum entries to read (0 = all)
+     * @param now millis() that "age_s" is counted to
+     */
+    static BufferCursor openCursor(size_t maxEntries, uint32_t now);
+    
+    /**
+     * Write the next buffered entry as one JSON value
+     * Entries saved since this boot carry "age_s", the seconds from
+     * when they were recorded to cursor.now. Earlier entries have no
+     * usable time base.
+     * Entries saved with an older schema layout are written as null,
+     * so positions still line up with removeEntries().
+     * @param cursor Advanced past the entry
+     * @param writer Destination (buffer or streaming sink)
+     * @return false when there are no more entries
+     */
+    static bool writeNext(BufferCursor& cursor, JsonWriter& writer);
+    
+    /**
+     * Check whether writeNext() would write another entry
+     */
+    static bool hasNext(const BufferCursor& cursor);
+    
+    /**
+     * Write the next buffered entry as one CBOR data item, keyed as in
+     * sensor_schema.h. Saved JSON text goes out as embedded JSON
+     * (tag 262).
+     */
+    static bool writeNext(BufferCursor& cursor, CborWriter& writer);
+    
+    /**
+     * Stream buffered entries as one JSON array
+     * RAM use is one JSON_STREAM_CHUNK_SIZE scratch buffer, whatever
+     * the backlog size. Wrap a Client in ChunkedPrint for an HTTP body.
+     * @param out Destination stream
+     * @param maxEntries Maximum entries to send (0 = all)
+     * @return Entries written
+     */
+    static size_t streamEntries(Print& out, size_t maxEntries = 0);
+    
+    /**
+     * Same, with ages counted to `now` (see openCursor())
+     */
+    static size_t streamEntries(Print& out, size_t maxEntries, uint32_t now);
+    
+    /**
+     * Stream buffered entries as one CBOR array (indefinite length)
+     * Same bounded RAM use as streamEntries().
+     * @param out Destination stream
+     * @param maxEntries Maximum entries to send (0 = all)
+     * @return Entries written
+     */
+    static size_t streamCBOREntries(Print& out, size_t maxEntries = 0);
+    static size_t streamCBOREntries(Print& out, size_t maxEntries, uint32_t now);
+    
+    /**
+     * Get number of buffered entries
      * @return Number of JSON entries currently buffered
      */
     static size_t getEntryCount();
     
     /**
      * Get total buffered data size in bytes
-     * @return Size of buffer file
+     * @return Flash bytes held by unconsumed records
      */
     static size_t getBufferSize();
     
     /**
      * Clear all buffered data
-     * Deletes and recreates the buffer file
+     * Erases the whole partition
      * @return true if successful
      */
     static bool clearBuffer();
     
     /**
      * Remove first N entries from buffer
-     * Useful for partial cleanup
+     * Marks them consumed in place (no rewrite)
      * @param count Number of entries to remove
      * @return true if successful
      */
@@ -110,6 +218,11 @@ public:
      * @return 0-100
      */
     static uint8_t getUsagePercent();
+    
+    /**
+     * Print ring log geometry and counters
+     */
+    static void report();
 };
 
 #endif
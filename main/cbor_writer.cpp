@@ -0,0 +1,145 @@
+#include "cbor_writer.h"
+#include <math.h>
+
+static const float POW10[] = { 1.0f, 10.0f, 100.0f, 1000.0f, 10000.0f, 100000.0f, 1000000.0f };
+static const uint8_t MAX_DECIMALS = sizeof(POW10) / sizeof(POW10[0]) - 1;
+static const float MAX_FORMATTED = 1e9f;   // JsonWriter prints null from here on
+
+int32_t CborWriter::toHalf(float f) {
+    uint32_t bits;
+    memcpy(&bits, &f, sizeof(bits));
+    uint16_t sign = (bits >> 16) & 0x8000;
+    int32_t exponent = (int32_t)((bits >> 23) & 0xFF) - 127;
+    uint32_t mantissa = bits & 0x7FFFFF;
+
+    if ((bits & 0x7FFFFFFF) == 0) return sign;
+
+    if (exponent >= -14 && exponent <= 15) {
+        // Normal: the low 13 mantissa bits must be zero
+        if (mantissa & 0x1FFF) return -1;
+        return sign | ((exponent + 15) << 10) | (mantissa >> 13);
+    }
+    if (exponent >= -24 && exponent < -14) {
+        // Subnormal: the implicit bit moves into the mantissa
+        uint32_t full = mantissa | 0x800000;
+        uint8_t shift = -(exponent + 1);
+        if (full & ((1UL << shift) - 1)) return -1;
+        return sign | (full >> shift);
+    }
+    return -1;
+}
+
+CborWriter::CborWriter(uint8_t* buffer, size_t capacity)
+    : sink(nullptr), buffer(buffer), capacity(capacity) {}
+
+CborWriter::CborWriter(Print& sink, uint8_t* buffer, size_t capacity)
+    : sink(&sink), buffer(buffer), capacity(capacity) {}
+
+void CborWriter::put(const uint8_t* data, size_t n) {
+    while (n > 0) {
+        size_t room = capacity - used;
+        if (room == 0) {
+            if (sink == nullptr) {
+                overflow = true;
+                return;
+            }
+            flush();
+            continue;
+        }
+
+        size_t chunk = (n < room) ? n : room;
+        memcpy(buffer + used, data, chunk);
+        used += chunk;
+        data += chunk;
+        n -= chunk;
+    }
+}
+
+void CborWriter::flush() {
+    if (sink == nullptr || used == 0) return;
+    sink->write(buffer, used);
+    flushed += used;
+    used = 0;
+}
+
+void CborWriter::putHead(uint8_t major, uint32_t argument) {
+    uint8_t head[5];
+    size_t n;
+    major <<= 5;
+
+    if (argument < 24) {
+        head[0] = major | argument;
+        n = 1;
+    } else if (argument <= 0xFF) {
+        head[0] = major | 24;
+        head[1] = argument;
+        n = 2;
+    } else if (argument <= 0xFFFF) {
+        head[0] = major | 25;
+        head[1] = argument >> 8;
+        head[2] = argument;
+        n = 3;
+    } else {
+        head[0] = major | 26;
+        head[1] = argument >> 24;
+        head[2] = argument >> 16;
+        head[3] = argument >> 8;
+        head[4] = argument;
+        n = 5;
+    }
+    put(head, n);
+}
+
+void CborWriter::beginObject() {
+    put(0xBF);
+}
+
+void CborWriter::beginArray() {
+    put(0x9F);
+}
+
+void CborWriter::value(long v) {
+    if (v < 0) {
+        // Negative integers are stored as -1 - n
+        putHead(MAJOR_NEGATIVE, (uint32_t)(-(v + 1)));
+    } else {
+        putHead(MAJOR_UNSIGNED, (uint32_t)v);
+    }
+}
+
+void CborWriter::value(const char* v) {
+    size_t n = strlen(v);
+    putHead(MAJOR_TEXT, n);
+    put((const uint8_t*)v, n);
+}
+
+void CborWriter::value(float v, uint8_t decimals) {
+    if (isnan(v) || isinf(v) || fabsf(v) >= MAX_FORMATTED) {
+        null();
+        return;
+    }
+
+    // Round as JsonWriter::formatFixed() does, so both encodings carry one value
+    if (decimals > MAX_DECIMALS) decimals = MAX_DECIMALS;
+    bool negative = v < 0;
+    uint64_t scaled = (uint64_t)((negative ? -v : v) * POW10[decimals] + 0.5f);
+    if (decimals == 0) {
+        value(negative ? -(long)scaled : (long)scaled);
+        return;
+    }
+    v = (float)scaled / POW10[decimals];
+    if (negative && scaled != 0) v = -v;
+
+    int32_t half = toHalf(v);
+    if (half >= 0) {
+        uint8_t out[3] = { 0xF9, (uint8_t)(half >> 8), (uint8_t)half };
+        put(out, sizeof(out));
+        return;
+    }
+
+    uint32_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    uint8_t out[5] = { 0xFA, (uint8_t)(bits >> 24), (uint8_t)(bits >> 16),
+                       (uint8_t)(bits >> 8), (uint8_t)bits };
+    put(out, sizeof(out));
+}
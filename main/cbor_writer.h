@@ -0,0 +1,123 @@
+#ifndef CBOR_WRITER_H
+#define CBOR_WRITER_H
+
+#include <Arduino.h>
+
+/**
+ * CborWriter
+ *
+ * Streaming CBOR (RFC 8949) emitter with the same shape as JsonWriter:
+ * no heap, output into a caller-supplied buffer and optionally on to a
+ * Print sink, with the buffer used as scratch.
+ *
+ * Maps and arrays are indefinite-length (0xBF / 0x9F ... 0xFF), so they
+ * can be written without knowing their size up front. Keys are small
+ * unsigned integers, which the receiver maps back to names through the
+ * schema (see SchemaKey in sensor_schema.h).
+ *
+ * Floats are rounded exactly as JsonWriter prints them (at most 6
+ * decimals, |v| * 10^decimals rounded half up), so both encodings carry
+ * one value, then written in the smallest exact form:
+ *   - decimals == 0: an integer (1 to 5 bytes)
+ *   - half precision when that is exact (3 bytes), else single (5 bytes)
+ * NaN, infinity and magnitudes of 1e9 or more are written as null, as
+ * JsonWriter does.
+ *
+ * Usage:
+ *   uint8_t buf[256];
+ *   CborWriter w(client, buf, sizeof(buf));
+ *   w.beginObject();
+ *   w.member(3, 1.234f, 3);
+ *   w.endObject();
+ *   w.flush();
+ */
+class CborWriter {
+    friend class HostHarness;   // host/ tests and benchmarks
+
+public:
+    CborWriter(uint8_t* buffer, size_t capacity);
+    CborWriter(Print& sink, uint8_t* buffer, size_t capacity);
+
+    void beginObject();
+    void endObject() { put(BREAK); }
+    void beginArray();
+    void endArray() { put(BREAK); }
+
+    void key(uint8_t id) { putHead(MAJOR_UNSIGNED, id); }
+
+    void value(float v, uint8_t decimals);
+    void value(int v) { value((long)v); }
+    void value(long v);
+    void value(unsigned long v) { putHead(MAJOR_UNSIGNED, (uint32_t)v); }
+    void value(bool v) { put(v ? SIMPLE_TRUE : SIMPLE_FALSE); }
+    void value(const char* v);
+    void null() { put(SIMPLE_NULL); }
+
+    template <typename T>
+    void member(uint8_t id, T v) { key(id); value(v); }
+    void member(uint8_t id, float v, uint8_t decimals) { key(id); value(v, decimals); }
+
+    /**
+     * Tag the next data item (e.g. 262, embedded JSON text)
+     */
+    void tag(uint32_t number) { putHead(MAJOR_TAG, number); }
+
+    /**
+     * Start a text string of the given length; its bytes follow with raw()
+     */
+    void beginText(size_t length) { putHead(MAJOR_TEXT, (uint32_t)length); }
+
+    /**
+     * Insert pre-encoded bytes (a buffered CBOR record, or text started
+     * with beginText())
+     */
+    void raw(const uint8_t* data, size_t length) { put(data, length); }
+
+    /**
+     * Write any buffered output to the sink (no-op without a sink)
+     */
+    void flush();
+
+    /**
+     * Bytes currently in the buffer (the whole document without a sink)
+     */
+    size_t length() const { return used; }
+
+    /**
+     * Bytes produced so far, including those already flushed
+     */
+    size_t totalLength() const { return flushed + used; }
+
+    const uint8_t* data() const { return buffer; }
+
+    /**
+     * False if the document did not fit (buffer-only mode)
+     */
+    bool ok() const { return !overflow; }
+
+private:
+    static const uint8_t MAJOR_UNSIGNED = 0;
+    static const uint8_t MAJOR_NEGATIVE = 1;
+    static const uint8_t MAJOR_TEXT = 3;
+    static const uint8_t MAJOR_TAG = 6;
+    static const uint8_t SIMPLE_FALSE = 0xF4;
+    static const uint8_t SIMPLE_TRUE = 0xF5;
+    static const uint8_t SIMPLE_NULL = 0xF6;
+    static const uint8_t BREAK = 0xFF;
+
+    // Half-precision bits for f, or -1 if f has no exact half representation
+    static int32_t toHalf(float f);
+
+    void putHead(uint8_t major, uint32_t argument);
+    void put(uint8_t b) { put(&b, 1); }
+    void put(const uint8_t* data, size_t n);
+
+    Print* sink;
+    uint8_t* buffer;
+    size_t capacity;
+    size_t used = 0;
+    size_t flushed = 0;
+    bool overflow = false;
+};
+
+#endif
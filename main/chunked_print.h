@@ -0,0 +1,65 @@
+#ifndef CHUNKED_PRINT_H
+#define CHUNKED_PRINT_H
+
+#include <Arduino.h>
+
+/**
+ * ChunkedPrint
+ *
+ * Print adapter that frames every write() as one HTTP/1.1 chunk
+ * (Transfer-Encoding: chunked) on the underlying stream. Put a
+ * JsonWriter with a fixed scratch buffer in front of it and each
+ * buffer flush becomes one chunk, so a response of any length goes
+ * out in bounded RAM without knowing its Content-Length up front.
+ *
+ * Usage:
+ *   client.print("...Transfer-Encoding: chunked\r\n\r\n");
+ *   ChunkedPrint body(client);
+ *   ... write the body through body ...
+ *   body.finish();
+ */
+class ChunkedPrint : public Print {
+public:
+    explicit ChunkedPrint(Print& out) : out(out) {}
+
+    size_t write(uint8_t c) override { return write(&c, 1); }
+
+    size_t write(const uint8_t* data, size_t length) override {
+        // A zero-length chunk would end the body early
+        if (length == 0) return 0;
+
+        char size[12];
+        int n = snprintf(size, sizeof(size), "%X\r\n", (unsigned)length);
+        out.write((const uint8_t*)size, n);
+        out.write(data, length);
+        out.write((const uint8_t*)"\r\n", 2);
+        bodyBytes += length;
+        return length;
+    }
+
+    /**
+     * Send the terminating zero-length chunk
+     */
+    void finish() { out.write((const uint8_t*)"0\r\n\r\n", 5); }
+
+    size_t bytesWritten() const { return bodyBytes; }
+
+    /**
+     * Most bytes a body can take on the wire, framing included
+     * @param body Body bytes
+     * @param block Largest single write(), e.g. a JsonWriter's buffer size
+     * @return body plus the size line and CRLF of each chunk, and finish()
+     */
+    static size_t wireLength(size_t body, size_t block) {
+        size_t digits = 1;
+        for (size_t n = block; n > 0xF; n >>= 4) digits++;
+        size_t chunks = (body + block - 1) / block;
+        return body + chunks * (digits + 4) + 5;
+    }
+
+private:
+    Print& out;
+    size_t bodyBytes = 0;
+};
+
+#endif
@@ -21,6 +21,7 @@
 #define ME4_SO2_SENSOR_ENABLED
 #define BUTTON_LED_ENABLED
 #define DEBUG_SERIAL_ENABLED
+// #define PERF_MONITOR_ENABLED  // On-device perf probes (perf_monitor.h); costs time on every probed call
 
 // Hardware Configuration
 #define ZE40_DAC_PIN 4
@@ -56,6 +57,51 @@ extern const char* API_ACCESS_TOKEN;
 #define DJANGO_ENABLED
 extern const char* DJANGO_SERVER_URL;  // e.g., "http://192.168.1.100:8000/api/sensors"
 
+// JSON Payloads (json_writer.h)
+#define JSON_PAYLOAD_BUFFER_SIZE 1024  // One buffered record
+#define UPLINK_PAYLOAD_BUFFER_SIZE 4096  // Live upload body, with the rolling statistics
+#define JSON_STREAM_CHUNK_SIZE 256     // Scratch for JSON streamed to a client
+
+// Offline Buffer (ring_log.h)
+#define BUFFER_LOG_PARTITION "buflog"  // Data partition in partitions.csv
+#define BACKLOG_BATCH_SIZE 20          // Buffered entries per replay POST
+#define BACKLOG_DRAIN_INTERVAL 5000    // Min time between replay POSTs
+#define BACKLOG_BATCHES_PER_DRAIN 2    // Replay POSTs sent back-to-back per drain
+
+// Uplink Queue (uplink_queue.h)
+#define UPLINK_POLICY_DROP_OLDEST 0
+#define UPLINK_POLICY_COALESCE 1
+#define UPLINK_POLICY_SPILL 2
+#define UPLINK_QUEUE_DEPTH 8           // Snapshots waiting for the uplink task (power of two)
+#define UPLINK_QUEUE_POLICY UPLINK_POLICY_SPILL  // What a full queue does with a new sample
+#define UPLINK_SPILL_DEPTH 4           // SPILL: pop() files a sample with this many queued behind it
+
+// Uplink Connection (django_client.h)
+#define HTTP_KEEPALIVE_ENABLED         // Comment out to open a connection per request
+#define HTTP_KEEPALIVE_IDLE_TIMEOUT 30000  // Reconnect instead of reusing an older socket
+#define HTTP_RESPONSE_TIMEOUT 10000    // Wait for status line, headers and body
+#define HTTP_RESPONSE_READ_SIZE 256    // Bulk read from the socket into the parser
+#define HTTP_RESPONSE_LINE_SIZE 128    // Longest status/header line kept
+#define HTTP_RESPONSE_BODY_KEPT 96     // Response body bytes kept for error logs
+#define HTTP_RETRY_AFTER_MAX 600       // Cap on a server's Retry-After (s)
+#define UPLINK_CBOR_ENABLED            // application/cbor bodies; comment out for JSON
+
+// Upload Compression (deflate_writer.h)
+#define UPLINK_COMPRESSION_ENABLED     // Comment out to always send plain JSON
+#define UPLINK_COMPRESSION_GZIP        // gzip framing; comment out for zlib ("deflate")
+#define UPLINK_COMPRESS_MIN_BYTES 256  // Smaller bodies go out plain
+#define UPLINK_COMPRESS_MAX_PERCENT 90 // Send plain unless this small or smaller
+#define DEFLATE_WINDOW_SIZE 2048       // LZ77 history (power of two); state is ~4.5x this
+#define DEFLATE_MAX_CHAIN 32           // Match candidates tried per position
+
+// DNS (dns_resolver.h)
+#define DNS_CACHE_SIZE 4               // Hostnames cached across interfaces
+#define DNS_TIMEOUT 2000               // Wait per query attempt
+#define DNS_RETRIES 2
+#define DNS_MIN_TTL 10                 // Clamp for the TTL of an answer (s)
+#define DNS_MAX_TTL 3600
+#define DNS_NEGATIVE_TTL 30            // Hold a failed lookup before retrying (s)
+
 // Task Configuration - Optimized for ESP32-S3
 // Increased stack sizes to prevent mutex assertion failures during concurrent network ops
 #define ETH_TASK_STACK_SIZE 32768  // Increased from 20480 for HTTP client stability
@@ -63,6 +109,8 @@ extern const char* DJANGO_SERVER_URL;  // e.g., "http://192.168.1.100:8000/api/s
 #define SENSOR_TASK_STACK_SIZE 20480
 #define ETH_TASK_PRIORITY 2
 #define SENSOR_TASK_PRIORITY 1
+#define UPLINK_TASK_STACK_SIZE 20480   // HTTP payload, response parser and DNS buffers
+#define UPLINK_TASK_PRIORITY 1
 
 // Timing Configuration
 #define DAC_READ_INTERVAL 5000
@@ -71,6 +119,64 @@ extern const char* DJANGO_SERVER_URL;  // e.g., "http://192.168.1.100:8000/api/s
 #define MR007_READ_INTERVAL 2000
 #define ME4_SO2_READ_INTERVAL 2000
 #define SENSOR_WARMUP_TIME 180000
+#define SENSOR_POLL_INTERVAL 50        // UART timeouts, button and WiFi client service
+#define DJANGO_SEND_INTERVAL 10000
+#define SCHEDULER_REPORT_INTERVAL 60000
+#define ZE40_UART_FRAME_INTERVAL 1000  // Initiative mode frame period
+
+// UART Transactions (ZE40 / ZPHS01B command queues)
+#define UART_REPLY_TIMEOUT 500         // Wait for a reply before resending
+#define UART_MAX_RETRIES 2             // Resends after a timeout
+#define ZE40_MODE_SETTLE_TIME 100      // Line hold after a mode switch
+#define UART_RX_TIMEOUT_SYMBOLS 2      // Idle time that ends a frame (~2 ms at 9600)
+#define UART_FRAME_QUEUE_DEPTH 4       // Frames waiting for the sensor task
+
+// ADC Sampling (continuous DMA on ZE40 DAC, MR007 and ME4-SO2 pins)
+#define ADC_SAMPLE_RATE_HZ 1000        // Conversions per second per channel
+#define ADC_OVERSAMPLE_BITS 4          // 4^n conversions per reading, n extra bits
+#define ADC_DRAIN_INTERVAL 100         // DMA pool drain period
+#define ADC_DMA_POOL_BYTES 4096        // Holds ~340 ms of conversions
+#define ADC_CIC_ORDER 2                // Decimator stages (1 = plain average)
+
+// Signal Filtering (dsp_filters.h)
+// Each channel picks a chain from FILTER_MEDIAN, FILTER_EMA and
+// FILTER_KALMAN (OR them together); stages run in that order.
+#define FILTER_NONE 0x00
+#define FILTER_MEDIAN 0x01
+#define FILTER_EMA 0x02
+#define FILTER_KALMAN 0x04
+
+#define FILTER_FRAC_BITS 16            // Q16.16 fixed point
+#define FILTER_MEDIAN_WINDOW 5
+#define FILTER_EMA_SHIFT 2             // alpha = 1/4
+#define FILTER_KALMAN_Q_OVER_R_Q16 655 // Process/measurement noise ~0.01
+
+#define MR007_FILTER (FILTER_MEDIAN | FILTER_EMA)
+#define ME4_SO2_FILTER (FILTER_MEDIAN | FILTER_EMA)
+#define ZE40_DAC_FILTER FILTER_EMA
+#define ZPHS01B_PM1_FILTER FILTER_MEDIAN
+#define ZPHS01B_PM25_FILTER FILTER_MEDIAN
+#define ZPHS01B_PM10_FILTER FILTER_MEDIAN
+#define ZPHS01B_CO2_FILTER (FILTER_MEDIAN | FILTER_KALMAN)
+#define ZPHS01B_VOC_FILTER FILTER_NONE      // 0-3 grade, not a concentration
+#define ZPHS01B_CH2O_FILTER FILTER_MEDIAN
+#define ZPHS01B_CO_FILTER FILTER_MEDIAN
+#define ZPHS01B_O3_FILTER FILTER_MEDIAN
+#define ZPHS01B_NO2_FILTER FILTER_MEDIAN
+#define ZPHS01B_TEMPERATURE_FILTER FILTER_EMA
+#define ZPHS01B_HUMIDITY_FILTER FILTER_EMA
+
+// Sensor History (per-sensor sample rings)
+#define HISTORY_SECONDS 3600           // Span kept when PSRAM is available
+#define HISTORY_SECONDS_NO_PSRAM 900   // Span kept in internal RAM only
+#define HISTORY_DEFAULT_POINTS 200     // /history output points when ?points= is absent
+#define HISTORY_MAX_POINTS 1000        // Upper bound on ?points=
+#define HISTORY_POINTS_PER_PASS 16     // Most /history points per connection per web server pass
+
+// Rolling Statistics (per-field mean/min/max/stddev, rolling_stats.h)
+#define ROLLING_STATS_ENABLED          // Comment out to drop "stats" from uploads and /stats
+#define ROLLING_WINDOWS_S { 60, 300, 3600 }  // Window lengths in seconds, at most 4
+#define ROLLING_BUCKETS 12             // Slices per window; a window slides one slice at a time
 
 // ZE40 Configuration
 #define FRAME_TIMEOUT 150
@@ -90,9 +196,18 @@ extern const char* DJANGO_SERVER_URL;  // e.g., "http://192.168.1.100:8000/api/s
 #define SO2_SENSITIVITY 0.8
 #define SO2_LOAD_RESISTOR 10.0
 
-// Connection Management
-#define MAX_CONCURRENT_CONNECTIONS 3
-#define CONNECTION_TIMEOUT_MS 5000
+// Connection Management (web_server.h)
+#define MAX_CONCURRENT_CONNECTIONS 4   // Web clients served at once; see the W5500 socket budget in web_server.h
+#define CONNECTION_TIMEOUT_MS 5000     // Drop a client that stops taking its response
+#define WEB_REQUEST_TIMEOUT 2000       // Request line and headers must arrive within this
+#define WEB_REQUEST_LINE_SIZE 256      // Longest request/header line kept
+#define WEB_AUTH_HEADER_SIZE 128       // Authorization / X-API-Token value kept
+#define WEB_MAX_HEADER_BYTES 4096      // Larger requests are answered 431
+#define WEB_WRITE_CHUNK 512            // Response bytes per connection per pass
+#define WEB_MAX_WEBSOCKETS 2           // Live dashboards (/ws); the other slots stay for HTTP
+#define WS_MIN_PUSH_INTERVAL_MS 500    // Sensor updates closer together are sent as one frame
+#define WS_PING_INTERVAL_MS 15000      // Ping a quiet client; close it after two silent intervals
+#define WS_FRAME_BUFFER_SIZE 768       // Largest pushed frame (a full JSON snapshot is ~450 B)
 #define LED_TIMEOUT 5000
 
 // Debug Configuration
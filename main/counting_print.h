@@ -0,0 +1,31 @@
+#ifndef COUNTING_PRINT_H
+#define COUNTING_PRINT_H
+
+#include <Arduino.h>
+
+/**
+ * CountingPrint
+ *
+ * Print sink that discards its input and counts the bytes. Running a
+ * streamed body through it first gives the Content-Length, without
+ * holding the body in RAM.
+ */
+class CountingPrint : public Print {
+public:
+    size_t write(uint8_t) override {
+        bytes++;
+        return 1;
+    }
+
+    size_t write(const uint8_t*, size_t length) override {
+        bytes += length;
+        return length;
+    }
+
+    size_t count() const { return bytes; }
+
+private:
+    size_t bytes = 0;
+};
+
+#endif
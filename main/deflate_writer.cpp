@@ -0,0 +1,240 @@
+#include "deflate_writer.h"
+#include <esp_rom_crc.h>
+
+static const size_t MIN_MATCH = 3;
+static const size_t MAX_MATCH = 258;
+
+static_assert((DEFLATE_WINDOW_SIZE & (DEFLATE_WINDOW_SIZE - 1)) == 0,
+              "DEFLATE_WINDOW_SIZE must be a power of two");
+static_assert(DEFLATE_WINDOW_SIZE >= 2 * MAX_MATCH && DEFLATE_WINDOW_SIZE <= 16384,
+              "DEFLATE_WINDOW_SIZE must be 516..16384 so positions fit 16 bits");
+
+// Length symbols 257..285: base length and extra bits
+static const uint16_t LENGTH_BASE[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+static const uint8_t LENGTH_EXTRA[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+
+// Distance codes 0..29: base distance and extra bits
+static const uint16_t DISTANCE_BASE[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+    8193, 12289, 16385, 24577
+};
+static const uint8_t DISTANCE_EXTRA[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+
+void DeflateWriter::begin(Print& sink, Format format) {
+    this->sink = &sink;
+    this->format = format;
+    filled = 0;
+    pos = 0;
+    bitBuffer = 0;
+    bitCount = 0;
+    outUsed = 0;
+    totalIn = 0;
+    totalOut = 0;
+    for (size_t i = 0; i < HASH_SIZE; i++) head[i] = NIL;
+
+    if (format == GZIP) {
+        // Magic, deflate, no flags, no mtime, no extra flags, OS unknown
+        static const uint8_t GZIP_HEADER[10] = { 0x1F, 0x8B, 8, 0, 0, 0, 0, 0, 0, 0xFF };
+        for (uint8_t b : GZIP_HEADER) putByte(b);
+        checksum = 0;
+    } else {
+        // 32K window, fastest level; 0x7801 is a multiple of 31
+        putByte(0x78);
+        putByte(0x01);
+        checksum = 1;
+    }
+
+    // One final block with the fixed Huffman code
+    putBits(1, 1);
+    putBits(1, 2);
+}
+
+size_t DeflateWriter::write(uint8_t c) {
+    return write(&c, 1);
+}
+
+size_t DeflateWriter::write(const uint8_t* data, size_t length) {
+    if (format == GZIP) {
+        checksum = esp_rom_crc32_le(checksum, data, length);
+    } else {
+        uint32_t a = checksum & 0xFFFF;
+        uint32_t b = checksum >> 16;
+        for (size_t i = 0; i < length; i++) {
+            a = (a + data[i]) % 65521;
+            b = (b + a) % 65521;
+        }
+        checksum = (b << 16) | a;
+    }
+    totalIn += length;
+
+    size_t left = length;
+    while (left > 0) {
+        size_t room = sizeof(window) - filled;
+        if (room == 0) {
+            compress(false);
+            slide();
+            continue;
+        }
+        size_t chunk = (left < room) ? left : room;
+        memcpy(window + filled, data, chunk);
+        filled += chunk;
+        data += chunk;
+        left -= chunk;
+    }
+    return length;
+}
+
+void DeflateWriter::finish() {
+    compress(true);
+
+    // End of block, then pad to a byte boundary
+    putCode(0, 7);
+    if (bitCount > 0) putBits(0, 8 - bitCount);
+
+    if (format == GZIP) {
+        for (uint8_t i = 0; i < 4; i++) putByte(checksum >> (8 * i));
+        for (uint8_t i = 0; i < 4; i++) putByte(totalIn >> (8 * i));
+    } else {
+        for (int8_t i = 3; i >= 0; i--) putByte(checksum >> (8 * i));
+    }
+    flushOutput();
+}
+
+uint16_t DeflateWriter::hashAt(size_t p) const {
+    return ((window[p] << 10) ^ (window[p + 1] << 5) ^ window[p + 2]) & (HASH_SIZE - 1);
+}
+
+void DeflateWriter::insert(size_t p) {
+    uint16_t h = hashAt(p);
+    prev[p & (WINDOW - 1)] = head[h];
+    head[h] = p;
+}
+
+size_t DeflateWriter::longestMatch(size_t p, size_t& distance) {
+    size_t limit = filled - p;
+    if (limit > MAX_MATCH) limit = MAX_MATCH;
+
+    size_t best = 0;
+    size_t last = p;
+    uint16_t candidate = head[hashAt(p)];
+
+    for (uint16_t chain = 0; chain < DEFLATE_MAX_CHAIN && candidate != NIL; chain++) {
+        // Chains only run backwards; anything else is a recycled slot
+        if (candidate >= last || p - candidate >= WINDOW) break;
+        last = candidate;
+
+        if (window[candidate + best] == window[p + best]) {
+            size_t length = 0;
+            while (length < limit && window[candidate + length] == window[p + length]) length++;
+            if (length > best) {
+                best = length;
+                distance = p - candidate;
+                if (best == limit) break;
+            }
+        }
+        candidate = prev[candidate & (WINDOW - 1)];
+    }
+    return best;
+}
+
+void DeflateWriter::compress(bool flush) {
+    while (pos < filled) {
+        size_t lookahead = filled - pos;
+        if (!flush && lookahead < MAX_MATCH) break;
+
+        size_t length = 0;
+        size_t distance = 0;
+        if (lookahead >= MIN_MATCH) {
+            length = longestMatch(pos, distance);
+            insert(pos);
+        }
+
+        if (length >= MIN_MATCH) {
+            match(length, distance);
+            for (size_t i = 1; i < length; i++) {
+                if (filled - (pos + i) >= MIN_MATCH) insert(pos + i);
+            }
+            pos += length;
+        } else {
+            literal(window[pos]);
+            pos++;
+        }
+    }
+}
+
+void DeflateWriter::slide() {
+    // Keep the last WINDOW bytes as history; positions move down with them
+    memmove(window, window + WINDOW, filled - WINDOW);
+    filled -= WINDOW;
+    pos -= WINDOW;
+    for (size_t i = 0; i < HASH_SIZE; i++) {
+        head[i] = (head[i] != NIL && head[i] >= WINDOW) ? head[i] - WINDOW : NIL;
+    }
+    for (size_t i = 0; i < WINDOW; i++) {
+        prev[i] = (prev[i] != NIL && prev[i] >= WINDOW) ? prev[i] - WINDOW : NIL;
+    }
+}
+
+void DeflateWriter::literal(uint8_t c) {
+    // Fixed code: 0..143 are 8 bits from 0x30, 144..255 are 9 bits from 0x190
+    if (c < 144) putCode(0x30 + c, 8);
+    else putCode(0x190 + (c - 144), 9);
+}
+
+void DeflateWriter::match(size_t length, size_t distance) {
+    uint8_t l = 28;
+    while (LENGTH_BASE[l] > length) l--;
+    uint16_t symbol = 257 + l;
+
+    // Fixed code: 256..279 are 7 bits from 0, 280..287 are 8 bits from 0xC0
+    if (symbol < 280) putCode(symbol - 256, 7);
+    else putCode(0xC0 + (symbol - 280), 8);
+    putBits(length - LENGTH_BASE[l], LENGTH_EXTRA[l]);
+
+    uint8_t d = 29;
+    while (DISTANCE_BASE[d] > distance) d--;
+    putCode(d, 5);
+    putBits(distance - DISTANCE_BASE[d], DISTANCE_EXTRA[d]);
+}
+
+void DeflateWriter::putBits(uint32_t value, uint8_t count) {
+    bitBuffer |= value << bitCount;
+    bitCount += count;
+    while (bitCount >= 8) {
+        putByte(bitBuffer & 0xFF);
+        bitBuffer >>= 8;
+        bitCount -= 8;
+    }
+}
+
+void DeflateWriter::putCode(uint32_t code, uint8_t count) {
+    // Huffman codes are packed starting from their most significant bit
+    uint32_t reversed = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        reversed = (reversed << 1) | (code & 1);
+        code >>= 1;
+    }
+    putBits(reversed, count);
+}
+
+void DeflateWriter::putByte(uint8_t b) {
+    out[outUsed++] = b;
+    if (outUsed == sizeof(out)) flushOutput();
+}
+
+void DeflateWriter::flushOutput() {
+    if (outUsed == 0) return;
+    sink->write(out, outUsed);
+    totalOut += outUsed;
+    outUsed = 0;
+}
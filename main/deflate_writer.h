@@ -0,0 +1,91 @@
+#ifndef DEFLATE_WRITER_H
+#define DEFLATE_WRITER_H
+
+#include <Arduino.h>
+#include "config.h"
+
+/**
+ * Deflate Writer
+ *
+ * Streaming DEFLATE compressor (RFC 1951) with zlib (RFC 1950) or gzip
+ * (RFC 1952) framing, as a Print sink. Whatever is written to it comes
+ * out compressed on the wrapped Print, through a small output buffer,
+ * so a body of any size is compressed in fixed RAM.
+ *
+ * The encoder is greedy LZ77 over a DEFLATE_WINDOW_SIZE history with
+ * hash chains, followed by the fixed Huffman code. There are no dynamic
+ * trees, so no per-block symbol statistics are kept. On sensor JSON,
+ * where the savings come from repeated keys, this gets close to zlib
+ * level 1 in about 4.5 x DEFLATE_WINDOW_SIZE bytes of state.
+ *
+ * The whole stream is one final fixed block. Output depends only on
+ * the input, so a sizing pass through a CountingPrint gives the exact
+ * Content-Length of a later pass.
+ *
+ * Usage:
+ *   static DeflateWriter deflater;      // State is large; keep it off the stack
+ *   deflater.begin(client, DeflateWriter::GZIP);
+ *   deflater.write(data, length);
+ *   deflater.finish();
+ */
+class DeflateWriter : public Print {
+public:
+    enum Format : uint8_t {
+        ZLIB,       // HTTP "Content-Encoding: deflate"
+        GZIP        // HTTP "Content-Encoding: gzip"
+    };
+
+    /**
+     * Start a new stream on sink (writes the format header)
+     */
+    void begin(Print& sink, Format format);
+
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* data, size_t length) override;
+    using Print::write;
+
+    /**
+     * Compress what is left, end the block and write the trailer
+     */
+    void finish();
+
+    size_t bytesIn() const { return totalIn; }
+    size_t bytesOut() const { return totalOut; }
+
+private:
+    static const size_t WINDOW = DEFLATE_WINDOW_SIZE;
+    static const size_t HASH_SIZE = 1024;
+    static const uint16_t NIL = 0xFFFF;
+
+    void compress(bool flush);
+    void slide();
+    uint16_t hashAt(size_t p) const;
+    void insert(size_t p);
+    size_t longestMatch(size_t p, size_t& distance);
+    void literal(uint8_t c);
+    void match(size_t length, size_t distance);
+    void putBits(uint32_t value, uint8_t count);
+    void putCode(uint32_t code, uint8_t count);
+    void putByte(uint8_t b);
+    void flushOutput();
+
+    Print* sink = nullptr;
+    Format format = GZIP;
+
+    uint8_t window[2 * WINDOW];         // History, then input still to encode
+    size_t filled = 0;                  // Bytes held in window
+    size_t pos = 0;                     // Next byte to encode
+    uint16_t head[HASH_SIZE];           // Latest window position per hash
+    uint16_t prev[WINDOW];              // Older position with the same hash
+
+    uint32_t bitBuffer = 0;
+    uint8_t bitCount = 0;
+    uint8_t out[256];                   // Compressed bytes waiting for the sink
+    size_t outUsed = 0;
+
+    uint32_t checksum = 0;              // CRC-32 (gzip) or Adler-32 (zlib)
+    size_t totalIn = 0;
+    size_t totalOut = 0;
+};
+
+#endif
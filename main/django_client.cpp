@@ -1,6 +1,16 @@
 #include "django_client.h"
 #include "shared_data.h"
 #include "network_manager.h"
+#include "perf_monitor.h"
+#include "sensor_schema.h"
+#include "rolling_stats.h"
+#include "json_writer.h"
+#include "cbor_writer.h"
+#include "buffer_manager.h"
+#include "counting_print.h"
+#include "dns_resolver.h"
+#include "http_response_parser.h"
+#include "deflate_writer.h"
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 #include <Ethernet.h>
@@ -10,326 +20,537 @@
 #include <WiFi.h>
 #endif
 
-String DjangoClient::serverURL = "";
-unsigned long DjangoClient::lastSendTime = 0;
+UplinkEndpoint DjangoClient::endpoint = {};
+bool DjangoClient::linkHealthy = false;
+Client* DjangoClient::connection = nullptr;
+IPAddress DjangoClient::connectedIP;
+uint16_t DjangoClient::connectedPort = 0;
+unsigned long DjangoClient::lastActivity = 0;
+DjangoClient::UplinkStats DjangoClient::uplinkStats = {};
+unsigned long DjangoClient::holdOffStart = 0;
+unsigned long DjangoClient::holdOffMs = 0;
+bool DjangoClient::compressionRejected = false;
+bool DjangoClient::cborRejected = false;
 
-// Native socket-based HTTP POST to avoid HTTPClient mutex conflicts
-bool DjangoClient::sendHTTPPOST(const String& url, const String& payload) {
-    // Parse URL to extract host, port, and path
-    String host = "";
-    String path = "/api/sensors";
-    int port = 80;
-    
-    // Remove http:// prefix if present
-    String cleanURL = url;
-    if (cleanURL.startsWith("http://")) {
-        cleanURL = cleanURL.substring(7);
-    }
-    
-    // Extract path
-    int pathIndex = cleanURL.indexOf('/');
-    if (pathIndex != -1) {
-        path = cleanURL.substring(pathIndex);
-        host = cleanURL.substring(0, pathIndex);
+// One socket per interface; at most one of them is open at a time
+#ifdef ETHERNET_ENABLED
+static EthernetClient ethernetClient;
+#endif
+
+#ifdef WIFI_FALLBACK_ENABLED
+static WiFiClient wifiClient;
+#endif
+
+#ifdef UPLINK_COMPRESSION_ENABLED
+// Encoder state is several KB; only the uplink task uses it
+static DeflateWriter deflater;
+
+#ifdef UPLINK_COMPRESSION_GZIP
+static const DeflateWriter::Format UPLINK_FORMAT = DeflateWriter::GZIP;
+static const char* UPLINK_ENCODING = "gzip";
+#else
+static const DeflateWriter::Format UPLINK_FORMAT = DeflateWriter::ZLIB;
+static const char* UPLINK_ENCODING = "deflate";
+#endif
+#endif
+
+void DjangoClient::writeBody(Print& out, const PostBody& body) {
+    if (body.data != nullptr) {
+        out.write((const uint8_t*)body.data, body.length);
+    } else if (body.cbor) {
+        BufferManager::streamCBOREntries(out, body.backlogEntries, body.backlogNow);
     } else {
-        host = cleanURL;
+        BufferManager::streamEntries(out, body.backlogEntries, body.backlogNow);
     }
+}
+
+bool DjangoClient::useCBOR() {
+    #ifdef UPLINK_CBOR_ENABLED
+    return !cborRejected;
+    #else
+    return false;
+    #endif
+}
+
+void DjangoClient::compressBody(PostBody& body) {
+    body.compressed = false;
+    body.wireLength = body.length;
     
-    // Extract port if specified
-    int portIndex = host.indexOf(':');
-    if (portIndex != -1) {
-        port = host.substring(portIndex + 1).toInt();
-        host = host.substring(0, portIndex);
+    #ifdef UPLINK_COMPRESSION_ENABLED
+    if (compressionRejected || body.length < UPLINK_COMPRESS_MIN_BYTES) {
+        return;
     }
     
-    // Parse host string to IP address
-    IPAddress serverIP;
-    if (!serverIP.fromString(host)) {
-        // Try WiFi DNS resolution if available
-        #ifdef WIFI_FALLBACK_ENABLED
-        if (networkManager.isWifiActive() || networkManager.isAPActive()) {
-            DEBUG_PRINT("Attempting DNS resolution for: ");
-            DEBUG_PRINTLN(host);
-            IPAddress resolvedIP;
-            int dnsResult = WiFi.hostByName(host.c_str(), resolvedIP);
-            if (dnsResult == 1) {
-                serverIP = resolvedIP;
-                DEBUG_PRINT("✓ Resolved to: ");
-                DEBUG_PRINTLN(serverIP);
-            } else {
-                DEBUG_PRINTLN("✗ DNS resolution failed for: " + host);
-                return false;
-            }
-        } else
-        #endif
-        {
-            // W5500 requires IP address
-            DEBUG_PRINTLN("✗ Host must be an IP address (DNS not available for W5500): " + host);
-            DEBUG_PRINTLN("  Edit credentials.h and set DJANGO_SERVER_URL to your server's IP");
+    // Sizing pass; the same bytes are produced again while sending
+    unsigned long start = micros();
+    CountingPrint counter;
+    {
+        PERF_SCOPE(PERF_UPLINK_COMPRESS);
+        deflater.begin(counter, UPLINK_FORMAT);
+        writeBody(deflater, body);
+        deflater.finish();
+    }
+    uplinkStats.compressUs += micros() - start;
+    uplinkStats.compressPasses++;
+    
+    if (counter.count() * 100 <= body.length * UPLINK_COMPRESS_MAX_PERCENT) {
+        body.compressed = true;
+        body.wireLength = counter.count();
+        uplinkStats.compressedBodies++;
+    }
+    #endif
+}
+
+// Headers and body go out as separate writes straight from their
+// buffers; nothing is concatenated on the heap
+void DjangoClient::writeRequest(Client& client, const PostBody& body) {
+    char contentLength[12];
+    contentLength[JsonWriter::formatUnsigned(contentLength, (uint32_t)body.wireLength)] = '\0';
+
+    client.print("POST ");
+    client.print(endpoint.path);
+    client.print(" HTTP/1.1\r\nHost: ");
+    client.print(endpoint.host);
+    if (endpoint.port != 80) {
+        client.print(':');
+        client.print(endpoint.port);
+    }
+    client.print(body.cbor ? "\r\nContent-Type: application/cbor" : "\r\nContent-Type: application/json");
+    client.print("\r\nContent-Length: ");
+    client.print(contentLength);
+    #ifdef UPLINK_COMPRESSION_ENABLED
+    if (body.compressed) {
+        client.print("\r\nContent-Encoding: ");
+        client.print(UPLINK_ENCODING);
+    }
+    #endif
+    #ifdef HTTP_KEEPALIVE_ENABLED
+    client.print("\r\nConnection: keep-alive\r\n\r\n");
+    #else
+    client.print("\r\nConnection: close\r\n\r\n");
+    #endif
+    
+    #ifdef UPLINK_COMPRESSION_ENABLED
+    if (body.compressed) {
+        deflater.begin(client, UPLINK_FORMAT);
+        writeBody(deflater, body);
+        deflater.finish();
+        return;
+    }
+    #endif
+    writeBody(client, body);
+}
+
+// Split "http://host[:port]/path" once, when the URL is configured
+static bool parseEndpoint(const char* url, UplinkEndpoint& endpoint) {
+    endpoint.valid = false;
+    
+    if (strncmp(url, "https://", 8) == 0) {
+        DEBUG_PRINTLN("✗ HTTPS is not supported, use an http:// URL");
+        return false;
+    }
+    if (strncmp(url, "http://", 7) == 0) {
+        url += 7;
+    }
+    
+    const char* slash = strchr(url, '/');
+    const char* hostEnd = slash ? slash : url + strlen(url);
+    const char* colon = (const char*)memchr(url, ':', hostEnd - url);
+    const char* nameEnd = colon ? colon : hostEnd;
+    
+    size_t hostLength = nameEnd - url;
+    if (hostLength == 0 || hostLength >= sizeof(endpoint.host)) {
+        DEBUG_PRINTLN("✗ Server URL has an empty or too long host");
+        return false;
+    }
+    memcpy(endpoint.host, url, hostLength);
+    endpoint.host[hostLength] = '\0';
+    
+    endpoint.port = 80;
+    if (colon) {
+        long port = atol(colon + 1);
+        if (port <= 0 || port > 65535) {
+            DEBUG_PRINTLN("✗ Server URL has an invalid port");
             return false;
         }
+        endpoint.port = (uint16_t)port;
     }
     
-    DEBUG_PRINT("✓ Connecting to ");
-    DEBUG_PRINT(serverIP);
-    DEBUG_PRINT(":");
-    DEBUG_PRINTLN(port);
+    const char* path = slash ? slash : "/api/sensors";
+    if (strlen(path) >= sizeof(endpoint.path)) {
+        DEBUG_PRINTLN("✗ Server URL path is too long");
+        return false;
+    }
+    strcpy(endpoint.path, path);
     
-    // Create appropriate client based on active network
-    unsigned long connectStart = millis();
-    bool connected = false;
+    endpoint.valid = true;
+    return true;
+}
+
+// Native socket-based HTTP POST to avoid HTTPClient mutex conflicts
+bool DjangoClient::sendHTTPPOST(const PostBody& json) {
+    // Hostnames are resolved through the cache; literals cost nothing
+    IPAddress serverIP;
+    if (!DnsResolver::resolve(endpoint.host, serverIP)) {
+        return false;
+    }
     
-    #ifdef ETHERNET_ENABLED
-    if (networkManager.isEthernetActive()) {
-        EthernetClient client;
-        connected = client.connect(serverIP, port);
-        
-        if (!connected) {
-            DEBUG_PRINTLN("✗ Failed to connect to server via Ethernet");
+    PostBody body = json;
+    compressBody(body);
+    
+    // Latency includes any connect, so reuse shows up in the average
+    unsigned long requestStart = micros();
+    
+    for (uint8_t attempt = 0; attempt < 2; attempt++) {
+        bool reused = false;
+        if (!openConnection(serverIP, endpoint.port, reused)) {
+            // The host may have moved; look it up again next time
+            DnsResolver::invalidate(endpoint.host);
             return false;
         }
         
-        unsigned long connectTime = millis() - connectStart;
-        DEBUG_PRINT("✓ Connected in ");
-        DEBUG_PRINT(connectTime);
-        DEBUG_PRINTLN("ms");
-        
-        // Build HTTP POST request
-        String httpRequest = "POST " + path + " HTTP/1.1\r\n";
-        httpRequest += "Host: " + host + "\r\n";
-        httpRequest += "Content-Type: application/json\r\n";
-        httpRequest += "Content-Length: " + String(payload.length()) + "\r\n";
-        httpRequest += "Connection: close\r\n";
-        httpRequest += "\r\n";
-        httpRequest += payload;
-        
-        // Send request
-        client.print(httpRequest);
-        client.flush();
+        writeRequest(*connection, body);
+        connection->flush();
         
-        DEBUG_PRINTLN("✓ Request sent, waiting for response...");
+        HttpResponseParser response;
+        bool closedUnanswered = false;
+        bool complete = readResponse(*connection, response, closedUnanswered);
+        bool keepOpen = complete && response.keepAlive();
+        int httpStatusCode = response.headersDone() ? response.statusCode() : 0;
         
-        // Read response
-        unsigned long responseStart = millis();
-        String response = "";
-        int httpStatusCode = 0;
-        bool headersParsed = false;
-        
-        unsigned long timeout = 10000;  // 10 second timeout
-        while (client.connected() && (millis() - responseStart < timeout)) {
-            if (client.available()) {
-                char c = client.read();
-                response += c;
-                
-                // Parse status line
-                if (!headersParsed && response.indexOf("\r\n\r\n") != -1) {
-                    headersParsed = true;
-                    
-                    int statusStart = response.indexOf(' ') + 1;
-                    int statusEnd = response.indexOf(' ', statusStart);
-                    String statusStr = response.substring(statusStart, statusEnd);
-                    httpStatusCode = statusStr.toInt();
-                    
-                    DEBUG_PRINT("✓ HTTP Status: ");
-                    DEBUG_PRINTLN(httpStatusCode);
-                    
-                    if (httpStatusCode >= 200 && httpStatusCode < 300) {
-                        client.stop();
-                        return true;
-                    }
-                }
-            } else {
-                vTaskDelay(pdMS_TO_TICKS(10));
-            }
+        if (closedUnanswered && reused) {
+            // The server dropped the idle socket as the request went out;
+            // retry once on a fresh one. A timeout is not retried: the
+            // server may have the request and still be working on it
+            DEBUG_PRINTLN("⚠ Kept-alive connection went stale, reconnecting");
+            uplinkStats.staleRetries++;
+            closeConnection();
+            continue;
         }
         
-        client.stop();
+        uplinkStats.requests++;
+        uplinkStats.requestUs += micros() - requestStart;
+        uplinkStats.bodyBytes += body.length;
+        if (body.cbor) uplinkStats.cborBodies++;
+        uplinkStats.wireBytes += body.wireLength;
         
         if (httpStatusCode == 0) {
             DEBUG_PRINTLN("✗ No valid HTTP response received");
+            uplinkStats.failures++;
+            closeConnection();
             return false;
         }
         
-        return (httpStatusCode >= 200 && httpStatusCode < 300);
-    }
-    #endif
-    
-    #ifdef WIFI_FALLBACK_ENABLED
-    if (networkManager.isWifiActive() || networkManager.isAPActive()) {
-        WiFiClient client;
-        connected = client.connect(serverIP, port);
+        DEBUG_PRINT("✓ HTTP Status: ");
+        DEBUG_PRINTLN(httpStatusCode);
         
-        if (!connected) {
-            DEBUG_PRINTLN("✗ Failed to connect to server via WiFi");
-            return false;
+        // One fallback per 415: compression first, then the encoding
+        if (httpStatusCode == 415 && body.compressed) {
+            DEBUG_PRINTLN("⚠ Server does not accept compressed bodies, sending them uncompressed from now on");
+            compressionRejected = true;
+        } else if (httpStatusCode == 415 && body.cbor) {
+            DEBUG_PRINTLN("⚠ Server does not accept CBOR, sending JSON from now on");
+            cborRejected = true;
         }
         
-        unsigned long connectTime = millis() - connectStart;
-        DEBUG_PRINT("✓ Connected in ");
-        DEBUG_PRINT(connectTime);
-        DEBUG_PRINTLN("ms");
-        
-        // Build HTTP POST request
-        String httpRequest = "POST " + path + " HTTP/1.1\r\n";
-        httpRequest += "Host: " + host + "\r\n";
-        httpRequest += "Content-Type: application/json\r\n";
-        httpRequest += "Content-Length: " + String(payload.length()) + "\r\n";
-        httpRequest += "Connection: close\r\n";
-        httpRequest += "\r\n";
-        httpRequest += payload;
-        
-        // Send request
-        client.print(httpRequest);
-        client.flush();
-        
-        DEBUG_PRINTLN("✓ Request sent, waiting for response...");
-        
-        // Read response
-        unsigned long responseStart = millis();
-        String response = "";
-        int httpStatusCode = 0;
-        bool headersParsed = false;
-        
-        unsigned long timeout = 10000;  // 10 second timeout
-        while (client.connected() && (millis() - responseStart < timeout)) {
-            if (client.available()) {
-                char c = client.read();
-                response += c;
-                
-                // Parse status line
-                if (!headersParsed && response.indexOf("\r\n\r\n") != -1) {
-                    headersParsed = true;
-                    
-                    int statusStart = response.indexOf(' ') + 1;
-                    int statusEnd = response.indexOf(' ', statusStart);
-                    String statusStr = response.substring(statusStart, statusEnd);
-                    httpStatusCode = statusStr.toInt();
-                    
-                    DEBUG_PRINT("✓ HTTP Status: ");
-                    DEBUG_PRINTLN(httpStatusCode);
-                    
-                    if (httpStatusCode >= 200 && httpStatusCode < 300) {
-                        client.stop();
-                        return true;
-                    }
-                }
-            } else {
-                vTaskDelay(pdMS_TO_TICKS(10));
-            }
+        if (response.retryAfter() > 0 && (httpStatusCode == 429 || httpStatusCode == 503)) {
+            holdOff(response.retryAfter());
         }
         
-        client.stop();
-        
-        if (httpStatusCode == 0) {
-            DEBUG_PRINTLN("✗ No valid HTTP response received");
-            return false;
+        #ifdef HTTP_KEEPALIVE_ENABLED
+        if (keepOpen) {
+            lastActivity = millis();
+        } else {
+            closeConnection();
         }
+        #else
+        closeConnection();
+        #endif
         
-        return (httpStatusCode >= 200 && httpStatusCode < 300);
+        bool success = (httpStatusCode >= 200 && httpStatusCode < 300);
+        if (!success) {
+            uplinkStats.failures++;
+            DEBUG_PRINT("✗ Server response: ");
+            DEBUG_PRINTLN(response.bodyPrefix());
+        }
+        return success;
+    }
+    
+    return false;
+}
+
+Client* DjangoClient::selectClient() {
+    #ifdef ETHERNET_ENABLED
+    if (networkManager.isEthernetActive()) {
+        return &ethernetClient;
     }
     #endif
     
-    DEBUG_PRINTLN("✗ No active network connection");
+    #ifdef WIFI_FALLBACK_ENABLED
+    if (networkManager.isWifiActive() || networkManager.isAPActive()) {
+        return &wifiClient;
+    }
+    #endif
+    
+    return nullptr;
+}
+
+bool DjangoClient::openConnection(const IPAddress& ip, uint16_t port, bool& reused) {
+    Client* client = selectClient();
+    if (client == nullptr) {
+        DEBUG_PRINTLN("✗ No active network connection");
+        closeConnection();
+        return false;
+    }
+    
+    #ifdef HTTP_KEEPALIVE_ENABLED
+    // Reuse only a socket on the same interface and target that is
+    // still open, has not idled past the timeout and holds no stray data
+    if (connection == client && connectedIP == ip && connectedPort == port &&
+        millis() - lastActivity < HTTP_KEEPALIVE_IDLE_TIMEOUT &&
+        client->connected() && client->available() == 0) {
+        reused = true;
+        uplinkStats.reuses++;
+        return true;
+    }
+    #endif
+    
+    closeConnection();
+    
+    DEBUG_PRINT("✓ Connecting to ");
+    DEBUG_PRINT(ip);
+    DEBUG_PRINT(":");
+    DEBUG_PRINTLN(port);
+    
+    unsigned long connectStart = millis();
+    if (!client->connect(ip, port)) {
+        DEBUG_PRINTLN("✗ Failed to connect to server");
+        uplinkStats.connectFailures++;
+        return false;
+    }
+    
+    unsigned long connectTime = millis() - connectStart;
+    uplinkStats.connects++;
+    uplinkStats.connectMs += connectTime;
+    DEBUG_PRINT("✓ Connected in ");
+    DEBUG_PRINT(connectTime);
+    DEBUG_PRINTLN("ms");
+    
+    connection = client;
+    connectedIP = ip;
+    connectedPort = port;
+    lastActivity = millis();
+    reused = false;
+    return true;
+}
+
+void DjangoClient::closeConnection() {
+    if (connection != nullptr) {
+        connection->stop();
+        connection = nullptr;
+    }
+}
+
+bool DjangoClient::readResponse(Client& client, HttpResponseParser& parser, bool& closedUnanswered) {
+    uint8_t buffer[HTTP_RESPONSE_READ_SIZE];
+    unsigned long start = millis();
+    size_t received = 0;
+    closedUnanswered = false;
+    
+    while (!parser.isDone() && millis() - start < HTTP_RESPONSE_TIMEOUT) {
+        int available = client.available();
+        if (available > 0) {
+            size_t want = (size_t)available < sizeof(buffer) ? (size_t)available : sizeof(buffer);
+            int n = client.read(buffer, want);
+            if (n <= 0) continue;
+            received += n;
+            
+            // Bytes past the end of the response were never asked for
+            size_t used;
+            {
+                PERF_SCOPE(PERF_HTTP_RESPONSE_PARSE);
+                used = parser.feed(buffer, n);
+            }
+            if (used < (size_t)n) {
+                return false;
+            }
+        } else if (!client.connected()) {
+            closedUnanswered = received == 0;
+            parser.finish();
+        } else {
+            vTaskDelay(pdMS_TO_TICKS(5));
+        }
+    }
+    
+    return parser.isComplete();
+}
+
+void DjangoClient::holdOff(uint32_t seconds) {
+    if (seconds > HTTP_RETRY_AFTER_MAX) seconds = HTTP_RETRY_AFTER_MAX;
+    holdOffStart = millis();
+    holdOffMs = seconds * 1000UL;
+    DEBUG_PRINTF("⚠ Server asked to retry after %lus, holding off\n", (unsigned long)seconds);
+}
+
+bool DjangoClient::isHeldOff() {
+    if (holdOffMs == 0) return false;
+    if (millis() - holdOffStart < holdOffMs) return true;
+    holdOffMs = 0;
     return false;
 }
 
+void DjangoClient::report() {
+    DEBUG_PRINTLN("┌─ Uplink report ────────────────────────────");
+    #ifdef HTTP_KEEPALIVE_ENABLED
+    DEBUG_PRINTF("│ Keep-alive on (idle timeout %lu ms), connection %s\n",
+                 (unsigned long)HTTP_KEEPALIVE_IDLE_TIMEOUT,
+                 connection != nullptr ? "open" : "closed");
+    #else
+    DEBUG_PRINTLN("│ Keep-alive off (one connection per request)");
+    #endif
+    DEBUG_PRINTF("│ %lu requests, %lu connects (%lu failed), %lu reused, %lu stale retries, %lu failures\n",
+                 (unsigned long)uplinkStats.requests,
+                 (unsigned long)uplinkStats.connects,
+                 (unsigned long)uplinkStats.connectFailures,
+                 (unsigned long)uplinkStats.reuses,
+                 (unsigned long)uplinkStats.staleRetries,
+                 (unsigned long)uplinkStats.failures);
+    DEBUG_PRINTF("│ %lu samples too large to send live, buffered instead\n",
+                 (unsigned long)uplinkStats.oversized);
+    DEBUG_PRINTF("│ avg connect %lu ms, avg request latency %lu ms\n",
+                 (unsigned long)(uplinkStats.connects ? uplinkStats.connectMs / uplinkStats.connects : 0),
+                 (unsigned long)(uplinkStats.requests ? uplinkStats.requestUs / uplinkStats.requests / 1000 : 0));
+    #ifdef UPLINK_COMPRESSION_ENABLED
+    DEBUG_PRINTF("│ %s: %lu of %lu bodies compressed%s, avg sizing pass %lu us\n",
+                 UPLINK_ENCODING,
+                 (unsigned long)uplinkStats.compressedBodies,
+                 (unsigned long)uplinkStats.compressPasses,
+                 compressionRejected ? " (rejected by server)" : "",
+                 (unsigned long)(uplinkStats.compressPasses ? uplinkStats.compressUs / uplinkStats.compressPasses : 0));
+    #endif
+    #ifdef UPLINK_CBOR_ENABLED
+    DEBUG_PRINTF("│ Body encoding %s, %lu CBOR bodies sent\n",
+                 cborRejected ? "JSON (CBOR rejected by server)" : "CBOR",
+                 (unsigned long)uplinkStats.cborBodies);
+    comparePayloads();
+    #endif
+    DEBUG_PRINTF("│ %lu KB encoded -> %lu KB on the wire (%lu%%)\n",
+                 (unsigned long)(uplinkStats.bodyBytes / 1024),
+                 (unsigned long)(uplinkStats.wireBytes / 1024),
+                 (unsigned long)(uplinkStats.bodyBytes ? uplinkStats.wireBytes * 100 / uplinkStats.bodyBytes : 100));
+    if (isHeldOff()) {
+        DEBUG_PRINTF("│ Held off by Retry-After for %lu more s\n",
+                     (unsigned long)((holdOffMs - (millis() - holdOffStart)) / 1000));
+    }
+    DEBUG_PRINTLN("└────────────────────────────────────────────");
+}
+
 void DjangoClient::init() {
     DEBUG_PRINTLN("Django Client initialized");
 }
 
 void DjangoClient::setServerURL(const char* url) {
-    serverURL = String(url);
-    DEBUG_PRINT("Django server URL set to: ");
-    DEBUG_PRINTLN(serverURL);
+    closeConnection();
+    if (!parseEndpoint(url, endpoint)) {
+        DEBUG_PRINT("✗ Invalid Django server URL: ");
+        DEBUG_PRINTLN(url);
+        return;
+    }
+    DEBUG_PRINTF("Django server set to: %s port %u path %s\n",
+                 endpoint.host, (unsigned)endpoint.port, endpoint.path);
 }
 
-String DjangoClient::buildJSONPayload() {
-    if (!lockData(1000)) {
-        DEBUG_PRINTLN("Failed to lock data for Django client");
-        return "{}";
-    }
-    
-    SharedSensorData localData = sharedData;
-    unlockData();
-    
-    String json = "{";
-    
-    // ZE40 Data
-    json += "\"ze40\":{";
-    json += "\"tvoc_ppb\":" + String(localData.ze40_tvoc_ppb) + ",";
-    json += "\"tvoc_ppm\":" + String(localData.ze40_tvoc_ppm, 3) + ",";
-    json += "\"dac_voltage\":" + String(localData.ze40_dac_voltage, 2) + ",";
-    json += "\"dac_ppm\":" + String(localData.ze40_dac_ppm, 3) + ",";
-    json += "\"uart_data_valid\":" + String(localData.ze40_uart_valid ? "true" : "false") + ",";
-    json += "\"analog_data_valid\":true";
-    json += "},";
-    
-    // ZPHS01B Air Quality Data
-    if (localData.zphs01b_valid) {
-        json += "\"air_quality\":{";
-        json += "\"pm1\":" + String(localData.zphs01b_pm1) + ",";
-        json += "\"pm25\":" + String(localData.zphs01b_pm25) + ",";
-        json += "\"pm10\":" + String(localData.zphs01b_pm10) + ",";
-        json += "\"co2\":" + String(localData.zphs01b_co2) + ",";
-        json += "\"voc\":" + String(localData.zphs01b_voc) + ",";
-        json += "\"ch2o\":" + String(localData.zphs01b_ch2o) + ",";
-        json += "\"co\":" + String(localData.zphs01b_co, 1) + ",";
-        json += "\"o3\":" + String(localData.zphs01b_o3, 2) + ",";
-        json += "\"no2\":" + String(localData.zphs01b_no2, 3) + ",";
-        json += "\"temperature\":" + String(localData.zphs01b_temperature, 1) + ",";
-        json += "\"humidity\":" + String(localData.zphs01b_humidity);
-        json += "},";
-    } else {
-        json += "\"air_quality\":null,";
+size_t DjangoClient::buildJSONPayload(const SharedSensorData& data, uint32_t capturedAt,
+                                      char* buffer, size_t capacity) {
+    PERF_SCOPE(PERF_BUILD_JSON_PAYLOAD);
+    
+    JsonWriter writer(buffer, capacity);
+    
+    // Layout comes from sensor_schema.h
+    writer.beginObject();
+    uint32_t now = millis();
+    if (now - capturedAt >= 1000) {
+        // Sat in the uplink queue; the server backdates the reading
+        writer.member("age_s", (unsigned long)((now - capturedAt) / 1000));
     }
+    writeSensorGroups(writer, data, now, true);
+    #ifdef ROLLING_STATS_ENABLED
+    writeRollingStats(writer, now);
+    #endif
+    writer.member("ip_address", data.ip_address);
+    writer.member("network_mode", networkManager.getModeName());
+    writer.endObject();
     
-    // MR007 Data
-    if (localData.mr007_valid) {
-        json += "\"mr007\":{";
-        json += "\"voltage\":" + String(localData.mr007_voltage, 3) + ",";
-        json += "\"rawValue\":" + String(localData.mr007_raw) + ",";
-        json += "\"lel_concentration\":" + String(localData.mr007_lel, 1);
-        json += "},";
-    } else {
-        json += "\"mr007\":null,";
+    if (!writer.ok()) {
+        DEBUG_PRINTF("✗ Payload exceeds %u byte buffer\n", (unsigned)capacity);
+        return 0;
     }
+    return writer.length();
+}
+
+size_t DjangoClient::buildCBORPayload(const SharedSensorData& data, uint32_t capturedAt,
+                                      uint8_t* buffer, size_t capacity) {
+    PERF_SCOPE(PERF_BUILD_CBOR_PAYLOAD);
     
-    // ME4-SO2 Data
-    if (localData.me4so2_valid) {
-        json += "\"me4_so2\":{";
-        json += "\"voltage\":" + String(localData.me4so2_voltage, 4) + ",";
-        json += "\"rawValue\":" + String(localData.me4so2_raw) + ",";
-        json += "\"current_ua\":" + String(localData.me4so2_current, 2) + ",";
-        json += "\"so2_concentration\":" + String(localData.me4so2_so2, 2);
-        json += "},";
-    } else {
-        json += "\"me4_so2\":null,";
+    CborWriter writer(buffer, capacity);
+    
+    // Same members as buildJSONPayload(), numbered by sensor_schema.h
+    writer.beginObject();
+    writeSchemaId(writer);
+    uint32_t now = millis();
+    if (now - capturedAt >= 1000) {
+        writer.member(SCHEMA_KEY_AGE_S, (unsigned long)((now - capturedAt) / 1000));
     }
+    writeSensorGroups(writer, data, now, true);
+    #ifdef ROLLING_STATS_ENABLED
+    writeRollingStats(writer, now);
+    #endif
+    writer.member(SCHEMA_KEY_IP_ADDRESS, (const char*)data.ip_address);
+    writer.member(SCHEMA_KEY_NETWORK_MODE, networkManager.getModeName());
+    writer.endObject();
     
-    // Network Info
-    json += "\"ip_address\":\"" + String(localData.ip_address) + "\",";
+    if (!writer.ok()) {
+        DEBUG_PRINTF("✗ CBOR payload exceeds %u byte buffer\n", (unsigned)capacity);
+        return 0;
+    }
+    return writer.length();
+}
+
+void DjangoClient::comparePayloads() {
+    SharedSensorData data;
+    if (!snapshotData(data)) {
+        return;
+    }
     
-    // Network mode
-    json += "\"network_mode\":\"";
-    if (networkManager.isEthernetActive()) json += "eth";
-    else if (networkManager.isWifiActive()) json += "wifi";
-    else if (networkManager.isAPActive()) json += "ap";
-    else json += "unknown";
-    json += "\"";
+    // Both encodings of one snapshot, timed the same way
+    char json[UPLINK_PAYLOAD_BUFFER_SIZE];
+    unsigned long start = micros();
+    size_t jsonLength = buildJSONPayload(data, millis(), json, sizeof(json));
+    unsigned long jsonUs = micros() - start;
     
-    json += "}";
+    uint8_t cbor[UPLINK_PAYLOAD_BUFFER_SIZE];
+    start = micros();
+    size_t cborLength = buildCBORPayload(data, millis(), cbor, sizeof(cbor));
+    unsigned long cborUs = micros() - start;
     
-    return json;
+    DEBUG_PRINTF("│ Live sample: JSON %u B in %lu us, CBOR %u B in %lu us (%u%% of JSON)\n",
+                 (unsigned)jsonLength, jsonUs,
+                 (unsigned)cborLength, cborUs,
+                 (unsigned)(jsonLength ? cborLength * 100 / jsonLength : 0));
 }
 
-void DjangoClient::sendSensorData() {
-    // Check if enough time has passed since last send
-    if (millis() - lastSendTime < SEND_INTERVAL) {
-        return;
+void DjangoClient::bufferSample(const SharedSensorData& data, uint32_t capturedAt) {
+    if (BufferManager::saveData(data, capturedAt / 1000)) {
+        DEBUG_PRINTF("→ Sample buffered for later (%u waiting)\n",
+                     (unsigned)BufferManager::getEntryCount());
     }
+}
+
+void DjangoClient::sendSensorData(const SharedSensorData& localData, uint32_t capturedAt) {
+    // Runs on the uplink task; samples arrive through the uplink queue
     
     // Check if server URL is set
-    if (serverURL.length() == 0) {
+    if (!endpoint.valid) {
         DEBUG_PRINTLN("⚠ Django server URL not set");
         return;
     }
@@ -337,6 +558,15 @@ void DjangoClient::sendSensorData() {
     // Check if network is available
     if (!networkManager.isEthernetActive() && !networkManager.isWifiActive()) {
         DEBUG_PRINTLN("⚠ No network connection available for Django upload");
+        linkHealthy = false;
+        bufferSample(localData, capturedAt);
+        return;
+    }
+    
+    // The server asked for a pause; keep the sample for the replay
+    if (isHeldOff()) {
+        DEBUG_PRINTLN("⚠ Django upload held off by Retry-After");
+        bufferSample(localData, capturedAt);
         return;
     }
     
@@ -347,26 +577,37 @@ void DjangoClient::sendSensorData() {
     DEBUG_PRINTLN("║   SENDING DATA TO DJANGO BACKEND       ║");
     DEBUG_PRINTLN("╚════════════════════════════════════════╝");
     
-    String payload = buildJSONPayload();
+    char payload[UPLINK_PAYLOAD_BUFFER_SIZE];
+    bool cbor = useCBOR();
+    size_t length = cbor
+        ? buildCBORPayload(localData, capturedAt, (uint8_t*)payload, sizeof(payload))
+        : buildJSONPayload(localData, capturedAt, payload, sizeof(payload));
     
-    if (payload.length() == 0 || payload == "{}") {
-        DEBUG_PRINTLN("⚠ Empty payload - skipping send");
-        lastSendTime = millis();
+    if (length == 0) {
+        // Too large for the buffer; the buffered record leaves out the
+        // statistics, so the reading still reaches the server on replay
+        DEBUG_PRINTLN("⚠ Payload does not fit UPLINK_PAYLOAD_BUFFER_SIZE - buffering");
+        uplinkStats.oversized++;
+        bufferSample(localData, capturedAt);
         return;
     }
     
-    DEBUG_PRINTLN("→ Target URL: " + serverURL);
-    DEBUG_PRINTLN("→ Payload size: " + String(payload.length()) + " bytes");
-    DEBUG_PRINTLN("→ Timestamp: " + String(millis() / 1000) + "s");
-    DEBUG_PRINTLN("");
-    DEBUG_PRINTLN("Payload:");
-    DEBUG_PRINTLN(payload);
+    DEBUG_PRINTF("→ Target: %s:%u%s\n", endpoint.host, (unsigned)endpoint.port, endpoint.path);
+    DEBUG_PRINTF("→ Payload size: %u bytes (%s)\n", (unsigned)length, cbor ? "CBOR" : "JSON");
+    DEBUG_PRINTF("→ Timestamp: %lus\n", millis() / 1000);
     DEBUG_PRINTLN("");
+    if (!cbor) {
+        DEBUG_PRINTLN("Payload:");
+        DEBUG_PRINTLN(payload);
+        DEBUG_PRINTLN("");
+    }
     
     unsigned long sendStart = millis();
+    PostBody body = { payload, length, 0, 0, cbor };
     
     // Use native socket-based POST (avoids HTTPClient mutex conflicts)
-    if (sendHTTPPOST(serverURL, payload)) {
+    linkHealthy = sendHTTPPOST(body);
+    if (linkHealthy) {
         unsigned long sendDuration = millis() - sendStart;
         DEBUG_PRINTLN("✓ Data successfully sent to Django");
         DEBUG_PRINT("  Send Time: ");
@@ -383,13 +624,50 @@ void DjangoClient::sendSensorData() {
         DEBUG_PRINTLN("  - Wrong URL configured");
         DEBUG_PRINTLN("  - Network connectivity issue");
         DEBUG_PRINTLN("  - Firewall blocking connection");
+        bufferSample(localData, capturedAt);
     }
     
     // Add delay after HTTP operation to let stack recover
     vTaskDelay(pdMS_TO_TICKS(100));
     
-    lastSendTime = millis();
-    
     DEBUG_PRINTLN("═══════════════════════════════════════════");
     DEBUG_PRINTLN("");
 }
+
+void DjangoClient::drainBacklog() {
+    // Only replay once live sends are getting through again
+    if (!linkHealthy || !endpoint.valid || !BufferManager::hasData() || isHeldOff()) {
+        return;
+    }
+    
+    // Batches go out back-to-back; with keep-alive they share one socket
+    for (uint8_t batch = 0; batch < BACKLOG_BATCHES_PER_DRAIN; batch++) {
+        // Size the batch first so it can go out with a Content-Length; the
+        // later passes stream the same entries from flash into the socket.
+        // Ages are counted to one instant, so every pass writes the same
+        // bytes however long the connect or a retry takes.
+        CountingPrint counter;
+        bool cbor = useCBOR();
+        uint32_t now = millis();
+        size_t entries = cbor
+            ? BufferManager::streamCBOREntries(counter, BACKLOG_BATCH_SIZE, now)
+            : BufferManager::streamEntries(counter, BACKLOG_BATCH_SIZE, now);
+        if (entries == 0) {
+            return;
+        }
+        
+        DEBUG_PRINTF("→ Replaying %u buffered entries (%u bytes, %u waiting)\n",
+                     (unsigned)entries, (unsigned)counter.count(),
+                     (unsigned)BufferManager::getEntryCount());
+        
+        PostBody body = { nullptr, counter.count(), entries, now, cbor };
+        if (!sendHTTPPOST(body)) {
+            DEBUG_PRINTLN("✗ Backlog batch not acknowledged, will retry");
+            linkHealthy = false;
+            return;
+        }
+        
+        // Acknowledged with a 2xx; only now are the entries dropped
+        BufferManager::removeEntries(entries);
+    }
+}
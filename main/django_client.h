@@ -2,21 +2,174 @@
 #define DJANGO_CLIENT_H
 
 #include <Arduino.h>
+#include <Client.h>
 #include "config.h"
+#include "shared_data.h"
+#include "http_response_parser.h"
 
+/**
+ * HTTP request body: a filled buffer, or a batch of buffered entries
+ * streamed from flash (length sized beforehand with CountingPrint)
+ */
+struct PostBody {
+    const char* data;           // nullptr = stream backlog entries
+    size_t length;              // Encoded (JSON or CBOR) bytes
+    size_t backlogEntries;
+    uint32_t backlogNow;        // millis() the entries' "age_s" is counted to
+    bool cbor;                  // application/cbor instead of JSON
+    size_t wireLength;          // Content-Length, set by compressBody()
+    bool compressed;
+};
+
+/**
+ * Upload target, parsed once from DJANGO_SERVER_URL
+ */
+struct UplinkEndpoint {
+    char host[64];              // Hostname or IPv4 literal
+    char path[96];
+    uint16_t port;
+    bool valid;
+};
+
+/**
+ * DjangoClient
+ *
+ * Store-and-forward uplink to the Django backend. Both calls run on
+ * the uplink task (TaskManager), never on the sensor task:
+ *   - sendSensorData() posts a sample taken from the UplinkQueue. When
+ *     the network is down or the POST fails, the sample goes to the
+ *     BufferManager instead. A sample that waited in the queue carries
+ *     "age_s" so the server can backdate it. With ROLLING_STATS_ENABLED
+ *     the body also carries "stats" (rolling_stats.h), the windows
+ *     ending when the body is built; buffered entries have none.
+ *   - drainBacklog() posts the oldest BACKLOG_BATCH_SIZE buffered
+ *     entries as one JSON array. They are removed only after a 2xx.
+ *     It runs at most every BACKLOG_DRAIN_INTERVAL, and only while the
+ *     last live send succeeded, so catching up after a long outage
+ *     never holds back live data. Up to BACKLOG_BATCHES_PER_DRAIN
+ *     batches go out back-to-back per run.
+ *
+ * With HTTP_KEEPALIVE_ENABLED one connection is kept open across
+ * requests. It is reused while it is on the active interface, still
+ * connected and idle for less than HTTP_KEEPALIVE_IDLE_TIMEOUT. A
+ * reused socket the server closes or resets before answering is
+ * reopened and the request retried once; one that times out is not. report() prints connect count and request latency.
+ *
+ * Responses are read with HttpResponseParser. A Retry-After on a 429
+ * or 503 pauses both live sends and replay for that long (capped at
+ * HTTP_RETRY_AFTER_MAX); live samples are buffered meanwhile.
+ *
+ * With UPLINK_COMPRESSION_ENABLED bodies of UPLINK_COMPRESS_MIN_BYTES
+ * or more are sent gzip (or zlib) encoded through DeflateWriter, when
+ * that saves enough. A sizing pass gives the Content-Length and the
+ * body is compressed again as it is sent, so no compressed copy is
+ * held. A 415 from the server turns compression off until reboot.
+ *
+ * With UPLINK_CBOR_ENABLED bodies are CBOR (application/cbor) keyed by
+ * the integer keys of sensor_schema.h, for both live samples and
+ * replayed batches. A 415 to a CBOR body falls back to JSON until
+ * reboot. report() encodes the current snapshot both ways and prints
+ * the size and encode time of each.
+ *
+ * The server URL is parsed once in setServerURL(). A hostname is
+ * resolved through DnsResolver, which caches the answer for its TTL on
+ * both Ethernet and WiFi.
+ */
 class DjangoClient {
+    friend class HostHarness;   // host/ tests and benchmarks
+    
 public:
     static void init();
-    static void sendSensorData();
+    static void sendSensorData(const SharedSensorData& data, uint32_t capturedAt);
+    static void drainBacklog();
     static void setServerURL(const char* url);
+    static void report();
     
 private:
-    static String serverURL;
-    static unsigned long lastSendTime;
-    static const unsigned long SEND_INTERVAL = 10000; // Send every 10 seconds
+    struct UplinkStats {
+        uint32_t requests;
+        uint32_t connects;
+        uint32_t connectFailures;
+        uint32_t reuses;            // Requests sent on a kept-alive socket
+        uint32_t staleRetries;      // Kept-alive socket found dead, reopened
+        uint32_t failures;          // No response or non-2xx status
+        uint32_t oversized;         // Live payloads that did not fit, buffered
+        uint32_t connectMs;
+        uint64_t requestUs;         // Send through response, incl. connect
+        uint32_t compressPasses;    // Bodies large enough to try
+        uint32_t compressedBodies;  // ... that compressed well enough
+        uint32_t cborBodies;
+        uint64_t bodyBytes;         // Encoded bytes before compression
+        uint64_t wireBytes;         // Body bytes sent
+        uint64_t compressUs;        // Sizing passes only
+    };
+    
+    static UplinkEndpoint endpoint;
+    static bool linkHealthy;    // Last live POST got a 2xx
+    
+    // Persistent connection
+    static Client* connection;  // Open socket, nullptr when closed
+    static IPAddress connectedIP;
+    static uint16_t connectedPort;
+    static unsigned long lastActivity;
+    static UplinkStats uplinkStats;
+    static unsigned long holdOffStart;
+    static unsigned long holdOffMs;     // 0 = not held off
+    
+    /**
+     * Write the upload body into a fixed buffer (no heap use)
+     * @return Body length, 0 if it did not fit
+     */
+    static size_t buildJSONPayload(const SharedSensorData& data, uint32_t capturedAt,
+                                   char* buffer, size_t capacity);
+    
+    /**
+     * Same sample as CBOR with sensor_schema.h integer keys
+     * @return Body length, 0 if it did not fit
+     */
+    static size_t buildCBORPayload(const SharedSensorData& data, uint32_t capturedAt,
+                                   uint8_t* buffer, size_t capacity);
+    
+    /**
+     * True while bodies go out as CBOR (enabled and not rejected)
+     */
+    static bool useCBOR();
+    static bool cborRejected;           // Server answered 415 to CBOR
+    
+    /**
+     * Encode the current snapshot as JSON and as CBOR and print both
+     * sizes and encode times (report line)
+     */
+    static void comparePayloads();
+    static bool sendHTTPPOST(const PostBody& body);
+    static void writeRequest(Client& client, const PostBody& body);
+    static void writeBody(Print& out, const PostBody& body);
+    
+    /**
+     * Decide whether the body goes out compressed and set wireLength
+     */
+    static void compressBody(PostBody& body);
+    static bool compressionRejected;    // Server answered 415
+    static void bufferSample(const SharedSensorData& data, uint32_t capturedAt);
+    
+    static Client* selectClient();
+    static bool openConnection(const IPAddress& ip, uint16_t port, bool& reused);
+    static void closeConnection();
+    
+    /**
+     * Feed the socket into the parser in bulk reads until the response
+     * is complete, the peer closes or HTTP_RESPONSE_TIMEOUT passes
+     * @param closedUnanswered Set when the peer closed or reset the
+     *                         socket before sending a byte of response
+     * @return true if a whole response was read and nothing after it
+     */
+    static bool readResponse(Client& client, HttpResponseParser& parser, bool& closedUnanswered);
     
-    static String buildJSONPayload();
-    static bool sendHTTPPOST(const String& url, const String& payload);
+    /**
+     * Honour a Retry-After from a 429/503: no POSTs until it expires
+     */
+    static void holdOff(uint32_t seconds);
+    static bool isHeldOff();
 };
 
 #endif
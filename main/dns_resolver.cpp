@@ -0,0 +1,276 @@
+#include "dns_resolver.h"
+#include "config.h"
+#include "network_manager.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <Ethernet.h>
+#include <EthernetUdp.h>
+
+#ifdef WIFI_FALLBACK_ENABLED
+#include <WiFi.h>
+#include <WiFiUdp.h>
+#endif
+
+static const uint16_t DNS_PORT = 53;
+static const size_t DNS_HEADER_SIZE = 12;
+static const size_t DNS_PACKET_SIZE = 512;     // Largest plain UDP answer
+static const uint16_t TYPE_A = 1;
+static const uint16_t CLASS_IN = 1;
+
+DnsResolver::CacheEntry DnsResolver::cache[DNS_CACHE_SIZE] = {};
+uint16_t DnsResolver::nextId = 0;
+uint32_t DnsResolver::hits = 0;
+uint32_t DnsResolver::queries = 0;
+uint32_t DnsResolver::failures = 0;
+uint32_t DnsResolver::lastQueryMs = 0;
+
+static uint16_t readU16(const uint8_t* p) {
+    return ((uint16_t)p[0] << 8) | p[1];
+}
+
+static uint32_t readU32(const uint8_t* p) {
+    return ((uint32_t)readU16(p) << 16) | readU16(p + 2);
+}
+
+// Skip an encoded name (labels, ending in a zero byte or a pointer)
+// @return Offset after the name, 0 if it runs past the packet
+static size_t skipName(const uint8_t* packet, size_t length, size_t offset) {
+    while (offset < length) {
+        uint8_t label = packet[offset];
+        if (label == 0) return offset + 1;
+        if ((label & 0xC0) == 0xC0) return (offset + 2 <= length) ? offset + 2 : 0;
+        offset += 1 + label;
+    }
+    return 0;
+}
+
+// Encode "a.b.c" as length-prefixed labels
+// @return Bytes written, 0 if a label is empty or too long
+static size_t encodeName(const char* host, uint8_t* out, size_t capacity) {
+    size_t n = 0;
+    while (*host) {
+        const char* dot = strchr(host, '.');
+        size_t label = dot ? (size_t)(dot - host) : strlen(host);
+        if (label == 0 || label > 63 || n + 1 + label + 1 > capacity) return 0;
+        out[n++] = (uint8_t)label;
+        memcpy(out + n, host, label);
+        n += label;
+        host += label;
+        if (*host == '.') host++;
+    }
+    out[n++] = 0;
+    return n;
+}
+
+DnsResolver::CacheEntry* DnsResolver::find(const char* host) {
+    for (size_t i = 0; i < DNS_CACHE_SIZE; i++) {
+        if (cache[i].host[0] != '\0' && strcasecmp(cache[i].host, host) == 0) {
+            return &cache[i];
+        }
+    }
+    return nullptr;
+}
+
+DnsResolver::CacheEntry* DnsResolver::allocate() {
+    // A free slot, else the entry closest to (or furthest past) expiry
+    CacheEntry* victim = &cache[0];
+    long victimLeft = 0;
+    unsigned long now = millis();
+    for (size_t i = 0; i < DNS_CACHE_SIZE; i++) {
+        if (cache[i].host[0] == '\0') return &cache[i];
+        long left = (long)(cache[i].ttlMs - (now - cache[i].storedAt));
+        if (i == 0 || left < victimLeft) {
+            victim = &cache[i];
+            victimLeft = left;
+        }
+    }
+    return victim;
+}
+
+bool DnsResolver::resolve(const char* host, IPAddress& address) {
+    if (address.fromString(host)) {
+        return true;
+    }
+    if (strlen(host) >= sizeof(cache[0].host)) {
+        DEBUG_PRINTF("✗ Hostname too long: %s\n", host);
+        return false;
+    }
+
+    CacheEntry* entry = find(host);
+    if (entry != nullptr && millis() - entry->storedAt < entry->ttlMs) {
+        hits++;
+        if (entry->ok) address = entry->address;
+        return entry->ok;
+    }
+
+    IPAddress resolved;
+    uint32_t ttl = 0;
+    unsigned long start = millis();
+    bool ok = query(host, resolved, ttl);
+    lastQueryMs = millis() - start;
+    queries++;
+
+    if (ok) {
+        if (ttl < DNS_MIN_TTL) ttl = DNS_MIN_TTL;
+        if (ttl > DNS_MAX_TTL) ttl = DNS_MAX_TTL;
+        DEBUG_PRINTF("✓ Resolved %s to %s (ttl %lus, %lums)\n", host,
+                     resolved.toString().c_str(), (unsigned long)ttl, (unsigned long)lastQueryMs);
+    } else {
+        failures++;
+        ttl = DNS_NEGATIVE_TTL;
+        DEBUG_PRINTF("✗ DNS resolution failed for: %s\n", host);
+    }
+
+    if (entry == nullptr) {
+        entry = allocate();
+        strncpy(entry->host, host, sizeof(entry->host) - 1);
+        entry->host[sizeof(entry->host) - 1] = '\0';
+    }
+    entry->address = resolved;
+    entry->storedAt = millis();
+    entry->ttlMs = ttl * 1000UL;
+    entry->ok = ok;
+
+    if (ok) address = resolved;
+    return ok;
+}
+
+void DnsResolver::invalidate(const char* host) {
+    CacheEntry* entry = find(host);
+    if (entry != nullptr) {
+        entry->host[0] = '\0';
+    }
+}
+
+bool DnsResolver::query(const char* host, IPAddress& address, uint32_t& ttl) {
+    // The socket and DNS server come from whichever link is up
+    UDP* udp = nullptr;
+    IPAddress server;
+
+    #ifdef ETHERNET_ENABLED
+    EthernetUDP ethernetUdp;
+    if (networkManager.isEthernetActive()) {
+        udp = &ethernetUdp;
+        server = Ethernet.dnsServerIP();
+    }
+    #endif
+
+    #ifdef WIFI_FALLBACK_ENABLED
+    WiFiUDP wifiUdp;
+    if (udp == nullptr && networkManager.isWifiActive()) {
+        udp = &wifiUdp;
+        server = WiFi.dnsIP();
+    }
+    #endif
+
+    if (udp == nullptr || server == IPAddress(0, 0, 0, 0)) {
+        return false;
+    }
+
+    uint8_t packet[DNS_PACKET_SIZE];
+
+    // Header: id, recursion desired, one question
+    uint16_t id = ++nextId ^ (uint16_t)esp_random();
+    memset(packet, 0, DNS_HEADER_SIZE);
+    packet[0] = id >> 8;
+    packet[1] = id & 0xFF;
+    packet[2] = 0x01;
+    packet[5] = 1;
+
+    size_t nameLength = encodeName(host, packet + DNS_HEADER_SIZE, DNS_PACKET_SIZE - DNS_HEADER_SIZE - 4);
+    if (nameLength == 0) {
+        return false;
+    }
+    size_t queryLength = DNS_HEADER_SIZE + nameLength;
+    packet[queryLength++] = 0;
+    packet[queryLength++] = TYPE_A;
+    packet[queryLength++] = 0;
+    packet[queryLength++] = CLASS_IN;
+
+    // Random ephemeral port makes spoofed answers harder to land
+    if (!udp->begin(49152 + (esp_random() % 16384))) {
+        return false;
+    }
+
+    bool ok = false;
+    bool answered = false;
+    for (uint8_t attempt = 0; attempt < DNS_RETRIES && !answered; attempt++) {
+        if (!udp->beginPacket(server, DNS_PORT)) break;
+        udp->write(packet, queryLength);
+        if (!udp->endPacket()) break;
+
+        unsigned long start = millis();
+        while (millis() - start < DNS_TIMEOUT) {
+            int size = udp->parsePacket();
+            if (size <= 0) {
+                vTaskDelay(pdMS_TO_TICKS(10));
+                continue;
+            }
+
+            uint8_t answer[DNS_PACKET_SIZE];
+            int length = udp->read(answer, sizeof(answer));
+            if (udp->remoteIP() != server || udp->remotePort() != DNS_PORT ||
+                length < (int)DNS_HEADER_SIZE || readU16(answer) != id) {
+                continue;
+            }
+            answered = true;
+
+            // Response bit set, no error code, not truncated
+            if ((answer[2] & 0x80) == 0 || (answer[2] & 0x02) != 0 || (answer[3] & 0x0F) != 0) {
+                break;
+            }
+
+            uint16_t questions = readU16(answer + 4);
+            uint16_t answers = readU16(answer + 6);
+            size_t offset = DNS_HEADER_SIZE;
+            for (uint16_t i = 0; i < questions && offset != 0; i++) {
+                offset = skipName(answer, length, offset);
+                if (offset != 0) offset += 4;
+            }
+
+            // First A record; CNAMEs in front of it are skipped
+            for (uint16_t i = 0; i < answers && offset != 0; i++) {
+                offset = skipName(answer, length, offset);
+                if (offset == 0 || offset + 10 > (size_t)length) break;
+                uint16_t type = readU16(answer + offset);
+                uint16_t rclass = readU16(answer + offset + 2);
+                uint32_t recordTtl = readU32(answer + offset + 4);
+                uint16_t rdLength = readU16(answer + offset + 8);
+                offset += 10;
+                if (offset + rdLength > (size_t)length) break;
+
+                if (type == TYPE_A && rclass == CLASS_IN && rdLength == 4) {
+                    address = IPAddress(answer[offset], answer[offset + 1],
+                                        answer[offset + 2], answer[offset + 3]);
+                    ttl = recordTtl;
+                    ok = true;
+                    break;
+                }
+                offset += rdLength;
+            }
+            break;
+        }
+    }
+
+    udp->stop();
+    return ok;
+}
+
+void DnsResolver::report() {
+    DEBUG_PRINTLN("┌─ DNS report ───────────────────────────────");
+    DEBUG_PRINTF("│ %lu cache hits, %lu queries (%lu failed), last query %lu ms\n",
+                 (unsigned long)hits,
+                 (unsigned long)queries,
+                 (unsigned long)failures,
+                 (unsigned long)lastQueryMs);
+    unsigned long now = millis();
+    for (size_t i = 0; i < DNS_CACHE_SIZE; i++) {
+        const CacheEntry& e = cache[i];
+        if (e.host[0] == '\0') continue;
+        unsigned long age = now - e.storedAt;
+        unsigned long left = (age < e.ttlMs) ? (e.ttlMs - age) / 1000 : 0;
+        DEBUG_PRINTF("│ %s -> %s, %lus left\n", e.host,
+                     e.ok ? e.address.toString().c_str() : "(failed)", left);
+    }
+    DEBUG_PRINTLN("└────────────────────────────────────────────");
+}
@@ -0,0 +1,64 @@
+#ifndef DNS_RESOLVER_H
+#define DNS_RESOLVER_H
+
+#include <Arduino.h>
+
+/**
+ * DNS Resolver
+ *
+ * Small stub resolver that sends A queries over UDP to the DNS server
+ * of the active interface. It works on the W5500 (EthernetUDP) as well
+ * as on WiFi (WiFiUDP), so hostnames are usable on either link.
+ *
+ * Answers are kept in a small cache shared by both interfaces, for the
+ * TTL the server returned (clamped to DNS_MIN_TTL..DNS_MAX_TTL). Failed
+ * lookups are cached for DNS_NEGATIVE_TTL so an unreachable server is
+ * not queried on every request. IP literals never hit the network.
+ *
+ * Usage:
+ *   IPAddress ip;
+ *   if (DnsResolver::resolve("sensors.example.com", ip)) { ... }
+ *   DnsResolver::invalidate("sensors.example.com");  // e.g. after connect fails
+ */
+class DnsResolver {
+public:
+    /**
+     * Resolve a hostname or dotted IPv4 literal
+     * @return false if there is no active network, no DNS server or no A record
+     */
+    static bool resolve(const char* host, IPAddress& address);
+
+    /**
+     * Drop a cached answer so the next resolve() queries again
+     */
+    static void invalidate(const char* host);
+
+    /**
+     * Print cache contents and lookup counters
+     */
+    static void report();
+
+private:
+    struct CacheEntry {
+        char host[64];
+        IPAddress address;
+        unsigned long storedAt;
+        unsigned long ttlMs;
+        bool ok;                // false = cached failure
+    };
+
+    static CacheEntry* find(const char* host);
+    static CacheEntry* allocate();
+    static bool query(const char* host, IPAddress& address, uint32_t& ttl);
+
+    static CacheEntry cache[];
+    static uint16_t nextId;
+
+    // Statistics
+    static uint32_t hits;
+    static uint32_t queries;
+    static uint32_t failures;
+    static uint32_t lastQueryMs;
+};
+
+#endif
@@ -0,0 +1,244 @@
+#ifndef DSP_FILTERS_H
+#define DSP_FILTERS_H
+
+#include <Arduino.h>
+#include "config.h"
+
+/**
+ * DSP Filters
+ *
+ * Streaming fixed-point filters for smoothing sensor readings before
+ * they are published. All state is a handful of int32 values per
+ * channel. Nothing allocates and nothing uses floating point inside
+ * the filter.
+ *
+ * Values are carried as Q(FRAC) integers: a reading of 1.0 is 1 << FRAC.
+ * With the default FILTER_FRAC_BITS of 16, readings up to about
+ * +/-32767 fit, which covers every sensor field on this board.
+ *
+ * - MedianFilter:  moving median over the last N samples (spike removal)
+ * - EmaFilter:     exponential moving average, alpha = 2^-SHIFT
+ * - CicDecimator:  ORDER-stage CIC, one output per 2^LOG2_R inputs
+ * - Kalman1D:      scalar random-walk Kalman filter
+ * - FilterChain:   median -> EMA -> Kalman, stages picked by a flag mask
+ *                  (FILTER_MEDIAN | FILTER_EMA | FILTER_KALMAN in config.h)
+ *
+ * Usage:
+ *   FilterChain<MR007_FILTER> voltageFilter;
+ *   float smoothed = voltageFilter.apply(voltage);
+ */
+
+template <uint8_t FRAC = FILTER_FRAC_BITS>
+inline int32_t toFixed(float value) {
+    const float limit = (float)(INT32_MAX >> FRAC);
+    if (value > limit) value = limit;
+    if (value < -limit) value = -limit;
+    return (int32_t)lroundf(value * (float)(1L << FRAC));
+}
+
+template <uint8_t FRAC = FILTER_FRAC_BITS>
+inline float fromFixed(int32_t value) {
+    return (float)value / (float)(1L << FRAC);
+}
+
+/**
+ * Moving median over a window of N samples
+ * Keeps the window both in arrival order and sorted, so each sample
+ * costs one removal and one insertion (O(N), no sorting pass).
+ */
+template <uint8_t N>
+class MedianFilter {
+    static_assert(N >= 1 && N <= 31, "median window must be 1..31");
+
+public:
+    int32_t apply(int32_t x) {
+        if (count == N) {
+            // Remove the sample leaving the window
+            int32_t old = window[head];
+            uint8_t pos = 0;
+            while (sorted[pos] != old) pos++;
+            for (; pos + 1 < count; pos++) sorted[pos] = sorted[pos + 1];
+            count--;
+        }
+
+        window[head] = x;
+        head = (head + 1) % N;
+
+        uint8_t pos = count;
+        while (pos > 0 && sorted[pos - 1] > x) {
+            sorted[pos] = sorted[pos - 1];
+            pos--;
+        }
+        sorted[pos] = x;
+        count++;
+
+        return sorted[count / 2];
+    }
+
+    void reset() {
+        count = 0;
+        head = 0;
+    }
+
+private:
+    int32_t window[N];
+    int32_t sorted[N];
+    uint8_t count = 0;
+    uint8_t head = 0;
+};
+
+/**
+ * Exponential moving average, y += (x - y) / 2^SHIFT
+ * The first sample seeds the average so there is no ramp from zero.
+ */
+template <uint8_t SHIFT>
+class EmaFilter {
+public:
+    int32_t apply(int32_t x) {
+        if (!seeded) {
+            y = x;
+            seeded = true;
+        } else {
+            y += (x - y) >> SHIFT;
+        }
+        return y;
+    }
+
+    void reset() { seeded = false; }
+
+private:
+    int32_t y = 0;
+    bool seeded = false;
+};
+
+/**
+ * Cascaded integrator-comb decimator
+ * ORDER integrators run at the input rate and ORDER combs at the output
+ * rate. The DC gain of (2^LOG2_R)^ORDER is removed with a shift. The
+ * registers wrap modulo 2^32 by design. That is exact as long as input
+ * bits + ORDER * LOG2_R <= 32.
+ */
+template <uint8_t LOG2_R, uint8_t ORDER>
+class CicDecimator {
+    static_assert(ORDER >= 1 && ORDER <= 4, "CIC order must be 1..4");
+
+public:
+    static const uint8_t GAIN_BITS = LOG2_R * ORDER;
+
+    /**
+     * Feed one input sample
+     * @param x Input sample
+     * @param out Set to the decimated output when one is produced
+     * @param outShift Bits of gain to drop; GAIN_BITS gives unity gain,
+     *                 smaller values keep extra resolution
+     * @return true every 2^LOG2_R inputs, when out is valid
+     */
+    bool apply(uint32_t x, uint32_t& out, uint8_t outShift = GAIN_BITS) {
+        integrator[0] += x;
+        for (uint8_t i = 1; i < ORDER; i++) integrator[i] += integrator[i - 1];
+
+        if (++phase < (1UL << LOG2_R)) return false;
+        phase = 0;
+
+        uint32_t y = integrator[ORDER - 1];
+        for (uint8_t i = 0; i < ORDER; i++) {
+            uint32_t delayed = comb[i];
+            comb[i] = y;
+            y -= delayed;
+        }
+
+        // The first ORDER - 1 outputs are still filling the comb delays
+        if (warmup < ORDER - 1) {
+            warmup++;
+            return false;
+        }
+
+        out = y >> outShift;
+        return true;
+    }
+
+    void reset() {
+        memset(integrator, 0, sizeof(integrator));
+        memset(comb, 0, sizeof(comb));
+        phase = 0;
+        warmup = 0;
+    }
+
+private:
+    uint32_t integrator[ORDER] = {0};
+    uint32_t comb[ORDER] = {0};
+    uint32_t phase = 0;
+    uint8_t warmup = 0;
+};
+
+/**
+ * Scalar Kalman filter for a slowly wandering value
+ * Works on the covariance normalised by the measurement noise, so only
+ * the ratio q/r matters. It is given in Q16 (655 is roughly 0.01).
+ * Smaller ratios smooth harder and respond more slowly.
+ * The gain is dimensionless, so the filter takes readings in any Q
+ * format and returns them in the same one.
+ */
+template <int32_t Q_OVER_R_Q16>
+class Kalman1D {
+public:
+    int32_t apply(int32_t z) {
+        const int64_t one = 1LL << 16;
+
+        if (!seeded) {
+            x = z;
+            p = one;
+            seeded = true;
+            return x;
+        }
+
+        // Predict, then update with gain k = p / (p + 1)
+        p += Q_OVER_R_Q16;
+        int64_t k = (p << 16) / (p + one);
+        x += (int32_t)((k * (int64_t)(z - x)) >> 16);
+        p = (int32_t)(((one - k) * p) >> 16);
+        return x;
+    }
+
+    void reset() { seeded = false; }
+
+private:
+    int32_t x = 0;
+    int64_t p = 0;
+    bool seeded = false;
+};
+
+/**
+ * Per-channel filter chain selected by a flag mask from config.h
+ * Unselected stages compile away.
+ */
+template <uint8_t CHAIN,
+          uint8_t MEDIAN_N = FILTER_MEDIAN_WINDOW,
+          uint8_t EMA_SHIFT = FILTER_EMA_SHIFT,
+          int32_t KALMAN_Q_OVER_R = FILTER_KALMAN_Q_OVER_R_Q16,
+          uint8_t FRAC = FILTER_FRAC_BITS>
+class FilterChain {
+public:
+    float apply(float value) {
+        if (CHAIN == FILTER_NONE) return value;
+
+        int32_t x = toFixed<FRAC>(value);
+        if (CHAIN & FILTER_MEDIAN) x = median.apply(x);
+        if (CHAIN & FILTER_EMA) x = ema.apply(x);
+        if (CHAIN & FILTER_KALMAN) x = kalman.apply(x);
+        return fromFixed<FRAC>(x);
+    }
+
+    void reset() {
+        median.reset();
+        ema.reset();
+        kalman.reset();
+    }
+
+private:
+    MedianFilter<(CHAIN & FILTER_MEDIAN) ? MEDIAN_N : 1> median;
+    EmaFilter<EMA_SHIFT> ema;
+    Kalman1D<KALMAN_Q_OVER_R> kalman;
+};
+
+#endif
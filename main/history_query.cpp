@@ -0,0 +1,324 @@
+#include "history_query.h"
+#include "sensor_history.h"
+#include "sensor_schema.h"
+#include "perf_monitor.h"
+#include <math.h>
+
+enum HistoryOp : uint8_t {
+    HISTORY_WALK,       // Visit every sample in range
+    HISTORY_COUNT,      // Return the number in range
+    HISTORY_FIRST,      // Visit the oldest in range
+    HISTORY_LAST        // Visit the newest in range
+};
+
+typedef void (*HistoryVisit)(void* context, uint32_t timestamp, float value);
+
+// One entry point per series keeps the table a plain array
+typedef size_t (*HistoryAccess)(HistoryOp op, uint32_t fromMs, uint32_t toMs,
+                                HistoryVisit visit, void* context);
+
+template <typename T, typename V, V T::*Member, SampleRing<T> SensorHistory::*Ring>
+static size_t accessField(HistoryOp op, uint32_t fromMs, uint32_t toMs,
+                          HistoryVisit visit, void* context) {
+    const SampleRing<T>& ring = sensorHistory.*Ring;
+    T sample;
+
+    switch (op) {
+        case HISTORY_COUNT:
+            return ring.countInRange(fromMs, toMs);
+
+        case HISTORY_FIRST:
+            if (!ring.firstInRange(fromMs, toMs, sample)) return 0;
+            visit(context, sample.timestamp, (float)(sample.*Member));
+            return 1;
+
+        case HISTORY_LAST:
+            if (!ring.lastInRange(fromMs, toMs, sample)) return 0;
+            visit(context, sample.timestamp, (float)(sample.*Member));
+            return 1;
+
+        default:
+            return ring.forEachInRange(fromMs, toMs, [&](const T& s) {
+                visit(context, s.timestamp, (float)(s.*Member));
+            });
+    }
+}
+
+struct HistorySeries {
+    const char* sensor;     // Group key in sensor_schema.h
+    const char* field;      // Field key in that group
+    HistoryAccess access;
+};
+
+#define HISTORY_SERIES(sensor, field, ring, T, member) \
+    { sensor, field, &accessField<T, decltype(T::member), &T::member, &SensorHistory::ring> }
+
+// Fields the history rings keep (ZE40 keeps no ppm reading)
+static const HistorySeries SERIES[] = {
+    HISTORY_SERIES("ze40",        "tvoc_ppb",          ze40,    ZE40Sample,    tvoc_ppb),
+    HISTORY_SERIES("ze40",        "dac_voltage",       ze40Dac, ZE40DacSample, dac_voltage),
+    HISTORY_SERIES("ze40",        "dac_ppm",           ze40Dac, ZE40DacSample, dac_ppm),
+    HISTORY_SERIES("air_quality", "pm1",               zphs01b, ZPHS01BSample, pm1),
+    HISTORY_SERIES("air_quality", "pm25",              zphs01b, ZPHS01BSample, pm25),
+    HISTORY_SERIES("air_quality", "pm10",              zphs01b, ZPHS01BSample, pm10),
+    HISTORY_SERIES("air_quality", "co2",               zphs01b, ZPHS01BSample, co2),
+    HISTORY_SERIES("air_quality", "voc",               zphs01b, ZPHS01BSample, voc),
+    HISTORY_SERIES("air_quality", "ch2o",              zphs01b, ZPHS01BSample, ch2o),
+    HISTORY_SERIES("air_quality", "co",                zphs01b, ZPHS01BSample, co),
+    HISTORY_SERIES("air_quality", "o3",                zphs01b, ZPHS01BSample, o3),
+    HISTORY_SERIES("air_quality", "no2",               zphs01b, ZPHS01BSample, no2),
+    HISTORY_SERIES("air_quality", "temperature",       zphs01b, ZPHS01BSample, temperature),
+    HISTORY_SERIES("air_quality", "humidity",          zphs01b, ZPHS01BSample, humidity),
+    HISTORY_SERIES("mr007",       "voltage",           mr007,   MR007Sample,   voltage),
+    HISTORY_SERIES("mr007",       "rawValue",          mr007,   MR007Sample,   raw),
+    HISTORY_SERIES("mr007",       "lel_concentration", mr007,   MR007Sample,   lel),
+    HISTORY_SERIES("me4_so2",     "voltage",           me4so2,  ME4SO2Sample,  voltage),
+    HISTORY_SERIES("me4_so2",     "rawValue",          me4so2,  ME4SO2Sample,  raw),
+    HISTORY_SERIES("me4_so2",     "current_ua",        me4so2,  ME4SO2Sample,  current),
+    HISTORY_SERIES("me4_so2",     "so2_concentration", me4so2,  ME4SO2Sample,  so2),
+};
+
+#undef HISTORY_SERIES
+
+static const size_t SERIES_COUNT = sizeof(SERIES) / sizeof(SERIES[0]);
+
+// Visitor state
+
+struct SampleCopy {
+    uint32_t timestamp;
+    float value;
+};
+
+static void copySample(void* context, uint32_t timestamp, float value) {
+    SampleCopy* copy = static_cast<SampleCopy*>(context);
+    copy->timestamp = timestamp;
+    copy->value = value;
+}
+
+struct BucketStats {
+    float min;
+    float max;
+    float sum;
+    uint32_t count;
+};
+
+static void addToBucket(void* context, uint32_t, float value) {
+    BucketStats* stats = static_cast<BucketStats*>(context);
+    if (stats->count == 0 || value < stats->min) stats->min = value;
+    if (stats->count == 0 || value > stats->max) stats->max = value;
+    stats->sum += value;
+    stats->count++;
+}
+
+struct BucketAverage {
+    uint32_t origin;        // Times are ms from here, as floats
+    float sumTime;
+    float sumValue;
+    uint32_t count;
+};
+
+static void addToAverage(void* context, uint32_t timestamp, float value) {
+    BucketAverage* average = static_cast<BucketAverage*>(context);
+    average->sumTime += (float)(int32_t)(timestamp - average->origin);
+    average->sumValue += value;
+    average->count++;
+}
+
+struct TriangleSearch {
+    uint32_t origin;
+    float previousTime;     // Point A, chosen in the bucket before
+    float previousValue;
+    float aheadTime;        // Point C, the next bucket's average
+    float aheadValue;
+    float bestArea;
+    uint32_t bestTimestamp;
+    float bestValue;
+    uint32_t count;
+};
+
+static void considerSample(void* context, uint32_t timestamp, float value) {
+    TriangleSearch* search = static_cast<TriangleSearch*>(context);
+    float t = (float)(int32_t)(timestamp - search->origin);
+
+    // Twice the area of triangle A, B, C; the factor doesn't change the winner
+    float area = fabsf((search->previousTime - search->aheadTime) * (value - search->previousValue) -
+                       (search->previousTime - t) * (search->aheadValue - search->previousValue));
+    if (search->count == 0 || area > search->bestArea) {
+        search->bestArea = area;
+        search->bestTimestamp = timestamp;
+        search->bestValue = value;
+    }
+    search->count++;
+}
+
+static void setPoint(HistoryQuery::Point& out, uint32_t timestamp, float value) {
+    out.timestamp = timestamp;
+    out.value = value;
+    out.min = value;
+    out.max = value;
+    out.count = 1;
+}
+
+bool HistoryQuery::begin(const char* sensor, const char* field, Mode mode,
+                         uint32_t fromMs, uint32_t toMs, uint16_t points) {
+    series = SERIES_COUNT;
+    for (size_t i = 0; i < SERIES_COUNT; i++) {
+        if (strcmp(SERIES[i].sensor, sensor) == 0 && strcmp(SERIES[i].field, field) == 0) {
+            series = i;
+            break;
+        }
+    }
+    if (series == SERIES_COUNT) return false;
+
+    int fieldDecimals = schemaFieldDecimals(sensor, field);
+    decimals = fieldDecimals < 0 ? 3 : fieldDecimals;
+
+    this->mode = mode;
+    this->fromMs = fromMs;
+    this->toMs = toMs;
+    bucket = 0;
+    stage = 0;
+    passThrough = false;
+    samples = SERIES[series].access(HISTORY_COUNT, fromMs, toMs, nullptr, nullptr);
+
+    if (mode == BUCKETS) {
+        if (points < 1) points = 1;
+        uint32_t span = toMs - fromMs + 1;
+        width = (span + points - 1) / points;
+        if (width == 0) width = 1;
+        buckets = (span + width - 1) / width;
+        return true;
+    }
+
+    // LTTB
+    if (points < 3) points = 3;
+    if (samples <= points) {
+        passThrough = true;
+        cursor = fromMs;
+        return true;
+    }
+
+    SampleCopy first;
+    SampleCopy last;
+    SERIES[series].access(HISTORY_FIRST, fromMs, toMs, copySample, &first);
+    SERIES[series].access(HISTORY_LAST, fromMs, toMs, copySample, &last);
+    previousTime = first.timestamp;
+    previousValue = first.value;
+    lastTime = last.timestamp;
+    lastValue = last.value;
+
+    // The buckets cover the time strictly between the first and last samples
+    this->fromMs = first.timestamp + 1;
+    this->toMs = last.timestamp - 1;
+    buckets = points - 2;
+    uint32_t span = (last.timestamp - first.timestamp > 1) ? last.timestamp - first.timestamp - 1 : 0;
+    width = (span + buckets - 1) / buckets;
+    if (width == 0) width = 1;
+    aheadBucket = 0;
+    return true;
+}
+
+bool HistoryQuery::next(Point& out) {
+    PERF_SCOPE(PERF_HISTORY_QUERY);
+
+    if (series >= SERIES_COUNT) return false;
+    if (mode == BUCKETS) return nextBucket(out);
+    if (passThrough) return nextSample(out);
+    return nextLttb(out);
+}
+
+const char* HistoryQuery::getSensor() const {
+    return series < SERIES_COUNT ? SERIES[series].sensor : "";
+}
+
+const char* HistoryQuery::getField() const {
+    return series < SERIES_COUNT ? SERIES[series].field : "";
+}
+
+uint32_t HistoryQuery::bucketStart(uint16_t index) const {
+    return fromMs + (uint32_t)index * width;
+}
+
+uint32_t HistoryQuery::bucketEnd(uint16_t index) const {
+    uint32_t end = bucketStart(index) + width - 1;
+    return ((int32_t)(end - toMs) > 0) ? toMs : end;
+}
+
+bool HistoryQuery::nextBucket(Point& out) {
+    while (bucket < buckets) {
+        BucketStats stats = {};
+        uint16_t index = bucket++;
+        SERIES[series].access(HISTORY_WALK, bucketStart(index), bucketEnd(index), addToBucket, &stats);
+        if (stats.count == 0) continue;
+
+        out.timestamp = bucketStart(index);
+        out.value = stats.sum / stats.count;
+        out.min = stats.min;
+        out.max = stats.max;
+        out.count = stats.count;
+        return true;
+    }
+    return false;
+}
+
+bool HistoryQuery::nextSample(Point& out) {
+    SampleCopy sample;
+    if ((int32_t)(cursor - toMs) > 0 ||
+        SERIES[series].access(HISTORY_FIRST, cursor, toMs, copySample, &sample) == 0) {
+        return false;
+    }
+    setPoint(out, sample.timestamp, sample.value);
+    cursor = sample.timestamp + 1;
+    return true;
+}
+
+void HistoryQuery::findAhead() {
+    // Point C for the current bucket: the next non-empty bucket's
+    // average, or the last sample when there is none
+    for (aheadBucket = bucket + 1; aheadBucket < buckets; aheadBucket++) {
+        BucketAverage average = { fromMs, 0, 0, 0 };
+        SERIES[series].access(HISTORY_WALK, bucketStart(aheadBucket), bucketEnd(aheadBucket),
+                              addToAverage, &average);
+        if (average.count > 0) {
+            aheadTime = average.sumTime / average.count;
+            aheadValue = average.sumValue / average.count;
+            return;
+        }
+    }
+    aheadTime = (float)(int32_t)(lastTime - fromMs);
+    aheadValue = lastValue;
+}
+
+bool HistoryQuery::nextLttb(Point& out) {
+    if (stage == 0) {
+        stage = 1;
+        setPoint(out, previousTime, previousValue);
+        return true;
+    }
+
+    while (stage == 1 && bucket < buckets) {
+        if (aheadBucket <= bucket) findAhead();
+
+        TriangleSearch search = {};
+        search.origin = fromMs;
+        search.previousTime = (float)(int32_t)(previousTime - fromMs);
+        search.previousValue = previousValue;
+        search.aheadTime = aheadTime;
+        search.aheadValue = aheadValue;
+        uint16_t index = bucket++;
+        SERIES[series].access(HISTORY_WALK, bucketStart(index), bucketEnd(index), considerSample, &search);
+        if (search.count == 0) continue;
+
+        previousTime = search.bestTimestamp;
+        previousValue = search.bestValue;
+        setPoint(out, previousTime, previousValue);
+        return true;
+    }
+
+    if (stage == 1) {
+        stage = 2;
+        setPoint(out, lastTime, lastValue);
+        return true;
+    }
+    return false;
+}
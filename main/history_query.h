@@ -0,0 +1,122 @@
+#ifndef HISTORY_QUERY_H
+#define HISTORY_QUERY_H
+
+#include <Arduino.h>
+#include "config.h"
+
+/**
+ * HistoryQuery
+ *
+ * Downsamples one field of the sensor history rings (sensor_history.h)
+ * over a time range, one output point per call to next(), so a caller
+ * can stream the series in pieces. The query holds a few dozen bytes of
+ * state whatever the range: each bucket is read from the ring in place
+ * when its point is computed, nothing is copied out.
+ *
+ * Series are named like the payload (sensor_schema.h): the group key
+ * ("air_quality", "mr007", ...) and the field key ("pm25",
+ * "lel_concentration", ...).
+ *
+ * Modes:
+ *   BUCKETS  The range is split into `points` equal time buckets. Each
+ *            non-empty bucket gives its start time and the min, max,
+ *            average and count of its samples.
+ *   LTTB     Largest-triangle-three-buckets. The first and last samples
+ *            are kept, and the time between them is split into
+ *            `points - 2` buckets. Each non-empty bucket gives the
+ *            sample that forms the largest triangle with the point
+ *            chosen before it and the average of the next non-empty
+ *            bucket. Each sample is read at most twice (once as part
+ *            of that average, once as a candidate). Ranges with no
+ *            more than `points` samples are returned as they are.
+ *
+ * Usage:
+ *   HistoryQuery q;
+ *   if (q.begin("mr007", "lel_concentration", HistoryQuery::LTTB, from, to, 200)) {
+ *       HistoryQuery::Point p;
+ *       while (q.next(p)) { ... }
+ *   }
+ */
+class HistoryQuery {
+public:
+    enum Mode : uint8_t {
+        BUCKETS,
+        LTTB
+    };
+
+    struct Point {
+        uint32_t timestamp;     // millis(): bucket start (BUCKETS) or the sample's (LTTB)
+        float value;            // Average (BUCKETS) or the sample's value (LTTB)
+        float min;
+        float max;
+        uint32_t count;         // Samples in the bucket; 1 for LTTB
+    };
+
+    /**
+     * Set up a query
+     * @param sensor Group key
+     * @param field Field key within the group
+     * @param mode BUCKETS or LTTB
+     * @param fromMs Start of range, millis()
+     * @param toMs End of range, millis(), inclusive
+     * @param points Output points wanted (at least 1, or 3 for LTTB)
+     * @return false if the schema has no such series
+     */
+    bool begin(const char* sensor, const char* field, Mode mode,
+               uint32_t fromMs, uint32_t toMs, uint16_t points);
+
+    /**
+     * Compute the next point
+     * @return false once the series is complete
+     */
+    bool next(Point& out);
+
+    const char* getSensor() const;
+    const char* getField() const;
+    Mode getMode() const { return mode; }
+
+    /**
+     * Decimals the field is written with in the payload
+     */
+    uint8_t getDecimals() const { return decimals; }
+
+    /**
+     * Samples in the range when the query began
+     */
+    uint32_t getSamples() const { return samples; }
+
+private:
+    bool nextBucket(Point& out);
+    bool nextLttb(Point& out);
+    bool nextSample(Point& out);
+    void findAhead();
+    uint32_t bucketStart(uint16_t index) const;
+    uint32_t bucketEnd(uint16_t index) const;
+
+    uint8_t series = 0;         // Row in the series table
+    uint8_t decimals = 0;
+    Mode mode = BUCKETS;
+    bool passThrough = false;   // LTTB with no more samples than points
+    uint8_t stage = 0;          // LTTB: first sample, buckets, last sample, done
+    uint32_t cursor = 0;        // Pass-through: next timestamp to return
+    uint16_t bucket = 0;
+    uint16_t buckets = 0;
+    uint32_t fromMs = 0;
+    uint32_t toMs = 0;
+    uint32_t width = 1;         // Bucket width in ms
+    uint32_t samples = 0;
+
+    // LTTB: the point chosen last, and the last sample of the range
+    uint32_t previousTime = 0;
+    float previousValue = 0;
+    uint32_t lastTime = 0;
+    float lastValue = 0;
+
+    // LTTB: average of the next non-empty bucket, reused while the
+    // buckets before it turn out empty
+    uint16_t aheadBucket = 0;
+    float aheadTime = 0;
+    float aheadValue = 0;
+};
+
+#endif
@@ -0,0 +1,167 @@
+#include "http_response_parser.h"
+
+void HttpResponseParser::reset() {
+    state = STATUS_LINE;
+    lineLength = 0;
+    status = 0;
+    length = -1;
+    chunked = false;
+    persistent = false;
+    retryAfterSeconds = 0;
+    remaining = 0;
+    body[0] = '\0';
+    bodyKept = 0;
+}
+
+bool HttpResponseParser::lineComplete(char c) {
+    if (c == '\n') {
+        if (lineLength > 0 && line[lineLength - 1] == '\r') lineLength--;
+        line[lineLength] = '\0';
+        return true;
+    }
+    // Overlong lines are truncated; nothing we read needs their tail
+    if (lineLength < sizeof(line) - 1) line[lineLength++] = c;
+    return false;
+}
+
+void HttpResponseParser::parseStatusLine() {
+    // "HTTP/1.1 200 OK"
+    if (lineLength < 12 || strncmp(line, "HTTP/1.", 7) != 0 || line[8] != ' ') {
+        state = FAILED;
+        return;
+    }
+    status = atoi(line + 9);
+    if (status < 100 || status > 999) {
+        status = 0;
+        state = FAILED;
+        return;
+    }
+    persistent = (line[7] == '1');
+    state = HEADERS;
+}
+
+void HttpResponseParser::parseHeader() {
+    char* colon = strchr(line, ':');
+    if (colon == nullptr) return;
+    *colon = '\0';
+    const char* value = colon + 1;
+    while (*value == ' ' || *value == '\t') value++;
+
+    if (strcasecmp(line, "Content-Length") == 0) {
+        length = atol(value);
+    } else if (strcasecmp(line, "Transfer-Encoding") == 0) {
+        chunked = strcasestr(value, "chunked") != nullptr;
+    } else if (strcasecmp(line, "Connection") == 0) {
+        if (strcasestr(value, "close") != nullptr) persistent = false;
+        else if (strcasestr(value, "keep-alive") != nullptr) persistent = true;
+    } else if (strcasecmp(line, "Retry-After") == 0) {
+        // The HTTP-date form would need a clock; only seconds are used
+        if (*value >= '0' && *value <= '9') retryAfterSeconds = strtoul(value, nullptr, 10);
+    }
+}
+
+void HttpResponseParser::endOfHeaders() {
+    if (status < 200) {
+        // Interim response (100 Continue); the real one follows
+        reset();
+        return;
+    }
+
+    if (status == 204 || status == 304) {
+        state = DONE;
+    } else if (chunked) {
+        state = CHUNK_SIZE;
+    } else if (length >= 0) {
+        remaining = length;
+        state = (remaining > 0) ? BODY_LENGTH : DONE;
+    } else {
+        // Body runs until the server closes the connection
+        persistent = false;
+        state = BODY_UNTIL_CLOSE;
+    }
+}
+
+void HttpResponseParser::keepBody(const uint8_t* data, size_t n) {
+    size_t room = HTTP_RESPONSE_BODY_KEPT - bodyKept;
+    if (n > room) n = room;
+    memcpy(body + bodyKept, data, n);
+    bodyKept += n;
+    body[bodyKept] = '\0';
+}
+
+size_t HttpResponseParser::feed(const uint8_t* data, size_t n) {
+    size_t i = 0;
+
+    while (i < n && !isDone()) {
+        switch (state) {
+            case BODY_LENGTH:
+            case CHUNK_DATA: {
+                size_t take = (n - i < remaining) ? n - i : remaining;
+                keepBody(data + i, take);
+                i += take;
+                remaining -= take;
+                if (remaining == 0) state = (state == BODY_LENGTH) ? DONE : CHUNK_DATA_END;
+                break;
+            }
+
+            case BODY_UNTIL_CLOSE:
+                keepBody(data + i, n - i);
+                i = n;
+                break;
+
+            default: {
+                // Line-oriented states
+                if (!lineComplete((char)data[i++])) break;
+
+                switch (state) {
+                    case STATUS_LINE:
+                        parseStatusLine();
+                        break;
+
+                    case HEADERS:
+                        if (lineLength == 0) endOfHeaders();
+                        else parseHeader();
+                        break;
+
+                    case CHUNK_SIZE: {
+                        // Hex size, optionally followed by ";extensions"
+                        char* end;
+                        unsigned long size = strtoul(line, &end, 16);
+                        if (end == line) {
+                            state = FAILED;
+                        } else if (size == 0) {
+                            state = TRAILERS;
+                        } else {
+                            remaining = size;
+                            state = CHUNK_DATA;
+                        }
+                        break;
+                    }
+
+                    case CHUNK_DATA_END:
+                        state = (lineLength == 0) ? CHUNK_SIZE : FAILED;
+                        break;
+
+                    case TRAILERS:
+                        if (lineLength == 0) state = DONE;
+                        break;
+
+                    default:
+                        break;
+                }
+                lineLength = 0;
+                break;
+            }
+        }
+    }
+    return i;
+}
+
+void HttpResponseParser::finish() {
+    if (state == BODY_UNTIL_CLOSE) {
+        state = DONE;
+    } else if (!isDone()) {
+        state = FAILED;
+    }
+    persistent = false;
+}
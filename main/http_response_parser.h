@@ -0,0 +1,104 @@
+#ifndef HTTP_RESPONSE_PARSER_H
+#define HTTP_RESPONSE_PARSER_H
+
+#include <Arduino.h>
+#include "config.h"
+
+/**
+ * HTTP Response Parser
+ *
+ * Incremental HTTP/1.x response parser. Bytes are fed in whatever
+ * pieces the socket returns; the parser keeps only the current line
+ * (status or header) and the first HTTP_RESPONSE_BODY_KEPT body bytes,
+ * so memory use does not depend on the response size.
+ *
+ * Handles:
+ *   - Status line (HTTP/1.0 and HTTP/1.1)
+ *   - Content-Length, Transfer-Encoding: chunked, Connection, Retry-After
+ *   - Bodies delimited by length, by chunks, or by connection close
+ *
+ * Usage:
+ *   HttpResponseParser parser;
+ *   while (!parser.isDone()) {
+ *       int n = client.read(buffer, sizeof(buffer));
+ *       parser.feed(buffer, n);
+ *   }
+ *   parser.finish();  // Peer closed: ends a close-delimited body
+ */
+class HttpResponseParser {
+public:
+    HttpResponseParser() { reset(); }
+
+    void reset();
+
+    /**
+     * Consume received bytes
+     * @return Bytes used; less than length once the response is done
+     *         (the rest belongs to the next response on the socket)
+     */
+    size_t feed(const uint8_t* data, size_t length);
+
+    /**
+     * The connection closed; completes a body that runs until close
+     */
+    void finish();
+
+    bool isDone() const { return state == DONE || state == FAILED; }
+    bool isComplete() const { return state == DONE; }
+    bool hasError() const { return state == FAILED; }
+    bool headersDone() const { return state > HEADERS && status != 0; }
+
+    int statusCode() const { return status; }
+    long contentLength() const { return length; }
+
+    /**
+     * The socket can carry another request after this response
+     */
+    bool keepAlive() const { return state == DONE && persistent; }
+
+    /**
+     * Retry-After in seconds (delta form only), 0 if absent
+     */
+    uint32_t retryAfter() const { return retryAfterSeconds; }
+
+    /**
+     * Start of the body, NUL-terminated, for logging errors
+     */
+    const char* bodyPrefix() const { return body; }
+
+private:
+    enum State : uint8_t {
+        STATUS_LINE,
+        HEADERS,
+        BODY_LENGTH,
+        BODY_UNTIL_CLOSE,
+        CHUNK_SIZE,
+        CHUNK_DATA,
+        CHUNK_DATA_END,
+        TRAILERS,
+        DONE,
+        FAILED
+    };
+
+    bool lineComplete(char c);
+    void parseStatusLine();
+    void parseHeader();
+    void endOfHeaders();
+    void keepBody(const uint8_t* data, size_t n);
+
+    State state;
+    char line[HTTP_RESPONSE_LINE_SIZE];
+    size_t lineLength;
+
+    int status;
+    long length;                // Content-Length, -1 if absent
+    bool chunked;
+    bool persistent;
+    uint32_t retryAfterSeconds;
+
+    uint32_t remaining;         // Body or chunk bytes still expected
+    char body[HTTP_RESPONSE_BODY_KEPT + 1];
+    size_t bodyKept;
+};
+
+#endif
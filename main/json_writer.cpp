@@ -0,0 +1,201 @@
+#include "json_writer.h"
+#include <math.h>
+
+static const uint32_t POW10[] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+// Largest magnitude written as a number; scaled values must fit 64 bits
+static const float MAX_FORMATTED = 1e9f;
+
+JsonWriter::JsonWriter(char* buffer, size_t capacity)
+    : sink(nullptr), buffer(buffer), capacity(capacity) {
+    if (capacity > 0) buffer[0] = '\0';
+}
+
+JsonWriter::JsonWriter(Print& sink, char* buffer, size_t capacity)
+    : sink(&sink), buffer(buffer), capacity(capacity) {
+    if (capacity > 0) buffer[0] = '\0';
+}
+
+void JsonWriter::put(char c) {
+    put(&c, 1);
+}
+
+void JsonWriter::put(const char* s, size_t n) {
+    while (n > 0) {
+        // Keep one byte for the terminator in buffer-only mode
+        size_t room = capacity - used - (sink ? 0 : 1);
+        if (room == 0) {
+            if (sink == nullptr) {
+                overflow = true;
+                return;
+            }
+            flush();
+            continue;
+        }
+
+        size_t chunk = (n < room) ? n : room;
+        memcpy(buffer + used, s, chunk);
+        used += chunk;
+        s += chunk;
+        n -= chunk;
+    }
+    if (sink == nullptr) buffer[used] = '\0';
+}
+
+void JsonWriter::flush() {
+    if (sink == nullptr || used == 0) return;
+    sink->write((const uint8_t*)buffer, used);
+    flushed += used;
+    used = 0;
+}
+
+void JsonWriter::separate() {
+    if (needComma) put(',');
+}
+
+void JsonWriter::beginObject() {
+    separate();
+    put('{');
+    needComma = false;
+}
+
+void JsonWriter::endObject() {
+    put('}');
+    needComma = true;
+}
+
+void JsonWriter::beginArray() {
+    separate();
+    put('[');
+    needComma = false;
+}
+
+void JsonWriter::endArray() {
+    put(']');
+    needComma = true;
+}
+
+void JsonWriter::key(const char* name) {
+    separate();
+    putString(name);
+    put(':');
+    needComma = false;
+}
+
+void JsonWriter::value(float v, uint8_t decimals) {
+    char digits[24];
+    size_t n = formatFixed(digits, v, decimals);
+    if (n == 0) {
+        null();
+        return;
+    }
+    separate();
+    put(digits, n);
+    needComma = true;
+}
+
+void JsonWriter::value(long v) {
+    char digits[12];
+    separate();
+    if (v < 0) {
+        put('-');
+        put(digits, formatUnsigned(digits, (uint32_t)(-(v + 1)) + 1));
+    } else {
+        put(digits, formatUnsigned(digits, (uint32_t)v));
+    }
+    needComma = true;
+}
+
+void JsonWriter::value(unsigned long v) {
+    char digits[12];
+    separate();
+    put(digits, formatUnsigned(digits, (uint32_t)v));
+    needComma = true;
+}
+
+void JsonWriter::value(bool v) {
+    separate();
+    if (v) put("true", 4);
+    else put("false", 5);
+    needComma = true;
+}
+
+void JsonWriter::value(const char* v) {
+    separate();
+    putString(v);
+    needComma = true;
+}
+
+void JsonWriter::null() {
+    separate();
+    put("null", 4);
+    needComma = true;
+}
+
+void JsonWriter::raw(const char* json, size_t length) {
+    separate();
+    put(json, length);
+    needComma = true;
+}
+
+void JsonWriter::putString(const char* s) {
+    put('"');
+    const char* run = s;
+    for (; *s; s++) {
+        char c = *s;
+        if (c != '"' && c != '\\' && (uint8_t)c >= 0x20) continue;
+
+        // Flush the clean run, then the escaped character
+        put(run, s - run);
+        if ((uint8_t)c < 0x20) {
+            put(' ');
+        } else {
+            put('\\');
+            put(c);
+        }
+        run = s + 1;
+    }
+    put(run, s - run);
+    put('"');
+}
+
+size_t JsonWriter::formatUnsigned(char* out, uint32_t v) {
+    char reversed[10];
+    size_t n = 0;
+    do {
+        reversed[n++] = '0' + (v % 10);
+        v /= 10;
+    } while (v > 0);
+
+    for (size_t i = 0; i < n; i++) {
+        out[i] = reversed[n - 1 - i];
+    }
+    return n;
+}
+
+size_t JsonWriter::formatFixed(char* out, float v, uint8_t decimals) {
+    if (isnan(v) || isinf(v) || fabsf(v) >= MAX_FORMATTED) return 0;
+    if (decimals > 6) decimals = 6;
+
+    bool negative = v < 0;
+    uint64_t scaled = (uint64_t)((negative ? -v : v) * (float)POW10[decimals] + 0.5f);
+    uint32_t whole = (uint32_t)(scaled / POW10[decimals]);
+    uint32_t fraction = (uint32_t)(scaled % POW10[decimals]);
+
+    size_t n = 0;
+    if (negative && scaled != 0) out[n++] = '-';
+    n += formatUnsigned(out + n, whole);
+
+    if (decimals > 0) {
+        out[n++] = '.';
+        // Fraction digits with leading zeros, most significant first
+        for (int8_t i = decimals - 1; i >= 0; i--) {
+            out[n + i] = '0' + (fraction % 10);
+            fraction /= 10;
+        }
+        n += decimals;
+    }
+    return n;
+}
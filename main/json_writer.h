@@ -0,0 +1,117 @@
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <Arduino.h>
+
+/**
+ * JsonWriter
+ *
+ * Streaming JSON emitter that never touches the heap. Output goes to a
+ * caller-supplied buffer, and optionally on to a Print sink (a Client,
+ * a File, Serial):
+ *
+ *   - Buffer only: the document is built in place and NUL-terminated.
+ *     If it does not fit, ok() turns false and the output is truncated.
+ *   - Buffer + sink: the buffer is scratch space. Each time it fills,
+ *     it is written to the sink in one block, and flush() sends the
+ *     rest. Documents of any size stream through a small stack buffer.
+ *
+ * Commas are tracked internally, so callers only describe structure.
+ * Floats use fixed-precision integer formatting instead of dtostrf().
+ * NaN, infinity and magnitudes of 1e9 or more are written as null,
+ * which keeps the output valid JSON.
+ *
+ * Usage:
+ *   char buf[256];
+ *   JsonWriter w(client, buf, sizeof(buf));
+ *   w.beginObject();
+ *   w.member("voltage", 1.234f, 3);
+ *   w.endObject();
+ *   w.flush();
+ */
+class JsonWriter {
+public:
+    JsonWriter(char* buffer, size_t capacity);
+    JsonWriter(Print& sink, char* buffer, size_t capacity);
+
+    void beginObject();
+    void endObject();
+    void beginArray();
+    void endArray();
+
+    void key(const char* name);
+
+    void value(float v, uint8_t decimals);
+    void value(int v) { value((long)v); }
+    void value(long v);
+    void value(unsigned long v);
+    void value(bool v);
+    void value(const char* v);
+    void null();
+
+    template <typename T>
+    void member(const char* name, T v) { key(name); value(v); }
+    void member(const char* name, float v, uint8_t decimals) { key(name); value(v, decimals); }
+
+    /**
+     * Insert pre-encoded JSON (e.g. a buffered record) as one value
+     */
+    void raw(const char* json, size_t length);
+
+    /**
+     * Append more bytes to the value started by raw() (no separator)
+     */
+    void rawContinue(const char* json, size_t length) { put(json, length); }
+
+    /**
+     * Write any buffered output to the sink (no-op without a sink)
+     */
+    void flush();
+
+    /**
+     * Bytes currently in the buffer (the whole document without a sink)
+     */
+    size_t length() const { return used; }
+
+    /**
+     * Bytes produced so far, including those already flushed
+     */
+    size_t totalLength() const { return flushed + used; }
+
+    const char* c_str() const { return buffer; }
+
+    /**
+     * False if the document did not fit (buffer-only mode)
+     */
+    bool ok() const { return !overflow; }
+
+    /**
+     * Format a float with a fixed number of decimals
+     * @param out Destination, at least 24 bytes
+     * @return Characters written, 0 if the value is not representable
+     */
+    static size_t formatFixed(char* out, float v, uint8_t decimals);
+
+    /**
+     * Format an unsigned integer
+     * @param out Destination, at least 11 bytes
+     * @return Characters written
+     */
+    static size_t formatUnsigned(char* out, uint32_t v);
+
+private:
+    void separate();
+    void put(char c);
+    void put(const char* s, size_t n);
+    void putString(const char* s);
+
+    Print* sink;
+    char* buffer;
+    size_t capacity;
+    size_t used = 0;
+    size_t flushed = 0;
+    bool overflow = false;
+    bool needComma = false;
+};
+
+#endif
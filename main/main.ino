@@ -1,6 +1,7 @@
 #include "config.h"
 #include "shared_data.h"
 #include "task_manager.h"
+#include "perf_monitor.h"
 
 void setup() {
     // Initialize serial with sufficient delay
@@ -10,13 +11,10 @@ void setup() {
     DEBUG_PRINTLN("Air Quality Monitor");
     DEBUG_PRINTLN("=============================================================");
 
-    // Initialize shared data FIRST - this creates the mutex
+    // Initialize shared data FIRST - tasks publish into it
     initSharedData();
     
-    // Wait for mutex initialization to complete
-    delay(1000);
-    
-    // Verify mutex is ready
+    // Verify shared data is ready
     if (!isDataReady()) {
         DEBUG_PRINTLN("FATAL ERROR: Shared data initialization failed!");
         while(1) {
@@ -24,6 +22,10 @@ void setup() {
         }
     }
     
+    #ifdef PERF_MONITOR_ENABLED
+    PerfMonitor::init();
+    #endif
+    
     // Create tasks - this starts the system
     taskManager.createTasks();
 }
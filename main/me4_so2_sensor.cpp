@@ -1,43 +1,48 @@
 #include "me4_so2_sensor.h"
 #include "config.h"
 #include "shared_data.h"
+#include "sensor_history.h"
+#include "rolling_stats.h"
+#include "adc_sampler.h"
 #include <Arduino.h>
 
 ME4SO2Sensor me4so2Sensor;
 
 void ME4SO2Sensor::init() {
-    analogReadResolution(ADC_RESOLUTION);
-    readSensor();
     DEBUG_PRINTLN("✓ ME4-SO2 Sensor initialized");
 }
 
 void ME4SO2Sensor::readSensor() {
-    float voltage = readVoltage();
-    int rawValue = analogRead(ME4_SO2_PIN);
+    // Voltage and raw come from the same decimated ADC reading; only
+    // the voltage (and what is derived from it) is smoothed
+    AdcReading reading;
+    if (!adcSampler.read(ADC_CH_ME4_SO2, reading)) return;
+    
+    float voltage = voltageFilter.apply(reading.voltage);
+    int rawValue = reading.raw;
     float current_ua = (voltage / SO2_LOAD_RESISTOR) * 1000000.0;
     float so2_concentration = current_ua / SO2_SENSITIVITY;
 
-    if (lockData()) {
-        sharedData.me4so2_voltage = voltage;
-        sharedData.me4so2_raw = rawValue;
-        sharedData.me4so2_current = current_ua;
-        sharedData.me4so2_so2 = so2_concentration;
-        sharedData.me4so2_valid = true;
-        sharedData.last_update = millis();
-        unlockData();
-    }
-}
+    uint32_t now = millis();
+
+    ME4SO2Sample sample;
+    sample.timestamp = now;
+    sample.voltage = voltage;
+    sample.raw = rawValue;
+    sample.current = current_ua;
+    sample.so2 = so2_concentration;
+
+    beginDataUpdate();
+    sensorHistory.me4so2.push(sample);
+    endDataUpdate();
 
-float ME4SO2Sensor::readVoltage() {
-    int rawValue = analogRead(ME4_SO2_PIN);
-    return rawValue * (V_REF / (1 << ADC_RESOLUTION));
+    rollingStats.add(ROLLING_me4so2_voltage, now, voltage);
+    rollingStats.add(ROLLING_me4so2_raw, now, rawValue);
+    rollingStats.add(ROLLING_me4so2_current, now, current_ua);
+    rollingStats.add(ROLLING_me4so2_so2, now, so2_concentration);
 }
 
 bool ME4SO2Sensor::isDataValid() {
-    bool valid = false;
-    if (lockData()) {
-        valid = sharedData.me4so2_valid && (millis() - sharedData.last_update < 5000);
-        unlockData();
-    }
-    return valid;
+    ME4SO2Sample latest;
+    return sensorHistory.me4so2.latest(latest) && (millis() - latest.timestamp < 5000);
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 #define ME4_SO2_SENSOR_H
 
 #include "config.h"
+#include "dsp_filters.h"
 
 class ME4SO2Sensor {
 public:
@@ -10,7 +11,7 @@ public:
     bool isDataValid();
 
 private:
-    float readVoltage();
+    FilterChain<ME4_SO2_FILTER> voltageFilter;
 };
 
 extern ME4SO2Sensor me4so2Sensor;
@@ -1,41 +1,45 @@
 #include "mr007_sensor.h"
 #include "config.h"
 #include "shared_data.h"
+#include "sensor_history.h"
+#include "rolling_stats.h"
+#include "adc_sampler.h"
 #include <Arduino.h>
 
 MR007Sensor mr007Sensor;
 
 void MR007Sensor::init() {
-    analogReadResolution(ADC_RESOLUTION);
-    readSensor();
     DEBUG_PRINTLN("✓ MR007 Combustible Gas Sensor initialized");
 }
 
 void MR007Sensor::readSensor() {
-    float voltage = readVoltage();
-    int rawValue = analogRead(MR007_PIN);
+    // Voltage and raw come from the same decimated ADC reading; only
+    // the voltage (and what is derived from it) is smoothed
+    AdcReading reading;
+    if (!adcSampler.read(ADC_CH_MR007, reading)) return;
+    
+    float voltage = voltageFilter.apply(reading.voltage);
+    int rawValue = reading.raw;
     float lel_concentration = (voltage / V_REF) * 100.0;
 
-    if (lockData()) {
-        sharedData.mr007_voltage = voltage;
-        sharedData.mr007_raw = rawValue;
-        sharedData.mr007_lel = lel_concentration;
-        sharedData.mr007_valid = true;
-        sharedData.last_update = millis();
-        unlockData();
-    }
-}
+    uint32_t now = millis();
+
+    MR007Sample sample;
+    sample.timestamp = now;
+    sample.voltage = voltage;
+    sample.raw = rawValue;
+    sample.lel = lel_concentration;
+
+    beginDataUpdate();
+    sensorHistory.mr007.push(sample);
+    endDataUpdate();
 
-float MR007Sensor::readVoltage() {
-    int rawValue = analogRead(MR007_PIN);
-    return rawValue * (V_REF / (1 << ADC_RESOLUTION));
+    rollingStats.add(ROLLING_mr007_voltage, now, voltage);
+    rollingStats.add(ROLLING_mr007_raw, now, rawValue);
+    rollingStats.add(ROLLING_mr007_lel, now, lel_concentration);
 }
 
 bool MR007Sensor::isDataValid() {
-    bool valid = false;
-    if (lockData()) {
-        valid = sharedData.mr007_valid && (millis() - sharedData.last_update < 5000);
-        unlockData();
-    }
-    return valid;
+    MR007Sample latest;
+    return sensorHistory.mr007.latest(latest) && (millis() - latest.timestamp < 5000);
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 #define MR007_SENSOR_H
 
 #include "config.h"
+#include "dsp_filters.h"
 
 class MR007Sensor {
 public:
@@ -10,7 +11,7 @@ public:
     bool isDataValid();
 
 private:
-    float readVoltage();
+    FilterChain<MR007_FILTER> voltageFilter;
 };
 
 extern MR007Sensor mr007Sensor;
@@ -21,6 +21,14 @@ public:
     bool isWifiActive() { return wifiActive; }
     bool isAPActive() { return apActive; }
     
+    // Short name of the active link: "eth", "wifi", "ap" or "unknown"
+    const char* getModeName() {
+        if (ethActive) return "eth";
+        if (wifiActive) return "wifi";
+        if (apActive) return "ap";
+        return "unknown";
+    }
+    
     // Security: Generate unique AP SSID using MAC address
     String generateAPSSID();
 
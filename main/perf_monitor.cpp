@@ -0,0 +1,178 @@
+#include "perf_monitor.h"
+#include "config.h"
+#include <esp_heap_caps.h>
+#include <freertos/FreeRTOS.h>
+
+// Per-probe budgets. These are upper limits, not measurements: tighten
+// them with the averages printed by report() on a real device so that
+// any later change which slows a hot path or adds heap churn is flagged.
+struct PerfBudget {
+    const char* name;
+    uint32_t maxAvgUs;
+    uint32_t maxAllocsPerOp;
+};
+
+static const PerfBudget PERF_BUDGETS[PERF_PROBE_COUNT] = {
+    { "DjangoClient::buildJSONPayload",      2000,   0 },
+    { "BufferManager::saveData",             5000,   0 },
+    { "SensorWebServer::handleHTTPRequest", 250000, 40 },
+    { "ZE40Sensor::processByte",               20,   0 },
+    { "snapshotData (reader)",                 20,   0 },
+    { "beginDataUpdate..endDataUpdate",        10,   0 },
+    { "ZPHS01BSensor::parse (64 B chunk)",     300,   0 },
+    { "ZPHS01BSensor::applyFilters",            40,   0 },
+    { "BufferManager::streamEntries",      5000000,   8 },
+    { "HttpResponseParser::feed (256 B)",      200,   0 },
+    { "DjangoClient::compressBody (sizing)", 100000,   8 },
+    { "DjangoClient::buildCBORPayload",       1000,   0 },
+    { "SensorWebServer::pushUpdates",         3000,   0 },
+    { "HistoryQuery::next",                   2000,   0 },
+    { "RollingStats::add",                      10,   0 },
+};
+
+PerfMonitor::ProbeStats PerfMonitor::stats[PERF_PROBE_COUNT];
+
+static portMUX_TYPE perfMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Allocation counters, one set per core so that the sensor task (core 1)
+// and the Ethernet task (core 0) do not pollute each other's numbers
+static volatile uint32_t heapAllocCount[portNUM_PROCESSORS] = {0};
+static volatile uint32_t heapAllocBytes[portNUM_PROCESSORS] = {0};
+
+#if defined(PERF_MONITOR_ENABLED) && defined(CONFIG_HEAP_USE_HOOKS)
+// Called by ESP-IDF on every allocation when heap hooks are enabled.
+// Runs in any context, including ISRs, so it only bumps counters.
+extern "C" void IRAM_ATTR esp_heap_trace_alloc_hook(void* ptr, size_t size, uint32_t caps) {
+    (void)ptr;
+    (void)caps;
+    int core = xPortGetCoreID();
+    heapAllocCount[core] = heapAllocCount[core] + 1;
+    heapAllocBytes[core] = heapAllocBytes[core] + size;
+}
+
+extern "C" void IRAM_ATTR esp_heap_trace_free_hook(void* ptr) {
+    (void)ptr;
+}
+#endif
+
+void PerfMonitor::init() {
+    portENTER_CRITICAL(&perfMux);
+    memset(stats, 0, sizeof(stats));
+    portEXIT_CRITICAL(&perfMux);
+
+    #ifdef CONFIG_HEAP_USE_HOOKS
+    DEBUG_PRINTLN("✓ Perf monitor initialized (heap hooks: exact allocation counts)");
+    #else
+    DEBUG_PRINTLN("✓ Perf monitor initialized (no heap hooks: net heap delta only)");
+    #endif
+}
+
+uint32_t PerfMonitor::allocCount() {
+    return heapAllocCount[xPortGetCoreID()];
+}
+
+uint32_t PerfMonitor::allocBytes() {
+    return heapAllocBytes[xPortGetCoreID()];
+}
+
+void PerfMonitor::record(PerfProbeId id, uint32_t elapsedUs, uint32_t allocs,
+                         uint32_t allocBytes, int32_t netHeapBytes) {
+    if (id >= PERF_PROBE_COUNT) return;
+
+    portENTER_CRITICAL(&perfMux);
+    ProbeStats& s = stats[id];
+    s.calls++;
+    s.totalUs += elapsedUs;
+    if (elapsedUs > s.maxUs) s.maxUs = elapsedUs;
+    s.totalAllocs += allocs;
+    s.totalAllocBytes += allocBytes;
+    s.totalNetHeap += netHeapBytes;
+    s.netHeapCalls++;
+    portEXIT_CRITICAL(&perfMux);
+}
+
+void PerfMonitor::record(PerfProbeId id, uint32_t elapsedUs, uint32_t allocs,
+                         uint32_t allocBytes) {
+    if (id >= PERF_PROBE_COUNT) return;
+
+    portENTER_CRITICAL(&perfMux);
+    ProbeStats& s = stats[id];
+    s.calls++;
+    s.totalUs += elapsedUs;
+    if (elapsedUs > s.maxUs) s.maxUs = elapsedUs;
+    s.totalAllocs += allocs;
+    s.totalAllocBytes += allocBytes;
+    portEXIT_CRITICAL(&perfMux);
+}
+
+void PerfMonitor::report() {
+    ProbeStats snapshot[PERF_PROBE_COUNT];
+    portENTER_CRITICAL(&perfMux);
+    memcpy(snapshot, stats, sizeof(snapshot));
+    portEXIT_CRITICAL(&perfMux);
+
+    DEBUG_PRINTLN("┌─ Perf report ──────────────────────────────");
+    for (uint8_t i = 0; i < PERF_PROBE_COUNT; i++) {
+        const ProbeStats& s = snapshot[i];
+        if (s.calls == 0) {
+            DEBUG_PRINTF("│ %-36s no calls\n", PERF_BUDGETS[i].name);
+            continue;
+        }
+
+        uint64_t avgNs = (s.totalUs * 1000ULL) / s.calls;
+        uint32_t avgAllocs = s.totalAllocs / s.calls;
+        uint32_t avgBytes = s.totalAllocBytes / s.calls;
+
+        bool overTime = (avgNs / 1000) > PERF_BUDGETS[i].maxAvgUs;
+        bool overAllocs = avgAllocs > PERF_BUDGETS[i].maxAllocsPerOp;
+
+        // Net heap is the free-heap change across the call on any task
+        char net[24] = "-";
+        if (s.netHeapCalls > 0) {
+            snprintf(net, sizeof(net), "%ld B/op", (long)(s.totalNetHeap / (int64_t)s.netHeapCalls));
+        }
+
+        DEBUG_PRINTF("│ %-36s %8lu calls %10llu ns/op (max %lu us) %4lu allocs/op %6lu B/op net %s%s\n",
+                     PERF_BUDGETS[i].name,
+                     (unsigned long)s.calls,
+                     (unsigned long long)avgNs,
+                     (unsigned long)s.maxUs,
+                     (unsigned long)avgAllocs,
+                     (unsigned long)avgBytes,
+                     net,
+                     (overTime || overAllocs) ? "  ⚠ OVER BUDGET" : "");
+    }
+    DEBUG_PRINTF("│ Free heap: %u bytes, largest block: %u bytes, min ever: %u bytes\n",
+                 (unsigned)heap_caps_get_free_size(MALLOC_CAP_8BIT),
+                 (unsigned)heap_caps_get_largest_free_block(MALLOC_CAP_8BIT),
+                 (unsigned)heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT));
+    DEBUG_PRINTLN("└────────────────────────────────────────────");
+}
+
+PerfScope::PerfScope(PerfProbeId id) : probe(id) {
+    startAllocs = PerfMonitor::allocCount();
+    startAllocBytes = PerfMonitor::allocBytes();
+    startFreeHeap = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    startUs = micros();
+}
+
+PerfScope::~PerfScope() {
+    uint32_t elapsed = micros() - startUs;
+    int32_t netHeap = (int32_t)startFreeHeap - (int32_t)heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    PerfMonitor::record(probe, elapsed,
+                        PerfMonitor::allocCount() - startAllocs,
+                        PerfMonitor::allocBytes() - startAllocBytes,
+                        netHeap);
+}
+
+PerfFastScope::PerfFastScope(PerfProbeId id) : probe(id) {
+    startAllocs = PerfMonitor::allocCount();
+    startAllocBytes = PerfMonitor::allocBytes();
+    startUs = micros();
+}
+
+PerfFastScope::~PerfFastScope() {
+    PerfMonitor::record(probe, micros() - startUs,
+                        PerfMonitor::allocCount() - startAllocs,
+                        PerfMonitor::allocBytes() - startAllocBytes);
+}
@@ -0,0 +1,142 @@
+#ifndef PERF_MONITOR_H
+#define PERF_MONITOR_H
+
+#include <Arduino.h>
+#include "config.h"
+
+/**
+ * PerfMonitor
+ *
+ * On-device timing and heap accounting for the firmware hot paths.
+ * Each probe accumulates call count, time per call and heap activity
+ * per call. report() runs every SCHEDULER_REPORT_INTERVAL and compares
+ * the averages against the budgets in perf_monitor.cpp, so a regression
+ * shows up in the serial log.
+ *
+ * Allocation counts are exact when the ESP-IDF heap hooks are enabled
+ * (CONFIG_HEAP_USE_HOOKS). Without them only the net heap delta of each
+ * call is available. That delta is the change in free heap across the
+ * call, so allocations by other tasks in the meantime are included.
+ *
+ * Off unless PERF_MONITOR_ENABLED is defined in config.h.
+ *
+ * Usage:
+ *   void DjangoClient::buildJSONPayload() {
+ *       PERF_SCOPE(PERF_BUILD_JSON_PAYLOAD);
+ *       ...
+ *   }
+ *
+ * Probes that run per byte or per sample use PERF_SCOPE_FAST instead.
+ * It only reads micros() and the per-core counters and skips the
+ * free-heap queries, which take the heap locks.
+ */
+enum PerfProbeId : uint8_t {
+    PERF_BUILD_JSON_PAYLOAD = 0,
+    PERF_BUFFER_SAVE_DATA,
+    PERF_HANDLE_HTTP_REQUEST,
+    PERF_ZE40_PROCESS_BYTE,
+    PERF_SHARED_DATA_READ,
+    PERF_SHARED_DATA_WRITE,
+    PERF_ZPHS01B_PARSE_CHUNK,
+    PERF_ZPHS01B_FILTER_CHAIN,
+    PERF_BUFFER_STREAM,
+    PERF_HTTP_RESPONSE_PARSE,
+    PERF_UPLINK_COMPRESS,
+    PERF_BUILD_CBOR_PAYLOAD,
+    PERF_WEBSOCKET_PUSH,
+    PERF_HISTORY_QUERY,
+    PERF_ROLLING_STATS_ADD,
+    PERF_PROBE_COUNT
+};
+
+class PerfMonitor {
+public:
+    /**
+     * Clear all probe statistics
+     */
+    static void init();
+
+    /**
+     * Add one call to a probe
+     * @param id Probe to update
+     * @param elapsedUs Wall time of the call in microseconds
+     * @param allocs Number of heap allocations made during the call
+     * @param allocBytes Bytes requested from the heap during the call
+     * @param netHeapBytes Change in used heap across the call
+     */
+    static void record(PerfProbeId id, uint32_t elapsedUs, uint32_t allocs,
+                       uint32_t allocBytes, int32_t netHeapBytes);
+
+    /**
+     * Add one call without a net heap reading (PERF_SCOPE_FAST)
+     */
+    static void record(PerfProbeId id, uint32_t elapsedUs, uint32_t allocs,
+                       uint32_t allocBytes);
+
+    /**
+     * Print ns/op, allocations/op and bytes/op for every probe
+     * and flag probes that exceed their budget
+     */
+    static void report();
+
+    /**
+     * Allocation counters for the calling core
+     * Used by PerfScope to take before/after readings
+     */
+    static uint32_t allocCount();
+    static uint32_t allocBytes();
+
+private:
+    struct ProbeStats {
+        uint32_t calls;
+        uint64_t totalUs;
+        uint32_t maxUs;
+        uint64_t totalAllocs;
+        uint64_t totalAllocBytes;
+        int64_t totalNetHeap;
+        uint32_t netHeapCalls;      // Calls that measured totalNetHeap
+    };
+
+    static ProbeStats stats[PERF_PROBE_COUNT];
+};
+
+/**
+ * RAII helper that times the enclosing scope and records it on exit
+ */
+class PerfScope {
+public:
+    explicit PerfScope(PerfProbeId id);
+    ~PerfScope();
+
+private:
+    PerfProbeId probe;
+    uint32_t startUs;
+    uint32_t startAllocs;
+    uint32_t startAllocBytes;
+    size_t startFreeHeap;
+};
+
+/**
+ * PerfScope without the net heap reading, for per-byte and per-sample paths
+ */
+class PerfFastScope {
+public:
+    explicit PerfFastScope(PerfProbeId id);
+    ~PerfFastScope();
+
+private:
+    PerfProbeId probe;
+    uint32_t startUs;
+    uint32_t startAllocs;
+    uint32_t startAllocBytes;
+};
+
+#ifdef PERF_MONITOR_ENABLED
+#define PERF_SCOPE(id) PerfScope _perfScope(id)
+#define PERF_SCOPE_FAST(id) PerfFastScope _perfScope(id)
+#else
+#define PERF_SCOPE(id)
+#define PERF_SCOPE_FAST(id)
+#endif
+
+#endif
@@ -0,0 +1,255 @@
+#include "ring_log.h"
+#include "config.h"
+#include <esp_rom_crc.h>
+#include <stddef.h>
+
+static const uint16_t RECORD_MAGIC = 0xB10C;
+static const uint32_t SECTOR_SIZE = 4096;
+static const uint32_t RECORDS_PER_SECTOR = SECTOR_SIZE / RingLog::RECORD_SIZE;
+static const uint8_t LIVE = 0xFF;
+static const uint8_t CONSUMED = 0x00;
+
+static_assert(sizeof(RingLog::Record) == RingLog::RECORD_SIZE, "record layout must be 128 bytes");
+static_assert(SECTOR_SIZE % RingLog::RECORD_SIZE == 0, "records must not straddle sectors");
+
+static uint32_t recordCrc(const RingLog::Record* r) {
+    return esp_rom_crc32_le(0, (const uint8_t*)r, offsetof(RingLog::Record, crc));
+}
+
+bool RingLog::begin(const char* label) {
+    partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, label);
+    if (partition == nullptr) {
+        DEBUG_PRINTF("✗ Ring log: no '%s' partition (flash with main/partitions.csv)\n", label);
+        return false;
+    }
+    if (partition->size % SECTOR_SIZE != 0 || partition->size < 2 * SECTOR_SIZE) {
+        DEBUG_PRINTF("✗ Ring log: partition size %lu is not usable\n", (unsigned long)partition->size);
+        partition = nullptr;
+        return false;
+    }
+
+    const void* mapped = nullptr;
+    esp_err_t err = esp_partition_mmap(partition, 0, partition->size,
+                                       ESP_PARTITION_MMAP_DATA, &mapped, &mapHandle);
+    if (err != ESP_OK) {
+        DEBUG_PRINTF("✗ Ring log: mmap failed (%s)\n", esp_err_to_name(err));
+        partition = nullptr;
+        return false;
+    }
+
+    base = (const Record*)mapped;
+    slots = partition->size / RECORD_SIZE;
+    scan();
+    return true;
+}
+
+size_t RingLog::capacityRecords() const {
+    // One sector stays erased ahead of the write head
+    return slots - RECORDS_PER_SECTOR;
+}
+
+const RingLog::Record* RingLog::record(uint32_t seq) const {
+    return base + (seq % slots);
+}
+
+bool RingLog::isValid(const Record* r, uint32_t seq) const {
+    return r->magic == RECORD_MAGIC && r->sequence == seq && r->crc == recordCrc(r);
+}
+
+bool RingLog::isBlank(const Record* r) const {
+    const uint32_t* words = (const uint32_t*)r;
+    for (size_t i = 0; i < RECORD_SIZE / sizeof(uint32_t); i++) {
+        if (words[i] != 0xFFFFFFFF) return false;
+    }
+    return true;
+}
+
+void RingLog::scan() {
+    bool found = false;
+    bool anyLive = false;
+    uint32_t maxSeq = 0;
+    uint32_t minLive = 0;
+
+    for (uint32_t slot = 0; slot < slots; slot++) {
+        const Record* r = base + slot;
+        if (r->magic != RECORD_MAGIC || r->sequence % slots != slot) continue;
+        if (!isValid(r, r->sequence)) continue;
+
+        if (!found || r->sequence > maxSeq) maxSeq = r->sequence;
+        found = true;
+
+        if (r->consumed == LIVE && (!anyLive || r->sequence < minLive)) {
+            minLive = r->sequence;
+            anyLive = true;
+        }
+    }
+
+    writeSeq = found ? maxSeq + 1 : 0;
+    readSeq = anyLive ? minLive : writeSeq;
+
+    // A torn write can leave the rest of the head sector dirty; resume
+    // at the next sector, which is erased before its first record
+    for (uint32_t seq = writeSeq; seq % RECORDS_PER_SECTOR != 0; seq++) {
+        if (!isBlank(record(seq))) {
+            writeSeq = seq - (seq % RECORDS_PER_SECTOR) + RECORDS_PER_SECTOR;
+            break;
+        }
+    }
+
+    if (writeSeq - readSeq > capacityRecords()) {
+        droppedRecords += (writeSeq - readSeq) - capacityRecords();
+        readSeq = writeSeq - capacityRecords();
+    }
+
+    liveEntries = 0;
+    uint32_t seq = readSeq;
+    while (nextEntry(seq) != nullptr) liveEntries++;
+}
+
+bool RingLog::writeRecord(const Record& r) {
+    uint32_t slot = r.sequence % slots;
+
+    if (slot % RECORDS_PER_SECTOR == 0) {
+        if (esp_partition_erase_range(partition, slot * RECORD_SIZE, SECTOR_SIZE) != ESP_OK) {
+            return false;
+        }
+        sectorErases++;
+    }
+
+    return esp_partition_write(partition, slot * RECORD_SIZE, &r, RECORD_SIZE) == ESP_OK;
+}
+
+bool RingLog::append(uint8_t type, uint8_t version, uint32_t timestamp,
+                     const uint8_t* data, size_t length) {
+    if (base == nullptr) return false;
+
+    size_t parts = (length == 0) ? 1 : (length + BODY_SIZE - 1) / BODY_SIZE;
+    if (parts > 255 || usedRecords() + parts > capacityRecords()) {
+        fullRejects++;
+        return false;
+    }
+
+    Record r;
+    for (size_t part = 0; part < parts; part++) {
+        size_t offset = part * BODY_SIZE;
+        size_t chunk = (length - offset < BODY_SIZE) ? length - offset : BODY_SIZE;
+
+        memset(&r, 0xFF, sizeof(r));
+        r.magic = RECORD_MAGIC;
+        r.type = type;
+        r.version = version;
+        r.part = (uint8_t)part;
+        r.parts = (uint8_t)parts;
+        r.length = (uint8_t)chunk;
+        r.sequence = writeSeq;
+        r.timestamp = timestamp;
+        memcpy(r.body, data + offset, chunk);
+        r.crc = recordCrc(&r);
+
+        // A failed slot is left behind as garbage that readers skip
+        bool written = writeRecord(r);
+        writeSeq++;
+        if (!written) {
+            writeErrors++;
+            return false;
+        }
+    }
+
+    liveEntries++;
+    appends++;
+    return true;
+}
+
+const RingLog::Record* RingLog::nextEntry(uint32_t& seq) const {
+    if (base == nullptr) return nullptr;
+
+    while (seq < writeSeq) {
+        const Record* head = record(seq);
+        if (!isValid(head, seq) || head->part != 0 || head->parts == 0 ||
+            head->parts > writeSeq - seq) {
+            seq++;
+            continue;
+        }
+
+        uint8_t part = 1;
+        while (part < head->parts) {
+            const Record* r = record(seq + part);
+            if (!isValid(r, seq + part) || r->part != part) break;
+            part++;
+        }
+        if (part < head->parts) {
+            seq++;
+            continue;
+        }
+
+        seq += head->parts;
+        return head;
+    }
+    return nullptr;
+}
+
+bool RingLog::markConsumed(uint32_t seq) {
+    uint32_t offset = (seq % slots) * RECORD_SIZE + offsetof(Record, consumed);
+    return esp_partition_write(partition, offset, &CONSUMED, 1) == ESP_OK;
+}
+
+size_t RingLog::consume(size_t count) {
+    size_t consumed = 0;
+
+    while (consumed < count && readSeq < writeSeq) {
+        uint32_t seq = readSeq;
+        const Record* head = nextEntry(seq);
+        uint32_t entryStart = head ? seq - head->parts : seq;
+
+        // Garbage in front of the entry is dropped with it
+        droppedRecords += entryStart - readSeq;
+
+        for (uint32_t s = entryStart; s < seq; s++) {
+            if (!markConsumed(s)) writeErrors++;
+        }
+        readSeq = seq;
+
+        if (head == nullptr) break;
+        consumed++;
+        liveEntries--;
+    }
+    return consumed;
+}
+
+bool RingLog::clear() {
+    if (base == nullptr) return false;
+
+    if (esp_partition_erase_range(partition, 0, partition->size) != ESP_OK) {
+        writeErrors++;
+        return false;
+    }
+    sectorErases += slots / RECORDS_PER_SECTOR;
+    readSeq = 0;
+    writeSeq = 0;
+    liveEntries = 0;
+    return true;
+}
+
+void RingLog::report() const {
+    DEBUG_PRINTLN("┌─ Buffer log report ────────────────────────");
+    if (base == nullptr) {
+        DEBUG_PRINTLN("│ Partition not available");
+    } else {
+        DEBUG_PRINTF("│ '%s' %lu KB, %lu/%lu records used, %u entries\n",
+                     partition->label,
+                     (unsigned long)(partition->size / 1024),
+                     (unsigned long)usedRecords(),
+                     (unsigned long)capacityRecords(),
+                     (unsigned)liveEntries);
+        DEBUG_PRINTF("│ tail seq %lu, head seq %lu\n",
+                     (unsigned long)readSeq,
+                     (unsigned long)writeSeq);
+        DEBUG_PRINTF("│ %lu appends, %lu sector erases, %lu rejected (full), %lu write errors, %lu dropped records\n",
+                     (unsigned long)appends,
+                     (unsigned long)sectorErases,
+                     (unsigned long)fullRejects,
+                     (unsigned long)writeErrors,
+                     (unsigned long)droppedRecords);
+    }
+    DEBUG_PRINTLN("└────────────────────────────────────────────");
+}
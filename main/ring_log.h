@@ -0,0 +1,132 @@
+#ifndef RING_LOG_H
+#define RING_LOG_H
+
+#include <Arduino.h>
+#include <esp_partition.h>
+
+/**
+ * Ring Log
+ *
+ * Append-only log of fixed 128-byte records in a raw flash data
+ * partition, used as a circular buffer. Each record carries a CRC and
+ * a sequence number. An entry larger than one record body is split
+ * across consecutive records (parts).
+ *
+ * Both ends of the log are persisted in the records themselves, so no
+ * separate index is rewritten on each operation:
+ *   - Write head: the record after the highest valid sequence number.
+ *     A record is only valid in the slot its sequence number maps to.
+ *   - Read tail: the oldest record whose consumed byte is still 0xFF.
+ *     Consuming clears that byte in place, a 1 -> 0 flash write that
+ *     needs no erase.
+ *
+ * append() and consume() are O(1) per record. A sector is erased only
+ * when the write head enters it, and one sector is always kept free so
+ * that the erase never reaches unconsumed records. The partition is
+ * memory-mapped, so readers get pointers straight into flash (no copy).
+ * begin() scans the record headers once to recover both ends after a
+ * reboot or power loss. A torn write fails its CRC and is skipped.
+ *
+ * Usage:
+ *   RingLog log;
+ *   log.begin("buflog");
+ *   log.append(type, version, timestamp, bytes, length);
+ *   uint32_t seq = log.tail();
+ *   while (const RingLog::Record* head = log.nextEntry(seq)) { ... }
+ *   log.consume(1);
+ */
+class RingLog {
+public:
+    static const size_t RECORD_SIZE = 128;
+    static const size_t BODY_SIZE = 104;
+
+    struct Record {
+        uint16_t magic;
+        uint8_t type;           // Caller-defined entry type
+        uint8_t version;        // Caller-defined body layout version
+        uint8_t part;           // Index of this record within its entry
+        uint8_t parts;          // Records in the entry
+        uint8_t length;         // Body bytes used in this record
+        uint8_t reserved;
+        uint32_t sequence;
+        uint32_t timestamp;
+        uint8_t body[BODY_SIZE];
+        uint32_t crc;           // Over every byte before it
+        uint8_t consumed;       // 0xFF live, 0x00 consumed (not in CRC)
+        uint8_t padding[3];
+    };
+
+    /**
+     * Map the partition and recover head and tail from its contents
+     * @param label Data partition label from partitions.csv
+     * @return false if the partition is missing or cannot be mapped
+     */
+    bool begin(const char* label);
+
+    /**
+     * Append one entry, split over as many records as it needs
+     * @return false if the log is full or the flash write failed
+     */
+    bool append(uint8_t type, uint8_t version, uint32_t timestamp,
+                const uint8_t* data, size_t length);
+
+    /**
+     * Head record of the first complete entry at or after seq
+     * @param seq Cursor; advanced past the returned entry
+     * @return Mapped record, or nullptr once the write head is reached
+     */
+    const Record* nextEntry(uint32_t& seq) const;
+
+    /**
+     * Mapped record for a sequence number (parts follow their head)
+     */
+    const Record* record(uint32_t seq) const;
+
+    /**
+     * Mark the oldest entries consumed
+     * @return Entries consumed
+     */
+    size_t consume(size_t count);
+
+    /**
+     * Erase the whole partition
+     */
+    bool clear();
+
+    uint32_t tail() const { return readSeq; }
+    uint32_t head() const { return writeSeq; }
+    size_t entryCount() const { return liveEntries; }
+    size_t usedRecords() const { return writeSeq - readSeq; }
+    size_t capacityRecords() const;
+    bool isReady() const { return base != nullptr; }
+
+    /**
+     * Print geometry, fill level and error counters
+     */
+    void report() const;
+
+private:
+    bool isValid(const Record* r, uint32_t seq) const;
+    bool isBlank(const Record* r) const;
+    void scan();
+    bool writeRecord(const Record& r);
+    bool markConsumed(uint32_t seq);
+
+    const esp_partition_t* partition = nullptr;
+    esp_partition_mmap_handle_t mapHandle = 0;
+    const Record* base = nullptr;
+    uint32_t slots = 0;
+
+    uint32_t readSeq = 0;       // Oldest unconsumed record
+    uint32_t writeSeq = 0;      // Next record to write
+    size_t liveEntries = 0;
+
+    // Statistics
+    uint32_t appends = 0;
+    uint32_t sectorErases = 0;
+    uint32_t writeErrors = 0;
+    uint32_t droppedRecords = 0;    // Invalid or incomplete, skipped by the tail
+    uint32_t fullRejects = 0;
+};
+
+#endif
@@ -0,0 +1,126 @@
+#include "rolling_stats.h"
+#include "sensor_history.h"
+#include "perf_monitor.h"
+#include <math.h>
+
+RollingStats rollingStats;
+
+static const uint32_t WINDOW_SECONDS[] = ROLLING_WINDOWS_S;
+static const uint8_t WINDOW_COUNT = sizeof(WINDOW_SECONDS) / sizeof(WINDOW_SECONDS[0]);
+
+static_assert(WINDOW_COUNT <= RollingStats::MAX_WINDOWS, "too many ROLLING_WINDOWS_S");
+static_assert(ROLLING_BUCKETS >= 2, "ROLLING_BUCKETS must be at least 2");
+
+// Slice length of each window in ms
+static uint32_t sliceMs(uint8_t window) {
+    uint32_t ms = WINDOW_SECONDS[window] * 1000UL / ROLLING_BUCKETS;
+    return ms > 0 ? ms : 1;
+}
+
+bool RollingStats::init() {
+    if (buckets != nullptr) return true;
+
+    size_t bytes = (size_t)ROLLING_FIELD_COUNT * WINDOW_COUNT * ROLLING_BUCKETS * sizeof(Bucket);
+    bool psram = false;
+    buckets = static_cast<Bucket*>(allocateHistoryBuffer(bytes, psram));
+    if (buckets == nullptr) {
+        DEBUG_PRINTF("✗ Failed to allocate rolling statistics (%u bytes)\n", (unsigned)bytes);
+        return false;
+    }
+
+    DEBUG_PRINTF("✓ Rolling statistics: %u fields x %u windows x %u buckets (%u bytes, %s)\n",
+                 (unsigned)ROLLING_FIELD_COUNT, (unsigned)WINDOW_COUNT, (unsigned)ROLLING_BUCKETS,
+                 (unsigned)bytes, psram ? "PSRAM" : "internal RAM");
+    return true;
+}
+
+uint8_t RollingStats::windowCount() {
+    return WINDOW_COUNT;
+}
+
+uint32_t RollingStats::windowSeconds(uint8_t window) {
+    return window < WINDOW_COUNT ? WINDOW_SECONDS[window] : 0;
+}
+
+RollingStats::Bucket* RollingStats::bucketsFor(RollingField field, uint8_t window) const {
+    return buckets + ((size_t)field * WINDOW_COUNT + window) * ROLLING_BUCKETS;
+}
+
+void RollingStats::add(RollingField field, uint32_t now, float value) {
+    PERF_SCOPE_FAST(PERF_ROLLING_STATS_ADD);
+
+    if (buckets == nullptr || field >= ROLLING_FIELD_COUNT || isnan(value)) return;
+
+    portENTER_CRITICAL(&mux);
+    for (uint8_t window = 0; window < WINDOW_COUNT; window++) {
+        uint32_t slot = now / sliceMs(window);
+        Bucket& b = bucketsFor(field, window)[slot % ROLLING_BUCKETS];
+
+        // A slice left over from an earlier pass round the window starts afresh
+        if (b.slot != slot || b.count == 0) {
+            b.slot = slot;
+            b.count = 1;
+            b.mean = value;
+            b.m2 = 0;
+            b.min = value;
+            b.max = value;
+            continue;
+        }
+
+        // Welford
+        b.count++;
+        float delta = value - b.mean;
+        b.mean += delta / b.count;
+        b.m2 += delta * (value - b.mean);
+        if (value < b.min) b.min = value;
+        if (value > b.max) b.max = value;
+    }
+    portEXIT_CRITICAL(&mux);
+}
+
+bool RollingStats::get(RollingField field, uint8_t window, uint32_t now, RollingSummary& out) const {
+    out.count = 0;
+    if (buckets == nullptr || field >= ROLLING_FIELD_COUNT || window >= WINDOW_COUNT) return false;
+
+    uint32_t current = now / sliceMs(window);
+    const Bucket* slices = bucketsFor(field, window);
+    uint32_t count = 0;
+    float mean = 0;
+    float m2 = 0;
+    float min = 0;
+    float max = 0;
+
+    portENTER_CRITICAL(&mux);
+    for (uint8_t i = 0; i < ROLLING_BUCKETS; i++) {
+        const Bucket& b = slices[i];
+        // Only the current slice and the ROLLING_BUCKETS - 1 before it
+        if (b.count == 0 || current - b.slot >= ROLLING_BUCKETS) continue;
+
+        if (count == 0) {
+            count = b.count;
+            mean = b.mean;
+            m2 = b.m2;
+            min = b.min;
+            max = b.max;
+            continue;
+        }
+
+        // Chan et al.: combine two Welford partials
+        uint32_t total = count + b.count;
+        float delta = b.mean - mean;
+        mean += delta * b.count / total;
+        m2 += b.m2 + delta * delta * ((float)count * b.count / total);
+        count = total;
+        if (b.min < min) min = b.min;
+        if (b.max > max) max = b.max;
+    }
+    portEXIT_CRITICAL(&mux);
+
+    if (count == 0) return false;
+    out.count = count;
+    out.mean = mean;
+    out.min = min;
+    out.max = max;
+    out.stddev = count > 1 ? sqrtf(m2 / (count - 1)) : 0.0f;
+    return true;
+}
@@ -0,0 +1,175 @@
+#ifndef ROLLING_STATS_H
+#define ROLLING_STATS_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "sensor_schema.h"
+#include <freertos/FreeRTOS.h>
+
+/**
+ * RollingStats
+ *
+ * Per-field mean, min, max, standard deviation and sample count over
+ * the windows in ROLLING_WINDOWS_S (1 min, 5 min and 1 h by default),
+ * updated as each reading is taken rather than from the 10 s uplink
+ * snapshots.
+ *
+ * Each window is split into ROLLING_BUCKETS time slices. A reading
+ * goes into the current slice of every window with Welford's update,
+ * so add() is O(1) and never walks old samples. A slice is reset
+ * lazily when its time comes round again. Reading a window merges its
+ * slices (Chan's parallel formula), so the window slides in steps of
+ * one slice: a 60 s window with 12 buckets covers the last 55-60 s.
+ *
+ * Fields are those of sensor_schema.h, one ROLLING_<member> ID per
+ * SharedSensorData member. Producers feed only the fields they
+ * actually measured; fields never fed are left out of the output.
+ *
+ * Usage:
+ *   rollingStats.add(ROLLING_mr007_lel, now, lel_concentration);
+ *
+ *   RollingSummary s;
+ *   if (rollingStats.get(ROLLING_mr007_lel, 0, millis(), s)) { ... }
+ */
+
+enum RollingField : uint8_t {
+    #define ROLLING_FIELD_ID(name, member, decimals) ROLLING_##member,
+    #define ROLLING_GROUP_IDS(name, valid, ring, FIELDS) FIELDS(ROLLING_FIELD_ID)
+    SENSOR_SCHEMA_GROUPS(ROLLING_GROUP_IDS)
+    #undef ROLLING_GROUP_IDS
+    #undef ROLLING_FIELD_ID
+    ROLLING_FIELD_COUNT
+};
+
+struct RollingSummary {
+    uint32_t count;
+    float mean;
+    float min;
+    float max;
+    float stddev;       // Sample standard deviation; 0 below two samples
+};
+
+class RollingStats {
+public:
+    static const uint8_t MAX_WINDOWS = 4;   // Entries allowed in ROLLING_WINDOWS_S
+
+    /**
+     * Allocate the slices for every field and window
+     * Prefers PSRAM, like the history rings
+     * @return true if storage was allocated
+     */
+    bool init();
+
+    /**
+     * Add a reading to every window (producer task only)
+     * @param field Schema field the reading belongs to
+     * @param now millis() when it was taken
+     * @param value The reading
+     */
+    void add(RollingField field, uint32_t now, float value);
+
+    /**
+     * Summarise one window
+     * @param field Schema field
+     * @param window Index into ROLLING_WINDOWS_S
+     * @param now millis(); the window ends here
+     * @return false if the window holds no readings
+     */
+    bool get(RollingField field, uint8_t window, uint32_t now, RollingSummary& out) const;
+
+    static uint8_t windowCount();
+    static uint32_t windowSeconds(uint8_t window);
+
+private:
+    struct Bucket {
+        uint32_t slot;      // now / slice length when the slice was started
+        uint32_t count;
+        float mean;
+        float m2;           // Sum of squared differences from the mean
+        float min;
+        float max;
+    };
+
+    Bucket* bucketsFor(RollingField field, uint8_t window) const;
+
+    Bucket* buckets = nullptr;
+    mutable portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
+};
+
+extern RollingStats rollingStats;
+
+/**
+ * Write the statistics as a "stats" member of the currently open object
+ * JSON:  "stats": {"windows_s": [60, 300, 3600],
+ *                  "mr007": {"lel_concentration": [[mean, min, max, stddev, count], ...]}}
+ * CBOR:  the same shape under SCHEMA_KEY_STATS, with "windows_s" as key 0
+ *        and groups and fields numbered as in writeSensorGroups()
+ * One entry per window, null when the window is empty. Fields with no
+ * readings in any window and groups with no such fields are left out.
+ * @param w JsonWriter or CborWriter
+ * @param now millis(); every window ends here
+ */
+template <typename Writer>
+void writeRollingStats(Writer& w, uint32_t now) {
+    #define ROLLING_WRITE_FIELD(name, member, decimals)                              \
+        {                                                                            \
+            RollingSummary s[RollingStats::MAX_WINDOWS];                             \
+            bool any = false;                                                        \
+            for (uint8_t i = 0; i < windows; i++) {                                  \
+                s[i].count = 0;                                                      \
+                any |= rollingStats.get(ROLLING_##member, i, now, s[i]);             \
+            }                                                                        \
+            if (any) {                                                               \
+                if (!open) {                                                         \
+                    writeSchemaKey(w, groupName, group);                             \
+                    w.beginObject();                                                 \
+                    open = true;                                                     \
+                }                                                                    \
+                writeSchemaKey(w, name, field);                                      \
+                w.beginArray();                                                      \
+                for (uint8_t i = 0; i < windows; i++) {                              \
+                    if (s[i].count == 0) {                                           \
+                        w.null();                                                    \
+                        continue;                                                    \
+                    }                                                                \
+                    w.beginArray();                                                  \
+                    w.value(s[i].mean, (uint8_t)((decimals) + 1));                   \
+                    w.value(s[i].min, (uint8_t)(decimals));                          \
+                    w.value(s[i].max, (uint8_t)(decimals));                          \
+                    w.value(s[i].stddev, (uint8_t)((decimals) + 1));                 \
+                    w.value((unsigned long)s[i].count);                              \
+                    w.endArray();                                                    \
+                }                                                                    \
+                w.endArray();                                                        \
+            }                                                                        \
+            field++;                                                                 \
+        }
+
+    #define ROLLING_WRITE_GROUP(name, valid, ring, FIELDS)                           \
+        {                                                                            \
+            const char* groupName = name;                                            \
+            uint8_t field = 0;                                                       \
+            bool open = false;                                                       \
+            FIELDS(ROLLING_WRITE_FIELD)                                              \
+            if (open) w.endObject();                                                 \
+            group++;                                                                 \
+        }
+
+    uint8_t windows = RollingStats::windowCount();
+
+    writeSchemaKey(w, "stats", SCHEMA_KEY_STATS);
+    w.beginObject();
+    writeSchemaKey(w, "windows_s", 0);
+    w.beginArray();
+    for (uint8_t i = 0; i < windows; i++) w.value((unsigned long)RollingStats::windowSeconds(i));
+    w.endArray();
+
+    uint8_t group = SCHEMA_KEY_FIRST_GROUP;
+    SENSOR_SCHEMA_GROUPS(ROLLING_WRITE_GROUP)
+    w.endObject();
+
+    #undef ROLLING_WRITE_GROUP
+    #undef ROLLING_WRITE_FIELD
+}
+
+#endif
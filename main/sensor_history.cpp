@@ -0,0 +1,114 @@
+#include "sensor_history.h"
+#include "shared_data.h"
+#include "config.h"
+#include <esp_heap_caps.h>
+
+SensorHistory sensorHistory;
+
+void* allocateHistoryBuffer(size_t bytes, bool& inPsram) {
+    void* buffer = nullptr;
+    inPsram = false;
+
+    if (psramFound()) {
+        buffer = heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        inPsram = (buffer != nullptr);
+    }
+    if (buffer == nullptr) {
+        buffer = heap_caps_malloc(bytes, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    }
+    if (buffer != nullptr) {
+        memset(buffer, 0, bytes);
+    }
+    return buffer;
+}
+
+// Samples needed to cover the history span at a given publish interval
+static size_t capacityFor(unsigned long spanSeconds, unsigned long intervalMs) {
+    return (spanSeconds * 1000UL) / intervalMs + 1;
+}
+
+template <typename T>
+static void initRing(SampleRing<T>& ring, const char* name, size_t capacity) {
+    if (ring.init(capacity)) {
+        DEBUG_PRINTF("  %-8s %5u samples x %2u B (%s)\n", name,
+                     (unsigned)capacity, (unsigned)sizeof(T),
+                     ring.isInPsram() ? "PSRAM" : "internal RAM");
+    } else {
+        DEBUG_PRINTF("✗ Failed to allocate %s history (%u bytes)\n", name,
+                     (unsigned)(capacity * sizeof(T)));
+    }
+}
+
+void SensorHistory::init() {
+    unsigned long span = psramFound() ? HISTORY_SECONDS : HISTORY_SECONDS_NO_PSRAM;
+    DEBUG_PRINTF("Allocating sensor history (%lu s)...\n", span);
+
+    initRing(ze40, "ZE40", capacityFor(span, ZE40_UART_FRAME_INTERVAL));
+    initRing(ze40Dac, "ZE40 DAC", capacityFor(span, DAC_READ_INTERVAL));
+    initRing(zphs01b, "ZPHS01B", capacityFor(span, ZPHS01B_READ_INTERVAL));
+    initRing(mr007, "MR007", capacityFor(span, MR007_READ_INTERVAL));
+    initRing(me4so2, "ME4-SO2", capacityFor(span, ME4_SO2_READ_INTERVAL));
+
+    DEBUG_PRINTLN("✓ Sensor history initialized");
+}
+
+void SensorHistory::latestReading(SharedSensorData& out) const {
+    uint32_t newest = out.last_update;
+    auto note = [&newest](uint32_t timestamp) {
+        if ((int32_t)(timestamp - newest) > 0) newest = timestamp;
+    };
+
+    ZE40Sample ze40Latest;
+    out.ze40_uart_valid = ze40.latest(ze40Latest);
+    if (out.ze40_uart_valid) {
+        out.ze40_tvoc_ppb = ze40Latest.tvoc_ppb;
+        out.ze40_tvoc_ppm = ze40Latest.tvoc_ppb / 1000.0f;
+        note(ze40Latest.timestamp);
+    }
+
+    ZE40DacSample dacLatest;
+    out.ze40_analog_valid = ze40Dac.latest(dacLatest);
+    if (out.ze40_analog_valid) {
+        out.ze40_dac_voltage = dacLatest.dac_voltage;
+        out.ze40_dac_ppm = dacLatest.dac_ppm;
+        note(dacLatest.timestamp);
+    }
+
+    ZPHS01BSample air;
+    out.zphs01b_valid = zphs01b.latest(air);
+    if (out.zphs01b_valid) {
+        out.zphs01b_pm1 = air.pm1;
+        out.zphs01b_pm25 = air.pm25;
+        out.zphs01b_pm10 = air.pm10;
+        out.zphs01b_co2 = air.co2;
+        out.zphs01b_voc = air.voc;
+        out.zphs01b_ch2o = air.ch2o;
+        out.zphs01b_co = air.co;
+        out.zphs01b_o3 = air.o3;
+        out.zphs01b_no2 = air.no2;
+        out.zphs01b_temperature = air.temperature;
+        out.zphs01b_humidity = air.humidity;
+        note(air.timestamp);
+    }
+
+    MR007Sample lel;
+    out.mr007_valid = mr007.latest(lel);
+    if (out.mr007_valid) {
+        out.mr007_voltage = lel.voltage;
+        out.mr007_raw = lel.raw;
+        out.mr007_lel = lel.lel;
+        note(lel.timestamp);
+    }
+
+    ME4SO2Sample so2;
+    out.me4so2_valid = me4so2.latest(so2);
+    if (out.me4so2_valid) {
+        out.me4so2_voltage = so2.voltage;
+        out.me4so2_raw = so2.raw;
+        out.me4so2_current = so2.current;
+        out.me4so2_so2 = so2.so2;
+        note(so2.timestamp);
+    }
+
+    out.last_update = newest;
+}
@@ -0,0 +1,277 @@
+#ifndef SENSOR_HISTORY_H
+#define SENSOR_HISTORY_H
+
+#include <Arduino.h>
+#include <atomic>
+#include "config.h"
+
+/**
+ * Sensor History
+ *
+ * Fixed-capacity rings of timestamped samples, one per sensor. Each
+ * ring is a contiguous array of small POD samples allocated once at
+ * startup (in PSRAM when the board has it).
+ *
+ * Every ring has exactly one producer, the sensor task, so push() is a
+ * plain store followed by a release of the head index. Readers on any
+ * task visit samples in place without taking a lock or copying the
+ * range.
+ *
+ * Timestamps are millis() at publication. Ranges are compared with
+ * wrap-safe arithmetic, so history spans must stay well below 24 days.
+ *
+ * The rings are the only store of sensor readings. Each sample holds
+ * only values that were measured together, so the ZE40 UART and DAC
+ * readings have separate rings. snapshotData() builds the current
+ * reading from the newest sample in each ring.
+ */
+
+struct SharedSensorData;
+
+struct ZE40Sample {
+    uint32_t timestamp;
+    float tvoc_ppb;
+};
+
+struct ZE40DacSample {
+    uint32_t timestamp;
+    float dac_voltage;
+    float dac_ppm;
+};
+
+struct ZPHS01BSample {
+    uint32_t timestamp;
+    float pm1;
+    float pm25;
+    float pm10;
+    float co2;
+    float voc;
+    float ch2o;
+    float co;
+    float o3;
+    float no2;
+    float temperature;
+    float humidity;
+};
+
+struct MR007Sample {
+    uint32_t timestamp;
+    float voltage;
+    int32_t raw;
+    float lel;
+};
+
+struct ME4SO2Sample {
+    uint32_t timestamp;
+    float voltage;
+    int32_t raw;
+    float current;
+    float so2;
+};
+
+/**
+ * Allocate backing storage for a ring
+ * Prefers PSRAM, falls back to internal RAM
+ * @param bytes Size to allocate
+ * @param inPsram Set to true when the buffer landed in PSRAM
+ * @return Buffer, or nullptr if both heaps are exhausted
+ */
+void* allocateHistoryBuffer(size_t bytes, bool& inPsram);
+
+template <typename T>
+class SampleRing {
+public:
+    /**
+     * Allocate the ring
+     * @param requestedCapacity Number of samples to keep
+     * @return true if storage was allocated
+     */
+    bool init(size_t requestedCapacity) {
+        if (slots != nullptr || requestedCapacity < 2) return slots != nullptr;
+
+        bool psram = false;
+        slots = static_cast<T*>(allocateHistoryBuffer(requestedCapacity * sizeof(T), psram));
+        if (slots == nullptr) return false;
+
+        capacity = requestedCapacity;
+        inPsram = psram;
+        head.store(0, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Append a sample (producer task only)
+     * Overwrites the oldest sample once the ring is full
+     */
+    void push(const T& sample) {
+        if (slots == nullptr) return;
+        uint32_t h = head.load(std::memory_order_relaxed);
+        slots[h % capacity] = sample;
+        head.store(h + 1, std::memory_order_release);
+    }
+
+    /**
+     * Copy out the most recent sample
+     * @return false if the ring is empty
+     */
+    bool latest(T& out) const {
+        uint32_t h = head.load(std::memory_order_acquire);
+        if (slots == nullptr || h == 0) return false;
+        out = slots[(h - 1) % capacity];
+        return head.load(std::memory_order_acquire) - (h - 1) < capacity;
+    }
+
+    /**
+     * Timestamp of the most recent sample, 0 if empty
+     */
+    uint32_t latestTimestamp() const {
+        uint32_t h = head.load(std::memory_order_acquire);
+        if (slots == nullptr || h == 0) return 0;
+        return slots[(h - 1) % capacity].timestamp;
+    }
+
+    /**
+     * Age of the most recent sample in ms, -1 if empty
+     * @param now Current millis()
+     */
+    int32_t latestAgeMs(uint32_t now) const {
+        uint32_t h = head.load(std::memory_order_acquire);
+        if (slots == nullptr || h == 0) return -1;
+        return (int32_t)(now - slots[(h - 1) % capacity].timestamp);
+    }
+
+    /**
+     * Visit every sample with from <= timestamp <= to, oldest first
+     * The visitor gets a reference into the ring. If the producer laps
+     * the reader during the walk, iteration stops before the
+     * overwritten region.
+     * @param fromMs Start of range (millis)
+     * @param toMs End of range (millis)
+     * @param visit Callable taking const T&
+     * @return Number of samples visited
+     */
+    template <typename Visitor>
+    size_t forEachInRange(uint32_t fromMs, uint32_t toMs, Visitor visit) const {
+        if (slots == nullptr) return 0;
+
+        uint32_t h = head.load(std::memory_order_acquire);
+        uint32_t lo = lowerBound(h, fromMs);
+
+        size_t visited = 0;
+        for (uint32_t i = lo; i != h; i++) {
+            if (head.load(std::memory_order_acquire) - i >= capacity) break;
+
+            const T& sample = slots[i % capacity];
+            if ((int32_t)(sample.timestamp - toMs) > 0) break;
+
+            visit(sample);
+            visited++;
+        }
+        return visited;
+    }
+
+    /**
+     * Number of samples with from <= timestamp <= to (two binary searches)
+     */
+    size_t countInRange(uint32_t fromMs, uint32_t toMs) const {
+        if (slots == nullptr || (int32_t)(toMs - fromMs) < 0) return 0;
+        uint32_t h = head.load(std::memory_order_acquire);
+        return lowerBound(h, toMs + 1) - lowerBound(h, fromMs);
+    }
+
+    /**
+     * Copy out the oldest sample with from <= timestamp <= to
+     * @return false if there is none
+     */
+    bool firstInRange(uint32_t fromMs, uint32_t toMs, T& out) const {
+        if (slots == nullptr) return false;
+        uint32_t h = head.load(std::memory_order_acquire);
+        uint32_t i = lowerBound(h, fromMs);
+        return i != h && copyIfInRange(i, fromMs, toMs, out);
+    }
+
+    /**
+     * Copy out the newest sample with from <= timestamp <= to
+     * @return false if there is none
+     */
+    bool lastInRange(uint32_t fromMs, uint32_t toMs, T& out) const {
+        if (slots == nullptr) return false;
+        uint32_t h = head.load(std::memory_order_acquire);
+        uint32_t i = lowerBound(h, toMs + 1);
+        return i != oldest(h) && copyIfInRange(i - 1, fromMs, toMs, out);
+    }
+
+    /**
+     * Number of samples currently held
+     */
+    size_t size() const {
+        uint32_t h = head.load(std::memory_order_acquire);
+        return (h < capacity) ? h : capacity;
+    }
+
+    size_t getCapacity() const { return capacity; }
+    bool isInPsram() const { return inPsram; }
+
+private:
+    // Index of the oldest sample a reader may use; the slot the producer
+    // writes next is left out
+    uint32_t oldest(uint32_t h) const {
+        return h - ((h < capacity) ? h : capacity - 1);
+    }
+
+    // First index at or after the oldest whose timestamp is >= ms, or h;
+    // samples are in publication order
+    uint32_t lowerBound(uint32_t h, uint32_t ms) const {
+        uint32_t lo = oldest(h);
+        uint32_t hi = h;
+        while (lo < hi) {
+            uint32_t mid = lo + (hi - lo) / 2;
+            if ((int32_t)(slots[mid % capacity].timestamp - ms) < 0) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        return lo;
+    }
+
+    bool copyIfInRange(uint32_t i, uint32_t fromMs, uint32_t toMs, T& out) const {
+        out = slots[i % capacity];
+        if (head.load(std::memory_order_acquire) - i >= capacity) return false;
+        return (int32_t)(out.timestamp - fromMs) >= 0 && (int32_t)(out.timestamp - toMs) <= 0;
+    }
+
+    T* slots = nullptr;
+    size_t capacity = 0;
+    bool inPsram = false;
+    std::atomic<uint32_t> head{0};
+};
+
+class SensorHistory {
+public:
+    /**
+     * Allocate all rings
+     * Sized for HISTORY_SECONDS with PSRAM, HISTORY_SECONDS_NO_PSRAM without
+     */
+    void init();
+
+    /**
+     * Fill the sensor fields of a reading from the newest sample of each
+     * ring. A sensor with no sample yet is marked invalid. snapshotData()
+     * calls this under the seqlock, and the sensors push inside
+     * beginDataUpdate()/endDataUpdate(), so all rings are read as of the
+     * same point in time.
+     * @param out Reading to fill; network fields are left alone
+     */
+    void latestReading(SharedSensorData& out) const;
+
+    SampleRing<ZE40Sample> ze40;            // UART frames
+    SampleRing<ZE40DacSample> ze40Dac;      // DAC reads
+    SampleRing<ZPHS01BSample> zphs01b;
+    SampleRing<MR007Sample> mr007;
+    SampleRing<ME4SO2Sample> me4so2;
+};
+
+extern SensorHistory sensorHistory;
+
+#endif
@@ -0,0 +1,140 @@
+#include "sensor_scheduler.h"
+#include "config.h"
+
+SensorScheduler sensorScheduler;
+
+int SensorScheduler::addJob(const char* name, uint32_t periodMs, SchedulerCallback callback,
+                            uint32_t initialDelayMs) {
+    if (jobCount >= MAX_JOBS || callback == nullptr || periodMs == 0) {
+        DEBUG_PRINTF("✗ Scheduler: cannot add job %s\n", name);
+        return -1;
+    }
+
+    uint8_t id = jobCount;
+    Job& job = jobs[id];
+    memset(&job, 0, sizeof(Job));
+    job.name = name;
+    job.periodMs = periodMs;
+    job.nextRun = millis() + initialDelayMs;
+    job.callback = callback;
+
+    heap[jobCount++] = id;
+    siftUp(jobCount - 1);
+
+    DEBUG_PRINTF("  Scheduled %-14s every %lu ms\n", name, (unsigned long)periodMs);
+    return id;
+}
+
+// Wrap-safe deadline comparison between two jobs
+bool SensorScheduler::earlier(uint8_t a, uint8_t b) const {
+    return (int32_t)(jobs[a].nextRun - jobs[b].nextRun) < 0;
+}
+
+void SensorScheduler::siftUp(uint8_t pos) {
+    while (pos > 0) {
+        uint8_t parent = (pos - 1) / 2;
+        if (!earlier(heap[pos], heap[parent])) break;
+        uint8_t tmp = heap[pos];
+        heap[pos] = heap[parent];
+        heap[parent] = tmp;
+        pos = parent;
+    }
+}
+
+void SensorScheduler::siftDown(uint8_t pos) {
+    while (true) {
+        uint8_t left = 2 * pos + 1;
+        uint8_t right = left + 1;
+        uint8_t smallest = pos;
+
+        if (left < jobCount && earlier(heap[left], heap[smallest])) smallest = left;
+        if (right < jobCount && earlier(heap[right], heap[smallest])) smallest = right;
+        if (smallest == pos) break;
+
+        uint8_t tmp = heap[pos];
+        heap[pos] = heap[smallest];
+        heap[smallest] = tmp;
+        pos = smallest;
+    }
+}
+
+uint32_t SensorScheduler::msUntilNext(uint32_t now) const {
+    if (jobCount == 0) return 1000;
+    int32_t remaining = (int32_t)(jobs[heap[0]].nextRun - now);
+    return (remaining > 0) ? (uint32_t)remaining : 0;
+}
+
+uint32_t SensorScheduler::runDueJobs() {
+    if (ownerTask == nullptr) {
+        ownerTask = xTaskGetCurrentTaskHandle();
+    }
+
+    uint32_t now = millis();
+    while (jobCount > 0 && (int32_t)(now - jobs[heap[0]].nextRun) >= 0) {
+        uint8_t id = heap[0];
+        Job& job = jobs[id];
+
+        uint32_t lateness = now - job.nextRun;
+        if (lateness > job.maxJitterMs) job.maxJitterMs = lateness;
+        job.totalJitterMs += lateness;
+
+        job.callback();
+
+        uint32_t finished = millis();
+        uint32_t runTime = finished - now;
+        if (runTime > job.maxRunMs) job.maxRunMs = runTime;
+        job.runs++;
+
+        // Keep the phase of the original schedule; whole periods that
+        // have already passed are counted as overruns and skipped
+        job.nextRun += job.periodMs;
+        if ((int32_t)(finished - job.nextRun) >= 0) {
+            uint32_t missed = (finished - job.nextRun) / job.periodMs + 1;
+            job.overruns += missed;
+            job.nextRun += missed * job.periodMs;
+        }
+        siftDown(0);
+
+        now = finished;
+    }
+
+    return msUntilNext(now);
+}
+
+void SensorScheduler::waitForNextDeadline() {
+    uint32_t waitMs = msUntilNext(millis());
+    if (waitMs == 0) return;
+
+    TickType_t ticks = pdMS_TO_TICKS(waitMs);
+    if (ticks == 0) ticks = 1;
+    ulTaskNotifyTake(pdTRUE, ticks);
+}
+
+void SensorScheduler::wake() {
+    if (ownerTask != nullptr) {
+        xTaskNotifyGive(ownerTask);
+    }
+}
+
+void SensorScheduler::wakeFromISR(BaseType_t* higherPriorityTaskWoken) {
+    if (ownerTask != nullptr) {
+        vTaskNotifyGiveFromISR(ownerTask, higherPriorityTaskWoken);
+    }
+}
+
+void SensorScheduler::report() {
+    DEBUG_PRINTLN("┌─ Scheduler report ─────────────────────────");
+    for (uint8_t i = 0; i < jobCount; i++) {
+        const Job& job = jobs[i];
+        unsigned long avgJitter = job.runs ? (unsigned long)(job.totalJitterMs / job.runs) : 0;
+        DEBUG_PRINTF("│ %-14s period %6lu ms  runs %7lu  jitter avg %4lu / max %5lu ms  run max %5lu ms  overruns %lu\n",
+                     job.name,
+                     (unsigned long)job.periodMs,
+                     (unsigned long)job.runs,
+                     avgJitter,
+                     (unsigned long)job.maxJitterMs,
+                     (unsigned long)job.maxRunMs,
+                     (unsigned long)job.overruns);
+    }
+    DEBUG_PRINTLN("└────────────────────────────────────────────");
+}
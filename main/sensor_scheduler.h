@@ -0,0 +1,97 @@
+#ifndef SENSOR_SCHEDULER_H
+#define SENSOR_SCHEDULER_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "config.h"
+
+/**
+ * Sensor Scheduler
+ *
+ * Deadline-driven periodic job runner for the sensor task. Jobs are kept
+ * in a min-heap ordered by next deadline; the owning task runs whatever
+ * is due and then sleeps until the earliest remaining deadline (or until
+ * another task wakes it with wake()).
+ *
+ * Deadlines advance by exactly one period from the previous deadline,
+ * so sampling does not drift with execution time. Each job records how
+ * late it started (jitter), its longest run time and how many periods
+ * it missed outright (overruns).
+ *
+ * Usage:
+ *   sensorScheduler.addJob("MR007", MR007_READ_INTERVAL, readMR007);
+ *   while (true) {
+ *       sensorScheduler.runDueJobs();
+ *       sensorScheduler.waitForNextDeadline();
+ *   }
+ */
+typedef void (*SchedulerCallback)();
+
+class SensorScheduler {
+public:
+    static const uint8_t MAX_JOBS = 16;
+
+    /**
+     * Register a periodic job
+     * @param name Label used in the stats report (must stay valid)
+     * @param periodMs Period between deadlines
+     * @param callback Function to run
+     * @param initialDelayMs Delay before the first deadline
+     * @return Job id, or -1 if the table is full
+     */
+    int addJob(const char* name, uint32_t periodMs, SchedulerCallback callback,
+               uint32_t initialDelayMs = 0);
+
+    /**
+     * Run every job whose deadline has passed, earliest first
+     * @return Milliseconds until the next deadline
+     */
+    uint32_t runDueJobs();
+
+    /**
+     * Block the calling task until the next deadline or a wake()
+     * Must be called from the task that owns the scheduler
+     */
+    void waitForNextDeadline();
+
+    /**
+     * Wake the owning task early (e.g. new data is ready)
+     */
+    void wake();
+    void wakeFromISR(BaseType_t* higherPriorityTaskWoken);
+
+    /**
+     * Print per-job run count, jitter, run time and overruns
+     */
+    void report();
+
+private:
+    struct Job {
+        const char* name;
+        uint32_t periodMs;
+        uint32_t nextRun;
+        SchedulerCallback callback;
+
+        // Statistics
+        uint32_t runs;
+        uint32_t overruns;
+        uint32_t maxJitterMs;
+        uint64_t totalJitterMs;
+        uint32_t maxRunMs;
+    };
+
+    bool earlier(uint8_t a, uint8_t b) const;
+    void siftUp(uint8_t pos);
+    void siftDown(uint8_t pos);
+    uint32_t msUntilNext(uint32_t now) const;
+
+    Job jobs[MAX_JOBS];
+    uint8_t heap[MAX_JOBS];
+    uint8_t jobCount = 0;
+    TaskHandle_t ownerTask = nullptr;
+};
+
+extern SensorScheduler sensorScheduler;
+
+#endif
@@ -0,0 +1,276 @@
+#ifndef SENSOR_SCHEMA_H
+#define SENSOR_SCHEMA_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "shared_data.h"
+#include "sensor_history.h"
+#include "json_writer.h"
+#include "cbor_writer.h"
+#include <math.h>
+
+/**
+ * Sensor Schema
+ *
+ * The single definition of the sensor payload layout. The upload body,
+ * the buffered records and the web /data response are all generated
+ * from the tables below, so adding a field or a sensor means editing
+ * only this file.
+ *
+ * Each group is one JSON object:
+ *   GROUP(key, validity, history ring, field list)
+ * The group is written as null when its validity expression on the
+ * snapshot `d` is false.
+ *
+ * Each field is:
+ *   FIELD(key, SharedSensorData member, decimals)
+ * Decimals only apply to float members.
+ *
+ * The tables are X-macros. They expand into straight-line writer calls
+ * at compile time, with no lookup tables and no runtime reflection.
+ *
+ * Offline buffer records store the fields in table order as binary, so
+ * bump SENSOR_SCHEMA_VERSION whenever a field is added, removed,
+ * reordered or changes type.
+ *
+ * CBOR output uses integer keys instead of names (see SchemaKey).
+ * Groups and fields are numbered in table order, and every record
+ * carries SENSOR_SCHEMA_VERSION as its schema ID, so the server needs
+ * the same tables (sensors/sensor_schema.py) to restore the names.
+ */
+
+#define SENSOR_SCHEMA_VERSION 1
+
+#define SENSOR_SCHEMA_ZE40_FIELDS(FIELD)                      \
+    FIELD("tvoc_ppb",          ze40_tvoc_ppb,        0)       \
+    FIELD("tvoc_ppm",          ze40_tvoc_ppm,        3)       \
+    FIELD("dac_voltage",       ze40_dac_voltage,     2)       \
+    FIELD("dac_ppm",           ze40_dac_ppm,         3)       \
+    FIELD("uart_data_valid",   ze40_uart_valid,      0)       \
+    FIELD("analog_data_valid", ze40_analog_valid,    0)
+
+#define SENSOR_SCHEMA_ZPHS01B_FIELDS(FIELD)                   \
+    FIELD("pm1",               zphs01b_pm1,          0)       \
+    FIELD("pm25",              zphs01b_pm25,         0)       \
+    FIELD("pm10",              zphs01b_pm10,         0)       \
+    FIELD("co2",               zphs01b_co2,          0)       \
+    FIELD("voc",               zphs01b_voc,          0)       \
+    FIELD("ch2o",              zphs01b_ch2o,         0)       \
+    FIELD("co",                zphs01b_co,           1)       \
+    FIELD("o3",                zphs01b_o3,           2)       \
+    FIELD("no2",               zphs01b_no2,          3)       \
+    FIELD("temperature",       zphs01b_temperature,  1)       \
+    FIELD("humidity",          zphs01b_humidity,     0)
+
+#define SENSOR_SCHEMA_MR007_FIELDS(FIELD)                     \
+    FIELD("voltage",           mr007_voltage,        3)       \
+    FIELD("rawValue",          mr007_raw,            0)       \
+    FIELD("lel_concentration", mr007_lel,            1)
+
+#define SENSOR_SCHEMA_ME4SO2_FIELDS(FIELD)                    \
+    FIELD("voltage",           me4so2_voltage,       4)       \
+    FIELD("rawValue",          me4so2_raw,           0)       \
+    FIELD("current_ua",        me4so2_current,       2)       \
+    FIELD("so2_concentration", me4so2_so2,           2)
+
+#define SENSOR_SCHEMA_GROUPS(GROUP)                                               \
+    GROUP("ze40",        true,             ze40,    SENSOR_SCHEMA_ZE40_FIELDS)    \
+    GROUP("air_quality", d.zphs01b_valid,  zphs01b, SENSOR_SCHEMA_ZPHS01B_FIELDS) \
+    GROUP("mr007",       d.mr007_valid,    mr007,   SENSOR_SCHEMA_MR007_FIELDS)   \
+    GROUP("me4_so2",     d.me4so2_valid,   me4so2,  SENSOR_SCHEMA_ME4SO2_FIELDS)
+
+/**
+ * CBOR integer keys for schema SENSOR_SCHEMA_VERSION
+ * Group N of SENSOR_SCHEMA_GROUPS is SCHEMA_KEY_FIRST_GROUP + N, and
+ * field N of a group is key N inside that group's map. Keys below 24
+ * encode in a single byte.
+ */
+enum SchemaKey : uint8_t {
+    SCHEMA_KEY_SCHEMA = 0,          // Value: SENSOR_SCHEMA_VERSION
+    SCHEMA_KEY_TIMESTAMP = 1,
+    SCHEMA_KEY_AGE_S = 2,
+    SCHEMA_KEY_IP_ADDRESS = 3,
+    SCHEMA_KEY_NETWORK_MODE = 4,
+    SCHEMA_KEY_NETWORK_READY = 5,
+    SCHEMA_KEY_SEQUENCE = 6,        // WebSocket frames (web_server.cpp)
+    SCHEMA_KEY_FULL = 7,
+    SCHEMA_KEY_STATS = 8,           // Rolling statistics (rolling_stats.h)
+    SCHEMA_KEY_FIRST_GROUP = 16,
+    SCHEMA_KEY_SAMPLE_AGE_MS = 23   // Inside a group, after its fields
+};
+
+#define SCHEMA_COUNT_FIELD(name, member, decimals) + 1
+#define SCHEMA_CHECK_GROUP(name, valid, ring, FIELDS) \
+    static_assert(0 FIELDS(SCHEMA_COUNT_FIELD) < SCHEMA_KEY_SAMPLE_AGE_MS, "too many fields in group " name);
+SENSOR_SCHEMA_GROUPS(SCHEMA_CHECK_GROUP)
+#undef SCHEMA_CHECK_GROUP
+#undef SCHEMA_COUNT_FIELD
+
+// JSON is keyed by name, CBOR by number
+inline void writeSchemaKey(JsonWriter& w, const char* name, uint8_t) {
+    w.key(name);
+}
+
+inline void writeSchemaKey(CborWriter& w, const char*, uint8_t id) {
+    w.key(id);
+}
+
+// Only numbered keys need the schema ID to be read back
+inline void writeSchemaId(JsonWriter&) {}
+
+inline void writeSchemaId(CborWriter& w) {
+    w.member(SCHEMA_KEY_SCHEMA, (unsigned long)SENSOR_SCHEMA_VERSION);
+}
+
+template <typename Writer, typename T>
+inline void writeSchemaMember(Writer& w, const char* name, uint8_t id, T v) {
+    writeSchemaKey(w, name, id);
+    w.value(v);
+}
+
+// Value overloads pick the encoding from the member's type; decimals
+// is ignored for integers and booleans
+template <typename Writer>
+inline void writeSchemaField(Writer& w, const char* name, uint8_t id, float v, uint8_t decimals) {
+    writeSchemaKey(w, name, id);
+    w.value(v, decimals);
+}
+
+template <typename Writer>
+inline void writeSchemaField(Writer& w, const char* name, uint8_t id, int v, uint8_t) {
+    writeSchemaMember(w, name, id, v);
+}
+
+template <typename Writer>
+inline void writeSchemaField(Writer& w, const char* name, uint8_t id, bool v, uint8_t) {
+    writeSchemaMember(w, name, id, v);
+}
+
+// A float only counts as changed when its written value (at the field's
+// decimals) does
+inline bool schemaFieldChanged(float a, float b, uint8_t decimals) {
+    static const float SCALE[] = { 1.0f, 10.0f, 100.0f, 1000.0f, 10000.0f, 100000.0f, 1000000.0f };
+    if (isnan(a) || isnan(b)) return isnan(a) != isnan(b);
+    if (decimals >= sizeof(SCALE) / sizeof(SCALE[0])) return a != b;
+    return roundf(a * SCALE[decimals]) != roundf(b * SCALE[decimals]);
+}
+
+inline bool schemaFieldChanged(int a, int b, uint8_t) {
+    return a != b;
+}
+
+inline bool schemaFieldChanged(bool a, bool b, uint8_t) {
+    return a != b;
+}
+
+/**
+ * Decimals a field is written with, for values derived from it
+ * @param group Group key, e.g. "air_quality"
+ * @param field Field key within the group, e.g. "pm25"
+ * @return Decimals, or -1 if the schema has no such field
+ */
+inline int schemaFieldDecimals(const char* group, const char* field) {
+    #define SCHEMA_FIND_FIELD(name, member, decimals) \
+        if (strcmp(field, name) == 0) return decimals;
+
+    #define SCHEMA_FIND_GROUP(name, valid, ring, FIELDS) \
+        if (strcmp(group, name) == 0) {                  \
+            FIELDS(SCHEMA_FIND_FIELD)                    \
+            return -1;                                   \
+        }
+
+    SENSOR_SCHEMA_GROUPS(SCHEMA_FIND_GROUP)
+
+    #undef SCHEMA_FIND_GROUP
+    #undef SCHEMA_FIND_FIELD
+    return -1;
+}
+
+/**
+ * Write every sensor group as members of the currently open object
+ * @param w JsonWriter or CborWriter
+ * @param d Consistent snapshot from snapshotData()
+ * @param now millis() used for sample ages
+ * @param withSampleAges Add "sample_age_ms" from the history rings
+ */
+template <typename Writer>
+void writeSensorGroups(Writer& w, const SharedSensorData& d, uint32_t now, bool withSampleAges) {
+    #define SCHEMA_WRITE_FIELD(name, member, decimals) \
+        writeSchemaField(w, name, field++, d.member, decimals);
+
+    #define SCHEMA_WRITE_GROUP(name, valid, ring, FIELDS)                    \
+        writeSchemaKey(w, name, group++);                                    \
+        if (valid) {                                                         \
+            uint8_t field = 0;                                               \
+            w.beginObject();                                                 \
+            FIELDS(SCHEMA_WRITE_FIELD)                                       \
+            if (withSampleAges) {                                            \
+                writeSchemaMember(w, "sample_age_ms", SCHEMA_KEY_SAMPLE_AGE_MS, \
+                                  (long)sensorHistory.ring.latestAgeMs(now)); \
+            }                                                                \
+            w.endObject();                                                   \
+        } else {                                                             \
+            w.null();                                                        \
+        }
+
+    uint8_t group = SCHEMA_KEY_FIRST_GROUP;
+    SENSOR_SCHEMA_GROUPS(SCHEMA_WRITE_GROUP)
+
+    #undef SCHEMA_WRITE_GROUP
+    #undef SCHEMA_WRITE_FIELD
+}
+
+/**
+ * Write what changed from one snapshot to the next, as members of the
+ * currently open object, with the same keys as writeSensorGroups():
+ *   - a group that became invalid is null
+ *   - a group that became valid is written in full
+ *   - otherwise only fields whose written value differs are included,
+ *     and a group with none is left out
+ * Applying the result to the previous reading gives the current one.
+ * @return Number of groups written
+ */
+template <typename Writer>
+uint8_t writeSensorDelta(Writer& w, const SharedSensorData& d, const SharedSensorData& prev) {
+    #define SCHEMA_DELTA_FIELD(name, member, decimals)                           \
+        if (!wasValid || schemaFieldChanged(d.member, prev.member, decimals)) {  \
+            if (!open) {                                                         \
+                writeSchemaKey(w, groupName, group);                             \
+                w.beginObject();                                                 \
+                open = true;                                                     \
+            }                                                                    \
+            writeSchemaField(w, name, field, d.member, decimals);                \
+        }                                                                        \
+        field++;
+
+    #define SCHEMA_DELTA_GROUP(name, valid, ring, FIELDS)                        \
+        {                                                                        \
+            auto isValid = [](const SharedSensorData& d) { (void)d; return (bool)(valid); }; \
+            const char* groupName = name;                                        \
+            bool wasValid = isValid(prev);                                       \
+            if (isValid(d)) {                                                    \
+                uint8_t field = 0;                                               \
+                bool open = false;                                               \
+                FIELDS(SCHEMA_DELTA_FIELD)                                       \
+                if (open) {                                                      \
+                    w.endObject();                                               \
+                    written++;                                                   \
+                }                                                                \
+            } else if (wasValid) {                                               \
+                writeSchemaKey(w, groupName, group);                             \
+                w.null();                                                        \
+                written++;                                                       \
+            }                                                                    \
+            group++;                                                             \
+        }
+
+    uint8_t group = SCHEMA_KEY_FIRST_GROUP;
+    uint8_t written = 0;
+    SENSOR_SCHEMA_GROUPS(SCHEMA_DELTA_GROUP)
+
+    #undef SCHEMA_DELTA_GROUP
+    #undef SCHEMA_DELTA_FIELD
+    return written;
+}
+
+#endif
@@ -1,16 +1,27 @@
 #include "shared_data.h"
+#include "sensor_history.h"
+#include "perf_monitor.h"
 #include <Arduino.h>
+#include <atomic>
 
 SharedSensorData sharedData;
-SemaphoreHandle_t dataMutex = NULL;
 bool dataInitialized = false;
 
 #ifdef DJANGO_ENABLED
 DjangoClient djangoClient;
 #endif
 
-// Static storage for mutex to prevent heap issues
-static StaticSemaphore_t mutexBuffer;
+// Sequence counter: odd while a writer is updating sharedData or
+// pushing to the history rings
+static std::atomic<uint32_t> dataSeq(0);
+
+// Serializes writers (sensor task and network setup on the other core).
+// Held only for the duration of the stores.
+static portMUX_TYPE dataWriteMux = portMUX_INITIALIZER_UNLOCKED;
+
+#ifdef PERF_MONITOR_ENABLED
+static uint32_t writeStartUs = 0;
+#endif
 
 void initSharedData() {
     if (dataInitialized) return;
@@ -18,56 +29,69 @@ void initSharedData() {
     memset(&sharedData, 0, sizeof(SharedSensorData));
     strcpy(sharedData.ip_address, "0.0.0.0");
     sharedData.last_update = millis();
+    dataSeq.store(0, std::memory_order_release);
 
-    if (dataMutex == NULL) {
-        dataMutex = xSemaphoreCreateMutexStatic(&mutexBuffer);
-        if (dataMutex != NULL) {
-            dataInitialized = true;
-            DEBUG_PRINTLN("✓ Shared data initialized");
-            vTaskDelay(pdMS_TO_TICKS(100));
-        } else {
-            DEBUG_PRINTLN("✗ ERROR: Failed to create data mutex");
-        }
-    }
+    dataInitialized = true;
+    DEBUG_PRINTLN("✓ Shared data initialized");
 }
 
-bool lockData(int timeout_ms) {
-    if (!dataInitialized || dataMutex == NULL) {
-        DEBUG_PRINTLN("ERROR: Mutex not initialized in lockData");
-        return false;
-    }
-    
-    // Prevent ISR context access
-    if (xPortInIsrContext()) {
-        DEBUG_PRINTLN("ERROR: Cannot lock mutex from ISR context");
+void beginDataUpdate() {
+    portENTER_CRITICAL_SAFE(&dataWriteMux);
+
+    #ifdef PERF_MONITOR_ENABLED
+    writeStartUs = micros();
+    #endif
+
+    uint32_t seq = dataSeq.load(std::memory_order_relaxed);
+    dataSeq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+void endDataUpdate() {
+    uint32_t seq = dataSeq.load(std::memory_order_relaxed);
+    dataSeq.store(seq + 1, std::memory_order_release);
+
+    #ifdef PERF_MONITOR_ENABLED
+    uint32_t elapsed = micros() - writeStartUs;
+    #endif
+
+    portEXIT_CRITICAL_SAFE(&dataWriteMux);
+
+    #ifdef PERF_MONITOR_ENABLED
+    PerfMonitor::record(PERF_SHARED_DATA_WRITE, elapsed, 0, 0);
+    #endif
+}
+
+bool snapshotData(SharedSensorData& out) {
+    if (!dataInitialized) {
+        DEBUG_PRINTLN("ERROR: Shared data not initialized in snapshotData");
         return false;
     }
-    
-    TickType_t timeout = pdMS_TO_TICKS(timeout_ms);
-    BaseType_t result = xSemaphoreTake(dataMutex, timeout);
-    
-    if (result != pdTRUE) {
-        DEBUG_PRINTLN("WARNING: Failed to acquire mutex lock");
-    }
-    
-    return (result == pdTRUE);
+
+    PERF_SCOPE_FAST(PERF_SHARED_DATA_READ);
+
+    uint32_t start;
+    do {
+        // A writer holds the sequence odd for a few microseconds at most
+        start = dataSeq.load(std::memory_order_acquire);
+        while (start & 1) {
+            start = dataSeq.load(std::memory_order_acquire);
+        }
+
+        // Network status from sharedData, readings from the rings
+        memcpy(&out, &sharedData, sizeof(SharedSensorData));
+        sensorHistory.latestReading(out);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+    } while (dataSeq.load(std::memory_order_relaxed) != start);
+
+    return true;
 }
 
-void unlockData() {
-    if (!dataInitialized || dataMutex == NULL) {
-        DEBUG_PRINTLN("ERROR: Mutex not initialized in unlockData");
-        return;
-    }
-    
-    // Prevent ISR context access
-    if (xPortInIsrContext()) {
-        DEBUG_PRINTLN("ERROR: Cannot unlock mutex from ISR context");
-        return;
-    }
-    
-    xSemaphoreGive(dataMutex);
+uint32_t dataSequence() {
+    return dataSeq.load(std::memory_order_acquire);
 }
 
 bool isDataReady() {
     return dataInitialized;
-}
\ No newline at end of file
+}
@@ -4,12 +4,13 @@
 #include <Arduino.h>
 #include "config.h"
 #include <freertos/FreeRTOS.h>
-#include <freertos/semphr.h>
 
 // Forward declarations
 class DjangoClient;
 
-// Unified sensor data structure
+// One complete reading. sharedData itself only holds the network status:
+// the sensor fields are filled in by snapshotData() from the newest
+// samples in the history rings (sensor_history.h).
 struct SharedSensorData {
     // ZE40 Sensor
     float ze40_tvoc_ppb = 0.0;
@@ -54,17 +55,23 @@ struct SharedSensorData {
 };
 
 extern SharedSensorData sharedData;
-extern SemaphoreHandle_t dataMutex;
 
 #ifdef DJANGO_ENABLED
 #include "django_client.h"
 extern DjangoClient djangoClient;
 #endif
 
-// Thread-safe data access functions
+// Lock-free data access (seqlock)
+// Writers wrap their stores to sharedData, and sensors their history
+// ring pushes, in beginDataUpdate()/endDataUpdate(); the update is a
+// handful of stores, so writers never wait on a reader.
+// Readers take a consistent reading with snapshotData() and retry only
+// if a writer was active during the copy.
 void initSharedData();
-bool lockData(int timeout_ms = 5000);
-void unlockData();
+void beginDataUpdate();
+void endDataUpdate();
+bool snapshotData(SharedSensorData& out);
+uint32_t dataSequence();
 bool isDataReady();
 
 #endif
\ No newline at end of file
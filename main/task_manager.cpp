@@ -6,8 +6,16 @@
 #include "web_server.h"
 #include "network_manager.h"
 #include "django_client.h"
+#include "dns_resolver.h"
+#include "uplink_queue.h"
 #include "config.h"
 #include "shared_data.h"
+#include "perf_monitor.h"
+#include "sensor_history.h"
+#include "rolling_stats.h"
+#include "sensor_scheduler.h"
+#include "adc_sampler.h"
+#include "buffer_manager.h"
 #include <Arduino.h>
 
 #ifdef MDNS_ENABLED
@@ -47,6 +55,19 @@ void TaskManager::createTasks() {
         1
     );
     DEBUG_PRINTLN("✓ Sensor task created on Core 1");
+    
+    #ifdef DJANGO_ENABLED
+    xTaskCreatePinnedToCore(
+        uplinkTask,
+        "Uplink_Task",
+        UPLINK_TASK_STACK_SIZE,
+        NULL,
+        UPLINK_TASK_PRIORITY,
+        NULL,
+        0
+    );
+    DEBUG_PRINTLN("✓ Uplink task created on Core 0");
+    #endif
 }
 
 #ifdef ETHERNET_ENABLED
@@ -72,15 +93,14 @@ void TaskManager::ethernetTask(void *pvParameters) {
         
         vTaskDelay(100 / portTICK_PERIOD_MS);
         
-        if (lockData(2000)) {
-            String ip = networkManager.getIPAddress();
-            strncpy(sharedData.ip_address, ip.c_str(), sizeof(sharedData.ip_address)-1);
-            sharedData.network_ready = true;
-            sharedData.last_update = millis();
-            unlockData();
-            DEBUG_PRINT("✓ IP address: ");
-            DEBUG_PRINTLN(sharedData.ip_address);
-        }
+        String ip = networkManager.getIPAddress();
+        beginDataUpdate();
+        strncpy(sharedData.ip_address, ip.c_str(), sizeof(sharedData.ip_address)-1);
+        sharedData.network_ready = true;
+        sharedData.last_update = millis();
+        endDataUpdate();
+        DEBUG_PRINT("✓ IP address: ");
+        DEBUG_PRINTLN(ip);
         
         DEBUG_PRINTLN("Starting web server...");
         webServer.init();
@@ -89,7 +109,7 @@ void TaskManager::ethernetTask(void *pvParameters) {
         
         unsigned long lastMaintain = 0;
         while (true) {
-            webServer.handleEthernetClient();
+            bool busy = webServer.handleEthernetClient();
             
             #ifdef ETHERNET_ENABLED
             if (millis() - lastMaintain > 1000) {
@@ -98,7 +118,8 @@ void TaskManager::ethernetTask(void *pvParameters) {
             }
             #endif
             
-            vTaskDelay(10 / portTICK_PERIOD_MS);
+            // Open connections are stepped every tick, idle listening every 10 ms
+            vTaskDelay(busy ? 1 : 10 / portTICK_PERIOD_MS);
         }
     } else {
         DEBUG_PRINTLN("✗ Ethernet initialization failed");
@@ -108,6 +129,32 @@ void TaskManager::ethernetTask(void *pvParameters) {
 }
 #endif
 
+#ifdef DJANGO_ENABLED
+void TaskManager::uplinkTask(void *pvParameters) {
+    DEBUG_PRINTLN("→ Uplink task started on Core 0");
+    
+    // Samples wake the task; otherwise it wakes to replay the backlog
+    uplinkQueue.setConsumer(xTaskGetCurrentTaskHandle());
+    unsigned long lastDrain = millis();
+    
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(BACKLOG_DRAIN_INTERVAL));
+        
+        UplinkSample sample;
+        while (uplinkQueue.pop(sample)) {
+            djangoClient.sendSensorData(sample.data, sample.capturedAt);
+        }
+        
+        // Bounds the replay rate to BACKLOG_BATCHES_PER_DRAIN batches of
+        // BACKLOG_BATCH_SIZE entries per BACKLOG_DRAIN_INTERVAL
+        if (millis() - lastDrain >= BACKLOG_DRAIN_INTERVAL) {
+            djangoClient.drainBacklog();
+            lastDrain = millis();
+        }
+    }
+}
+#endif
+
 void TaskManager::sensorTask(void *pvParameters) {
     DEBUG_PRINTLN("→ Sensor task started on Core 1");
     
@@ -121,31 +168,29 @@ void TaskManager::sensorTask(void *pvParameters) {
     }
     #endif
     
-    unsigned long lastReadings[4] = {0};
-    bool buttonPressed = false;
+    scheduleJobs();
     
     while (true) {
-        unsigned long currentTime = millis();
+        sensorScheduler.runDueJobs();
         
-        readSensors(currentTime);
-        
-        #ifdef BUTTON_LED_ENABLED
-        handleButtonAndRelay(currentTime, buttonPressed);
-        #endif
-        
-        #ifdef ETHERNET_ENABLED
-        if (!networkManager.isEthernetActive()) {
-            webServer.handleWiFiClient();
-        }
-        #endif
+        // UART receive callbacks wake the task as soon as a frame is
+        // queued, so frames are published here rather than on a poll
+        publishUartFrames();
         
-        vTaskDelay(50 / portTICK_PERIOD_MS);
+        sensorScheduler.waitForNextDeadline();
     }
 }
 
 void TaskManager::initSensors() {
     DEBUG_PRINTLN("Initializing sensors...");
     
+    sensorHistory.init();
+    #ifdef ROLLING_STATS_ENABLED
+    rollingStats.init();
+    #endif
+    adcSampler.init();
+    BufferManager::init();
+    
     #ifdef ZE40_SENSOR_ENABLED
     ze40Sensor.init();
     #endif
@@ -193,83 +238,160 @@ void TaskManager::handleNetworkFallback() {
     }
     
     // Update IP in shared data
-    if (lockData()) {
-        String ip = networkManager.getIPAddress();
-        strncpy(sharedData.ip_address, ip.c_str(), sizeof(sharedData.ip_address)-1);
-        sharedData.network_ready = true;
-        sharedData.last_update = millis();
-        unlockData();
-    }
+    String ip = networkManager.getIPAddress();
+    beginDataUpdate();
+    strncpy(sharedData.ip_address, ip.c_str(), sizeof(sharedData.ip_address)-1);
+    sharedData.network_ready = true;
+    sharedData.last_update = millis();
+    endDataUpdate();
     
     webServer.init();
     #endif
 }
 
-void TaskManager::readSensors(unsigned long currentTime) {
+void TaskManager::scheduleJobs() {
+    DEBUG_PRINTLN("Scheduling sensor jobs...");
+    
+    sensorScheduler.addJob("ADC drain", ADC_DRAIN_INTERVAL, drainAdc);
+    
     #ifdef ZE40_SENSOR_ENABLED
-    ze40Sensor.processData();
+    sensorScheduler.addJob("ZE40 link", SENSOR_POLL_INTERVAL, pollZE40);
+    sensorScheduler.addJob("ZE40 DAC", DAC_READ_INTERVAL, readZE40Analog);
+    sensorScheduler.addJob("ZE40 request", ZE40_REQUEST_INTERVAL, requestZE40);
+    #endif
     
-    // Read ZE40 analog data periodically
-    static unsigned long lastZE40Analog = 0;
-    if (currentTime - lastZE40Analog >= DAC_READ_INTERVAL) {
-        float voltage = ze40Sensor.readDACVoltage();
-        float ppm = ze40Sensor.readDACPPM(voltage);
-        
-        if (lockData()) {
-            sharedData.ze40_dac_voltage = voltage;
-            sharedData.ze40_dac_ppm = ppm;
-            sharedData.ze40_analog_valid = true;
-            sharedData.last_update = currentTime;
-            unlockData();
-        }
-        lastZE40Analog = currentTime;
-    }
+    #ifdef ZPHS01B_SENSOR_ENABLED
+    sensorScheduler.addJob("ZPHS01B link", SENSOR_POLL_INTERVAL, pollZPHS01B);
+    sensorScheduler.addJob("ZPHS01B req", ZPHS01B_READ_INTERVAL, requestZPHS01B);
+    #endif
     
-    // Request ZE40 UART data periodically
-    static unsigned long lastZE40Request = 0;
-    if (ze40Sensor.isPreheatComplete() && (currentTime - lastZE40Request >= ZE40_REQUEST_INTERVAL)) {
-        ze40Sensor.requestReading();
-        lastZE40Request = currentTime;
-    }
+    #ifdef MR007_SENSOR_ENABLED
+    sensorScheduler.addJob("MR007", MR007_READ_INTERVAL, readMR007);
+    #endif
+    
+    #ifdef ME4_SO2_SENSOR_ENABLED
+    sensorScheduler.addJob("ME4-SO2", ME4_SO2_READ_INTERVAL, readME4SO2);
+    #endif
+    
+    sensorScheduler.addJob("I/O", SENSOR_POLL_INTERVAL, serviceIO);
+    
+    #ifdef DJANGO_ENABLED
+    sensorScheduler.addJob("Django queue", DJANGO_SEND_INTERVAL, queueDjangoSample);
+    #endif
+    
+    sensorScheduler.addJob("Reports", SCHEDULER_REPORT_INTERVAL, printReports, SCHEDULER_REPORT_INTERVAL);
+}
+
+void TaskManager::drainAdc() {
+    adcSampler.drain();
+}
+
+void TaskManager::publishUartFrames() {
+    #ifdef ZE40_SENSOR_ENABLED
+    ze40Sensor.processData();
     #endif
     
     #ifdef ZPHS01B_SENSOR_ENABLED
     zphs01bSensor.processData();
-    
-    static unsigned long lastZPHS01BRequest = 0;
-    if (currentTime - lastZPHS01BRequest >= ZPHS01B_READ_INTERVAL) {
-        zphs01bSensor.requestReading();
-        lastZPHS01BRequest = currentTime;
+    #endif
+}
+
+#ifdef ZE40_SENSOR_ENABLED
+void TaskManager::pollZE40() {
+    ze40Sensor.processData();
+}
+
+void TaskManager::readZE40Analog() {
+    ze40Sensor.updateAnalog();
+}
+
+void TaskManager::requestZE40() {
+    if (ze40Sensor.isPreheatComplete()) {
+        ze40Sensor.requestReading();
     }
+}
+#endif
+
+#ifdef ZPHS01B_SENSOR_ENABLED
+void TaskManager::pollZPHS01B() {
+    zphs01bSensor.processData();
+}
+
+void TaskManager::requestZPHS01B() {
+    zphs01bSensor.requestReading();
+}
+#endif
+
+#ifdef MR007_SENSOR_ENABLED
+void TaskManager::readMR007() {
+    mr007Sensor.readSensor();
+}
+#endif
+
+#ifdef ME4_SO2_SENSOR_ENABLED
+void TaskManager::readME4SO2() {
+    me4so2Sensor.readSensor();
+}
+#endif
+
+void TaskManager::serviceIO() {
+    #ifdef BUTTON_LED_ENABLED
+    handleButtonAndRelay(millis());
     #endif
     
-    #ifdef MR007_SENSOR_ENABLED
-    static unsigned long lastMR007Read = 0;
-    if (currentTime - lastMR007Read >= MR007_READ_INTERVAL) {
-        mr007Sensor.readSensor();
-        lastMR007Read = currentTime;
+    #ifdef ETHERNET_ENABLED
+    if (!networkManager.isEthernetActive()) {
+        webServer.handleWiFiClient();
     }
     #endif
-    
-    #ifdef ME4_SO2_SENSOR_ENABLED
-    static unsigned long lastME4SO2Read = 0;
-    if (currentTime - lastME4SO2Read >= ME4_SO2_READ_INTERVAL) {
-        me4so2Sensor.readSensor();
-        lastME4SO2Read = currentTime;
+}
+
+#ifdef DJANGO_ENABLED
+void TaskManager::queueDjangoSample() {
+    // Only a snapshot copy here; the uplink task does the network I/O,
+    // so a dead server cannot stall sampling
+    SharedSensorData snapshot;
+    if (!snapshotData(snapshot)) {
+        DEBUG_PRINTLN("Failed to read data for Django client");
+        return;
     }
+    uplinkQueue.push(snapshot);
+}
+#endif
+
+void TaskManager::printReports() {
+    sensorScheduler.report();
+    
+    DEBUG_PRINTLN("┌─ UART report ──────────────────────────────");
+    #ifdef ZE40_SENSOR_ENABLED
+    ze40Sensor.reportUart();
     #endif
+    #ifdef ZPHS01B_SENSOR_ENABLED
+    zphs01bSensor.reportUart();
+    #endif
+    DEBUG_PRINTLN("└────────────────────────────────────────────");
+    
+    adcSampler.report();
+    BufferManager::report();
     
-    // Add small delay before sending to Django to avoid network contention
-    // with the Ethernet server on the other core
-    vTaskDelay(pdMS_TO_TICKS(50));
+    #ifdef WEB_SERVER_ENABLED
+    webServer.report();
+    #endif
     
-    // Send data to Django server
     #ifdef DJANGO_ENABLED
-    djangoClient.sendSensorData();
+    uplinkQueue.report();
+    djangoClient.report();
+    DnsResolver::report();
+    #endif
+    
+    #ifdef PERF_MONITOR_ENABLED
+    PerfMonitor::report();
     #endif
 }
 
-void TaskManager::handleButtonAndRelay(unsigned long currentTime, bool& buttonPressed) {
+void TaskManager::handleButtonAndRelay(unsigned long currentTime) {
+    static bool buttonPressed = false;
+    
     if (digitalRead(BUTTON_PIN) == LOW && !buttonPressed) {
         digitalWrite(LED_PIN, HIGH);
         digitalWrite(RELAY_PIN, HIGH);
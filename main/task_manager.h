@@ -15,11 +15,46 @@ private:
     
     static void sensorTask(void *pvParameters);
     
+    #ifdef DJANGO_ENABLED
+    static void uplinkTask(void *pvParameters);
+    #endif
+    
     // Helper functions
     static void initSensors();
     static void handleNetworkFallback();
-    static void readSensors(unsigned long currentTime);
-    static void handleButtonAndRelay(unsigned long currentTime, bool& buttonPressed);
+    static void scheduleJobs();
+    static void publishUartFrames();
+    static void handleButtonAndRelay(unsigned long currentTime);
+    
+    // Scheduler jobs
+    static void drainAdc();
+    
+    #ifdef ZE40_SENSOR_ENABLED
+    static void pollZE40();
+    static void readZE40Analog();
+    static void requestZE40();
+    #endif
+    
+    #ifdef ZPHS01B_SENSOR_ENABLED
+    static void pollZPHS01B();
+    static void requestZPHS01B();
+    #endif
+    
+    #ifdef MR007_SENSOR_ENABLED
+    static void readMR007();
+    #endif
+    
+    #ifdef ME4_SO2_SENSOR_ENABLED
+    static void readME4SO2();
+    #endif
+    
+    static void serviceIO();
+    
+    #ifdef DJANGO_ENABLED
+    static void queueDjangoSample();
+    #endif
+    
+    static void printReports();
 };
 
 extern TaskManager taskManager;
@@ -0,0 +1,140 @@
+#include "uart_transaction.h"
+#include "config.h"
+
+void UartTransactionEngine::init(HardwareSerial* port, const char* label) {
+    serial = port;
+    name = label;
+    queueHead = 0;
+    queueCount = 0;
+    state = IDLE;
+}
+
+bool UartTransactionEngine::enqueue(const uint8_t* bytes, uint8_t length, uint8_t replyCode,
+                                    uint16_t timeoutMs, uint8_t retries) {
+    if (queueCount >= QUEUE_DEPTH || length == 0 || length > MAX_COMMAND_LENGTH) {
+        rejected++;
+        return false;
+    }
+
+    Command& cmd = queue[(queueHead + queueCount) % QUEUE_DEPTH];
+    memcpy(cmd.bytes, bytes, length);
+    cmd.length = length;
+    cmd.replyCode = replyCode;
+    cmd.timeoutMs = timeoutMs;
+    cmd.retriesLeft = retries;
+    queueCount++;
+    return true;
+}
+
+void UartTransactionEngine::transmit(uint32_t now) {
+    const Command& cmd = queue[queueHead];
+    serial->write(cmd.bytes, cmd.length);
+    sent++;
+    sentAt = now;
+    state = (cmd.replyCode == NO_REPLY) ? SETTLING : AWAITING_REPLY;
+}
+
+// Drop the head command and return to idle
+void UartTransactionEngine::finish() {
+    queueHead = (queueHead + 1) % QUEUE_DEPTH;
+    queueCount--;
+    state = IDLE;
+}
+
+void UartTransactionEngine::service(uint32_t now) {
+    if (serial == nullptr) return;
+
+    if (state != IDLE) {
+        Command& cmd = queue[queueHead];
+        if (now - sentAt < cmd.timeoutMs) return;
+
+        if (state == SETTLING) {
+            completed++;
+            finish();
+        } else if (cmd.retriesLeft > 0) {
+            cmd.retriesLeft--;
+            retried++;
+            transmit(now);
+            return;
+        } else {
+            timedOut++;
+            DEBUG_PRINTF("✗ %s: no reply to 0x%02X after retries\n", name, cmd.bytes[2]);
+            finish();
+        }
+    }
+
+    if (queueCount > 0) {
+        transmit(now);
+    }
+}
+
+bool UartTransactionEngine::onFrame(const uint8_t* frame, size_t length) {
+    if (state != AWAITING_REPLY || length < 2) return false;
+    if (frame[1] != queue[queueHead].replyCode) return false;
+
+    uint32_t replyMs = millis() - sentAt;
+    if (replyMs > maxReplyMs) maxReplyMs = replyMs;
+    completed++;
+    finish();
+    return true;
+}
+
+bool UartTransactionEngine::isIdle() const {
+    return state == IDLE && queueCount == 0;
+}
+
+void UartTransactionEngine::report() const {
+    DEBUG_PRINTF("│ %-8s UART: %lu sent, %lu done, %lu retries, %lu timeouts, %lu rejected, max reply %lu ms\n",
+                 name,
+                 (unsigned long)sent,
+                 (unsigned long)completed,
+                 (unsigned long)retried,
+                 (unsigned long)timedOut,
+                 (unsigned long)rejected,
+                 (unsigned long)maxReplyMs);
+}
+
+bool UartFrameQueue::init(uint8_t depth) {
+    if (queue == nullptr) {
+        queue = xQueueCreate(depth, sizeof(UartFrame));
+    }
+    return queue != nullptr;
+}
+
+bool UartFrameQueue::push(const uint8_t* bytes, uint8_t length) {
+    if (queue == nullptr || length > UartFrame::MAX_LENGTH) return false;
+
+    UartFrame frame;
+    memcpy(frame.bytes, bytes, length);
+    frame.length = length;
+    frame.receivedUs = micros();
+
+    if (xQueueSend(queue, &frame, 0) != pdTRUE) {
+        dropped++;
+        return false;
+    }
+    queued++;
+    return true;
+}
+
+bool UartFrameQueue::pop(UartFrame& out) {
+    if (queue == nullptr) return false;
+    return xQueueReceive(queue, &out, 0) == pdTRUE;
+}
+
+void UartFrameQueue::markPublished(const UartFrame& frame) {
+    uint32_t latencyUs = micros() - frame.receivedUs;
+    if (latencyUs > maxLatencyUs) maxLatencyUs = latencyUs;
+    totalLatencyUs += latencyUs;
+    published++;
+}
+
+void UartFrameQueue::report(const char* label) const {
+    unsigned long avgUs = published ? (unsigned long)(totalLatencyUs / published) : 0;
+    DEBUG_PRINTF("│ %-8s RX: %lu frames queued, %lu dropped, publish latency avg %lu / max %lu us\n",
+                 label,
+                 (unsigned long)queued,
+                 (unsigned long)dropped,
+                 avgUs,
+                 (unsigned long)maxLatencyUs);
+}
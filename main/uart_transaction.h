@@ -0,0 +1,183 @@
+#ifndef UART_TRANSACTION_H
+#define UART_TRANSACTION_H
+
+#include <Arduino.h>
+#include <HardwareSerial.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include "config.h"
+
+/**
+ * UART Transaction Engine
+ *
+ * One instance per sensor UART. Commands are queued and written one at
+ * a time by service(), which the sensor task calls from its scheduler
+ * jobs. The engine never sleeps. A command either waits for a reply or,
+ * if it has no reply (e.g. a mode switch), holds the line for a settle
+ * time before the next command goes out.
+ *
+ * The sensor's frame parser hands every valid frame to onFrame(). A
+ * frame whose command byte matches the pending command's reply code
+ * completes it. If no match arrives before the timeout, the command is
+ * resent, up to its retry limit. Because every port has its own engine,
+ * requests to different sensors can be in flight at the same time.
+ *
+ * Usage:
+ *   link.enqueue(REQUEST_CMD, 9, 0x86);
+ *   ...
+ *   link.onFrame(frame, 9);          // from the parser
+ *   link.service(millis());          // from a scheduler job
+ */
+class UartTransactionEngine {
+public:
+    static const uint8_t MAX_COMMAND_LENGTH = 9;
+    static const uint8_t QUEUE_DEPTH = 4;
+    static const uint8_t NO_REPLY = 0x00;
+
+    /**
+     * Attach the engine to an initialised port
+     * @param port UART the commands are written to
+     * @param label Name used in the report (must stay valid)
+     */
+    void init(HardwareSerial* port, const char* label);
+
+    /**
+     * Queue a command
+     * @param bytes Command bytes (copied)
+     * @param length Number of bytes, at most MAX_COMMAND_LENGTH
+     * @param replyCode Command byte of the expected reply, NO_REPLY for none
+     * @param timeoutMs Reply timeout, or settle time when there is no reply
+     * @param retries Number of resends after a timeout
+     * @return false if the queue is full or the command is too long
+     */
+    bool enqueue(const uint8_t* bytes, uint8_t length, uint8_t replyCode,
+                 uint16_t timeoutMs = UART_REPLY_TIMEOUT,
+                 uint8_t retries = UART_MAX_RETRIES);
+
+    /**
+     * Advance the state machine: send the next command, expire settle
+     * times and reply timeouts
+     * @param now Current millis()
+     */
+    void service(uint32_t now);
+
+    /**
+     * Offer a complete, checksummed frame to the pending command
+     * @param frame Frame bytes, frame[1] is the command byte
+     * @param length Frame length
+     * @return true if the frame was the awaited reply
+     */
+    bool onFrame(const uint8_t* frame, size_t length);
+
+    /**
+     * True when nothing is queued or in flight
+     */
+    bool isIdle() const;
+
+    /**
+     * Print sent/completed/retry/timeout counters
+     */
+    void report() const;
+
+private:
+    enum State : uint8_t {
+        IDLE,
+        AWAITING_REPLY,
+        SETTLING
+    };
+
+    struct Command {
+        uint8_t bytes[MAX_COMMAND_LENGTH];
+        uint8_t length;
+        uint8_t replyCode;
+        uint16_t timeoutMs;
+        uint8_t retriesLeft;
+    };
+
+    void transmit(uint32_t now);
+    void finish();
+
+    HardwareSerial* serial = nullptr;
+    const char* name = "";
+
+    Command queue[QUEUE_DEPTH];
+    uint8_t queueHead = 0;
+    uint8_t queueCount = 0;
+
+    State state = IDLE;
+    uint32_t sentAt = 0;
+
+    // Statistics
+    uint32_t sent = 0;
+    uint32_t completed = 0;
+    uint32_t retried = 0;
+    uint32_t timedOut = 0;
+    uint32_t rejected = 0;
+    uint32_t maxReplyMs = 0;
+};
+
+/**
+ * UART Frame Queue
+ *
+ * Hands complete, checksummed frames from a UART receive callback to the
+ * sensor task. The callback runs on the UART driver's event task as soon
+ * as the line goes idle after a frame. It assembles the frame, pushes it
+ * here and wakes the sensor scheduler. The sensor task then publishes the
+ * frame, so every history ring keeps a single producer.
+ *
+ * Each frame carries the micros() at which it completed. The sensor task
+ * uses that stamp to record frame-to-publish latency.
+ */
+struct UartFrame {
+    static const uint8_t MAX_LENGTH = 26;
+
+    uint8_t bytes[MAX_LENGTH];
+    uint8_t length;
+    uint32_t receivedUs;
+};
+
+class UartFrameQueue {
+public:
+    /**
+     * Create the queue
+     * @param depth Number of frames that can wait for the sensor task
+     * @return false if the queue could not be allocated
+     */
+    bool init(uint8_t depth);
+
+    /**
+     * Queue a frame (receive callback only)
+     * Drops the frame and counts it when the queue is full
+     * @return true if queued
+     */
+    bool push(const uint8_t* bytes, uint8_t length);
+
+    /**
+     * Take the oldest frame without blocking (sensor task only)
+     * @return false if no frame is waiting
+     */
+    bool pop(UartFrame& out);
+
+    /**
+     * Record that a popped frame has been published
+     */
+    void markPublished(const UartFrame& frame);
+
+    /**
+     * Print queued/dropped counters and frame-to-publish latency
+     * @param label Sensor name
+     */
+    void report(const char* label) const;
+
+private:
+    QueueHandle_t queue = nullptr;
+
+    // Statistics
+    uint32_t queued = 0;
+    uint32_t dropped = 0;
+    uint32_t published = 0;
+    uint32_t maxLatencyUs = 0;
+    uint64_t totalLatencyUs = 0;
+};
+
+#endif
@@ -0,0 +1,120 @@
+#include "uplink_queue.h"
+#include "buffer_manager.h"
+
+static_assert((UPLINK_QUEUE_DEPTH & (UPLINK_QUEUE_DEPTH - 1)) == 0,
+              "UPLINK_QUEUE_DEPTH must be a power of two");
+#if UPLINK_QUEUE_POLICY == UPLINK_POLICY_SPILL
+static_assert(UPLINK_SPILL_DEPTH > 0 && UPLINK_SPILL_DEPTH < UPLINK_QUEUE_DEPTH,
+              "UPLINK_SPILL_DEPTH must leave room in the queue");
+#endif
+
+UplinkQueue uplinkQueue;
+
+static const char* policyName() {
+    #if UPLINK_QUEUE_POLICY == UPLINK_POLICY_DROP_OLDEST
+    return "drop-oldest";
+    #elif UPLINK_QUEUE_POLICY == UPLINK_POLICY_COALESCE
+    return "coalesce";
+    #else
+    return "spill";
+    #endif
+}
+
+size_t UplinkQueue::depth() const {
+    return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+}
+
+bool UplinkQueue::push(const SharedSensorData& data) {
+    uint32_t h = head.load(std::memory_order_relaxed);
+    uint32_t t = tail.load(std::memory_order_acquire);
+    pushed++;
+
+    #if UPLINK_QUEUE_POLICY != UPLINK_POLICY_DROP_OLDEST
+    // An earlier overflow sample goes first, to keep the order
+    if (hasPending && h - t < UPLINK_QUEUE_DEPTH) {
+        slots[h % UPLINK_QUEUE_DEPTH] = pending;
+        head.store(++h, std::memory_order_release);
+        hasPending = false;
+    }
+    #endif
+
+    if (h - t >= UPLINK_QUEUE_DEPTH) {
+        #if UPLINK_QUEUE_POLICY == UPLINK_POLICY_DROP_OLDEST
+        // Claim the oldest slot; if the consumer took it first there is room anyway
+        if (tail.compare_exchange_strong(t, t + 1, std::memory_order_acq_rel)) {
+            dropped++;
+        }
+        #else
+        // Flash writes are left to the consumer; hold the latest sample
+        if (hasPending) coalesced++;
+        pending.data = data;
+        pending.capturedAt = millis();
+        hasPending = true;
+        if (consumer != nullptr) xTaskNotifyGive(consumer);
+        return false;
+        #endif
+    }
+
+    UplinkSample& slot = slots[h % UPLINK_QUEUE_DEPTH];
+    slot.data = data;
+    slot.capturedAt = millis();
+    head.store(h + 1, std::memory_order_release);
+
+    uint32_t queued = h + 1 - tail.load(std::memory_order_relaxed);
+    if (queued > highWater) highWater = queued;
+
+    if (consumer != nullptr) xTaskNotifyGive(consumer);
+    return true;
+}
+
+bool UplinkQueue::pop(UplinkSample& out) {
+    while (true) {
+        uint32_t t = tail.load(std::memory_order_acquire);
+        if (t == head.load(std::memory_order_acquire)) return false;
+
+        out = slots[t % UPLINK_QUEUE_DEPTH];
+
+        // Fails only if the producer dropped this slot during the copy
+        if (!tail.compare_exchange_strong(t, t + 1, std::memory_order_acq_rel)) continue;
+
+        #if UPLINK_QUEUE_POLICY == UPLINK_POLICY_SPILL
+        // Too far behind to send them all live; the replay takes this one
+        if (head.load(std::memory_order_acquire) - (t + 1) >= UPLINK_SPILL_DEPTH) {
+            spilled++;
+            BufferManager::saveData(out.data, out.capturedAt / 1000);
+            continue;
+        }
+        #endif
+
+        popped++;
+        return true;
+    }
+}
+
+void UplinkQueue::writeMetrics(JsonWriter& writer) const {
+    writer.member("policy", policyName());
+    writer.member("depth", (unsigned long)depth());
+    writer.member("capacity", (unsigned long)UPLINK_QUEUE_DEPTH);
+    writer.member("high_water", (unsigned long)highWater);
+    writer.member("pushed", (unsigned long)pushed);
+    writer.member("sent", (unsigned long)popped);
+    writer.member("dropped", (unsigned long)dropped);
+    writer.member("coalesced", (unsigned long)coalesced);
+    writer.member("spilled", (unsigned long)spilled);
+}
+
+void UplinkQueue::report() const {
+    DEBUG_PRINTLN("┌─ Uplink queue report ──────────────────────");
+    DEBUG_PRINTF("│ %s, depth %u/%u, high water %lu\n",
+                 policyName(),
+                 (unsigned)depth(),
+                 (unsigned)UPLINK_QUEUE_DEPTH,
+                 (unsigned long)highWater);
+    DEBUG_PRINTF("│ %lu pushed, %lu taken, %lu dropped, %lu coalesced, %lu spilled\n",
+                 (unsigned long)pushed,
+                 (unsigned long)popped,
+                 (unsigned long)dropped,
+                 (unsigned long)coalesced,
+                 (unsigned long)spilled);
+    DEBUG_PRINTLN("└────────────────────────────────────────────");
+}
@@ -0,0 +1,105 @@
+#ifndef UPLINK_QUEUE_H
+#define UPLINK_QUEUE_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "config.h"
+#include "shared_data.h"
+#include "json_writer.h"
+
+/**
+ * Snapshot waiting for upload
+ */
+struct UplinkSample {
+    SharedSensorData data;
+    uint32_t capturedAt;    // millis() when the snapshot was taken
+};
+
+/**
+ * Uplink Queue
+ *
+ * Bounded lock-free queue of sensor snapshots between the sensor task
+ * (single producer) and the uplink task (single consumer). The sensor
+ * task never blocks on the network: push() copies one snapshot and
+ * wakes the consumer with a task notification.
+ *
+ * When the queue is full, UPLINK_QUEUE_POLICY decides what happens:
+ *   - UPLINK_POLICY_DROP_OLDEST: the oldest queued sample is discarded.
+ *     The producer claims it by advancing the tail with a CAS; a
+ *     consumer that was copying that slot sees its own CAS fail and
+ *     throws the (possibly torn) copy away.
+ *   - UPLINK_POLICY_COALESCE: overflow samples collapse into a single
+ *     latest sample held by the producer. It is queued ahead of the
+ *     next push that finds room.
+ *   - UPLINK_POLICY_SPILL: the uplink task saves samples it has fallen
+ *     behind on to the BufferManager, to go out with the backlog
+ *     replay: pop() files each sample that still has
+ *     UPLINK_SPILL_DEPTH or more queued behind it. A push that finds
+ *     the queue full coalesces as above; the sensor task never
+ *     writes to flash.
+ *
+ * Usage:
+ *   uplinkQueue.setConsumer(xTaskGetCurrentTaskHandle());  // uplink task
+ *   uplinkQueue.push(snapshot);                            // sensor task
+ *   UplinkSample s;
+ *   while (uplinkQueue.pop(s)) { ... }                     // uplink task
+ */
+class UplinkQueue {
+public:
+    /**
+     * Queue a snapshot (producer only)
+     * @return false if the sample was dropped or spilled
+     */
+    bool push(const SharedSensorData& data);
+
+    /**
+     * Take the oldest snapshot (consumer only). With
+     * UPLINK_POLICY_SPILL, older samples are filed to the BufferManager
+     * first while the queue is UPLINK_SPILL_DEPTH deep.
+     * @return false if the queue is empty
+     */
+    bool pop(UplinkSample& out);
+
+    /**
+     * Task to notify on each push
+     */
+    void setConsumer(TaskHandle_t task) { consumer = task; }
+
+    size_t depth() const;
+    size_t capacity() const { return UPLINK_QUEUE_DEPTH; }
+
+    /**
+     * Queue depth and counters as members of the open JSON object
+     */
+    void writeMetrics(JsonWriter& writer) const;
+
+    /**
+     * Print depth, high-water mark and counters
+     */
+    void report() const;
+
+private:
+    UplinkSample slots[UPLINK_QUEUE_DEPTH];
+    std::atomic<uint32_t> head{0};      // Next slot to fill (producer)
+    std::atomic<uint32_t> tail{0};      // Next slot to take (consumer, or producer dropping)
+    TaskHandle_t consumer = nullptr;
+
+    #if UPLINK_QUEUE_POLICY != UPLINK_POLICY_DROP_OLDEST
+    UplinkSample pending;               // Latest sample that did not fit
+    bool hasPending = false;
+    #endif
+
+    // Statistics
+    uint32_t pushed = 0;
+    uint32_t popped = 0;
+    uint32_t dropped = 0;
+    uint32_t coalesced = 0;
+    uint32_t spilled = 0;
+    uint32_t highWater = 0;
+};
+
+extern UplinkQueue uplinkQueue;
+
+#endif
@@ -9,6 +9,8 @@
  * for securing web interface and API endpoints
  */
 class WebAuthManager {
+    friend class HostHarness;   // host/ tests and benchmarks
+
 public:
     /**
      * Check if request has valid authentication credentials
@@ -0,0 +1,212 @@
+// Generated by tools/build_web_page.py from web/index.html - do not edit.
+// Rerun the script after changing the page.
+#ifndef WEB_PAGE_H
+#define WEB_PAGE_H
+
+#include <Arduino.h>
+
+#define MAIN_PAGE_ETAG          "\"15787a6220741e1d\""
+#define MAIN_PAGE_GZIP_LENGTH   3144
+#define MAIN_PAGE_SOURCE_LENGTH 13482
+
+static const uint8_t MAIN_PAGE_GZIP[MAIN_PAGE_GZIP_LENGTH] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xd5, 0x5b, 0xdb, 0x72, 0xdb, 0xc6,
+    0x19, 0xbe, 0xf7, 0x53, 0xac, 0x99, 0x49, 0x48, 0x36, 0x24, 0x78, 0x12, 0x25, 0x95, 0x12, 0x15,
+    0xcb, 0x12, 0x95, 0xb8, 0x95, 0x23, 0xd5, 0x92, 0xd5, 0x49, 0x3b, 0x19, 0xcd, 0x12, 0x58, 0x90,
+    0x6b, 0x2d, 0xb0, 0xe8, 0x62, 0x49, 0x8a, 0xc9, 0xf8, 0xa2, 0x17, 0x49, 0x7b, 0x91, 0xf7, 0xc8,
+    0x34, 0x37, 0x6d, 0x27, 0xb7, 0xbd, 0xca, 0x03, 0xf4, 0xda, 0x4e, 0x5e, 0xa6, 0xff, 0x2e, 0x40,
+    0x12, 0x67, 0x52, 0x1a, 0x75, 0xec, 0x30, 0xd1, 0x18, 0xc4, 0xfe, 0xfc, 0x0f, 0xdf, 0x7f, 0xdc,
+    0x25, 0xb8, 0xff, 0xf8, 0xf8, 0xec, 0xe8, 0xf2, 0x8b, 0xf3, 0x01, 0x1a, 0x4b, 0x87, 0x1d, 0x3c,
+    0xda, 0x57, 0xff, 0x20, 0x86, 0xdd, 0x51, 0xbf, 0x64, 0xe3, 0x92, 0xba, 0x41, 0xb0, 0x75, 0xf0,
+    0x08, 0xc1, 0x6b, 0xdf, 0x21, 0x12, 0x23, 0x73, 0x8c, 0x85, 0x4f, 0x64, 0xbf, 0xf4, 0xf2, 0xf2,
+    0xa4, 0xbe, 0x5b, 0x8a, 0x2e, 0xb9, 0xd8, 0x21, 0xfd, 0xd2, 0x94, 0x92, 0x99, 0xc7, 0x85, 0x2c,
+    0x21, 0x93, 0xbb, 0x92, 0xb8, 0x40, 0x3a, 0xa3, 0x96, 0x1c, 0xf7, 0x2d, 0x32, 0xa5, 0x26, 0xa9,
+    0xeb, 0x37, 0x35, 0x44, 0x5d, 0x2a, 0x29, 0x66, 0x75, 0xdf, 0xc4, 0x8c, 0xf4, 0x5b, 0x46, 0x73,
+    0xc1, 0x4a, 0x52, 0xc9, 0xc8, 0xc1, 0x21, 0x15, 0xe8, 0x0f, 0x13, 0xcc, 0xa8, 0x9c, 0xa3, 0xe7,
+    0x1c, 0x68, 0xb9, 0xa0, 0xee, 0x08, 0x5d, 0xcc, 0x7d, 0x49, 0x9c, 0xfd, 0x46, 0x40, 0x14, 0x7c,
+    0x80, 0x51, 0xf7, 0x06, 0x8d, 0x05, 0xb1, 0xfb, 0xa5, 0xb1, 0x94, 0x9e, 0xdf, 0x6b, 0x34, 0x6c,
+    0x90, 0xec, 0x1b, 0x23, 0xce, 0x47, 0x8c, 0x60, 0x8f, 0xfa, 0x86, 0xc9, 0x9d, 0x86, 0xe9, 0xfb,
+    0xed, 0x4f, 0x6c, 0xec, 0x50, 0x36, 0xef, 0x3f, 0x03, 0xcd, 0x44, 0x6f, 0x36, 0x1a, 0xcb, 0x27,
+    0x9d, 0x66, 0x73, 0x6f, 0x0b, 0xfe, 0xba, 0xf0, 0xb7, 0xdd, 0x6c, 0x7e, 0x64, 0x51, 0xdf, 0x63,
+    0x78, 0xde, 0xf7, 0x67, 0xd8, 0x2b, 0x21, 0x41, 0x58, 0xbf, 0xe4, 0xcb, 0x39, 0x23, 0xfe, 0x98,
+    0x10, 0x59, 0xca, 0x97, 0x69, 0x5a, 0xae, 0xf1, 0xca, 0xb7, 0x08, 0xa3, 0x53, 0x61, 0xb8, 0x44,
+    0x36, 0x46, 0xe3, 0x86, 0xc0, 0xbe, 0xa4, 0x37, 0x44, 0x58, 0x58, 0x34, 0xa6, 0xf8, 0x2b, 0x2a,
+    0xea, 0x4a, 0xb3, 0x27, 0xd3, 0x4e, 0xd3, 0x00, 0x8b, 0x1b, 0x20, 0x4a, 0x6a, 0x5d, 0xeb, 0x36,
+    0x36, 0x89, 0x01, 0x0a, 0x16, 0x0b, 0x4c, 0xae, 0xa5, 0x35, 0x78, 0x05, 0xa6, 0x32, 0x3e, 0xb1,
+    0x6c, 0x86, 0x05, 0xd1, 0x56, 0xe3, 0x57, 0xf8, 0xb6, 0xc1, 0xe8, 0xd0, 0x0f, 0x04, 0xe1, 0x19,
+    0xf1, 0xb9, 0x43, 0x1a, 0xdb, 0xc6, 0x16, 0x28, 0x00, 0x12, 0x1b, 0x98, 0x31, 0xc3, 0xa1, 0xae,
+    0x96, 0x1e, 0x0a, 0xd3, 0x22, 0x82, 0x6b, 0xf5, 0xea, 0x09, 0xce, 0x25, 0xfa, 0x7a, 0xf9, 0x5e,
+    0xbd, 0xea, 0x75, 0x4f, 0x50, 0x07, 0x8b, 0x79, 0x0f, 0x7d, 0xd0, 0x1e, 0xec, 0x1c, 0x77, 0xda,
+    0x7b, 0xd9, 0xeb, 0x75, 0x46, 0x01, 0x65, 0xa0, 0xda, 0x3a, 0x3a, 0x3c, 0xe9, 0x36, 0xf3, 0xa8,
+    0x00, 0xa1, 0x1b, 0x20, 0x6a, 0x3d, 0xed, 0x0e, 0xda, 0x29, 0x22, 0x9f, 0x40, 0x28, 0x59, 0x81,
+    0xb0, 0x66, 0x7b, 0x67, 0xe7, 0xe9, 0x71, 0x92, 0x02, 0x9b, 0x26, 0x44, 0x1a, 0x2c, 0x9f, 0x9c,
+    0xfc, 0x76, 0xb7, 0x99, 0x62, 0x30, 0xc4, 0xe6, 0xcd, 0x48, 0xf0, 0x89, 0x6b, 0x29, 0x92, 0xee,
+    0xc9, 0xce, 0xc9, 0x61, 0x92, 0xc4, 0xc4, 0xc2, 0xaa, 0x0f, 0x47, 0x9a, 0x85, 0x7a, 0x25, 0xd7,
+    0x25, 0xb9, 0x95, 0x51, 0x9b, 0xb7, 0x3b, 0xed, 0xce, 0x6e, 0x26, 0x51, 0x54, 0xdb, 0xee, 0xd6,
+    0xf6, 0x60, 0x27, 0x25, 0x6b, 0xc8, 0x85, 0x05, 0xe1, 0x87, 0x3e, 0x18, 0x34, 0xd5, 0x7f, 0x29,
+    0x73, 0x27, 0x60, 0x8d, 0xef, 0xe7, 0x62, 0x36, 0xc3, 0xc2, 0x85, 0x64, 0xc8, 0xb5, 0xd6, 0x82,
+    0xf4, 0xd5, 0xec, 0x4f, 0xb6, 0xb6, 0x3a, 0x9d, 0xed, 0xd5, 0xf2, 0xeb, 0xe5, 0xd5, 0xf2, 0xe2,
+    0x37, 0x09, 0xbf, 0x82, 0x79, 0x23, 0xea, 0xf6, 0x50, 0x82, 0xa9, 0x87, 0x2d, 0x4b, 0x8b, 0x4c,
+    0xdc, 0x1f, 0xf2, 0xdb, 0xba, 0x4f, 0xbf, 0xd2, 0x4b, 0x81, 0x55, 0x60, 0xdc, 0x6d, 0xa1, 0xc4,
+    0x21, 0xb7, 0xe6, 0x09, 0xa1, 0x61, 0x0a, 0xa8, 0xcc, 0xec, 0xa1, 0xb2, 0xce, 0xcd, 0x72, 0x0d,
+    0x95, 0x2f, 0xc8, 0x88, 0x13, 0xf4, 0xf2, 0x19, 0x5c, 0x5f, 0xe2, 0x31, 0x77, 0x70, 0x0d, 0x7d,
+    0x4a, 0x5c, 0x32, 0x85, 0x7f, 0xaf, 0x54, 0x4e, 0xb9, 0x70, 0xe1, 0x63, 0xd7, 0x07, 0xc4, 0x05,
+    0xb5, 0xf7, 0xee, 0x64, 0x47, 0xbb, 0xe9, 0xdd, 0x26, 0x4c, 0x89, 0xc4, 0xc8, 0x14, 0x8b, 0x4a,
+    0x34, 0x6a, 0xaa, 0x71, 0x52, 0x93, 0x33, 0x2e, 0x16, 0x54, 0xd1, 0xc0, 0x48, 0xd0, 0x41, 0xd2,
+    0x92, 0xfa, 0x98, 0x04, 0x09, 0xd0, 0x32, 0x8a, 0x3d, 0x61, 0xa8, 0x72, 0x89, 0xe1, 0x13, 0x22,
+    0xe5, 0x92, 0xdb, 0xa0, 0x68, 0x02, 0x8f, 0x76, 0x33, 0xa5, 0xf7, 0xd2, 0x52, 0x84, 0x27, 0x92,
+    0x17, 0x8b, 0x50, 0xc5, 0x3c, 0xc5, 0x5f, 0x1b, 0x00, 0x95, 0x76, 0x04, 0x4c, 0x54, 0x16, 0x11,
+    0x91, 0x25, 0x00, 0xfc, 0x2a, 0x25, 0x77, 0x7a, 0xa8, 0x93, 0xd2, 0x20, 0x07, 0xd4, 0x02, 0x05,
+    0xc6, 0xad, 0xc2, 0x08, 0xb8, 0x52, 0xa5, 0x52, 0x45, 0xc0, 0x22, 0x14, 0xf2, 0xbc, 0xac, 0x3f,
+    0x36, 0x0b, 0x01, 0xde, 0x4e, 0x66, 0x42, 0xcc, 0x4d, 0xd1, 0x42, 0x53, 0x2d, 0x34, 0xb0, 0x95,
+    0x32, 0x50, 0x8b, 0x81, 0x30, 0x27, 0x60, 0xa2, 0xd1, 0x16, 0xc4, 0x29, 0x36, 0xd2, 0x97, 0x58,
+    0x4e, 0xfc, 0x84, 0x85, 0x4b, 0x90, 0x14, 0xfb, 0xac, 0xf0, 0x0b, 0xb2, 0x47, 0x60, 0x8b, 0x4e,
+    0xfc, 0x75, 0xf1, 0xa9, 0x02, 0x0b, 0x8b, 0xfa, 0x48, 0x51, 0x83, 0xc7, 0x2a, 0xad, 0x4e, 0xd7,
+    0x22, 0xa3, 0x5a, 0xdc, 0xd4, 0x6a, 0xe2, 0x7d, 0x50, 0x89, 0xab, 0xd9, 0xb1, 0x3c, 0x1b, 0x53,
+    0x49, 0xe2, 0x2b, 0x61, 0x23, 0xec, 0x41, 0xab, 0xd6, 0x81, 0x3c, 0x64, 0xdc, 0xbc, 0xb9, 0x0f,
+    0x72, 0x0b, 0x07, 0x75, 0xa3, 0x0e, 0xca, 0x04, 0x8e, 0xb8, 0x3e, 0x57, 0x66, 0x51, 0x2b, 0x81,
+    0xde, 0x52, 0x17, 0xb5, 0x16, 0x17, 0xa1, 0xee, 0x40, 0x12, 0x3a, 0xb0, 0x2e, 0x49, 0x1d, 0xcc,
+    0x99, 0x38, 0x2e, 0x00, 0x28, 0x88, 0x47, 0xb0, 0xac, 0xa8, 0x9c, 0xa8, 0xdb, 0x54, 0xd6, 0x10,
+    0xf4, 0x38, 0xc8, 0xa4, 0x4a, 0x47, 0x65, 0x50, 0x0d, 0xb5, 0x6c, 0x91, 0x44, 0x62, 0x84, 0x3d,
+    0xc0, 0xbd, 0x9b, 0x9d, 0x5f, 0x39, 0xe1, 0x5f, 0x60, 0x85, 0x6a, 0x28, 0x09, 0x2b, 0xd2, 0x25,
+    0x26, 0xec, 0x3a, 0xd5, 0xbc, 0x84, 0xea, 0xae, 0x09, 0x93, 0x56, 0x3b, 0x4d, 0x00, 0x15, 0x79,
+    0x8c, 0x2d, 0x3e, 0x53, 0x25, 0x61, 0x0b, 0x62, 0x4d, 0xd1, 0x20, 0x31, 0x1a, 0xe2, 0x4a, 0xb3,
+    0x86, 0xc2, 0xff, 0x8d, 0xe6, 0x6e, 0x42, 0xa6, 0x14, 0x90, 0x63, 0x30, 0x92, 0x71, 0xa8, 0x02,
+    0xfa, 0xda, 0xe6, 0xc2, 0x01, 0xc2, 0x8e, 0x8f, 0x08, 0xf6, 0x49, 0x2d, 0xc2, 0x78, 0x75, 0x37,
+    0x53, 0x37, 0xc9, 0x01, 0x47, 0x25, 0xd8, 0xe7, 0x0c, 0x1c, 0x19, 0x8f, 0xc9, 0x8d, 0xa1, 0xeb,
+    0x8d, 0xf9, 0x34, 0x5d, 0xaa, 0x16, 0x8a, 0x85, 0x3a, 0x2a, 0x97, 0x7f, 0x51, 0xa9, 0x03, 0x4a,
+    0xd5, 0x22, 0x14, 0x76, 0x15, 0x0a, 0xdb, 0x19, 0x28, 0xb4, 0xda, 0x9b, 0x29, 0x94, 0x59, 0x37,
+    0x23, 0x55, 0xa1, 0x95, 0xa8, 0x0a, 0xeb, 0x6b, 0x53, 0x22, 0xaa, 0xd2, 0xe9, 0xbe, 0x69, 0xf1,
+    0x5a, 0x66, 0x86, 0xcd, 0x48, 0x82, 0x85, 0xae, 0xe9, 0x75, 0xc8, 0x6b, 0xc7, 0xcf, 0xae, 0xec,
+    0x61, 0x9c, 0xad, 0xf2, 0xb7, 0x9d, 0x13, 0x6e, 0x4b, 0x35, 0x13, 0x5e, 0x0d, 0x96, 0xef, 0x84,
+    0x21, 0xcd, 0x1c, 0x38, 0xea, 0x22, 0x6c, 0x92, 0x1b, 0xe1, 0x50, 0xdd, 0xcb, 0x77, 0xc4, 0xd6,
+    0xda, 0xf2, 0x6c, 0x61, 0x89, 0xeb, 0x02, 0xc2, 0xf8, 0xeb, 0x4d, 0x81, 0x7c, 0x35, 0x81, 0x31,
+    0xde, 0x9e, 0xd7, 0xc3, 0x0d, 0x4d, 0x0f, 0xf9, 0x1e, 0xcc, 0xeb, 0xf5, 0x21, 0x91, 0x33, 0x42,
+    0xdc, 0x3b, 0x82, 0xbe, 0xe8, 0xd7, 0x3a, 0x2d, 0xf3, 0xc6, 0x13, 0xbd, 0xd8, 0xea, 0x16, 0xf5,
+    0x00, 0x1d, 0xcb, 0x3b, 0xdb, 0x50, 0xca, 0x76, 0xba, 0x35, 0xb4, 0x1b, 0x64, 0x75, 0xb7, 0x5a,
+    0x58, 0x2e, 0x76, 0x73, 0xfc, 0xcb, 0x88, 0x0d, 0x56, 0x75, 0xb2, 0x73, 0x36, 0xec, 0x1b, 0x1b,
+    0x80, 0xca, 0xf0, 0x90, 0xb0, 0xac, 0x2c, 0xc9, 0xec, 0x00, 0x77, 0x99, 0xa4, 0xee, 0x1b, 0xe5,
+    0x6b, 0x54, 0x2d, 0x0e, 0xc6, 0xdd, 0xc2, 0x58, 0x5c, 0x8e, 0xf9, 0x9b, 0x20, 0x33, 0xc5, 0x6c,
+    0x42, 0x8a, 0x90, 0xb9, 0xf7, 0xf0, 0x12, 0x0b, 0xfe, 0xd6, 0xda, 0xe0, 0xb7, 0x61, 0x2b, 0x77,
+    0xdf, 0x09, 0x50, 0x17, 0xf6, 0x8d, 0xc7, 0xbf, 0x6c, 0xf7, 0x66, 0xa1, 0x96, 0xec, 0x1d, 0xad,
+    0xfb, 0x54, 0x99, 0xd0, 0x30, 0x8b, 0x4e, 0x73, 0x76, 0x34, 0xdd, 0x78, 0xba, 0x65, 0xf0, 0x78,
+    0xe2, 0x10, 0x8b, 0x62, 0x54, 0x89, 0x0c, 0xdc, 0x3b, 0xdb, 0x10, 0x04, 0xd5, 0x04, 0xc7, 0x82,
+    0x39, 0xa5, 0x60, 0x20, 0x81, 0x89, 0x23, 0x6e, 0xf2, 0xeb, 0x38, 0xd3, 0xbc, 0xd1, 0x38, 0xe5,
+    0xe4, 0xdd, 0x54, 0xab, 0x79, 0x9d, 0xb0, 0x6a, 0xbf, 0x11, 0xee, 0xe0, 0xf7, 0x1b, 0xc1, 0xf1,
+    0xcd, 0xbe, 0xda, 0x74, 0x85, 0x9b, 0x7b, 0x85, 0x90, 0xc9, 0xb0, 0xef, 0xf7, 0x4b, 0xcb, 0x1d,
+    0x47, 0x69, 0xb5, 0xd9, 0x8f, 0xae, 0x07, 0x2a, 0x45, 0x16, 0x35, 0xc1, 0xb8, 0x75, 0xb0, 0x4f,
+    0x17, 0x24, 0x36, 0xf6, 0x91, 0x8d, 0xeb, 0x0e, 0x35, 0x05, 0x37, 0xc7, 0xd4, 0x2b, 0x1d, 0xec,
+    0x37, 0xe8, 0x01, 0x7a, 0xf3, 0xe3, 0x2f, 0xdf, 0xbd, 0xf9, 0xf1, 0xcd, 0x0f, 0x6f, 0xbf, 0x41,
+    0x6f, 0xbf, 0x79, 0xf3, 0xfd, 0xdb, 0x6f, 0xe1, 0xed, 0x0f, 0x6f, 0xff, 0xfe, 0xe6, 0xdf, 0xbf,
+    0x7c, 0xf7, 0xf6, 0xdb, 0x9f, 0xff, 0x89, 0x7e, 0xfe, 0x07, 0x5c, 0xfc, 0x55, 0xdd, 0x44, 0x6f,
+    0xff, 0x06, 0xf7, 0xbf, 0x07, 0x4d, 0x5b, 0x09, 0x39, 0x11, 0x45, 0x82, 0x89, 0xba, 0x84, 0xa8,
+    0xd5, 0x2f, 0xb9, 0x50, 0x75, 0xb9, 0xb8, 0xb9, 0x08, 0x6e, 0x1d, 0x1c, 0x71, 0xd7, 0x25, 0xa6,
+    0x84, 0x00, 0x34, 0x0c, 0x63, 0xbf, 0x01, 0x1f, 0x8a, 0xd8, 0x12, 0x7f, 0x9b, 0x69, 0x63, 0xc4,
+    0x97, 0x49, 0x43, 0x1f, 0xd7, 0xeb, 0xe8, 0x4f, 0x83, 0xad, 0x26, 0xba, 0xbc, 0x3a, 0x3b, 0x42,
+    0x17, 0x9a, 0x10, 0xb6, 0xd7, 0x05, 0x6a, 0xae, 0xc6, 0x97, 0x04, 0xaf, 0x1c, 0xca, 0x4c, 0x80,
+    0x97, 0xf4, 0x49, 0x90, 0x67, 0xd4, 0xb5, 0x42, 0x7c, 0x93, 0x6a, 0xa5, 0x85, 0xc5, 0x4d, 0xcf,
+    0xd2, 0x61, 0xd1, 0x07, 0xf3, 0xc4, 0x43, 0x93, 0x73, 0x63, 0xb4, 0xba, 0x66, 0xe6, 0x50, 0x67,
+    0x2a, 0x3c, 0xe4, 0x4c, 0x86, 0x0a, 0x1f, 0x1f, 0x1e, 0xa1, 0x2b, 0x78, 0x8b, 0x47, 0xa4, 0x97,
+    0x2d, 0xae, 0xa1, 0xe4, 0x6d, 0xaa, 0x8a, 0xae, 0xa7, 0x41, 0x3c, 0x58, 0xd8, 0x0c, 0x19, 0x97,
+    0x0e, 0xc0, 0x61, 0x57, 0x79, 0x8c, 0xde, 0x0b, 0x44, 0x24, 0x36, 0xc7, 0xdc, 0x21, 0x50, 0xa9,
+    0xa0, 0xde, 0x2e, 0xb0, 0xd1, 0x7e, 0x3c, 0x3f, 0x7f, 0xfe, 0xf0, 0xc0, 0x00, 0x53, 0x0d, 0x8a,
+    0xe7, 0x39, 0x77, 0x80, 0x25, 0xe3, 0x56, 0x46, 0x62, 0x9c, 0x7f, 0x76, 0xd1, 0x6c, 0x3d, 0x45,
+    0xd1, 0x83, 0xda, 0x77, 0x98, 0x1b, 0xfa, 0xd4, 0x73, 0x91, 0x1c, 0x69, 0xd5, 0xde, 0xcf, 0x68,
+    0xf0, 0x1d, 0x3e, 0x0a, 0x75, 0x3e, 0x7f, 0xde, 0x36, 0xba, 0x0f, 0x1c, 0x00, 0x9e, 0xd3, 0xee,
+    0x5e, 0xe9, 0xb7, 0x2a, 0x06, 0xfe, 0xfb, 0x9f, 0x51, 0xc3, 0xf9, 0xe9, 0xc7, 0xf7, 0x3a, 0x3d,
+    0x62, 0x80, 0xb4, 0x9a, 0x0f, 0x8e, 0x47, 0xab, 0xf9, 0xeb, 0xc2, 0x03, 0x0a, 0x3e, 0x6c, 0x3d,
+    0xc4, 0x3c, 0xc4, 0xe4, 0xe8, 0xac, 0xfd, 0xc0, 0x90, 0x98, 0xbc, 0xbd, 0x42, 0xe4, 0x6e, 0x55,
+    0xe2, 0x1d, 0x14, 0xcf, 0x31, 0x11, 0x4e, 0x58, 0x3d, 0xc7, 0x98, 0xd9, 0x8b, 0xf2, 0x09, 0xa3,
+    0x16, 0x11, 0x30, 0x0d, 0x88, 0x87, 0x6e, 0x2d, 0x6a, 0x88, 0x5b, 0xc1, 0xf3, 0xd3, 0xbf, 0x8e,
+    0xde, 0x6f, 0x78, 0xa8, 0xbb, 0xe8, 0x28, 0x9f, 0x4d, 0x1c, 0x6a, 0x41, 0xd9, 0x7b, 0x60, 0x3c,
+    0xc6, 0x21, 0xdb, 0x15, 0x26, 0x1f, 0x3e, 0x74, 0x5b, 0x79, 0xfe, 0xa2, 0xd9, 0xdc, 0x41, 0x47,
+    0xdc, 0x19, 0xaa, 0x3d, 0xf7, 0x90, 0x11, 0xf4, 0x29, 0x58, 0xf7, 0x0e, 0x1b, 0x8b, 0x4d, 0x05,
+    0x09, 0x51, 0xcd, 0xd4, 0xed, 0xfd, 0x8c, 0x05, 0x72, 0x0b, 0xef, 0x1d, 0xac, 0x8e, 0xf3, 0xea,
+    0x52, 0x50, 0xec, 0x8e, 0xd8, 0xc2, 0x8a, 0xd3, 0xc1, 0xe9, 0x03, 0x87, 0x85, 0x23, 0x00, 0x17,
+    0x60, 0x7b, 0xe7, 0x88, 0x78, 0xa7, 0x13, 0xe9, 0xff, 0x67, 0x1a, 0xd5, 0x58, 0xdc, 0x77, 0x1e,
+    0xdd, 0x2c, 0x43, 0x06, 0x5b, 0xf5, 0x8b, 0xb3, 0x36, 0xba, 0x98, 0x30, 0x7b, 0x22, 0xd0, 0x31,
+    0xe5, 0xb7, 0xd4, 0x22, 0xef, 0x32, 0x45, 0xfc, 0x9b, 0x09, 0x63, 0x75, 0xd8, 0x00, 0xfa, 0xfe,
+    0x90, 0xbb, 0xc4, 0x5f, 0xa4, 0x4b, 0xa6, 0xa2, 0xef, 0x67, 0x5c, 0x4c, 0x29, 0x66, 0xa1, 0xda,
+    0x4a, 0x65, 0xd8, 0x54, 0xaa, 0x73, 0x10, 0xa1, 0x13, 0xe8, 0x81, 0x23, 0xc4, 0xe7, 0xed, 0x18,
+    0xfb, 0x5f, 0x45, 0xeb, 0x8d, 0xe4, 0xcd, 0xd1, 0x44, 0x08, 0x75, 0x08, 0xfa, 0xf0, 0xa8, 0x04,
+    0x8c, 0xc3, 0xe1, 0xec, 0xf0, 0xfe, 0x79, 0xb3, 0xc9, 0xb6, 0x3f, 0x38, 0x2e, 0x2a, 0xa5, 0x73,
+    0xe6, 0xe0, 0xd9, 0x39, 0x3a, 0xb4, 0x2c, 0xa1, 0xbf, 0x80, 0x0f, 0x54, 0x56, 0xfa, 0x51, 0x2f,
+    0xbc, 0xa9, 0xd4, 0x0b, 0x55, 0xcb, 0xd2, 0x44, 0xdd, 0x39, 0xc5, 0xbe, 0x44, 0x2f, 0x3d, 0x30,
+    0x91, 0x44, 0x59, 0x80, 0x60, 0x19, 0xdc, 0xcd, 0xe7, 0x11, 0x79, 0x1b, 0x5e, 0x86, 0x4f, 0x64,
+    0x98, 0x82, 0x7a, 0x72, 0x45, 0x67, 0x72, 0x17, 0x64, 0x9c, 0x9f, 0x9d, 0x9e, 0x5e, 0x3f, 0xfb,
+    0xfc, 0x72, 0xf0, 0xe2, 0xea, 0xf0, 0xf4, 0xfa, 0xf9, 0x05, 0xea, 0xa3, 0x76, 0x33, 0x7a, 0x90,
+    0x18, 0x90, 0x5d, 0x9c, 0x1d, 0xfd, 0x7e, 0x70, 0x79, 0xfd, 0x62, 0x70, 0xf9, 0xe2, 0x8b, 0x80,
+    0xaa, 0xd5, 0x8c, 0x91, 0x31, 0x22, 0x91, 0x80, 0x94, 0x57, 0x4f, 0xd8, 0xf4, 0x91, 0x0b, 0xd9,
+    0x1c, 0x5f, 0xf3, 0x38, 0x63, 0x97, 0xd4, 0x21, 0x62, 0xb9, 0xba, 0x5c, 0xb6, 0x27, 0xae, 0xa9,
+    0xa2, 0x18, 0x3e, 0xef, 0x42, 0xc9, 0xa8, 0x28, 0xbf, 0x26, 0xcf, 0xcb, 0x1a, 0x8d, 0x10, 0x0d,
+    0x14, 0x9e, 0xdd, 0x20, 0xea, 0xda, 0x3c, 0x7e, 0xbe, 0xcb, 0xcd, 0x89, 0x03, 0xce, 0x37, 0x46,
+    0x44, 0x0e, 0x18, 0x51, 0x97, 0x4f, 0xe7, 0xcf, 0xac, 0x4a, 0x79, 0x89, 0x7b, 0xb9, 0x6a, 0xa8,
+    0x03, 0xc4, 0xa3, 0xe0, 0x08, 0x1e, 0x14, 0x51, 0x92, 0x0c, 0xea, 0x5d, 0xe3, 0x60, 0x7d, 0x6f,
+    0x33, 0x7e, 0x2b, 0x27, 0xa4, 0x18, 0xba, 0x64, 0x86, 0x8e, 0x61, 0xa1, 0x02, 0x0b, 0xfc, 0x94,
+    0xab, 0xe7, 0x92, 0x94, 0xd1, 0x17, 0x52, 0x3d, 0x79, 0x54, 0x49, 0x9c, 0x57, 0x26, 0x8e, 0x39,
+    0x15, 0xcc, 0xc1, 0x21, 0x95, 0x92, 0xa6, 0xb4, 0xcb, 0x53, 0x20, 0x76, 0x7c, 0x55, 0x4e, 0x70,
+    0x5d, 0xb1, 0x48, 0xe8, 0x56, 0xfe, 0x3c, 0xf8, 0x58, 0x0f, 0x95, 0xd1, 0xc7, 0x81, 0xe9, 0x21,
+    0xa3, 0x6b, 0x87, 0x5b, 0x04, 0x14, 0x7e, 0xe9, 0xc1, 0x10, 0x7c, 0x84, 0x7d, 0x52, 0xa8, 0x29,
+    0xb8, 0x42, 0x1f, 0x1d, 0x81, 0x9d, 0x78, 0x33, 0xc0, 0x56, 0xc7, 0x2b, 0xd9, 0x1e, 0xf8, 0x8a,
+    0x6c, 0x35, 0x0d, 0x20, 0xba, 0x9e, 0x06, 0x54, 0xa0, 0xca, 0x09, 0xbd, 0x25, 0x56, 0xa5, 0x5d,
+    0x05, 0x4d, 0xcb, 0xe8, 0xaa, 0xbc, 0xb7, 0xb1, 0xa0, 0xf3, 0xf3, 0xe7, 0x6b, 0x84, 0x40, 0x9d,
+    0x5c, 0x0a, 0xe8, 0x04, 0x02, 0xe0, 0x56, 0x79, 0x8d, 0xc5, 0xe1, 0x79, 0x40, 0xca, 0x68, 0x6a,
+    0x23, 0x1d, 0xb0, 0x06, 0xa6, 0xe2, 0xfa, 0x2f, 0xc1, 0x49, 0x41, 0x35, 0xe3, 0xf8, 0x35, 0x57,
+    0xe7, 0xe5, 0x0e, 0x3b, 0x5b, 0xed, 0x08, 0x5b, 0x43, 0x91, 0x6a, 0x7d, 0xc3, 0x7d, 0x67, 0x42,
+    0xe7, 0x35, 0x62, 0xc2, 0x8d, 0xeb, 0x26, 0x62, 0x5a, 0xcd, 0xfb, 0x8a, 0x59, 0x6c, 0x06, 0xd7,
+    0x4b, 0x01, 0xca, 0x1c, 0xec, 0x0b, 0x05, 0x2c, 0xf7, 0x53, 0xeb, 0x25, 0xc8, 0xd5, 0xa6, 0x6e,
+    0xe9, 0xf0, 0x56, 0xe0, 0x70, 0xd8, 0x87, 0xdd, 0x45, 0x68, 0x6c, 0xd3, 0xb2, 0x5e, 0xf0, 0x82,
+    0x5c, 0x8b, 0xfa, 0xb0, 0x5c, 0x74, 0x64, 0x9f, 0x8c, 0xb3, 0x60, 0x7f, 0x90, 0x1f, 0x65, 0x7a,
+    0x36, 0xbc, 0x53, 0x7c, 0x2d, 0x26, 0xeb, 0x6c, 0xb5, 0xf5, 0xaa, 0xc1, 0x08, 0xbb, 0x36, 0xa3,
+    0x03, 0x45, 0x12, 0xaf, 0x0f, 0xef, 0x82, 0x56, 0x74, 0x7e, 0x2d, 0x92, 0x9a, 0xcc, 0xf6, 0x4e,
+    0x76, 0xb6, 0xaf, 0x01, 0x2c, 0x9c, 0x10, 0x0b, 0x20, 0x23, 0x5b, 0xd7, 0x30, 0x1a, 0xdc, 0x09,
+    0xb4, 0xe4, 0x80, 0x95, 0x63, 0x46, 0xc0, 0xd9, 0x80, 0xbf, 0x1c, 0xf8, 0xda, 0xd5, 0xfb, 0xc4,
+    0xf8, 0x6a, 0x90, 0x29, 0x96, 0x6b, 0x06, 0x44, 0xd7, 0x13, 0x9c, 0x14, 0x08, 0xb3, 0x4f, 0x39,
+    0xff, 0xfb, 0x9d, 0x47, 0x11, 0xfc, 0x4e, 0x30, 0x63, 0xea, 0x2b, 0x61, 0x34, 0x1b, 0x13, 0x17,
+    0xc9, 0x31, 0x41, 0x8c, 0x4e, 0x09, 0xf2, 0xb9, 0x79, 0x03, 0x5d, 0x9b, 0xfa, 0x68, 0xe2, 0xe2,
+    0x29, 0xa6, 0x30, 0xed, 0x31, 0x92, 0xee, 0xd8, 0x13, 0xdd, 0x06, 0x83, 0xef, 0x0f, 0x94, 0x07,
+    0x2a, 0x49, 0x94, 0x6d, 0x22, 0xcd, 0x71, 0xa5, 0xdc, 0x50, 0x7a, 0x97, 0xab, 0x29, 0x08, 0x0c,
+    0x10, 0xe8, 0x56, 0xa0, 0xf7, 0x7a, 0xd0, 0xfe, 0x08, 0xea, 0x1f, 0x64, 0x38, 0x69, 0xe1, 0xcc,
+    0xc7, 0x0b, 0x32, 0x83, 0xdf, 0x54, 0x41, 0x53, 0xf5, 0xf5, 0xbb, 0xea, 0xb7, 0x03, 0x21, 0xb8,
+    0xa8, 0x2c, 0xba, 0x1b, 0x22, 0xea, 0x6d, 0xb2, 0x29, 0x2e, 0x5e, 0x82, 0x40, 0x35, 0x50, 0x83,
+    0x46, 0xc8, 0xe9, 0x95, 0xcf, 0xdd, 0x4a, 0x06, 0xed, 0xeb, 0x7c, 0x55, 0xd5, 0x88, 0x92, 0xb1,
+    0x6a, 0x62, 0x65, 0xa8, 0x16, 0x9e, 0x6f, 0x86, 0x6a, 0xf2, 0x9c, 0x11, 0x83, 0x04, 0x2a, 0x6b,
+    0xcd, 0x03, 0x88, 0xd4, 0xd8, 0xa4, 0x30, 0xea, 0x95, 0x6b, 0x81, 0x05, 0x39, 0x06, 0x6c, 0x3a,
+    0x13, 0x24, 0x7b, 0xff, 0xe2, 0x2b, 0x2e, 0xf0, 0x99, 0x96, 0x5a, 0xce, 0xb2, 0x79, 0x2f, 0x2b,
+    0x46, 0x96, 0xbe, 0x86, 0xc1, 0x42, 0xc8, 0x73, 0x18, 0xe3, 0xf4, 0x28, 0x93, 0xb0, 0x50, 0x39,
+    0x68, 0x39, 0xe2, 0x55, 0x43, 0x9c, 0xe3, 0x32, 0xd2, 0xb1, 0x92, 0xf8, 0x0e, 0x38, 0x32, 0x21,
+    0xfa, 0x44, 0xea, 0xe7, 0xf6, 0x60, 0xba, 0xaf, 0x24, 0x3f, 0x57, 0x4b, 0xcd, 0xac, 0x6b, 0x15,
+    0xe7, 0x5e, 0x9e, 0xde, 0x26, 0x23, 0x58, 0x2c, 0x45, 0xad, 0x2c, 0xc8, 0x57, 0x2d, 0x3e, 0xda,
+    0xc6, 0x93, 0xe9, 0x10, 0x84, 0x32, 0x86, 0x6c, 0x81, 0x1d, 0xa2, 0x9e, 0x1e, 0x63, 0xd8, 0x24,
+    0xbe, 0x4e, 0xaa, 0x70, 0x34, 0xde, 0x43, 0x18, 0x59, 0x84, 0xa9, 0x67, 0xe0, 0xb1, 0x10, 0x14,
+    0x16, 0xb9, 0xcb, 0xe6, 0xea, 0x81, 0x78, 0x77, 0x44, 0xac, 0x28, 0x2b, 0x9b, 0x12, 0x66, 0xf9,
+    0x35, 0x84, 0x5d, 0x4b, 0x8b, 0x44, 0x36, 0x84, 0x0a, 0x46, 0xc1, 0xe6, 0x1a, 0x58, 0x62, 0x89,
+    0x66, 0xca, 0xb7, 0xdc, 0xb6, 0xd5, 0x93, 0x75, 0x69, 0xab, 0xb1, 0xe7, 0xb1, 0xf9, 0x89, 0xd2,
+    0xa4, 0xa2, 0xf5, 0xc9, 0xf2, 0x98, 0x5e, 0x30, 0x94, 0xce, 0x59, 0xd5, 0x71, 0x35, 0xce, 0x6b,
+    0xba, 0x44, 0x3d, 0x41, 0x84, 0x41, 0xc6, 0x2a, 0x2e, 0x21, 0x5d, 0x35, 0xf3, 0x4b, 0x67, 0x81,
+    0x2a, 0xc1, 0x68, 0xfb, 0xe7, 0x1b, 0x32, 0x57, 0x4f, 0x13, 0x42, 0x07, 0xfd, 0x12, 0xb4, 0x46,
+    0x67, 0xc3, 0x57, 0x10, 0x90, 0x86, 0xaa, 0x99, 0x80, 0x43, 0xa8, 0x63, 0xb5, 0x20, 0xff, 0x83,
+    0xe7, 0x1f, 0x3e, 0xfa, 0x08, 0xc9, 0xb9, 0x47, 0x80, 0x41, 0xf0, 0xbe, 0xdf, 0x87, 0xe8, 0xe6,
+    0x9a, 0x57, 0x59, 0x2d, 0x86, 0xca, 0x28, 0x69, 0x5f, 0xe6, 0x71, 0x53, 0xaf, 0x50, 0x3c, 0x6c,
+    0xe4, 0xe8, 0xc8, 0xad, 0x44, 0x3f, 0x15, 0x2a, 0x99, 0x93, 0x80, 0xa1, 0xdd, 0xf9, 0x8c, 0xa3,
+    0xac, 0x00, 0x3a, 0xcd, 0x2b, 0x87, 0xd5, 0xa3, 0xe2, 0x3b, 0xb9, 0xa2, 0xb2, 0xb2, 0x2b, 0xfe,
+    0xd1, 0x70, 0x27, 0xb5, 0xf0, 0x4c, 0x71, 0x7e, 0x98, 0x41, 0x6d, 0xb8, 0xd0, 0x25, 0x3f, 0x33,
+    0xb3, 0x1f, 0x57, 0xca, 0x7f, 0x24, 0xc3, 0x80, 0xa0, 0x0c, 0x3b, 0x2f, 0xa4, 0xbe, 0x46, 0xe6,
+    0xb3, 0x4c, 0x77, 0xc5, 0xcb, 0xc4, 0xde, 0x3d, 0x94, 0x0f, 0xb7, 0x42, 0xe6, 0x18, 0xca, 0x1b,
+    0x20, 0xc8, 0x60, 0x1b, 0xa5, 0x9b, 0xaa, 0x27, 0xb8, 0xe4, 0x26, 0x67, 0x81, 0xcf, 0x83, 0x5f,
+    0x2c, 0x94, 0xd1, 0x27, 0xa8, 0x3c, 0xf3, 0xd5, 0x4f, 0x17, 0xca, 0xa8, 0xa7, 0x2e, 0xd5, 0xd5,
+    0x5e, 0x16, 0xbf, 0xa0, 0xa3, 0x05, 0x7b, 0xb4, 0xa5, 0x35, 0x95, 0x50, 0xcc, 0xc7, 0x2b, 0x31,
+    0x63, 0x0e, 0xd4, 0xd0, 0x44, 0x1b, 0x33, 0x5f, 0x3d, 0x3f, 0x1c, 0x64, 0x9c, 0xaf, 0x5b, 0x45,
+    0x6a, 0xaf, 0xa5, 0x79, 0x18, 0xdc, 0xe5, 0x1e, 0x34, 0xcf, 0x7e, 0xb4, 0xd2, 0xe4, 0x10, 0x3a,
+    0xb0, 0xcd, 0x84, 0x99, 0x07, 0x68, 0xc9, 0x54, 0x97, 0xe6, 0x83, 0x68, 0xa2, 0xfe, 0xee, 0xe2,
+    0xec, 0x73, 0xc3, 0x53, 0x3f, 0x8e, 0xa9, 0xe8, 0x65, 0xfd, 0xe0, 0x4f, 0x35, 0x4f, 0xa8, 0xc9,
+    0xb8, 0xea, 0x99, 0x08, 0x5c, 0x96, 0xd9, 0x71, 0xa0, 0x8a, 0x1c, 0xeb, 0xdf, 0xcb, 0xa0, 0xe1,
+    0xc4, 0x9f, 0x23, 0x48, 0xc5, 0x89, 0x0b, 0x11, 0x01, 0xc5, 0x06, 0x7a, 0x79, 0x4f, 0x17, 0xb5,
+    0xa0, 0xbe, 0x48, 0x31, 0xd7, 0x45, 0x2a, 0x84, 0x08, 0x8f, 0x30, 0xb8, 0x58, 0x3d, 0x79, 0x22,
+    0x0a, 0x6a, 0x42, 0xbc, 0x0e, 0x6e, 0xea, 0x7d, 0x28, 0xec, 0xaa, 0x90, 0xf2, 0x89, 0xac, 0xc4,
+    0xc2, 0xae, 0x96, 0x3c, 0x61, 0x48, 0x7c, 0xf6, 0x75, 0x66, 0x08, 0x27, 0x22, 0x77, 0x6f, 0xf1,
+    0xe4, 0x4a, 0x78, 0xd2, 0xb1, 0xdf, 0x08, 0x9e, 0x59, 0xd9, 0x6f, 0x04, 0xbf, 0x4c, 0xfa, 0x1f,
+    0xb0, 0x57, 0x5b, 0x2e, 0xaa, 0x34, 0x00, 0x00,
+};
+
+#endif
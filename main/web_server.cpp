@@ -2,20 +2,49 @@
 #include "config.h"
 #include "credentials.h"
 #include "shared_data.h"
+#include "perf_monitor.h"
+#include "sensor_schema.h"
+#include "rolling_stats.h"
+#include "json_writer.h"
+#include "chunked_print.h"
+#include "buffer_manager.h"
+#include "uplink_queue.h"
+#include "web_page.h"
 #include <Arduino.h>
+#include <freertos/semphr.h>
 #include <mbedtls/base64.h>
+#include <mbedtls/sha1.h>
+#ifdef WIFI_FALLBACK_ENABLED
+#include <lwip/sockets.h>
+#endif
 
 #ifdef WEB_SERVER_ENABLED
 
+#define WEB_STRINGIFY_(x) #x
+#define WEB_STRINGIFY(x) WEB_STRINGIFY_(x)
+
 // HTTP Headers for caching control
+// The page body is MAIN_PAGE_GZIP from web_page.h (tools/build_web_page.py)
 const char HTTP_CACHE_HEADER[] PROGMEM = 
     "HTTP/1.1 200 OK\r\n"
-    "Content-Type: text/html\r\n"
-    "Cache-Control: public, max-age=3600\r\n"  // Cache HTML for 1 hour
+    "Content-Type: text/html; charset=UTF-8\r\n"
+    "Content-Encoding: gzip\r\n"
+    "Content-Length: " WEB_STRINGIFY(MAIN_PAGE_GZIP_LENGTH) "\r\n"
+    "ETag: " MAIN_PAGE_ETAG "\r\n"
+    "Vary: Accept-Encoding\r\n"
+    "Cache-Control: private, max-age=3600\r\n"  // Cache HTML for 1 hour
     "X-Frame-Options: DENY\r\n"  // Security: prevent clickjacking
     "X-Content-Type-Options: nosniff\r\n"  // Security: prevent MIME sniffing
     "Connection: close\r\n\r\n";
 
+// If-None-Match matched; the browser's copy is current
+const char HTTP_NOT_MODIFIED[] PROGMEM = 
+    "HTTP/1.1 304 Not Modified\r\n"
+    "ETag: " MAIN_PAGE_ETAG "\r\n"
+    "Vary: Accept-Encoding\r\n"
+    "Cache-Control: private, max-age=3600\r\n"
+    "Connection: close\r\n\r\n";
+
 const char HTTP_NO_CACHE_HEADER[] PROGMEM = 
     "HTTP/1.1 200 OK\r\n"
     "Content-Type: application/json\r\n"
@@ -26,6 +55,16 @@ const char HTTP_NO_CACHE_HEADER[] PROGMEM =
     "X-Content-Type-Options: nosniff\r\n"  // Security header
     "Connection: close\r\n\r\n";
 
+// Buffered-record replay; the body length is unknown up front
+const char HTTP_CHUNKED_JSON_HEADER[] PROGMEM = 
+    "HTTP/1.1 200 OK\r\n"
+    "Content-Type: application/json\r\n"
+    "Transfer-Encoding: chunked\r\n"
+    "Access-Control-Allow-Origin: http://localhost\r\n"
+    "Cache-Control: no-cache, no-store, must-revalidate\r\n"
+    "X-Content-Type-Options: nosniff\r\n"
+    "Connection: close\r\n\r\n";
+
 const char HTTP_UNAUTHORIZED[] PROGMEM = 
     "HTTP/1.1 401 Unauthorized\r\n"
     "WWW-Authenticate: Basic realm=\"Smart Sensor System\"\r\n"
@@ -42,337 +81,90 @@ const char HTTP_FORBIDDEN[] PROGMEM =
     "<!DOCTYPE html><html><head><title>403 Forbidden</title></head>"
     "<body><h1>403 Forbidden</h1><p>Rate limit exceeded.</p></body></html>";
 
-// Static HTML content (without HTTP headers - we'll add them separately)
-const char MAIN_PAGE[] PROGMEM = R"=====(<!DOCTYPE html>
-<html lang="fa">
-<head>
-    <meta charset="UTF-8">
-    <meta name="viewport" content="width=device-width, initial-scale=1.0">
-    <title>Air Quality Monitoring System</title>
-    <link href="https://fonts.googleapis.com/css2?family=Inter:wght@300;400;500;600&display=swap" rel="stylesheet">
-    <link href="https://cdn.jsdelivr.net/gh/rastikerdar/vazir-font@v30.1.0/dist/font-face.css" rel="stylesheet">
-    <link rel="stylesheet" href="https://cdnjs.cloudflare.com/ajax/libs/font-awesome/6.4.0/css/all.min.css">
-    <style>
-        :root {
-            --primary: #2E7D32;
-            --primary-light: #4CAF50;
-            --primary-dark: #1B5E20;
-            --secondary: #0277BD;
-            --accent: #FF9800;
-            --background: #F5F7FA;
-            --card-bg: #FFFFFF;
-            --text-primary: #263238;
-            --text-secondary: #546E7A;
-            --border: #E0E0E0;
-            --success: #4CAF50;
-            --warning: #FF9800;
-            --danger: #F44336;
-        }
-        
-        * {
-            margin: 0;
-            padding: 0;
-            box-sizing: border-box;
-        }
-        
-        body {
-            font-family: 'Inter', 'Segoe UI', Tahoma, Geneva, Verdana, sans-serif;
-            margin: 0;
-            padding: 20px;
-            background: var(--background);
-            color: var(--text-primary);
-            line-height: 1.6;
-        }
-        
-        .container {
-            max-width: 1200px;
-            margin: 0 auto;
-        }
-        
-        .header {
-            text-align: center;
-            margin-bottom: 30px;
-            padding: 20px;
-        }
-        
-        .header h1 {
-            font-family: 'Vazir', 'Inter', sans-serif;
-            font-weight: 600;
-            color: var(--primary-dark);
-            margin-bottom: 10px;
-            font-size: 2.2rem;
-        }
-        
-        .status {
-            padding: 10px 20px;
-            border-radius: 20px;
-            background: linear-gradient(135deg, var(--primary), var(--primary-light));
-            color: white;
-            display: inline-block;
-            margin-bottom: 10px;
-            font-weight: 500;
-        }
-        
-        .sensor-grid {
-            display: grid;
-            grid-template-columns: repeat(auto-fit, minmax(300px, 1fr));
-            gap: 25px;
-            margin-bottom: 30px;
-        }
-        
-        .sensor-card {
-            background: var(--card-bg);
-            padding: 25px;
-            border-radius: 12px;
-            box-shadow: 0 4px 12px rgba(0, 0, 0, 0.08);
-            transition: transform 0.3s ease, box-shadow 0.3s ease;
-            border-top: 4px solid var(--primary);
-        }
-        
-        .sensor-card:hover {
-            transform: translateY(-5px);
-            box-shadow: 0 8px 16px rgba(0, 0, 0, 0.12);
-        }
-        
-        .sensor-header {
-            font-size: 1.2rem;
-            font-weight: 600;
-            margin-bottom: 20px;
-            color: var(--primary-dark);
-            display: flex;
-            align-items: center;
-            padding-bottom: 12px;
-            border-bottom: 2px solid var(--border);
-        }
-        
-        .sensor-header i {
-            margin-right: 10px;
-            color: var(--primary);
-            font-size: 1.4rem;
-        }
-        
-        .data-row {
-            display: flex;
-            justify-content: space-between;
-            align-items: center;
-            margin: 12px 0;
-            padding: 12px 15px;
-            background: rgba(76, 175, 80, 0.05);
-            border-radius: 8px;
-            border-left: 3px solid var(--primary-light);
-        }
-        
-        .data-label {
-            font-weight: 500;
-            color: var(--text-primary);
-            display: flex;
-            align-items: center;
-        }
-        
-        .data-label i {
-            margin-right: 8px;
-            color: var(--secondary);
-        }
-        
-        .data-value {
-            font-weight: 600;
-            color: var(--primary-dark);
-            font-size: 1.1rem;
-        }
-        
-        .footer {
-            text-align: center;
-            margin-top: 30px;
-            padding: 20px;
-            color: var(--text-secondary);
-            border-top: 1px solid var(--border);
-        }
-        
-        .footer div {
-            margin: 5px 0;
-        }
-        
-        @media (max-width: 768px) {
-            .sensor-grid {
-                grid-template-columns: 1fr;
-            }
-            .header h1 {
-                font-size: 1.8rem;
-            }
-        }
-    </style>
-</head>
-<body>
-    <div class="container">
-        <div class="header">
-            <h1><i class="fas fa-microchip"></i> سیستم مانیتورینگ کیفیت هوا</h1>
-            <div class="status" id="networkStatus">Connecting...</div>
-        </div>
-        
-        <div class="sensor-grid">
-            <!-- ZE40 TVOC Sensor -->
-            <div class="sensor-card">
-                <div class="sensor-header">
-                    <i class="fas fa-wind"></i> ZE40 TVOC Sensor
-                </div>
-                <div class="data-row">
-                    <span class="data-label">
-                        <i class="fas fa-bolt"></i> DAC Voltage:
-                    </span>
-                    <span class="data-value" id="dacVoltage">-- V</span>
-                </div>
-                <div class="data-row">
-                    <span class="data-label">
-                        <i class="fas fa-tachometer-alt"></i> TVOC PPM:
-                    </span>
-                    <span class="data-value" id="dacPPM">-- ppm</span>
-                </div>
-            </div>
-            
-            <!-- ZPHS01B Air Quality -->
-            <div class="sensor-card">
-                <div class="sensor-header">
-                    <i class="fas fa-cloud"></i> ZPHS01B Air Quality
-                </div>
-                <div class="data-row">
-                    <span class="data-label">
-                        <i class="fas fa-smog"></i> PM2.5:
-                    </span>
-                    <span class="data-value" id="pm25Value">-- μg/m³</span>
-                </div>
-                <div class="data-row">
-                    <span class="data-label">
-                        <i class="fas fa-smog"></i> PM10:
-                    </span>
-                    <span class="data-value" id="pm10Value">-- μg/m³</span>
-                </div>
-                <div class="data-row">
-                    <span class="data-label">
-                        <i class="fas fa-industry"></i> CO2:
-                    </span>
-                    <span class="data-value" id="co2Value">-- ppm</span>
-                </div>
-                <div class="data-row">
-                    <span class="data-label">
-                        <i class="fas fa-thermometer-half"></i> Temperature:
-                    </span>
-                    <span class="data-value" id="tempValue">-- °C</span>
-                </div>
-                <div class="data-row">
-                    <span class="data-label">
-                        <i class="fas fa-tint"></i> Humidity:
-                    </span>
-                    <span class="data-value" id="humidityValue">-- %</span>
-                </div>
-            </div>
-            
-            <!-- MR007 Combustible Gas -->
-            <div class="sensor-card">
-                <div class="sensor-header">
-                    <i class="fas fa-fire"></i> MR007 Combustible Gas
-                </div>
-                <div class="data-row">
-                    <span class="data-label">
-                        <i class="fas fa-exclamation-triangle"></i> LEL:
-                    </span>
-                    <span class="data-value" id="mr007LEL">-- %</span>
-                </div>
-                <div class="data-row">
-                    <span class="data-label">
-                        <i class="fas fa-bolt"></i> Voltage:
-                    </span>
-                    <span class="data-value" id="mr007Voltage">-- V</span>
-                </div>
-            </div>
-            
-            <!-- ME4-SO2 Sulfur Dioxide -->
-            <div class="sensor-card">
-                <div class="sensor-header">
-                    <i class="fas fa-skull-crossbones"></i> ME4-SO2 Sulfur Dioxide
-                </div>
-                <div class="data-row">
-                    <span class="data-label">
-                        <i class="fas fa-vial"></i> SO2 Concentration:
-                    </span>
-                    <span class="data-value" id="so2Concentration">-- ppm</span>
-                </div>
-                <div class="data-row">
-                    <span class="data-label">
-                        <i class="fas fa-bolt"></i> Current:
-                    </span>
-                    <span class="data-value" id="so2Current">-- μA</span>
-                </div>
-            </div>
-        </div>
-        
-        <div class="footer">
-            <div>IP Address: <span id="ipAddress">--</span></div>
-            <div>Last Update: <span id="lastUpdate">--</span></div>
-        </div>
-    </div>
-
-    <script>
-        function updateSensorData() {
-            fetch('/data')
-                .then(response => {
-                    if (!response.ok) throw new Error('Network error');
-                    return response.json();
-                })
-                .then(data => {
-                    // Update network info
-                    document.getElementById('ipAddress').textContent = data.ip_address;
-                    document.getElementById('lastUpdate').textContent = new Date().toLocaleTimeString();
-                    
-                    const statusElem = document.getElementById('networkStatus');
-                    statusElem.textContent = 'Network: ' + data.network_mode.toUpperCase();
-                    
-                    // ZE40 Data
-                    document.getElementById('dacVoltage').textContent = data.dac_voltage.toFixed(2) + ' V';
-                    document.getElementById('dacPPM').textContent = data.dac_ppm.toFixed(3) + ' ppm';
-                    
-                    // ZPHS01B Data
-                    if (data.air_quality) {
-                        document.getElementById('pm25Value').textContent = data.air_quality.pm25 + ' μg/m³';
-                        document.getElementById('pm10Value').textContent = data.air_quality.pm10 + ' μg/m³';
-                        document.getElementById('co2Value').textContent = data.air_quality.co2 + ' ppm';
-                        document.getElementById('tempValue').textContent = data.air_quality.temperature.toFixed(1) + ' °C';
-                        document.getElementById('humidityValue').textContent = data.air_quality.humidity + ' %';
-                    }
-                    
-                    // MR007 Data
-                    if (data.mr007) {
-                        document.getElementById('mr007LEL').textContent = data.mr007.lel_concentration.toFixed(1) + ' %';
-                        document.getElementById('mr007Voltage').textContent = data.mr007.voltage.toFixed(3) + ' V';
-                    }
-                    
-                    // ME4-SO2 Data
-                    if (data.me4_so2) {
-                        document.getElementById('so2Concentration').textContent = data.me4_so2.so2_concentration.toFixed(2) + ' ppm';
-                        document.getElementById('so2Current').textContent = data.me4_so2.current_ua.toFixed(2) + ' μA';
-                    }
-                })
-                .catch(error => {
-                    console.error('Error fetching data:', error);
-                    document.getElementById('networkStatus').textContent = 'Connection Error';
-                });
-        }
+const char HTTP_HEADERS_TOO_LARGE[] PROGMEM = 
+    "HTTP/1.1 431 Request Header Fields Too Large\r\n"
+    "Content-Type: text/plain\r\n"
+    "Connection: close\r\n\r\n"
+    "431 Request Header Fields Too Large\r\n";
+
+// Missing or malformed query parameters; the reason follows
+const char HTTP_BAD_REQUEST[] PROGMEM = 
+    "HTTP/1.1 400 Bad Request\r\n"
+    "Content-Type: text/plain\r\n"
+    "Connection: close\r\n\r\n";
 
-        // Initial update and set interval
-        updateSensorData();
-        setInterval(updateSensorData, 2000);
-    </script>
-</body>
-</html>
-)=====";
+// /ws without a usable RFC 6455 handshake
+const char HTTP_UPGRADE_REQUIRED[] PROGMEM = 
+    "HTTP/1.1 426 Upgrade Required\r\n"
+    "Upgrade: websocket\r\n"
+    "Sec-WebSocket-Version: 13\r\n"
+    "Content-Type: text/plain\r\n"
+    "Connection: close\r\n\r\n"
+    "426 WebSocket handshake expected\r\n";
+
+// Every connection slot is taken
+const char HTTP_BUSY[] PROGMEM = 
+    "HTTP/1.1 503 Service Unavailable\r\n"
+    "Retry-After: 1\r\n"
+    "Content-Type: text/plain\r\n"
+    "Connection: close\r\n\r\n"
+    "503 Server busy\r\n";
+
+// RFC 6455
+static const char WS_GUID[] = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+static const uint8_t WS_OP_TEXT = 0x1;
+static const uint8_t WS_OP_BINARY = 0x2;
+static const uint8_t WS_OP_CLOSE = 0x8;
+static const uint8_t WS_OP_PING = 0x9;
+static const uint8_t WS_OP_PONG = 0xA;
+static const uint8_t WS_FIN = 0x80;
+static const uint8_t WS_MASKED = 0x80;
+static const size_t WS_MAX_CONTROL_PAYLOAD = 125;
+static const size_t WS_HEADER_ROOM = 4;     // Pushed frames stay under 64 KB
+static const uint16_t WS_CLOSE_PROTOCOL_ERROR = 1002;
+static const uint16_t WS_CLOSE_TOO_BIG = 1009;
+
+// Incoming frames are assembled in WebConnection::line
+static_assert(WEB_REQUEST_LINE_SIZE >= 2 + 4 + WS_MAX_CONTROL_PAYLOAD,
+              "WEB_REQUEST_LINE_SIZE must hold one masked control frame");
+static_assert(WS_FRAME_BUFFER_SIZE - WS_HEADER_ROOM <= 0xFFFF,
+              "WS_FRAME_BUFFER_SIZE must fit a 16-bit frame length");
 
 SensorWebServer webServer;
 
+#ifdef ETHERNET_ENABLED
+// Listener, uplink, DNS/DHCP and the 503 reply; see the class comment
+static const int ETHERNET_RESERVED_SOCKETS = 4;
+static_assert(MAX_CONCURRENT_CONNECTIONS + ETHERNET_RESERVED_SOCKETS <= MAX_SOCK_NUM,
+              "MAX_CONCURRENT_CONNECTIONS leaves too few W5500 sockets for the listener, uplink and DNS");
+#endif
+
+// Open dashboards never hold every slot: /data, /history and the page
+// must still be served (the dashboard polls /data when /ws is refused)
+static_assert(WEB_MAX_WEBSOCKETS < MAX_CONCURRENT_CONNECTIONS,
+              "WEB_MAX_WEBSOCKETS must leave connection slots for HTTP requests");
+
+// Slots are claimed from the Ethernet task and, on WiFi, the sensor task
+static portMUX_TYPE slotMux = portMUX_INITIALIZER_UNLOCKED;
+
+// pushUpdates() runs on both of those tasks too. The shared push state
+// (wsCurrent, wsPrevious, wsPushSeq and the counters) is only touched
+// under this mutex. Frames are encoded under it into the task's own
+// wsFrame buffer and written after it is released.
+static SemaphoreHandle_t pushMutex = nullptr;
+
+struct PushLock {
+    PushLock() { if (pushMutex) xSemaphoreTake(pushMutex, portMAX_DELAY); }
+    ~PushLock() { if (pushMutex) xSemaphoreGive(pushMutex); }
+};
+
 void SensorWebServer::init() {
     DEBUG_PRINTLN("Initializing web server...");
     
     // Initialize authentication manager
     WebAuthManager::init();
     lastRateLimitCleanup = millis();
+    if (pushMutex == nullptr) pushMutex = xSemaphoreCreateMutex();
     
     #ifdef ETHERNET_ENABLED
     // Allocate on heap with placement new to control construction timing
@@ -414,59 +206,497 @@ void SensorWebServer::init() {
     #endif
 }
 
-void SensorWebServer::handleEthernetClient() {
+bool SensorWebServer::handleEthernetClient() {
     #ifdef ETHERNET_ENABLED
     if (ethServer == nullptr) {
         DEBUG_PRINTLN("ERROR: ethServer is nullptr!");
-        return;
+        return false;
     }
     
-    if (activeClients >= MAX_CONCURRENT_CONNECTIONS) {
-        DEBUG_PRINTLN("Max clients reached");
-        return;
+    // Take every socket that connected since the last pass
+    while (EthernetClient client = ethServer->accept()) {
+        WebConnection* conn = claimSlot(true);
+        if (conn == nullptr) {
+            client.print(FPSTR(HTTP_BUSY));
+            client.stop();
+            refused++;
+            continue;
+        }
+        conn->ethClient = client;
+        conn->client = &conn->ethClient;
+        startConnection(*conn);
     }
     
-    EthernetClient client = ethServer->available();
+    pushUpdates(true);
     
-    if (client) {
-        DEBUG_PRINTLN("→ Client connected!");
-        IPAddress ip = client.remoteIP();
-        String clientIP = String(ip[0]) + "." + String(ip[1]) + "." + 
-                         String(ip[2]) + "." + String(ip[3]);
-        DEBUG_PRINTF("  Client IP: %s\n", clientIP.c_str());
-        
-        activeClients++;
-        handleHTTPRequest(client, clientIP);
-        client.stop();
-        activeClients--;
-        DEBUG_PRINTLN("← Client disconnected");
+    bool busy = false;
+    for (WebConnection& conn : connections) {
+        if (conn.state != WebConnection::FREE && conn.ethernet) {
+            serviceConnection(conn);
+            // Open WebSockets alone don't need the fast poll
+            busy = busy || (conn.state != WebConnection::FREE && conn.state != WebConnection::WEBSOCKET);
+        }
     }
+    return busy;
+    #else
+    return false;
     #endif
 }
 
-void SensorWebServer::handleWiFiClient() {
+bool SensorWebServer::handleWiFiClient() {
     #ifdef WIFI_FALLBACK_ENABLED
     if (wifiServer == nullptr) {
+        return false;
+    }
+    
+    while (WiFiClient client = wifiServer->accept()) {
+        WebConnection* conn = claimSlot(false);
+        if (conn == nullptr) {
+            client.print(FPSTR(HTTP_BUSY));
+            client.stop();
+            refused++;
+            continue;
+        }
+        conn->wifiClient = client;
+        conn->client = &conn->wifiClient;
+        startConnection(*conn);
+    }
+    
+    pushUpdates(false);
+    
+    bool busy = false;
+    for (WebConnection& conn : connections) {
+        if (conn.state != WebConnection::FREE && !conn.ethernet) {
+            serviceConnection(conn);
+            // Open WebSockets alone don't need the fast poll
+            busy = busy || (conn.state != WebConnection::FREE && conn.state != WebConnection::WEBSOCKET);
+        }
+    }
+    return busy;
+    #else
+    return false;
+    #endif
+}
+
+WebConnection* SensorWebServer::claimSlot(bool ethernet) {
+    WebConnection* slot = nullptr;
+    
+    // Ethernet and WiFi are polled from different tasks
+    portENTER_CRITICAL(&slotMux);
+    for (WebConnection& conn : connections) {
+        if (conn.state == WebConnection::FREE) {
+            conn.ethernet = ethernet;
+            conn.state = WebConnection::READING;
+            slot = &conn;
+            activeClients++;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&slotMux);
+    
+    return slot;
+}
+
+void SensorWebServer::startConnection(WebConnection& conn) {
+    IPAddress ip;
+    #ifdef ETHERNET_ENABLED
+    if (conn.ethernet) ip = conn.ethClient.remoteIP();
+    #endif
+    #ifdef WIFI_FALLBACK_ENABLED
+    if (!conn.ethernet) ip = conn.wifiClient.remoteIP();
+    #endif
+    snprintf(conn.ip, sizeof(conn.ip), "%u.%u.%u.%u", ip[0], ip[1], ip[2], ip[3]);
+    
+    conn.acceptedAt = millis();
+    conn.lastProgress = conn.acceptedAt;
+    conn.lineLength = 0;
+    conn.headerBytes = 0;
+    conn.requestLineSeen = false;
+    conn.method[0] = '\0';
+    conn.path[0] = '\0';
+    conn.query[0] = '\0';
+    conn.authorization[0] = '\0';
+    conn.apiToken[0] = '\0';
+    conn.etagMatches = false;
+    conn.wsUpgrade = false;
+    conn.wsProtocol = WebConnection::WS_NONE;
+    conn.wsVersion = 0;
+    conn.wsKey[0] = '\0';
+    conn.wsSeq = 0;
+    conn.routed = false;
+    conn.sent = 0;
+    conn.entries = 0;
+    
+    accepted++;
+    if ((uint32_t)activeClients > peakClients) peakClients = activeClients;
+    DEBUG_PRINTF("→ Client connected: %s (%d open)\n", conn.ip, activeClients);
+}
+
+void SensorWebServer::closeConnection(WebConnection& conn) {
+    conn.client->stop();
+    
+    if (conn.state == WebConnection::WEBSOCKET) {
+        DEBUG_PRINTF("WebSocket closed: %s\n", conn.ip);
+        portENTER_CRITICAL(&slotMux);
+        webSockets--;
+        portEXIT_CRITICAL(&slotMux);
+    } else if (conn.routed) {
+        uint32_t elapsed = millis() - conn.acceptedAt;
+        totalResponseMs += elapsed;
+        if (elapsed > maxResponseMs) maxResponseMs = elapsed;
+        
+        if (conn.state == WebConnection::SENDING_PAGE && conn.sent == MAIN_PAGE_GZIP_LENGTH) {
+            pagesSent++;
+            totalPageMs += elapsed;
+            if (elapsed > maxPageMs) maxPageMs = elapsed;
+        }
+    }
+    
+    portENTER_CRITICAL(&slotMux);
+    conn.state = WebConnection::FREE;
+    activeClients--;
+    portEXIT_CRITICAL(&slotMux);
+    
+    DEBUG_PRINTF("← Client disconnected: %s\n", conn.ip);
+}
+
+void SensorWebServer::serviceConnection(WebConnection& conn) {
+    switch (conn.state) {
+        case WebConnection::READING:
+            readRequest(conn);
+            break;
+        
+        case WebConnection::SENDING_PAGE:
+        case WebConnection::SENDING_BUFFER:
+        case WebConnection::SENDING_HISTORY:
+            continueResponse(conn);
+            break;
+        
+        case WebConnection::WEBSOCKET:
+            readWebSocket(conn);
+            break;
+        
+        default:
+            break;
+    }
+}
+
+void SensorWebServer::readRequest(WebConnection& conn) {
+    Client& client = *conn.client;
+    uint8_t buffer[128];
+    
+    // Whatever has arrived, without waiting for more
+    int available = client.available();
+    while (available > 0 && conn.state == WebConnection::READING) {
+        size_t want = (size_t)available < sizeof(buffer) ? (size_t)available : sizeof(buffer);
+        int n = client.read(buffer, want);
+        if (n <= 0) break;
+        conn.lastProgress = millis();
+        
+        for (int i = 0; i < n && conn.state == WebConnection::READING; i++) {
+            if (++conn.headerBytes > WEB_MAX_HEADER_BYTES) {
+                DEBUG_PRINTF("Request headers from %s too large\n", conn.ip);
+                client.print(FPSTR(HTTP_HEADERS_TOO_LARGE));
+                closeConnection(conn);
+                return;
+            }
+            
+            char c = (char)buffer[i];
+            if (c != '\n') {
+                // Overlong lines are truncated; nothing we read needs their tail
+                if (conn.lineLength < sizeof(conn.line) - 1) conn.line[conn.lineLength++] = c;
+                continue;
+            }
+            
+            if (conn.lineLength > 0 && conn.line[conn.lineLength - 1] == '\r') conn.lineLength--;
+            conn.line[conn.lineLength] = '\0';
+            
+            if (!conn.requestLineSeen) {
+                // Blank lines before the request line are allowed
+                if (conn.lineLength > 0) parseRequestLine(conn);
+            } else if (conn.lineLength == 0) {
+                handleHTTPRequest(conn);
+            } else {
+                parseHeader(conn);
+            }
+            conn.lineLength = 0;
+        }
+        
+        if (conn.state != WebConnection::READING) return;
+        available = client.available();
+    }
+    
+    if (!client.connected()) {
+        DEBUG_PRINTLN("Empty request");
+        closeConnection(conn);
+    } else if (millis() - conn.acceptedAt > WEB_REQUEST_TIMEOUT) {
+        DEBUG_PRINTF("Request from %s timed out\n", conn.ip);
+        timeouts++;
+        closeConnection(conn);
+    }
+}
+
+void SensorWebServer::parseRequestLine(WebConnection& conn) {
+    // "GET /path?query HTTP/1.1"
+    conn.requestLineSeen = true;
+    
+    const char* p = conn.line;
+    size_t n = 0;
+    while (*p && *p != ' ' && n < sizeof(conn.method) - 1) conn.method[n++] = *p++;
+    conn.method[n] = '\0';
+    while (*p && *p != ' ') p++;
+    while (*p == ' ') p++;
+    
+    n = 0;
+    while (*p && *p != ' ' && *p != '?' && n < sizeof(conn.path) - 1) conn.path[n++] = *p++;
+    conn.path[n] = '\0';
+    
+    while (*p && *p != ' ' && *p != '?') p++;
+    if (*p == '?') p++;
+    n = 0;
+    while (*p && *p != ' ' && n < sizeof(conn.query) - 1) conn.query[n++] = *p++;
+    conn.query[n] = '\0';
+}
+
+// Copy the value of name=value from a query string; values are plain
+// identifiers and numbers, so no percent-decoding
+static bool queryParam(const char* query, const char* name, char* out, size_t size) {
+    size_t nameLength = strlen(name);
+    while (*query) {
+        if (strncmp(query, name, nameLength) == 0 && query[nameLength] == '=') {
+            const char* value = query + nameLength + 1;
+            size_t n = 0;
+            while (value[n] && value[n] != '&' && n < size - 1) {
+                out[n] = value[n];
+                n++;
+            }
+            out[n] = '\0';
+            return true;
+        }
+        query = strchr(query, '&');
+        if (query == nullptr) break;
+        query++;
+    }
+    return false;
+}
+
+// Unsigned query parameter; false if present but not a number
+static bool queryNumber(const char* query, const char* name, uint32_t& out) {
+    char text[12];
+    if (!queryParam(query, name, text, sizeof(text))) return true;
+    char* end;
+    unsigned long value = strtoul(text, &end, 10);
+    if (text[0] == '\0' || *end != '\0') return false;
+    out = (uint32_t)value;
+    return true;
+}
+
+// Case-insensitive search for token in a header value
+static bool containsToken(const char* value, const char* token) {
+    size_t n = strlen(token);
+    for (; *value; value++) {
+        if (strncasecmp(value, token, n) == 0) return true;
+    }
+    return false;
+}
+
+void SensorWebServer::parseHeader(WebConnection& conn) {
+    char* colon = strchr(conn.line, ':');
+    if (colon == nullptr) return;
+    *colon = '\0';
+    const char* value = colon + 1;
+    while (*value == ' ' || *value == '\t') value++;
+    
+    if (strcasecmp(conn.line, "Upgrade") == 0) {
+        conn.wsUpgrade = containsToken(value, "websocket");
         return;
     }
+    if (strcasecmp(conn.line, "Sec-WebSocket-Version") == 0) {
+        conn.wsVersion = (uint8_t)atoi(value);
+        return;
+    }
+    if (strcasecmp(conn.line, "Sec-WebSocket-Key") == 0) {
+        size_t n = 0;
+        while (value[n] && value[n] != ' ' && n < sizeof(conn.wsKey) - 1) {
+            conn.wsKey[n] = value[n];
+            n++;
+        }
+        conn.wsKey[n] = '\0';
+        return;
+    }
+    if (strcasecmp(conn.line, "Sec-WebSocket-Protocol") == 0) {
+        // The client lists its choices in order of preference
+        const char* json = strstr(value, "sensors.json");
+        const char* cbor = strstr(value, "sensors.cbor");
+        if (cbor && (!json || cbor < json)) conn.wsProtocol = WebConnection::WS_CBOR;
+        else if (json) conn.wsProtocol = WebConnection::WS_JSON;
+        return;
+    }
+    if (strcasecmp(conn.line, "If-None-Match") == 0) {
+        // A list of tags, possibly weak (W/"..."), or "*"
+        conn.etagMatches = strstr(value, MAIN_PAGE_ETAG) != nullptr || strcmp(value, "*") == 0;
+        return;
+    }
+    
+    char* target = nullptr;
+    if (strcasecmp(conn.line, "Authorization") == 0) {
+        target = conn.authorization;
+    } else if (strcasecmp(conn.line, "X-API-Token") == 0) {
+        target = conn.apiToken;
+    }
+    if (target == nullptr) return;
+    
+    strncpy(target, value, WEB_AUTH_HEADER_SIZE - 1);
+    target[WEB_AUTH_HEADER_SIZE - 1] = '\0';
+}
+
+size_t SensorWebServer::writeRoom(WebConnection& conn) {
+    #ifdef ETHERNET_ENABLED
+    if (conn.ethernet) {
+        // Free space in the W5500 socket buffer; writing more would block
+        int room = conn.ethClient.availableForWrite();
+        return room > 0 ? room : 0;
+    }
+    #endif
+    // lwIP's write() waits until it has queued everything, and there is
+    // no free-space count to ask; one chunk per pass bounds that wait
+    return WEB_WRITE_CHUNK;
+}
+
+void SensorWebServer::continueResponse(WebConnection& conn) {
+    Client& client = *conn.client;
     
-    if (activeClients >= MAX_CONCURRENT_CONNECTIONS) {
+    if (!client.connected()) {
+        closeConnection(conn);
         return;
     }
     
-    WiFiClient client = wifiServer->available();
+    if (writeRoom(conn) < WEB_WRITE_CHUNK) {
+        // The client is not taking data; give the others their turn
+        if (millis() - conn.lastProgress > CONNECTION_TIMEOUT_MS) {
+            DEBUG_PRINTF("Client %s stopped reading, closing\n", conn.ip);
+            timeouts++;
+            closeConnection(conn);
+        }
+        return;
+    }
+    conn.lastProgress = millis();
     
-    if (client) {
-        IPAddress ip = client.remoteIP();
-        String clientIP = String(ip[0]) + "." + String(ip[1]) + "." + 
-                         String(ip[2]) + "." + String(ip[3]);
+    if (conn.state == WebConnection::SENDING_PAGE) {
+        // Flash is memory-mapped, so the socket copies straight from it;
+        // one write fills all the room the W5500 has
+        size_t bytesToSend = MAIN_PAGE_GZIP_LENGTH - conn.sent;
+        size_t room = writeRoom(conn);
+        if (bytesToSend > room) bytesToSend = room;
+        
+        size_t written = client.write(MAIN_PAGE_GZIP + conn.sent, bytesToSend);
+        conn.sent += written;
+        pageWireBytes += written;
         
-        activeClients++;
-        handleHTTPRequest(client, clientIP);
-        client.stop();
-        activeClients--;
+        if (conn.sent >= MAIN_PAGE_GZIP_LENGTH) {
+            DEBUG_PRINTF("✓ HTML page sent in %lu ms (will be cached by browser)\n",
+                         (unsigned long)(millis() - conn.acceptedAt));
+            closeConnection(conn);
+        }
+        return;
+    }
+    
+    if (conn.state == WebConnection::SENDING_HISTORY) {
+        continueHistory(conn, client);
+        return;
+    }
+    
+    // SENDING_BUFFER: one record per pass, as its own chunk(s)
+    ChunkedPrint body(client);
+    char chunk[JSON_STREAM_CHUNK_SIZE];
+    JsonWriter writer(body, chunk, sizeof(chunk));
+    if (conn.sent == 0) writer.rawContinue("[", 1);
+    
+    // Each pass starts a fresh writer, so the separator is added by hand
+    if (BufferManager::hasNext(conn.cursor)) {
+        if (conn.entries > 0) writer.rawContinue(",", 1);
+        BufferManager::writeNext(conn.cursor, writer);
+        conn.entries++;
+    }
+    bool done = !BufferManager::hasNext(conn.cursor);
+    if (done) writer.rawContinue("]", 1);
+    writer.flush();
+    conn.sent += body.bytesWritten();
+    
+    if (done) {
+        body.finish();
+        DEBUG_PRINTF("✓ Streamed %u buffered entries (%u bytes)\n",
+                     (unsigned)conn.entries, (unsigned)conn.sent);
+        closeConnection(conn);
+    }
+}
+
+// Longest point continueHistory() writes, its separator included:
+// ",[t_ms,min,max,avg,count]" or ",[t_ms,value]" with every number at its widest
+static size_t historyPointMaxLength(HistoryQuery::Mode mode, uint8_t decimals) {
+    // A sign and nine digits (1e9 and up are null), then the decimals
+    size_t number = 10 + (decimals > 0 ? 1 + decimals : 0);
+    size_t timestamp = 11;      // "-2147483648"
+    if (mode == HistoryQuery::BUCKETS) return 3 + timestamp + 3 * (1 + number) + 1 + 10;
+    return 3 + timestamp + 1 + number;
+}
+
+void SensorWebServer::continueHistory(WebConnection& conn, Client& client) {
+    // A few points per pass; the query keeps its place between passes
+    ChunkedPrint body(client);
+    char chunk[JSON_STREAM_CHUNK_SIZE];
+    JsonWriter writer(body, chunk, sizeof(chunk));
+    HistoryQuery& history = conn.history;
+    uint8_t decimals = history.getDecimals();
+    bool done = false;
+    
+    // Only as many points as the room there is now surely holds, with the
+    // chunk framing and the closing "]}", so no write has to wait
+    size_t room = writeRoom(conn);
+    size_t pointMax = historyPointMaxLength(history.getMode(), decimals);
+    
+    for (int i = 0; i < HISTORY_POINTS_PER_PASS; i++) {
+        if (ChunkedPrint::wireLength(writer.totalLength() + pointMax + 2, sizeof(chunk)) > room) break;
+        
+        HistoryQuery::Point point;
+        if (!history.next(point)) {
+            done = true;
+            break;
+        }
+        
+        // Each pass starts a fresh writer, so the separator is added by hand
+        if (i == 0 && conn.entries > 0) writer.rawContinue(",", 1);
+        writer.beginArray();
+        writer.value((long)(int32_t)(point.timestamp - conn.acceptedAt));
+        if (history.getMode() == HistoryQuery::BUCKETS) {
+            writer.value(point.min, decimals);
+            writer.value(point.max, decimals);
+            writer.value(point.value, decimals);
+            writer.value((unsigned long)point.count);
+        } else {
+            writer.value(point.value, decimals);
+        }
+        writer.endArray();
+        conn.entries++;
+    }
+    
+    if (done) writer.rawContinue("]}", 2);
+    writer.flush();
+    conn.sent += body.bytesWritten();
+    
+    if (done) {
+        body.finish();
+        DEBUG_PRINTF("✓ Streamed %u history points of %s.%s (%u bytes)\n",
+                     (unsigned)conn.entries, history.getSensor(), history.getField(),
+                     (unsigned)conn.sent);
+        closeConnection(conn);
     }
-    #endif
+}
+
+void SensorWebServer::sendBadRequest(Client &client, const char* reason) {
+    client.print(FPSTR(HTTP_BAD_REQUEST));
+    client.println(reason);
+    DEBUG_PRINTF("Sent 400 Bad Request: %s\n", reason);
 }
 
 void SensorWebServer::sendUnauthorized(Client &client) {
@@ -479,30 +709,31 @@ void SensorWebServer::sendForbidden(Client &client) {
     DEBUG_PRINTLN("Sent 403 Forbidden (Rate Limited)");
 }
 
-bool SensorWebServer::checkAuthentication(const String& authHeader) {
-    if (authHeader.length() == 0) {
+bool SensorWebServer::checkAuthentication(const char* authHeader) {
+    if (authHeader[0] == '\0') {
         return false;
     }
 
     // Check if it's Basic authentication
-    if (!authHeader.startsWith("Basic ")) {
+    if (strncmp(authHeader, "Basic ", 6) != 0) {
         return false;
     }
 
     // Extract Base64 encoded credentials
-    String encodedCreds = authHeader.substring(6); // Remove "Basic "
+    const char* encodedCreds = authHeader + 6; // Remove "Basic "
+    size_t encodedLength = strlen(encodedCreds);
     
     // Decode Base64 using mbedtls
     size_t outputLen;
     
     // First call to get required buffer size
     mbedtls_base64_decode(NULL, 0, &outputLen,
-                          (const unsigned char*)encodedCreds.c_str(), encodedCreds.length());
+                          (const unsigned char*)encodedCreds, encodedLength);
     
     // Allocate buffer and decode
     unsigned char decoded[outputLen + 1];
     int ret = mbedtls_base64_decode(decoded, outputLen, &outputLen,
-                                     (const unsigned char*)encodedCreds.c_str(), encodedCreds.length());
+                                     (const unsigned char*)encodedCreds, encodedLength);
     
     if (ret != 0) {
         return false;  // Decode failed
@@ -527,84 +758,67 @@ bool SensorWebServer::checkAuthentication(const String& authHeader) {
     return (usernameMatch && passwordMatch);
 }
 
-bool SensorWebServer::checkAPIToken(const String& tokenHeader) {
-    if (tokenHeader.length() == 0) {
+bool SensorWebServer::checkAPIToken(const char* tokenHeader) {
+    if (tokenHeader[0] == '\0') {
         return false;
     }
     
     // Constant-time comparison
-    return (tokenHeader == API_ACCESS_TOKEN);
+    return (strcmp(tokenHeader, API_ACCESS_TOKEN) == 0);
 }
 
-void SensorWebServer::handleHTTPRequest(Client &client, const String& clientIP) {
-    if (xPortInIsrContext()) {
-        client.stop();
-        return;
-    }
-    
-    DEBUG_PRINTLN("Reading HTTP request...");
+void SensorWebServer::handleHTTPRequest(WebConnection& conn) {
+    PERF_SCOPE(PERF_HANDLE_HTTP_REQUEST);
     
-    unsigned long startTime = millis();
-    String request = "";
-    String authHeader = "";
-    String apiTokenHeader = "";
+    Client& client = *conn.client;
+    conn.routed = true;
+    requests++;
     
-    while (client.connected() && (millis() - startTime < 2000)) {
-        if (client.available()) {
-            char c = client.read();
-            request += c;
-            if (request.endsWith("\r\n\r\n")) break;
-        }
-        vTaskDelay(1);
-    }
-
-    if (request.length() == 0) {
-        DEBUG_PRINTLN("Empty request");
-        client.stop();
+    if (xPortInIsrContext()) {
+        closeConnection(conn);
         return;
     }
     
-    DEBUG_PRINTF("Request: %s\n", request.substring(0, 50).c_str());
+    DEBUG_PRINTF("Request: %s %s\n", conn.method, conn.path);
 
     // Rate limiting check
-    if (clientIP.length() > 0) {
+    if (conn.ip[0] != '\0') {
         // Periodically clean old rate limit records
         if (millis() - lastRateLimitCleanup > 60000) {
             WebAuthManager::clearRateLimitRecords();
             lastRateLimitCleanup = millis();
         }
         
-        if (!WebAuthManager::checkRateLimit(clientIP)) {
-            DEBUG_PRINTF("Rate limit exceeded for IP: %s\n", clientIP.c_str());
+        if (!WebAuthManager::checkRateLimit(String(conn.ip))) {
+            DEBUG_PRINTF("Rate limit exceeded for IP: %s\n", conn.ip);
             sendForbidden(client);
-            client.stop();
+            closeConnection(conn);
             return;
         }
     }
 
-    // Extract Authorization header
-    int authStart = request.indexOf("Authorization: ");
-    if (authStart != -1) {
-        int authEnd = request.indexOf("\r\n", authStart);
-        authHeader = request.substring(authStart + 15, authEnd);
-    }
-
-    // Extract X-API-Token header
-    int tokenStart = request.indexOf("X-API-Token: ");
-    if (tokenStart != -1) {
-        int tokenEnd = request.indexOf("\r\n", tokenStart);
-        apiTokenHeader = request.substring(tokenStart + 13, tokenEnd);
-    }
-
     // Check if this is a data endpoint (requires API token or basic auth)
-    bool isDataEndpoint = (request.indexOf("GET /data") != -1);
-    bool isMainPage = (request.indexOf("GET / ") != -1 || request.indexOf("GET /index") != -1);
+    bool isGet = (strcmp(conn.method, "GET") == 0);
+    bool isDataEndpoint = isGet && strcmp(conn.path, "/data") == 0;
+    bool isBufferEndpoint = isGet && strcmp(conn.path, "/buffer") == 0;
+    bool isMetricsEndpoint = isGet && strcmp(conn.path, "/metrics") == 0;
+    bool isHistoryEndpoint = isGet && strcmp(conn.path, "/history") == 0;
+    #ifdef ROLLING_STATS_ENABLED
+    bool isStatsEndpoint = isGet && strcmp(conn.path, "/stats") == 0;
+    #else
+    bool isStatsEndpoint = false;
+    #endif
+    bool isWebSocket = isGet && strcmp(conn.path, "/ws") == 0;
+    bool isMainPage = isGet && (strcmp(conn.path, "/") == 0 || strncmp(conn.path, "/index", 6) == 0);
+    const char* authHeader = conn.authorization;
+    const char* apiTokenHeader = conn.apiToken;
     
     // Authentication logic
     bool authenticated = false;
     
-    if (isDataEndpoint) {
-        // Data endpoint: Accept either API token or Basic Auth
+    if (isDataEndpoint || isBufferEndpoint || isMetricsEndpoint || isHistoryEndpoint ||
+        isStatsEndpoint || isWebSocket) {
+        // Data endpoints: Accept either API token or Basic Auth
         authenticated = checkAPIToken(apiTokenHeader) || checkAuthentication(authHeader);
     } else if (isMainPage) {
         // Main page: Require Basic Auth
@@ -618,7 +832,7 @@ void SensorWebServer::handleHTTPRequest(Client &client, const String& clientIP)
             sendUnauthorized(client);
         } else {
             DEBUG_PRINTLN("Sending main page (authenticated)");
-            sendMainPage(client, true);
+            sendMainPage(conn, true);
         }
     }
     else if (isDataEndpoint) {
@@ -630,6 +844,49 @@ void SensorWebServer::handleHTTPRequest(Client &client, const String& clientIP)
             sendJSONData(client, true);
         }
     }
+    else if (isBufferEndpoint) {
+        if (!authenticated) {
+            DEBUG_PRINTLN("Unauthorized access to buffer endpoint");
+            sendUnauthorized(client);
+        } else {
+            DEBUG_PRINTLN("Streaming buffered records (authenticated)");
+            sendBufferedData(conn, true);
+        }
+    }
+    else if (isStatsEndpoint) {
+        if (!authenticated) {
+            DEBUG_PRINTLN("Unauthorized access to stats endpoint");
+            sendUnauthorized(client);
+        } else {
+            DEBUG_PRINTLN("Sending rolling statistics (authenticated)");
+            sendStats(client, true);
+        }
+    }
+    else if (isHistoryEndpoint) {
+        if (!authenticated) {
+            DEBUG_PRINTLN("Unauthorized access to history endpoint");
+            sendUnauthorized(client);
+        } else {
+            sendHistory(conn, true);
+        }
+    }
+    else if (isWebSocket) {
+        if (!authenticated) {
+            DEBUG_PRINTLN("Unauthorized access to WebSocket endpoint");
+            sendUnauthorized(client);
+        } else {
+            sendWebSocketHandshake(conn, true);
+        }
+    }
+    else if (isMetricsEndpoint) {
+        if (!authenticated) {
+            DEBUG_PRINTLN("Unauthorized access to metrics endpoint");
+            sendUnauthorized(client);
+        } else {
+            DEBUG_PRINTLN("Sending uplink metrics (authenticated)");
+            sendMetrics(client, true);
+        }
+    }
     else {
         DEBUG_PRINTLN("404 Not Found");
         client.println("HTTP/1.1 404 Not Found");
@@ -638,39 +895,37 @@ void SensorWebServer::handleHTTPRequest(Client &client, const String& clientIP)
         client.println();
         client.println("404 Not Found");
     }
+    
+    // Large bodies continue on later passes and WebSockets stay open;
+    // everything else is done
+    if (conn.state == WebConnection::READING) {
+        closeConnection(conn);
+    }
 }
 
-void SensorWebServer::sendMainPage(Client &client, bool authenticated) {
+void SensorWebServer::sendMainPage(WebConnection& conn, bool authenticated) {
     if (!authenticated) {
-        sendUnauthorized(client);
+        sendUnauthorized(*conn.client);
         return;
     }
     
-    // Send HTTP header with cache control FIRST
-    client.print(FPSTR(HTTP_CACHE_HEADER));
-    
-    // Then send large HTML in chunks to avoid buffer overflow
-    const char* htmlPtr = MAIN_PAGE;
-    size_t totalLen = strlen_P(htmlPtr);
-    size_t chunkSize = 512;  // Send 512 bytes at a time
-    
-    DEBUG_PRINTF("Sending cached HTML page (%d bytes) in chunks...\n", totalLen);
-    
-    for (size_t i = 0; i < totalLen; i += chunkSize) {
-        size_t remaining = totalLen - i;
-        size_t bytesToSend = (remaining < chunkSize) ? remaining : chunkSize;
-        
-        char buffer[chunkSize + 1];
-        memcpy_P(buffer, htmlPtr + i, bytesToSend);
-        buffer[bytesToSend] = '\0';
-        
-        client.write((const uint8_t*)buffer, bytesToSend);
-        client.flush();  // Ensure data is sent before continuing
-        
-        vTaskDelay(1);  // Small delay to allow TCP stack to process
+    if (conn.etagMatches) {
+        conn.client->print(FPSTR(HTTP_NOT_MODIFIED));
+        pagesNotModified++;
+        pageWireBytes += sizeof(HTTP_NOT_MODIFIED) - 1;
+        DEBUG_PRINTLN("✓ HTML page not modified (304)");
+        return;
     }
     
-    DEBUG_PRINTLN("✓ HTML page sent successfully (will be cached by browser)");
+    // Send HTTP header with cache control FIRST
+    conn.client->print(FPSTR(HTTP_CACHE_HEADER));
+    pageWireBytes += sizeof(HTTP_CACHE_HEADER) - 1;
+    
+    // The gzipped body follows from continueResponse()
+    DEBUG_PRINTF("Sending cached HTML page (%u bytes gzip, %u bytes source)...\n",
+                 (unsigned)MAIN_PAGE_GZIP_LENGTH, (unsigned)MAIN_PAGE_SOURCE_LENGTH);
+    conn.sent = 0;
+    conn.state = WebConnection::SENDING_PAGE;
 }
 
 void SensorWebServer::sendJSONData(Client &client, bool authenticated) {
@@ -681,87 +936,519 @@ void SensorWebServer::sendJSONData(Client &client, bool authenticated) {
         return;
     }
     
-    if (!lockData(1000)) {
+    SharedSensorData localData;
+    if (!snapshotData(localData)) {
         client.print(FPSTR(HTTP_NO_CACHE_HEADER));
         client.println("{\"error\":\"Data temporarily unavailable\"}");
         return;
     }
 
-    SharedSensorData localData = sharedData;
-    unlockData();
-
     // Send JSON response header with NO CACHE directive
     client.print(FPSTR(HTTP_NO_CACHE_HEADER));
     
-    // Build and send JSON body
-    client.print("{");
-    
-    // ZE40 Data
-    client.print("\"dac_voltage\":");
-    client.print(localData.ze40_dac_voltage, 2);
-    client.print(",\"dac_ppm\":");
-    client.print(localData.ze40_dac_ppm, 3);
-    client.print(",\"tvoc_ppb\":");
-    client.print(localData.ze40_tvoc_ppb);
-    client.print(",\"tvoc_ppm\":");
-    client.print(localData.ze40_tvoc_ppm, 3);
-    
-    // ZPHS01B Data
-    if (localData.zphs01b_valid) {
-        client.print(",\"air_quality\":{");
-        client.print("\"pm25\":");
-        client.print(localData.zphs01b_pm25);
-        client.print(",\"pm10\":");
-        client.print(localData.zphs01b_pm10);
-        client.print(",\"co2\":");
-        client.print(localData.zphs01b_co2);
-        client.print(",\"temperature\":");
-        client.print(localData.zphs01b_temperature, 1);
-        client.print(",\"humidity\":");
-        client.print(localData.zphs01b_humidity);
-        client.print("}");
+    // Same layout as the Django upload body (sensor_schema.h)
+    char chunk[JSON_STREAM_CHUNK_SIZE];
+    JsonWriter writer(client, chunk, sizeof(chunk));
+    writer.beginObject();
+    writeSensorGroups(writer, localData, millis(), true);
+    writer.member("ip_address", localData.ip_address);
+    writer.member("network_mode", networkManager.getModeName());
+    writer.endObject();
+    writer.flush();
+    client.println();
+}
+
+void SensorWebServer::sendBufferedData(WebConnection& conn, bool authenticated) {
+    if (!authenticated) {
+        sendUnauthorized(*conn.client);
+        return;
+    }
+    
+    conn.client->print(FPSTR(HTTP_CHUNKED_JSON_HEADER));
+    
+    // Oldest first, one record per pass from continueResponse(); records
+    // stay buffered until the uploader removes them
+    conn.cursor = BufferManager::openCursor();
+    conn.sent = 0;
+    conn.entries = 0;
+    conn.state = WebConnection::SENDING_BUFFER;
+}
+
+void SensorWebServer::sendHistory(WebConnection& conn, bool authenticated) {
+    Client& client = *conn.client;
+    if (!authenticated) {
+        sendUnauthorized(client);
+        return;
+    }
+    
+    // /history?sensor=mr007&field=lel_concentration&mode=lttb&from=3600&to=0&points=200
+    // from and to are seconds before the request; the device has no wall clock
+    char sensor[16];
+    char field[24];
+    char modeName[8] = "buckets";
+    uint32_t fromSeconds = HISTORY_SECONDS;
+    uint32_t toSeconds = 0;
+    uint32_t points = HISTORY_DEFAULT_POINTS;
+    
+    if (!queryParam(conn.query, "sensor", sensor, sizeof(sensor)) ||
+        !queryParam(conn.query, "field", field, sizeof(field))) {
+        sendBadRequest(client, "sensor and field are required");
+        return;
+    }
+    queryParam(conn.query, "mode", modeName, sizeof(modeName));
+    if (!queryNumber(conn.query, "from", fromSeconds) ||
+        !queryNumber(conn.query, "to", toSeconds) ||
+        !queryNumber(conn.query, "points", points)) {
+        sendBadRequest(client, "from, to and points must be whole numbers");
+        return;
+    }
+    
+    HistoryQuery::Mode mode;
+    if (strcmp(modeName, "buckets") == 0) {
+        mode = HistoryQuery::BUCKETS;
+    } else if (strcmp(modeName, "lttb") == 0) {
+        mode = HistoryQuery::LTTB;
+    } else {
+        sendBadRequest(client, "mode must be buckets or lttb");
+        return;
+    }
+    
+    // The rings never hold more than HISTORY_SECONDS
+    if (fromSeconds > HISTORY_SECONDS) fromSeconds = HISTORY_SECONDS;
+    if (toSeconds >= fromSeconds) {
+        sendBadRequest(client, "from must be further back than to");
+        return;
+    }
+    if (points < 1) points = 1;
+    if (points > HISTORY_MAX_POINTS) points = HISTORY_MAX_POINTS;
+    
+    uint32_t fromMs = conn.acceptedAt - fromSeconds * 1000;
+    uint32_t toMs = conn.acceptedAt - toSeconds * 1000;
+    if (!conn.history.begin(sensor, field, mode, fromMs, toMs, (uint16_t)points)) {
+        sendBadRequest(client, "unknown sensor or field");
+        return;
+    }
+    
+    client.print(FPSTR(HTTP_CHUNKED_JSON_HEADER));
+    
+    // Everything known up front goes in the preamble; the points follow
+    // from continueResponse(), HISTORY_POINTS_PER_PASS at a time
+    ChunkedPrint body(client);
+    char chunk[JSON_STREAM_CHUNK_SIZE];
+    JsonWriter writer(body, chunk, sizeof(chunk));
+    writer.beginObject();
+    writer.member("sensor", conn.history.getSensor());
+    writer.member("field", conn.history.getField());
+    writer.member("mode", mode == HistoryQuery::BUCKETS ? "buckets" : "lttb");
+    writer.member("from_s", (unsigned long)fromSeconds);
+    writer.member("to_s", (unsigned long)toSeconds);
+    writer.member("samples", (unsigned long)conn.history.getSamples());
+    writer.key("columns");
+    writer.beginArray();
+    writer.value("t_ms");
+    if (mode == HistoryQuery::BUCKETS) {
+        writer.value("min");
+        writer.value("max");
+        writer.value("avg");
+        writer.value("count");
     } else {
-        client.print(",\"air_quality\":null");
+        writer.value("value");
+    }
+    writer.endArray();
+    writer.key("points");
+    writer.rawContinue("[", 1);
+    writer.flush();
+    
+    conn.sent = body.bytesWritten();
+    conn.entries = 0;
+    conn.state = WebConnection::SENDING_HISTORY;
+}
+
+void SensorWebServer::sendMetrics(Client &client, bool authenticated) {
+    if (!authenticated) {
+        sendUnauthorized(client);
+        return;
+    }
+    
+    client.print(FPSTR(HTTP_NO_CACHE_HEADER));
+    
+    char chunk[JSON_STREAM_CHUNK_SIZE];
+    JsonWriter writer(client, chunk, sizeof(chunk));
+    writer.beginObject();
+    writer.member("uptime_s", (unsigned long)(millis() / 1000));
+    
+    #ifdef DJANGO_ENABLED
+    writer.key("uplink_queue");
+    writer.beginObject();
+    uplinkQueue.writeMetrics(writer);
+    writer.endObject();
+    #endif
+    
+    writer.key("buffer");
+    writer.beginObject();
+    writer.member("entries", (unsigned long)BufferManager::getEntryCount());
+    writer.member("usage_percent", (unsigned long)BufferManager::getUsagePercent());
+    writer.endObject();
+    
+    writer.endObject();
+    writer.flush();
+    client.println();
+}
+
+void SensorWebServer::sendStats(Client &client, bool authenticated) {
+    if (!authenticated) {
+        sendUnauthorized(client);
+        return;
     }
     
-    // MR007 Data
-    if (localData.mr007_valid) {
-        client.print(",\"mr007\":{");
-        client.print("\"voltage\":");
-        client.print(localData.mr007_voltage, 3);
-        client.print(",\"lel_concentration\":");
-        client.print(localData.mr007_lel, 1);
-        client.print("}");
+    client.print(FPSTR(HTTP_NO_CACHE_HEADER));
+    
+    // Same "stats" member as the upload body
+    uint32_t now = millis();
+    char chunk[JSON_STREAM_CHUNK_SIZE];
+    JsonWriter writer(client, chunk, sizeof(chunk));
+    writer.beginObject();
+    writer.member("uptime_s", (unsigned long)(now / 1000));
+    writeRollingStats(writer, now);
+    writer.endObject();
+    writer.flush();
+    client.println();
+}
+
+void SensorWebServer::sendWebSocketHandshake(WebConnection& conn, bool authenticated) {
+    Client& client = *conn.client;
+    if (!authenticated) {
+        sendUnauthorized(client);
+        return;
+    }
+    
+    if (!conn.wsUpgrade || conn.wsVersion != 13 || strlen(conn.wsKey) != 24) {
+        DEBUG_PRINTF("Bad WebSocket handshake from %s\n", conn.ip);
+        client.print(FPSTR(HTTP_UPGRADE_REQUIRED));
+        return;
+    }
+    
+    portENTER_CRITICAL(&slotMux);
+    bool full = webSockets >= WEB_MAX_WEBSOCKETS;
+    if (!full) webSockets++;
+    portEXIT_CRITICAL(&slotMux);
+    if (full) {
+        // The dashboard falls back to polling /data
+        DEBUG_PRINTF("WebSocket limit reached, refusing %s\n", conn.ip);
+        client.print(FPSTR(HTTP_BUSY));
+        wsRefused++;
+        return;
+    }
+    
+    // Sec-WebSocket-Accept = base64(SHA-1(key + GUID))
+    char keyAndGuid[sizeof(conn.wsKey) + sizeof(WS_GUID)];
+    int keyLength = snprintf(keyAndGuid, sizeof(keyAndGuid), "%s%s", conn.wsKey, WS_GUID);
+    uint8_t digest[20];
+    mbedtls_sha1((const unsigned char*)keyAndGuid, keyLength, digest);
+    char accept[32];
+    size_t acceptLength = 0;
+    mbedtls_base64_encode((unsigned char*)accept, sizeof(accept), &acceptLength, digest, sizeof(digest));
+    accept[acceptLength] = '\0';
+    
+    const char* protocol = "";
+    if (conn.wsProtocol == WebConnection::WS_JSON) protocol = "Sec-WebSocket-Protocol: sensors.json\r\n";
+    if (conn.wsProtocol == WebConnection::WS_CBOR) protocol = "Sec-WebSocket-Protocol: sensors.cbor\r\n";
+    
+    char response[192];
+    int length = snprintf(response, sizeof(response),
+                          "HTTP/1.1 101 Switching Protocols\r\n"
+                          "Upgrade: websocket\r\n"
+                          "Connection: Upgrade\r\n"
+                          "Sec-WebSocket-Accept: %s\r\n"
+                          "%s\r\n",
+                          accept, protocol);
+    client.write((const uint8_t*)response, length);
+    
+    // From here on conn.line assembles incoming frames
+    conn.state = WebConnection::WEBSOCKET;
+    conn.lineLength = 0;
+    conn.wsSeq = 0;
+    conn.lastProgress = millis();
+    conn.wsLastPing = conn.lastProgress;
+    DEBUG_PRINTF("WebSocket open: %s (%s, %d of %d)\n", conn.ip,
+                 conn.wsProtocol == WebConnection::WS_CBOR ? "CBOR" : "JSON",
+                 webSockets, WEB_MAX_WEBSOCKETS);
+}
+
+void SensorWebServer::readWebSocket(WebConnection& conn) {
+    Client& client = *conn.client;
+    uint8_t* frame = (uint8_t*)conn.line;
+    unsigned long now = millis();
+    
+    // Client frames are masked; only control frames matter to us, so
+    // anything longer than a control frame is refused
+    while (client.available() > 0) {
+        size_t want = 2;
+        if (conn.lineLength >= 2) want = 2 + 4 + (frame[1] & 0x7F);
+        
+        int n = client.read(frame + conn.lineLength, want - conn.lineLength);
+        if (n <= 0) break;
+        conn.lineLength += n;
+        if (conn.lineLength < 2) continue;
+        
+        if (!(frame[1] & WS_MASKED) || (frame[1] & 0x7F) > WS_MAX_CONTROL_PAYLOAD) {
+            uint16_t code = (frame[1] & WS_MASKED) ? WS_CLOSE_TOO_BIG : WS_CLOSE_PROTOCOL_ERROR;
+            uint8_t reason[2] = { (uint8_t)(code >> 8), (uint8_t)code };
+            DEBUG_PRINTF("WebSocket %s sent an unsupported frame, closing\n", conn.ip);
+            writeFrame(conn, WS_OP_CLOSE, reason, sizeof(reason));
+            closeConnection(conn);
+            return;
+        }
+        size_t length = frame[1] & 0x7F;
+        if (conn.lineLength < 2 + 4 + length) continue;
+        
+        const uint8_t* mask = frame + 2;
+        uint8_t* payload = frame + 6;
+        for (size_t i = 0; i < length; i++) payload[i] ^= mask[i & 3];
+        conn.lineLength = 0;
+        conn.lastProgress = now;
+        
+        uint8_t opcode = frame[0] & 0x0F;
+        if (opcode == WS_OP_PING) {
+            writeFrame(conn, WS_OP_PONG, payload, length);
+        } else if (opcode == WS_OP_CLOSE) {
+            // Echo the status code, then close
+            writeFrame(conn, WS_OP_CLOSE, payload, length >= 2 ? 2 : 0);
+            closeConnection(conn);
+            return;
+        }
+        // Pongs only prove the client is alive; data frames are ignored
+    }
+    
+    if (!client.connected()) {
+        closeConnection(conn);
+    } else if (now - conn.lastProgress > 2 * WS_PING_INTERVAL_MS) {
+        DEBUG_PRINTF("WebSocket %s stopped answering, closing\n", conn.ip);
+        timeouts++;
+        closeConnection(conn);
+    } else if (now - conn.lastProgress > WS_PING_INTERVAL_MS &&
+               now - conn.wsLastPing > WS_PING_INTERVAL_MS) {
+        writeFrame(conn, WS_OP_PING, nullptr, 0);
+        conn.wsLastPing = now;
+    }
+}
+
+// A WebSocket frame goes out whole or not at all: the length when sent,
+// 0 when the socket has no room for it now, -1 when it failed or took
+// only part of it
+int SensorWebServer::writeNow(WebConnection& conn, const uint8_t* data, size_t length) {
+    #ifdef WIFI_FALLBACK_ENABLED
+    if (!conn.ethernet) {
+        // WiFiClient::write() would wait for lwIP to queue it all
+        int n = lwip_send(conn.wifiClient.fd(), data, length, MSG_DONTWAIT);
+        if (n < 0) return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+        return n == (int)length ? n : -1;
+    }
+    #endif
+    if (writeRoom(conn) < length) return 0;
+    return conn.client->write(data, length) == length ? (int)length : -1;
+}
+
+bool SensorWebServer::writeFrame(WebConnection& conn, uint8_t opcode, const uint8_t* payload, size_t length) {
+    uint8_t frame[2 + WS_MAX_CONTROL_PAYLOAD];
+    if (length > WS_MAX_CONTROL_PAYLOAD) return false;
+    
+    frame[0] = WS_FIN | opcode;
+    frame[1] = length;
+    if (length > 0) memcpy(frame + 2, payload, length);
+    return writeNow(conn, frame, 2 + length) > 0;
+}
+
+// One pushed frame: the current reading in full, or what changed since
+// the previous push, in sensor_schema.h layout
+template <typename Writer>
+static void writePushedReading(Writer& w, uint32_t seq, bool full,
+                               const SharedSensorData& d, const SharedSensorData& prev,
+                               const char* mode, const char* prevMode) {
+    w.beginObject();
+    writeSchemaId(w);
+    writeSchemaMember(w, "seq", SCHEMA_KEY_SEQUENCE, (unsigned long)seq);
+    writeSchemaMember(w, "full", SCHEMA_KEY_FULL, full);
+    if (full) {
+        writeSensorGroups(w, d, millis(), false);
     } else {
-        client.print(",\"mr007\":null");
-    }
-    
-    // ME4-SO2 Data
-    if (localData.me4so2_valid) {
-        client.print(",\"me4_so2\":{");
-        client.print("\"voltage\":");
-        client.print(localData.me4so2_voltage, 4);
-        client.print(",\"current_ua\":");
-        client.print(localData.me4so2_current, 2);
-        client.print(",\"so2_concentration\":");
-        client.print(localData.me4so2_so2, 2);
-        client.print("}");
+        writeSensorDelta(w, d, prev);
+    }
+    if (full || strcmp(d.ip_address, prev.ip_address) != 0) {
+        writeSchemaMember(w, "ip_address", SCHEMA_KEY_IP_ADDRESS, d.ip_address);
+    }
+    if (full || mode != prevMode) {
+        writeSchemaMember(w, "network_mode", SCHEMA_KEY_NETWORK_MODE, mode);
+    }
+    w.endObject();
+}
+
+size_t SensorWebServer::buildFrame(uint8_t* buffer, bool binary, bool full, const uint8_t*& frame) {
+    // Encode after WS_HEADER_ROOM bytes, then put the header just before
+    // the payload so the frame is one contiguous write
+    uint8_t* payload = buffer + WS_HEADER_ROOM;
+    size_t capacity = WS_FRAME_BUFFER_SIZE - WS_HEADER_ROOM;
+    size_t length;
+    bool fits;
+    
+    if (binary) {
+        CborWriter writer(payload, capacity);
+        writePushedReading(writer, wsPushSeq, full, wsCurrent, wsPrevious, wsModeCurrent, wsModePrevious);
+        length = writer.length();
+        fits = writer.ok();
     } else {
-        client.print(",\"me4_so2\":null");
+        JsonWriter writer((char*)payload, capacity);
+        writePushedReading(writer, wsPushSeq, full, wsCurrent, wsPrevious, wsModeCurrent, wsModePrevious);
+        length = writer.length();
+        fits = writer.ok();
+    }
+    if (!fits) {
+        DEBUG_PRINTLN("WebSocket frame does not fit WS_FRAME_BUFFER_SIZE");
+        return 0;
+    }
+    
+    uint8_t opcode = binary ? WS_OP_BINARY : WS_OP_TEXT;
+    if (length < 126) {
+        frame = payload - 2;
+        buffer[2] = WS_FIN | opcode;
+        buffer[3] = length;
+        return length + 2;
     }
+    frame = buffer;
+    buffer[0] = WS_FIN | opcode;
+    buffer[1] = 126;
+    buffer[2] = length >> 8;
+    buffer[3] = length;
+    return length + 4;
+}
+
+// A client that has the previous push takes the delta; a new client,
+// or one that missed a frame, takes the full reading
+static bool wantsFrame(const WebConnection& conn, bool ethernet, uint32_t seq, bool binary, bool full) {
+    if (conn.state != WebConnection::WEBSOCKET || conn.ethernet != ethernet) return false;
+    if (conn.wsSeq == seq) return false;
     
-    // Network info
-    client.print(",\"ip_address\":\"");
-    client.print(localData.ip_address);
-    client.print("\",\"network_mode\":\"");
+    bool needsFull = conn.wsSeq == 0 || conn.wsSeq + 1 != seq;
+    return needsFull == full && (conn.wsProtocol == WebConnection::WS_CBOR) == binary;
+}
+
+void SensorWebServer::pushUpdates(bool ethernet) {
+    if (webSockets == 0) return;
+    
+    // At most one push per WS_MIN_PUSH_INTERVAL_MS, and only for new data.
+    // Whichever interface's task gets here first takes the snapshot; the
+    // other one's clients are then behind wsPushSeq and get it as well.
+    bool pushed = false;
+    {
+        PushLock lock;
+        unsigned long now = millis();
+        uint32_t dataSeq = dataSequence();
+        if (wsPushSeq == 0 || (dataSeq != wsDataSeq && now - wsLastPush >= WS_MIN_PUSH_INTERVAL_MS)) {
+            SharedSensorData d;
+            if (snapshotData(d)) {
+                wsPrevious = wsCurrent;
+                wsModePrevious = wsModeCurrent;
+                wsCurrent = d;
+                wsModeCurrent = networkManager.getModeName();
+                wsDataSeq = dataSeq;
+                wsLastPush = now;
+                wsPushSeq++;
+                pushed = true;
+            }
+        }
+        if (wsPushSeq == 0) return;
+    }
     
-    // These method calls should now work with SensorNetworkManager
-    if (networkManager.isEthernetActive()) client.print("eth");
-    else if (networkManager.isWifiActive()) client.print("wifi");
-    else if (networkManager.isAPActive()) client.print("ap");
-    else client.print("unknown");
+    PERF_SCOPE(PERF_WEBSOCKET_PUSH);
     
-    client.println("\"}");
+    // Each of the four frame kinds is encoded at most once per pass,
+    // whatever the number of clients, and every client behind wsPushSeq
+    // is served, not only on the pass that took the snapshot. Only this
+    // task touches this interface's connections and its wsFrame buffer,
+    // so the writes happen outside pushMutex: a client that is not
+    // reading never holds up the other interface's task.
+    uint8_t* buffer = wsFrame[ethernet ? 1 : 0];
+    uint32_t bytes = 0;
+    uint32_t fullFrames = 0;
+    uint32_t deltaFrames = 0;
+    uint32_t dropped = 0;
+    for (uint8_t kind = 0; kind < 4; kind++) {
+        bool binary = kind & 1;
+        bool full = kind & 2;
+        const uint8_t* frame = nullptr;
+        size_t length = 0;
+        uint32_t seq;
+        {
+            PushLock lock;
+            seq = wsPushSeq;
+            for (const WebConnection& conn : connections) {
+                if (wantsFrame(conn, ethernet, seq, binary, full)) {
+                    length = buildFrame(buffer, binary, full, frame);
+                    break;
+                }
+            }
+        }
+        if (length == 0) continue;
+        
+        for (WebConnection& conn : connections) {
+            if (!wantsFrame(conn, ethernet, seq, binary, full)) continue;
+            
+            int written = writeNow(conn, frame, length);
+            if (written == 0) {
+                // Skip rather than queue; a later pass resyncs it in full.
+                // Counted once per push it missed, not per retry.
+                if (pushed) dropped++;
+                continue;
+            }
+            if (written < 0) {
+                // Part of a frame went out; the stream can't be resumed
+                closeConnection(conn);
+                continue;
+            }
+            conn.wsSeq = seq;
+            bytes += length;
+            if (full) fullFrames++;
+            else deltaFrames++;
+        }
+    }
+    
+    PushLock lock;
+    wsBytes += bytes;
+    wsFullFrames += fullFrames;
+    wsDeltaFrames += deltaFrames;
+    wsDropped += dropped;
+}
+
+void SensorWebServer::report() {
+    DEBUG_PRINTLN("┌─ Web server report ────────────────────────");
+    DEBUG_PRINTF("│ %d of %d connections open (peak %lu), %lu accepted, %lu refused\n",
+                 activeClients,
+                 MAX_CONCURRENT_CONNECTIONS,
+                 (unsigned long)peakClients,
+                 (unsigned long)accepted,
+                 (unsigned long)refused);
+    DEBUG_PRINTF("│ %lu requests, %lu timed out, response avg %lu ms, max %lu ms\n",
+                 (unsigned long)requests,
+                 (unsigned long)timeouts,
+                 (unsigned long)(requests ? totalResponseMs / requests : 0),
+                 (unsigned long)maxResponseMs);
+    DEBUG_PRINTF("│ page: %lu sent (%u B gzip of %u B), %lu not modified, avg %lu ms, max %lu ms, %lu B on the wire\n",
+                 (unsigned long)pagesSent,
+                 (unsigned)MAIN_PAGE_GZIP_LENGTH,
+                 (unsigned)MAIN_PAGE_SOURCE_LENGTH,
+                 (unsigned long)pagesNotModified,
+                 (unsigned long)(pagesSent ? totalPageMs / pagesSent : 0),
+                 (unsigned long)maxPageMs,
+                 (unsigned long)pageWireBytes);
+    uint32_t frames = wsFullFrames + wsDeltaFrames;
+    DEBUG_PRINTF("│ websocket: %d open, %lu full + %lu delta frames, avg %lu B, %lu dropped, %lu refused\n",
+                 webSockets,
+                 (unsigned long)wsFullFrames,
+                 (unsigned long)wsDeltaFrames,
+                 (unsigned long)(frames ? wsBytes / frames : 0),
+                 (unsigned long)wsDropped,
+                 (unsigned long)wsRefused);
+    DEBUG_PRINTLN("└────────────────────────────────────────────");
 }
 
 #endif
\ No newline at end of file
@@ -18,29 +18,200 @@ class EthernetServer;
 
 #include "network_manager.h"
 #include "web_auth.h"
+#include "buffer_manager.h"
+#include "history_query.h"
 
-// Connection management - removed to prevent pointer issues
-// Each connection is now handled immediately without tracking
+/**
+ * One client connection and where its request/response stands
+ */
+struct WebConnection {
+    enum State : uint8_t {
+        FREE,
+        READING,            // Request line and headers
+        SENDING_PAGE,       // Gzipped MAIN_PAGE, as much as the socket takes
+        SENDING_BUFFER,     // Buffered records, one entry per pass
+        SENDING_HISTORY,    // Downsampled /history series, a few points per pass
+        WEBSOCKET           // Upgraded /ws; pushed frames until either side closes
+    };
+    
+    // Sec-WebSocket-Protocol picked from the client's list
+    enum WsProtocol : uint8_t {
+        WS_NONE,            // None asked for; JSON text frames
+        WS_JSON,            // sensors.json: JSON text frames
+        WS_CBOR             // sensors.cbor: CBOR binary frames
+    };
+    
+    State state = FREE;
+    bool ethernet = false;          // Which server accepted it
+    Client* client = nullptr;       // Points at the member below
+    #ifdef ETHERNET_ENABLED
+    EthernetClient ethClient;
+    #endif
+    #ifdef WIFI_FALLBACK_ENABLED
+    WiFiClient wifiClient;
+    #endif
+    char ip[16];
+    unsigned long acceptedAt;
+    unsigned long lastProgress;     // Last byte read or written
+    
+    // Request
+    char line[WEB_REQUEST_LINE_SIZE];
+    uint16_t lineLength;
+    uint16_t headerBytes;
+    bool requestLineSeen;
+    char method[8];
+    char path[64];
+    char query[96];                 // After '?', without it
+    char authorization[WEB_AUTH_HEADER_SIZE];
+    char apiToken[WEB_AUTH_HEADER_SIZE];
+    bool etagMatches;               // If-None-Match names the current page
+    bool wsUpgrade;                 // Upgrade: websocket
+    WsProtocol wsProtocol;
+    uint8_t wsVersion;              // Sec-WebSocket-Version
+    char wsKey[32];                 // Sec-WebSocket-Key (24 base64 chars)
+    
+    // Response
+    bool routed;                    // Request complete and answered
+    size_t sent;                    // Body bytes written so far
+    size_t entries;                 // Buffered records written so far
+    BufferCursor cursor;            // SENDING_BUFFER position
+    HistoryQuery history;           // SENDING_HISTORY state
+    uint32_t wsSeq;                 // Last frame this WebSocket client has (0: none)
+    unsigned long wsLastPing;
+};
 
+/**
+ * SensorWebServer
+ *
+ * HTTP/1.0-style server (one request per connection) that never blocks
+ * on a client. Every accepted socket gets a WebConnection slot, up to
+ * MAX_CONCURRENT_CONNECTIONS across Ethernet and WiFi, and each call to
+ * handleEthernetClient() / handleWiFiClient() gives every open slot of
+ * that interface one short step:
+ *   - READING: take whatever bytes have arrived and parse them line by
+ *     line. The blank line ends the headers and the request is routed.
+ *     Requests that take longer than WEB_REQUEST_TIMEOUT are dropped.
+ *   - Small responses (errors, /data, /metrics, /stats) are written at once.
+ *   - SENDING_PAGE: the pre-gzipped page (web_page.h) is written
+ *     straight from flash, as much per pass as the socket has room for.
+ *     A browser that already holds it gets 304 via its ETag.
+ *   - SENDING_BUFFER / SENDING_HISTORY: buffered records go out one
+ *     per pass, /history points up to HISTORY_POINTS_PER_PASS at a time
+ *     (no more than surely fit the socket's room), only when the socket
+ *     has room for WEB_WRITE_CHUNK bytes.
+ *   - WEBSOCKET: /ws upgrades to RFC 6455 and stays open. Readings are
+ *     pushed by pushUpdates(), and incoming control frames are answered.
+ *     At most WEB_MAX_WEBSOCKETS slots upgrade, so open dashboards
+ *     always leave slots for HTTP requests.
+ *   - A client that takes nothing for CONNECTION_TIMEOUT_MS is closed.
+ * One slow or idle client therefore only holds its own slot.
+ *
+ * W5500 socket budget (MAX_SOCK_NUM = 8): the listening socket, the
+ * uplink's kept-alive connection, a DNS or DHCP query, and one socket
+ * to answer a client 503 when every slot is taken are reserved. The
+ * other four are the WebConnection slots (MAX_CONCURRENT_CONNECTIONS),
+ * and web_server.cpp refuses to build if they would not fit.
+ *
+ * lwIP has no free-space count for WiFi sockets, and its write() waits
+ * until it has queued everything. writeRoom() therefore reports
+ * WEB_WRITE_CHUNK for them, so a slow WiFi client holds up the loop for
+ * one chunk at most. WebSocket frames go to WiFi clients with a
+ * non-blocking lwip_send() instead: a client whose window is full
+ * misses that push, as one with a full W5500 socket does, and one that
+ * takes only part of a frame is closed.
+ */
 class SensorWebServer {
+    friend class HostHarness;   // host/ tests and benchmarks
+    
 public:
     void init();
-    void handleEthernetClient();
-    void handleWiFiClient();
+    
+    /**
+     * Accept new Ethernet clients and advance every Ethernet connection
+     * @return true while any connection is open (poll again soon)
+     */
+    bool handleEthernetClient();
+    
+    /**
+     * Same for the WiFi server
+     */
+    bool handleWiFiClient();
+    
+    /**
+     * Print connection and request counters
+     */
+    void report();
 
 private:
-    void sendMainPage(Client &client, bool authenticated);
+    WebConnection* claimSlot(bool ethernet);
+    void startConnection(WebConnection& conn);
+    void serviceConnection(WebConnection& conn);
+    void readRequest(WebConnection& conn);
+    void parseRequestLine(WebConnection& conn);
+    void parseHeader(WebConnection& conn);
+    void continueResponse(WebConnection& conn);
+    void closeConnection(WebConnection& conn);
+    size_t writeRoom(WebConnection& conn);
+    
+    void sendWebSocketHandshake(WebConnection& conn, bool authenticated);
+    void readWebSocket(WebConnection& conn);
+    int writeNow(WebConnection& conn, const uint8_t* data, size_t length);
+    bool writeFrame(WebConnection& conn, uint8_t opcode, const uint8_t* payload, size_t length);
+    size_t buildFrame(uint8_t* buffer, bool binary, bool full, const uint8_t*& frame);
+    void pushUpdates(bool ethernet);
+    
+    void sendMainPage(WebConnection& conn, bool authenticated);
     void sendJSONData(Client &client, bool authenticated);
-    void handleHTTPRequest(Client &client, const String& clientIP);
+    void sendBufferedData(WebConnection& conn, bool authenticated);
+    void sendHistory(WebConnection& conn, bool authenticated);
+    void sendStats(Client &client, bool authenticated);
+    void continueHistory(WebConnection& conn, Client& client);
+    void sendBadRequest(Client &client, const char* reason);
+    void sendMetrics(Client &client, bool authenticated);
+    void handleHTTPRequest(WebConnection& conn);
     void sendUnauthorized(Client &client);
     void sendForbidden(Client &client);
     void sendSecurityHeaders(Client &client);
-    bool checkAuthentication(const String& authHeader);
-    bool checkAPIToken(const String& tokenHeader);
+    bool checkAuthentication(const char* authHeader);
+    bool checkAPIToken(const char* tokenHeader);
     
+    WebConnection connections[MAX_CONCURRENT_CONNECTIONS];
     volatile int activeClients = 0;
     unsigned long lastRateLimitCleanup = 0;
     
+    // Statistics
+    uint32_t accepted = 0;
+    uint32_t refused = 0;           // No free slot
+    uint32_t requests = 0;
+    uint32_t timeouts = 0;
+    uint32_t peakClients = 0;
+    uint32_t maxResponseMs = 0;
+    uint64_t totalResponseMs = 0;   // Accept to close, for answered requests
+    uint32_t pagesSent = 0;
+    uint32_t pagesNotModified = 0;  // 304 from If-None-Match
+    uint32_t pageWireBytes = 0;     // Headers and body, both kinds
+    uint32_t maxPageMs = 0;
+    uint64_t totalPageMs = 0;       // Accept to close, full pages only
+    
+    // WebSocket push state, shared by every /ws client: each pass encodes
+    // a frame kind at most once and writes the same bytes to all clients
+    // that need it. pushUpdates() holds pushMutex (web_server.cpp) while
+    // it uses these, but not while it writes.
+    int webSockets = 0;
+    SharedSensorData wsCurrent;     // Reading of the latest push (wsPushSeq)
+    SharedSensorData wsPrevious;    // Reading of the push before it
+    const char* wsModeCurrent = nullptr;
+    const char* wsModePrevious = nullptr;
+    uint32_t wsPushSeq = 0;
+    uint32_t wsDataSeq = 0;         // dataSequence() behind wsCurrent
+    unsigned long wsLastPush = 0;
+    uint8_t wsFrame[2][WS_FRAME_BUFFER_SIZE];   // WiFi, Ethernet: each task encodes into its own
+    uint32_t wsFullFrames = 0;
+    uint32_t wsDeltaFrames = 0;
+    uint32_t wsDropped = 0;         // Socket full; the client resyncs with a full frame
+    uint32_t wsRefused = 0;         // WEB_MAX_WEBSOCKETS reached
+    uint64_t wsBytes = 0;
+    
     #ifdef ETHERNET_ENABLED
     EthernetServer* ethServer = nullptr;
     #endif
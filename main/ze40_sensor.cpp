@@ -1,6 +1,11 @@
 #include "ze40_sensor.h"
 #include "config.h"
 #include "shared_data.h"
+#include "perf_monitor.h"
+#include "sensor_history.h"
+#include "rolling_stats.h"
+#include "sensor_scheduler.h"
+#include "adc_sampler.h"
 #include <Arduino.h>
 
 ZE40Sensor ze40Sensor;
@@ -9,16 +14,26 @@ ZE40Sensor ze40Sensor;
 const unsigned long INITIAL_PREHEAT = 0;
 const unsigned long DAILY_PREHEAT = 180000;
 
+const uint8_t INITIATIVE_MODE_CMD[9] = {0xFF, 0x01, 0x78, 0x40, 0x00, 0x00, 0x00, 0x00, 0x47};
+const uint8_t QA_MODE_CMD[9] = {0xFF, 0x01, 0x78, 0x41, 0x00, 0x00, 0x00, 0x00, 0x46};
+const uint8_t REQUEST_READING_CMD[9] = {0xFF, 0x01, 0x86, 0x00, 0x00, 0x00, 0x00, 0x00, 0x79};
+
 void ZE40Sensor::init() {
+    rxFrames.init(UART_FRAME_QUEUE_DEPTH);
+    
     ze40State.serial = new HardwareSerial(1);
     ze40State.serial->begin(9600, SERIAL_8N1, ZE40_RX_PIN, ZE40_TX_PIN);
-    analogReadResolution(12);
+    
+    // Called by the UART driver once the line has been idle for
+    // UART_RX_TIMEOUT_SYMBOLS, i.e. right after each frame
+    ze40State.serial->setRxTimeout(UART_RX_TIMEOUT_SYMBOLS);
+    ze40State.serial->onReceive([this]() { onUartReceive(); });
     
     ze40State.powerOnTime = millis();
+    uartLink.init(ze40State.serial, "ZE40");
 
     // Start in initiative upload mode
-    uint8_t initCmd[9] = {0xFF, 0x01, 0x78, 0x40, 0x00, 0x00, 0x00, 0x00, 0x47};
-    ze40State.serial->write(initCmd, 9);
+    uartLink.enqueue(INITIATIVE_MODE_CMD, 9, UartTransactionEngine::NO_REPLY, ZE40_MODE_SETTLE_TIME, 0);
 
     DEBUG_PRINTLN("✓ ZE40 TVOC Sensor initialized");
 }
@@ -27,33 +42,57 @@ void ZE40Sensor::processData() {
     unsigned long elapsed = millis() - ze40State.powerOnTime;
     
     // Handle preheating
-    if (!ze40State.preheatComplete) {
-        if (elapsed >= INITIAL_PREHEAT) {
-            ze40State.preheatComplete = true;
-            DEBUG_PRINTLN("✓ ZE40 preheating complete");
-        } else {
-            return;
-        }
+    if (!ze40State.preheatComplete && elapsed >= INITIAL_PREHEAT) {
+        ze40State.preheatComplete = true;
+        DEBUG_PRINTLN("✓ ZE40 preheating complete");
     }
     
-    // Skip during daily preheating
-    if (elapsed % 86400000 < DAILY_PREHEAT) {
-        return;
+    // Publish frames completed by the receive callback
+    UartFrame received;
+    while (rxFrames.pop(received)) {
+        uartLink.onFrame(received.bytes, received.length);
+        parseDataFrame(received.bytes);
+        rxFrames.markPublished(received);
     }
+    
+    // Send queued commands, expire settle times and reply timeouts
+    uartLink.service(millis());
+}
 
-    // Process incoming UART data
+// Data is ignored during initial and daily preheating
+bool ZE40Sensor::isListening(uint32_t now) const {
+    unsigned long elapsed = now - ze40State.powerOnTime;
+    return elapsed >= INITIAL_PREHEAT && elapsed % 86400000 >= DAILY_PREHEAT;
+}
+
+// Runs on the UART driver's event task, not the sensor task. Only
+// assembles frames; publishing happens in processData().
+void ZE40Sensor::onUartReceive() {
+    bool listening = isListening(millis());
+    bool frameReady = false;
+    
     while (ze40State.serial->available()) {
-        processByte(ze40State.serial->read());
+        uint8_t byte = ze40State.serial->read();
+        if (!listening) continue;
+        
+        frameReady |= processByte(byte);
     }
     
-    // Handle frame timeout
-    if (ze40State.frameIndex > 0 && (millis() - ze40State.lastByteTime > FRAME_TIMEOUT)) {
-        ze40State.frameIndex = 0;
+    if (frameReady) {
+        sensorScheduler.wake();
     }
 }
 
-void ZE40Sensor::processByte(uint8_t byte) {
-    ze40State.lastByteTime = millis();
+bool ZE40Sensor::processByte(uint8_t byte) {
+    PERF_SCOPE_FAST(PERF_ZE40_PROCESS_BYTE);
+    
+    uint32_t now = millis();
+    
+    // Handle frame timeout
+    if (ze40State.frameIndex > 0 && (now - ze40State.lastByteTime > FRAME_TIMEOUT)) {
+        ze40State.frameIndex = 0;
+    }
+    ze40State.lastByteTime = now;
     
     if (byte == 0xFF) {
         ze40State.frameIndex = 0;
@@ -64,80 +103,93 @@ void ZE40Sensor::processByte(uint8_t byte) {
     }
     
     if (ze40State.frameIndex == 9 && validateChecksum()) {
-        parseDataFrame();
         ze40State.frameIndex = 0;
+        return rxFrames.push(ze40State.frame, 9);
     }
+    return false;
 }
 
-void ZE40Sensor::switchToQAMode() {
+void ZE40Sensor::requestReading() {
     if (!ze40State.preheatComplete) return;
     
-    uint8_t qaCmd[9] = {0xFF, 0x01, 0x78, 0x41, 0x00, 0x00, 0x00, 0x00, 0x46};
-    ze40State.serial->write(qaCmd, 9);
-    ze40State.inQAMode = true;
+    // The previous Q&A exchange is still running; its reply will do
+    if (!uartLink.isIdle()) return;
+
+    // Q&A mode, one read, back to initiative upload. The mode switches
+    // have no reply, so each holds the line for the settle time.
+    uartLink.enqueue(QA_MODE_CMD, 9, UartTransactionEngine::NO_REPLY, ZE40_MODE_SETTLE_TIME, 0);
+    uartLink.enqueue(REQUEST_READING_CMD, 9, 0x86);
+    uartLink.enqueue(INITIATIVE_MODE_CMD, 9, UartTransactionEngine::NO_REPLY, ZE40_MODE_SETTLE_TIME, 0);
 }
 
-void ZE40Sensor::switchToInitiativeMode() {
-    uint8_t initCmd[9] = {0xFF, 0x01, 0x78, 0x40, 0x00, 0x00, 0x00, 0x00, 0x47};
-    ze40State.serial->write(initCmd, 9);
-    ze40State.inQAMode = false;
+float ZE40Sensor::readDACPPM(float voltage) {
+    if (voltage < DAC_ZERO_VOLTAGE) return 0.0;
+    return (voltage - DAC_ZERO_VOLTAGE) * (DAC_PPM_RANGE / (DAC_FULLSCALE_VOLTAGE - DAC_ZERO_VOLTAGE));
 }
 
-void ZE40Sensor::requestReading() {
-    if (!ze40State.preheatComplete) return;
-
-    switchToQAMode();
-    delay(100);
-    
-    uint8_t requestCmd[9] = {0xFF, 0x01, 0x86, 0x00, 0x00, 0x00, 0x00, 0x00, 0x79};
-    ze40State.serial->write(requestCmd, 9);
+void ZE40Sensor::updateAnalog() {
+    AdcReading reading;
+    if (!adcSampler.read(ADC_CH_ZE40_DAC, reading)) return;
     
-    delay(100);
-    switchToInitiativeMode();
-}
+    float voltage = dacFilter.apply(reading.voltage);
+    float ppm = readDACPPM(voltage);
+    uint32_t now = millis();
 
-float ZE40Sensor::readDACVoltage() {
-    int adcValue = analogRead(ZE40_DAC_PIN);
-    return adcValue * (3.3 / 4095.0);
-}
+    ZE40DacSample sample;
+    sample.timestamp = now;
+    sample.dac_voltage = voltage;
+    sample.dac_ppm = ppm;
 
-float ZE40Sensor::readDACPPM(float voltage) {
-    if (voltage < DAC_ZERO_VOLTAGE) return 0.0;
-    return (voltage - DAC_ZERO_VOLTAGE) * (DAC_PPM_RANGE / (DAC_FULLSCALE_VOLTAGE - DAC_ZERO_VOLTAGE));
+    beginDataUpdate();
+    sensorHistory.ze40Dac.push(sample);
+    endDataUpdate();
+
+    rollingStats.add(ROLLING_ze40_dac_voltage, now, voltage);
+    rollingStats.add(ROLLING_ze40_dac_ppm, now, ppm);
 }
 
 bool ZE40Sensor::isPreheatComplete() {
     return ze40State.preheatComplete;
 }
 
+void ZE40Sensor::reportUart() const {
+    uartLink.report();
+    rxFrames.report("ZE40");
+}
+
 bool ZE40Sensor::validateChecksum() {
     uint8_t sum = 0;
     for (uint8_t i = 1; i <= 7; i++) {
         sum += ze40State.frame[i];
     }
-    return ((~sum) + 1) == ze40State.frame[8];
+    // Truncate before comparing: ~sum alone is promoted to int
+    uint8_t checksum = (uint8_t)(~sum + 1);
+    return checksum == ze40State.frame[8];
 }
 
-void ZE40Sensor::parseDataFrame() {
-    if (ze40State.frame[0] != 0xFF) return;
+void ZE40Sensor::parseDataFrame(const uint8_t* frame) {
+    if (frame[0] != 0xFF) return;
     
-    if (ze40State.frame[1] == 0x17 || ze40State.frame[1] == 0x86) {
+    if (frame[1] == 0x17 || frame[1] == 0x86) {
         uint16_t ppb = 0;
         
-        if (ze40State.frame[1] == 0x17) {
-            ppb = (ze40State.frame[4] << 8) | ze40State.frame[5];
+        if (frame[1] == 0x17) {
+            ppb = (frame[4] << 8) | frame[5];
         } else {
-            ppb = (ze40State.frame[6] << 8) | ze40State.frame[7];
+            ppb = (frame[6] << 8) | frame[7];
         }
 
-        // Update shared data directly
-        if (lockData()) {
-            sharedData.ze40_tvoc_ppb = ppb;
-            sharedData.ze40_tvoc_ppm = ppb / 1000.0;
-            sharedData.ze40_uart_valid = true;
-            sharedData.last_update = millis();
-            unlockData();
-        }
+        uint32_t now = millis();
+        ZE40Sample sample;
+        sample.timestamp = now;
+        sample.tvoc_ppb = ppb;
+
+        beginDataUpdate();
+        sensorHistory.ze40.push(sample);
+        endDataUpdate();
+
+        rollingStats.add(ROLLING_ze40_tvoc_ppb, now, ppb);
+        rollingStats.add(ROLLING_ze40_tvoc_ppm, now, ppb / 1000.0);
         
         DEBUG_PRINTF("ZE40 UART - TVOC: %d ppb (%.3f ppm)\n", ppb, ppb / 1000.0);
         ze40State.uartDataReceived = true;
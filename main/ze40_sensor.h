@@ -3,15 +3,20 @@
 
 #include <HardwareSerial.h>
 #include "config.h"
+#include "dsp_filters.h"
+#include "uart_transaction.h"
 
 class ZE40Sensor {
+    friend class HostHarness;   // host/ tests and benchmarks
+
 public:
     void init();
     void processData();
     void requestReading();
-    float readDACVoltage();
     float readDACPPM(float voltage);
+    void updateAnalog();
     bool isPreheatComplete();
+    void reportUart() const;
 
 private:
     struct ZE40State {
@@ -22,16 +27,18 @@ private:
         bool preheatComplete = false;
         uint32_t powerOnTime = 0;
         bool uartDataReceived = false;
-        bool inQAMode = false;
     };
 
+    void onUartReceive();
+    bool isListening(uint32_t now) const;
     bool validateChecksum();
-    void parseDataFrame();
-    void processByte(uint8_t byte);
-    void switchToQAMode();
-    void switchToInitiativeMode();
+    void parseDataFrame(const uint8_t* frame);
+    bool processByte(uint8_t byte);
 
     ZE40State ze40State;
+    UartTransactionEngine uartLink;
+    UartFrameQueue rxFrames;
+    FilterChain<ZE40_DAC_FILTER> dacFilter;
 };
 
 extern ZE40Sensor ze40Sensor;
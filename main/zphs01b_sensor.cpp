@@ -1,6 +1,10 @@
 #include "zphs01b_sensor.h"
 #include "config.h"
 #include "shared_data.h"
+#include "sensor_history.h"
+#include "rolling_stats.h"
+#include "perf_monitor.h"
+#include "sensor_scheduler.h"
 #include <Arduino.h>
 
 ZPHS01BSensor zphs01bSensor;
@@ -8,78 +12,227 @@ ZPHS01BSensor zphs01bSensor;
 const uint8_t REQUEST_DATA_CMD[9] = {0xFF, 0x01, 0x86, 0x00, 0x00, 0x00, 0x00, 0x00, 0x79};
 
 void ZPHS01BSensor::init() {
+    rxFrames.init(UART_FRAME_QUEUE_DEPTH);
+    
     sensorSerial = new HardwareSerial(2);
     sensorSerial->begin(SENSOR_BAUD_RATE, SERIAL_8N1, ZPHS01B_RX_PIN, ZPHS01B_TX_PIN);
+    
+    // Called by the UART driver once the line has been idle for
+    // UART_RX_TIMEOUT_SYMBOLS, i.e. right after each frame
+    sensorSerial->setRxTimeout(UART_RX_TIMEOUT_SYMBOLS);
+    sensorSerial->onReceive([this]() { onUartReceive(); });
     warmUpStart = millis();
+    uartLink.init(sensorSerial, "ZPHS01B");
     DEBUG_PRINTLN("✓ ZPHS01B Air Quality Sensor initialized");
 }
 
 void ZPHS01BSensor::processData() {
-    if (millis() - warmUpStart < SENSOR_WARMUP_TIME) {
-        return;
+    // Publish frames completed by the receive callback
+    UartFrame received;
+    while (rxFrames.pop(received)) {
+        uartLink.onFrame(received.bytes, received.length);
+        processSensorData(received.bytes);
+        dataValid = true;
+        rxFrames.markPublished(received);
     }
     
-    while (sensorSerial->available()) {
-        uint8_t rawData[26] = {0};
-        size_t bytesRead = sensorSerial->readBytes(rawData, 26);
+    // Send queued commands and expire reply timeouts
+    uartLink.service(millis());
+}
+
+// Runs on the UART driver's event task, not the sensor task. Only
+// assembles frames; publishing happens in processData().
+void ZPHS01BSensor::onUartReceive() {
+    uint8_t chunk[64];
+    bool warmedUp = millis() - warmUpStart >= SENSOR_WARMUP_TIME;
+    bool frameReady = false;
+    
+    // Only ask for what is already buffered so readBytes() never waits
+    int available;
+    while ((available = sensorSerial->available()) > 0) {
+        size_t wanted = ((size_t)available < sizeof(chunk)) ? (size_t)available : sizeof(chunk);
+        size_t count = sensorSerial->readBytes(chunk, wanted);
+        if (!warmedUp) continue;
         
-        if (bytesRead == 26 && validateChecksum(rawData, bytesRead)) {
-            processSensorData(rawData);
-            dataValid = true;
+        PERF_SCOPE(PERF_ZPHS01B_PARSE_CHUNK);
+        for (size_t i = 0; i < count; i++) {
+            frameReady |= processByte(chunk[i]);
         }
     }
+    
+    if (frameReady) {
+        sensorScheduler.wake();
+    }
+}
+
+bool ZPHS01BSensor::processByte(uint8_t byte) {
+    uint32_t now = millis();
+    
+    // Drop a partial frame once the line has been quiet too long
+    if (parser.frameIndex > 0 && (now - parser.lastByteTime > FRAME_TIMEOUT)) {
+        discardBytes(parser.frameIndex);
+        parser.frameIndex = 0;
+    }
+    parser.lastByteTime = now;
+    
+    // Hunt for the 0xFF 0x86 header
+    if (parser.frameIndex == 0) {
+        if (byte == 0xFF) {
+            parser.frame[parser.frameIndex++] = byte;
+        } else {
+            discardBytes(1);
+        }
+        return false;
+    }
+    
+    if (parser.frameIndex == 1 && byte != 0x86) {
+        // 0xFF 0xFF may still be the start of a frame
+        discardBytes(1);
+        if (byte != 0xFF) {
+            discardBytes(1);
+            parser.frameIndex = 0;
+        }
+        return false;
+    }
+    
+    parser.frame[parser.frameIndex++] = byte;
+    if (parser.frameIndex < RESPONSE_LENGTH) return false;
+    
+    if (validateChecksum(parser.frame, RESPONSE_LENGTH)) {
+        parser.framesOk++;
+        if (parser.currentResyncBytes > 0) {
+            parser.resyncs++;
+            if (parser.currentResyncBytes > parser.maxResyncBytes) {
+                parser.maxResyncBytes = parser.currentResyncBytes;
+            }
+            parser.currentResyncBytes = 0;
+        }
+        parser.frameIndex = 0;
+        return rxFrames.push(parser.frame, RESPONSE_LENGTH);
+    }
+    
+    parser.checksumErrors++;
+    resyncAfterBadFrame();
+    return false;
+}
+
+// A full frame failed its checksum. Rather than throwing all 26 bytes
+// away, restart from the next header candidate inside it so that a
+// frame which began mid-buffer is still recovered.
+void ZPHS01BSensor::resyncAfterBadFrame() {
+    uint8_t start = 1;
+    while (start < RESPONSE_LENGTH) {
+        if (parser.frame[start] == 0xFF &&
+            (start + 1 == RESPONSE_LENGTH || parser.frame[start + 1] == 0x86)) {
+            break;
+        }
+        start++;
+    }
+    
+    discardBytes(start);
+    parser.frameIndex = RESPONSE_LENGTH - start;
+    memmove(parser.frame, parser.frame + start, parser.frameIndex);
+}
+
+void ZPHS01BSensor::discardBytes(uint32_t count) {
+    parser.bytesDiscarded += count;
+    parser.currentResyncBytes += count;
 }
 
 void ZPHS01BSensor::requestReading() {
     if (millis() - warmUpStart < SENSOR_WARMUP_TIME) {
         return;
     }
-    sensorSerial->write(REQUEST_DATA_CMD, sizeof(REQUEST_DATA_CMD));
+    
+    // Previous request still awaiting its reply or retrying
+    if (!uartLink.isIdle()) return;
+    
+    uartLink.enqueue(REQUEST_DATA_CMD, sizeof(REQUEST_DATA_CMD), 0x86);
+}
+
+void ZPHS01BSensor::reportUart() const {
+    uartLink.report();
+    rxFrames.report("ZPHS01B");
+    DEBUG_PRINTF("│ %-8s parser: %lu frames, %lu checksum errors, %lu resyncs, %lu bytes discarded, worst resync %lu bytes\n",
+                 "ZPHS01B",
+                 (unsigned long)parser.framesOk,
+                 (unsigned long)parser.checksumErrors,
+                 (unsigned long)parser.resyncs,
+                 (unsigned long)parser.bytesDiscarded,
+                 (unsigned long)parser.maxResyncBytes);
 }
 
 bool ZPHS01BSensor::isDataValid() {
-    bool valid = false;
-    if (lockData()) {
-        valid = sharedData.zphs01b_valid && (millis() - sharedData.last_update < 10000);
-        unlockData();
-    }
-    return valid;
+    ZPHS01BSample latest;
+    return sensorHistory.zphs01b.latest(latest) && (millis() - latest.timestamp < 10000);
 }
 
 bool ZPHS01BSensor::validateChecksum(const uint8_t* response, size_t length) {
-    if (length != 26) return false;
+    if (length != RESPONSE_LENGTH) return false;
 
     uint16_t calculatedSum = 0;
-    for (uint8_t i = 1; i < 25; i++) {
+    for (uint8_t i = 1; i < RESPONSE_LENGTH - 1; i++) {
         calculatedSum += response[i];
     }
     uint8_t checksum = (~static_cast<uint8_t>(calculatedSum)) + 1;
-    return (checksum == response[25]);
+    return (checksum == response[RESPONSE_LENGTH - 1]);
 }
 
 void ZPHS01BSensor::processSensorData(const uint8_t* data) {
-    if (lockData()) {
-        // Particulate Matter
-        sharedData.zphs01b_pm1 = (data[2] << 8) | data[3];
-        sharedData.zphs01b_pm25 = (data[4] << 8) | data[5];
-        sharedData.zphs01b_pm10 = (data[6] << 8) | data[7];
-
-        // Gases
-        sharedData.zphs01b_co2 = (data[8] << 8) | data[9];
-        sharedData.zphs01b_voc = data[10];
-
-        // Environmental
-        sharedData.zphs01b_temperature = ((data[11] << 8 | data[12]) - 500) * 0.1;
-        sharedData.zphs01b_humidity = (data[13] << 8) | data[14];
-        
-        // Additional gases
-        sharedData.zphs01b_ch2o = (data[15] << 8) | data[16];
-        sharedData.zphs01b_co = (data[17] << 8 | data[18]) * 0.1;
-        sharedData.zphs01b_o3 = (data[19] << 8 | data[20]) * 0.01;
-        sharedData.zphs01b_no2 = (data[21] << 8 | data[22]) * 0.01;
-        
-        sharedData.zphs01b_valid = true;
-        sharedData.last_update = millis();
-        unlockData();
-    }
+    ZPHS01BSample sample;
+    sample.timestamp = millis();
+
+    // Particulate Matter
+    sample.pm1 = (data[2] << 8) | data[3];
+    sample.pm25 = (data[4] << 8) | data[5];
+    sample.pm10 = (data[6] << 8) | data[7];
+
+    // Gases
+    sample.co2 = (data[8] << 8) | data[9];
+    sample.voc = data[10];
+
+    // Environmental
+    sample.temperature = ((data[11] << 8 | data[12]) - 500) * 0.1;
+    sample.humidity = (data[13] << 8) | data[14];
+    
+    // Additional gases
+    sample.ch2o = (data[15] << 8) | data[16];
+    sample.co = (data[17] << 8 | data[18]) * 0.1;
+    sample.o3 = (data[19] << 8 | data[20]) * 0.01;
+    sample.no2 = (data[21] << 8 | data[22]) * 0.01;
+
+    applyFilters(sample);
+
+    beginDataUpdate();
+    sensorHistory.zphs01b.push(sample);
+    endDataUpdate();
+
+    uint32_t now = sample.timestamp;
+    rollingStats.add(ROLLING_zphs01b_pm1, now, sample.pm1);
+    rollingStats.add(ROLLING_zphs01b_pm25, now, sample.pm25);
+    rollingStats.add(ROLLING_zphs01b_pm10, now, sample.pm10);
+    rollingStats.add(ROLLING_zphs01b_co2, now, sample.co2);
+    rollingStats.add(ROLLING_zphs01b_voc, now, sample.voc);
+    rollingStats.add(ROLLING_zphs01b_ch2o, now, sample.ch2o);
+    rollingStats.add(ROLLING_zphs01b_co, now, sample.co);
+    rollingStats.add(ROLLING_zphs01b_o3, now, sample.o3);
+    rollingStats.add(ROLLING_zphs01b_no2, now, sample.no2);
+    rollingStats.add(ROLLING_zphs01b_temperature, now, sample.temperature);
+    rollingStats.add(ROLLING_zphs01b_humidity, now, sample.humidity);
+}
+
+void ZPHS01BSensor::applyFilters(ZPHS01BSample& sample) {
+    PERF_SCOPE(PERF_ZPHS01B_FILTER_CHAIN);
+
+    sample.pm1 = filters.pm1.apply(sample.pm1);
+    sample.pm25 = filters.pm25.apply(sample.pm25);
+    sample.pm10 = filters.pm10.apply(sample.pm10);
+    sample.co2 = filters.co2.apply(sample.co2);
+    sample.voc = filters.voc.apply(sample.voc);
+    sample.ch2o = filters.ch2o.apply(sample.ch2o);
+    sample.co = filters.co.apply(sample.co);
+    sample.o3 = filters.o3.apply(sample.o3);
+    sample.no2 = filters.no2.apply(sample.no2);
+    sample.temperature = filters.temperature.apply(sample.temperature);
+    sample.humidity = filters.humidity.apply(sample.humidity);
 }
\ No newline at end of file
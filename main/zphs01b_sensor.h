@@ -3,19 +3,69 @@
 
 #include <HardwareSerial.h>
 #include "config.h"
+#include "dsp_filters.h"
+#include "uart_transaction.h"
+
+struct ZPHS01BSample;
 
 class ZPHS01BSensor {
+    friend class HostHarness;   // host/ tests and benchmarks
+
 public:
     void init();
     void processData();
     void requestReading();
     bool isDataValid();
+    void reportUart() const;
 
 private:
+    // Frame assembly state, owned by the UART receive callback. Bytes are
+    // fed in one at a time, so a partial frame never blocks and a dropped
+    // or corrupt byte costs at most one frame before the parser locks back
+    // onto the 0xFF 0x86 header.
+    struct ParserState {
+        uint8_t frame[RESPONSE_LENGTH];
+        uint8_t frameIndex = 0;
+        uint32_t lastByteTime = 0;
+
+        // Error counters
+        uint32_t framesOk = 0;
+        uint32_t checksumErrors = 0;
+        uint32_t resyncs = 0;
+        uint32_t bytesDiscarded = 0;
+        uint32_t maxResyncBytes = 0;
+        uint32_t currentResyncBytes = 0;
+    };
+
+    void onUartReceive();
+    bool processByte(uint8_t byte);
+    void resyncAfterBadFrame();
+    void discardBytes(uint32_t count);
     bool validateChecksum(const uint8_t* response, size_t length);
     void processSensorData(const uint8_t* response);
 
+    // One filter chain per published field, chosen in config.h
+    struct FieldFilters {
+        FilterChain<ZPHS01B_PM1_FILTER> pm1;
+        FilterChain<ZPHS01B_PM25_FILTER> pm25;
+        FilterChain<ZPHS01B_PM10_FILTER> pm10;
+        FilterChain<ZPHS01B_CO2_FILTER> co2;
+        FilterChain<ZPHS01B_VOC_FILTER> voc;
+        FilterChain<ZPHS01B_CH2O_FILTER> ch2o;
+        FilterChain<ZPHS01B_CO_FILTER> co;
+        FilterChain<ZPHS01B_O3_FILTER> o3;
+        FilterChain<ZPHS01B_NO2_FILTER> no2;
+        FilterChain<ZPHS01B_TEMPERATURE_FILTER> temperature;
+        FilterChain<ZPHS01B_HUMIDITY_FILTER> humidity;
+    };
+
+    void applyFilters(ZPHS01BSample& sample);
+
     HardwareSerial* sensorSerial;
+    ParserState parser;
+    FieldFilters filters;
+    UartTransactionEngine uartLink;
+    UartFrameQueue rxFrames;
     uint32_t warmUpStart = 0;
     bool dataValid = false;
 };
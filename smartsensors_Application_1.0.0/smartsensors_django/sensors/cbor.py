@@ -0,0 +1,135 @@
+"""
+Minimal CBOR (RFC 8949) decoder for ESP32 uplink bodies
+
+Covers what the firmware's CborWriter emits: integers, text and byte
+strings, definite and indefinite arrays and maps, tags, simple values
+and half/single/double floats. Tag 262 (embedded JSON) is decoded into
+the JSON value it carries; other tags yield their content.
+"""
+import json
+import struct
+
+
+class CBORDecodeError(ValueError):
+    pass
+
+
+_BREAK = object()
+_TAG_EMBEDDED_JSON = 262
+_MAX_DEPTH = 16
+
+
+def loads(data):
+    """Decode one CBOR data item that spans all of data"""
+    decoder = _Decoder(bytes(data))
+    value = decoder.item(0)
+    if value is _BREAK:
+        raise CBORDecodeError("unexpected break")
+    if decoder.pos != len(decoder.data):
+        raise CBORDecodeError(f"{len(decoder.data) - decoder.pos} trailing bytes")
+    return value
+
+
+class _Decoder:
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def take(self, n):
+        if self.pos + n > len(self.data):
+            raise CBORDecodeError("truncated data")
+        chunk = self.data[self.pos:self.pos + n]
+        self.pos += n
+        return chunk
+
+    def argument(self, info):
+        if info < 24:
+            return info
+        if info == 24:
+            return self.take(1)[0]
+        if info == 25:
+            return struct.unpack('>H', self.take(2))[0]
+        if info == 26:
+            return struct.unpack('>I', self.take(4))[0]
+        if info == 27:
+            return struct.unpack('>Q', self.take(8))[0]
+        raise CBORDecodeError(f"invalid additional info {info}")
+
+    def item(self, depth):
+        if depth > _MAX_DEPTH:
+            raise CBORDecodeError("nesting too deep")
+
+        initial = self.take(1)[0]
+        major, info = initial >> 5, initial & 0x1F
+
+        if major == 7:
+            return self.simple(info)
+
+        if info == 31:
+            return self.indefinite(major, depth)
+
+        arg = self.argument(info)
+        if major == 0:
+            return arg
+        if major == 1:
+            return -1 - arg
+        if major == 2:
+            return self.take(arg)
+        if major == 3:
+            return self.take(arg).decode('utf-8')
+        if major == 4:
+            return [self.value(depth) for _ in range(arg)]
+        if major == 5:
+            return {self.value(depth): self.value(depth) for _ in range(arg)}
+
+        # major == 6: tag
+        content = self.value(depth)
+        if arg == _TAG_EMBEDDED_JSON and isinstance(content, str):
+            return json.loads(content)
+        return content
+
+    def value(self, depth):
+        value = self.item(depth + 1)
+        if value is _BREAK:
+            raise CBORDecodeError("unexpected break")
+        return value
+
+    def indefinite(self, major, depth):
+        if major == 4:
+            items = []
+            while (value := self.item(depth + 1)) is not _BREAK:
+                items.append(value)
+            return items
+        if major == 5:
+            result = {}
+            while (key := self.item(depth + 1)) is not _BREAK:
+                result[key] = self.value(depth)
+            return result
+        if major in (2, 3):
+            chunks = []
+            while (chunk := self.item(depth + 1)) is not _BREAK:
+                chunks.append(chunk)
+            return b''.join(chunks) if major == 2 else ''.join(chunks)
+        raise CBORDecodeError(f"major type {major} cannot be indefinite")
+
+    def simple(self, info):
+        if info == 20:
+            return False
+        if info == 21:
+            return True
+        if info in (22, 23):
+            return None
+        if info == 25:
+            return struct.unpack('>e', self.take(2))[0]
+        if info == 26:
+            return struct.unpack('>f', self.take(4))[0]
+        if info == 27:
+            return struct.unpack('>d', self.take(8))[0]
+        if info == 31:
+            return _BREAK
+        if info == 24:
+            self.take(1)
+            return None
+        if info < 20:
+            return None
+        raise CBORDecodeError(f"invalid simple value {info}")
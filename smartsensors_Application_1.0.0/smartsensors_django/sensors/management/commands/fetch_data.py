@@ -10,17 +10,17 @@ class Command(BaseCommand):
         response = requests.get(url, timeout=5)
         data = response.json()
 
-        aq = data.get('air_quality')
-        mr = data.get('mr007')
-        me4 = data.get('me4_so2')
-        ze40 = {
-            'tvoc_ppb': data.get('tvoc_ppb'),
-            'tvoc_ppm': data.get('tvoc_ppm'),
-            'dac_voltage': data.get('dac_voltage'),
-            'dac_ppm': data.get('dac_ppm'),
-            'uart_data_valid': data.get('uart_data_valid'),
-            'analog_data_valid': data.get('analog_data_valid'),
-        }
+        # Groups share the upload layout; drop the device-side sample age
+        def group(name):
+            values = data.get(name)
+            if values:
+                values.pop('sample_age_ms', None)
+            return values
+
+        aq = group('air_quality')
+        mr = group('mr007')
+        me4 = group('me4_so2')
+        ze40 = group('ze40') or {}
         info = {
             'ip_address': data.get('ip_address'),
             'network_mode': data.get('network_mode'),
@@ -5,6 +5,50 @@ from django.utils import timezone
 from django.http import JsonResponse
 from sensors.logging_utils import SecurityLogger, RateLimiter
 import time
+import zlib
+
+
+class DecompressRequestMiddleware:
+    """Inflate request bodies sent with Content-Encoding: gzip or deflate"""
+    
+    # Cap on the inflated size, so a small body cannot expand without bound
+    MAX_INFLATED_BYTES = 4 * 1024 * 1024
+    
+    def __init__(self, get_response):
+        self.get_response = get_response
+    
+    def __call__(self, request):
+        encoding = request.META.get('HTTP_CONTENT_ENCODING', '').strip().lower()
+        if not encoding or encoding == 'identity':
+            return self.get_response(request)
+        
+        if encoding not in ('gzip', 'deflate'):
+            return JsonResponse({
+                'status': 'error',
+                'message': f'Unsupported Content-Encoding: {encoding}'
+            }, status=415)
+        
+        # gzip framing is wbits 16+15; zlib framing (HTTP "deflate") is 15
+        inflater = zlib.decompressobj(31 if encoding == 'gzip' else 15)
+        try:
+            body = inflater.decompress(request.body, self.MAX_INFLATED_BYTES)
+            if inflater.unconsumed_tail:
+                return JsonResponse({
+                    'status': 'error',
+                    'message': 'Decompressed body too large'
+                }, status=413)
+            body += inflater.flush()
+        except zlib.error as e:
+            return JsonResponse({
+                'status': 'error',
+                'message': f'Invalid {encoding} body: {e}'
+            }, status=400)
+        
+        request.compressed_size = len(request.body)
+        request._body = body
+        request.META['CONTENT_LENGTH'] = str(len(body))
+        del request.META['HTTP_CONTENT_ENCODING']
+        return self.get_response(request)
 
 
 class SecurityLoggingMiddleware:
@@ -0,0 +1,114 @@
+"""
+Integer-keyed CBOR readings from the ESP32, mapped back to named fields
+
+Mirrors main/sensor_schema.h in the firmware: groups and fields are
+numbered in table order, and every reading carries the schema ID
+(SENSOR_SCHEMA_VERSION) under key 0. Add a new entry to SCHEMAS when
+the firmware bumps its version; keep the old ones for buffered readings
+that are still being replayed.
+"""
+
+# Top-level keys (SchemaKey in sensor_schema.h)
+KEY_SCHEMA = 0
+KEY_FIRST_GROUP = 16
+KEY_SAMPLE_AGE_MS = 23
+KEY_STATS = 8           # Rolling statistics; key 0 inside is 'windows_s'
+
+TOP_LEVEL_KEYS = {
+    1: 'timestamp',
+    2: 'age_s',
+    3: 'ip_address',
+    4: 'network_mode',
+    5: 'network_ready',
+    6: 'seq',       # WebSocket frames only
+    7: 'full',
+}
+
+# Schema ID -> [(group name, [(field name, decimals), ...]), ...]
+SCHEMAS = {
+    1: [
+        ('ze40', [
+            ('tvoc_ppb', 0), ('tvoc_ppm', 3), ('dac_voltage', 2), ('dac_ppm', 3),
+            ('uart_data_valid', 0), ('analog_data_valid', 0),
+        ]),
+        ('air_quality', [
+            ('pm1', 0), ('pm25', 0), ('pm10', 0), ('co2', 0), ('voc', 0), ('ch2o', 0),
+            ('co', 1), ('o3', 2), ('no2', 3), ('temperature', 1), ('humidity', 0),
+        ]),
+        ('mr007', [
+            ('voltage', 3), ('rawValue', 0), ('lel_concentration', 1),
+        ]),
+        ('me4_so2', [
+            ('voltage', 4), ('rawValue', 0), ('current_ua', 2), ('so2_concentration', 2),
+        ]),
+    ],
+}
+
+
+def _group_to_dict(values, fields):
+    if not isinstance(values, dict):
+        return None
+    group = {}
+    for key, value in values.items():
+        if key == KEY_SAMPLE_AGE_MS:
+            group['sample_age_ms'] = value
+        elif isinstance(key, int) and 0 <= key < len(fields):
+            name, decimals = fields[key]
+            # Floats arrive as half/single precision; round like the JSON text
+            group[name] = round(value, decimals) if isinstance(value, float) else value
+    return group
+
+
+def _stats_row(row, decimals):
+    """[mean, min, max, stddev, count] for one window, or None when empty"""
+    if not isinstance(row, list) or len(row) != 5:
+        return row
+    mean, low, high, stddev, count = row
+    return [round(mean, decimals + 1), round(low, decimals), round(high, decimals),
+            round(stddev, decimals + 1), count]
+
+
+def _stats_to_dict(stats, groups):
+    """Rolling statistics (firmware rolling_stats.h), numbered like the reading"""
+    if not isinstance(stats, dict):
+        return None
+    result = {}
+    for key, value in stats.items():
+        if key == 0:
+            result['windows_s'] = value
+        elif isinstance(key, int) and 0 <= key - KEY_FIRST_GROUP < len(groups) and isinstance(value, dict):
+            name, fields = groups[key - KEY_FIRST_GROUP]
+            group = {}
+            for index, rows in value.items():
+                if isinstance(index, int) and 0 <= index < len(fields) and isinstance(rows, list):
+                    field, decimals = fields[index]
+                    group[field] = [_stats_row(row, decimals) for row in rows]
+            result[name] = group
+    return result
+
+
+def reading_from_cbor(item):
+    """
+    Turn one decoded CBOR reading into the dict a JSON reading gives
+
+    Items that are not integer-keyed maps (embedded JSON, null) pass
+    through unchanged. Raises ValueError for an unknown schema ID.
+    """
+    if not isinstance(item, dict) or KEY_SCHEMA not in item:
+        return item
+
+    schema_id = item[KEY_SCHEMA]
+    groups = SCHEMAS.get(schema_id)
+    if groups is None:
+        raise ValueError(f"Unknown sensor schema {schema_id}")
+
+    reading = {}
+    for key, value in item.items():
+        if key == KEY_STATS:
+            reading['stats'] = _stats_to_dict(value, groups)
+        elif key in TOP_LEVEL_KEYS:
+            reading[TOP_LEVEL_KEYS[key]] = value
+        elif isinstance(key, int) and 0 <= key - KEY_FIRST_GROUP < len(groups):
+            name, fields = groups[key - KEY_FIRST_GROUP]
+            reading[name] = _group_to_dict(value, fields)
+    return reading
@@ -4,9 +4,12 @@ from django.views.decorators.csrf import csrf_exempt
 from django.views.decorators.http import require_http_methods
 from django.utils import timezone
 import json
+from datetime import timedelta
 import traceback
 from sensors.models import AirQuality, MR007, ME4SO2, ZE40, DeviceInfo
 from sensors.logging_utils import SecurityLogger
+from sensors import cbor
+from sensors.sensor_schema import reading_from_cbor
 
 
 def dashboard(request):
@@ -256,7 +259,117 @@ def data_api(request):
 
 
 
+def _store_reading(data, device_ip):
+    """Store one sensor reading; returns (sensors_included, errors)"""
+    sensors_included = []
+    errors = []
+    created = []
+    
+    # Track which sensors sent data
+    if 'air_quality' in data and data['air_quality']:
+        sensors_included.append('air_quality')
+    if 'mr007' in data and data['mr007']:
+        sensors_included.append('mr007')
+    if 'me4_so2' in data and data['me4_so2']:
+        sensors_included.append('me4_so2')
+    if 'ze40' in data and data['ze40']:
+        sensors_included.append('ze40')
+    
+    # Store Air Quality data if present
+    if 'air_quality' in data and data['air_quality']:
+        try:
+            aq_data = data['air_quality']
+            created.append(AirQuality.objects.create(
+                pm1=aq_data.get('pm1', 0),
+                pm25=aq_data.get('pm25', 0),
+                pm10=aq_data.get('pm10', 0),
+                co2=aq_data.get('co2', 0),
+                voc=aq_data.get('voc', 0),
+                ch2o=aq_data.get('ch2o', 0),
+                co=aq_data.get('co', 0.0),
+                o3=aq_data.get('o3', 0.0),
+                no2=aq_data.get('no2', 0.0),
+                temperature=aq_data.get('temperature', 0.0),
+                humidity=aq_data.get('humidity', 0)
+            ))
+        except Exception as e:
+            errors.append(f"AirQuality: {str(e)}")
+    
+    # Store MR007 data if present
+    if 'mr007' in data and data['mr007']:
+        try:
+            mr_data = data['mr007']
+            created.append(MR007.objects.create(
+                voltage=mr_data.get('voltage', 0.0),
+                rawValue=mr_data.get('rawValue', 0),
+                lel_concentration=mr_data.get('lel_concentration', 0.0)
+            ))
+        except Exception as e:
+            errors.append(f"MR007: {str(e)}")
+    
+    # Store ME4-SO2 data if present
+    if 'me4_so2' in data and data['me4_so2']:
+        try:
+            me4_data = data['me4_so2']
+            created.append(ME4SO2.objects.create(
+                voltage=me4_data.get('voltage', 0.0),
+                rawValue=me4_data.get('rawValue', 0),
+                current_ua=me4_data.get('current_ua', 0.0),
+                so2_concentration=me4_data.get('so2_concentration', 0.0)
+            ))
+        except Exception as e:
+            errors.append(f"ME4SO2: {str(e)}")
+    
+    # Store ZE40 data if present
+    if 'ze40' in data and data['ze40']:
+        try:
+            ze40_data = data['ze40']
+            created.append(ZE40.objects.create(
+                tvoc_ppb=ze40_data.get('tvoc_ppb', 0.0),
+                tvoc_ppm=ze40_data.get('tvoc_ppm', 0.0),
+                dac_voltage=ze40_data.get('dac_voltage', 0.0),
+                dac_ppm=ze40_data.get('dac_ppm', 0.0),
+                uart_data_valid=ze40_data.get('uart_data_valid', False),
+                analog_data_valid=ze40_data.get('analog_data_valid', True)
+            ))
+        except Exception as e:
+            errors.append(f"ZE40: {str(e)}")
+    
+    # Store device info if present
+    if 'ip_address' in data or 'network_mode' in data:
+        try:
+            created.append(DeviceInfo.objects.create(
+                ip_address=data.get('ip_address', device_ip),
+                network_mode=data.get('network_mode', 'unknown')
+            ))
+        except Exception as e:
+            errors.append(f"DeviceInfo: {str(e)}")
+    
+    # Buffered readings replayed by the ESP32 say how old they are;
+    # timestamp is auto_now_add, so it is corrected after the insert
+    age_s = data.get('age_s')
+    if isinstance(age_s, (int, float)) and age_s > 0:
+        recorded_at = timezone.now() - timedelta(seconds=age_s)
+        for obj in created:
+            type(obj).objects.filter(pk=obj.pk).update(timestamp=recorded_at)
+    
+    return sensors_included, errors
+
+
+def _parse_sensor_body(request):
+    """Decode a JSON or CBOR (application/cbor) body into readings"""
+    if request.content_type == 'application/cbor':
+        data = cbor.loads(request.body)
+        if isinstance(data, list):
+            return [reading_from_cbor(item) for item in data]
+        return reading_from_cbor(data)
+    return json.loads(request.body)
+
+
 # POST endpoint to receive data from ESP32
+# The body is one reading object, or an array of buffered readings
+# replayed after an outage (null entries are skipped). It is JSON, or
+# CBOR with the integer keys of the firmware's sensor_schema.h.
 @csrf_exempt
 @require_http_methods(["POST"])
 def receive_sensor_data(request):
@@ -268,87 +381,23 @@ def receive_sensor_data(request):
     errors = []
     
     try:
-        data = json.loads(request.body)
-        
-        # Track which sensors sent data
-        if 'air_quality' in data and data['air_quality']:
-            sensors_included.append('air_quality')
-        if 'mr007' in data and data['mr007']:
-            sensors_included.append('mr007')
-        if 'me4_so2' in data and data['me4_so2']:
-            sensors_included.append('me4_so2')
-        if 'ze40' in data and data['ze40']:
-            sensors_included.append('ze40')
-        
-        # Store Air Quality data if present
-        if 'air_quality' in data and data['air_quality']:
-            try:
-                aq_data = data['air_quality']
-                AirQuality.objects.create(
-                    pm1=aq_data.get('pm1', 0),
-                    pm25=aq_data.get('pm25', 0),
-                    pm10=aq_data.get('pm10', 0),
-                    co2=aq_data.get('co2', 0),
-                    voc=aq_data.get('voc', 0),
-                    ch2o=aq_data.get('ch2o', 0),
-                    co=aq_data.get('co', 0.0),
-                    o3=aq_data.get('o3', 0.0),
-                    no2=aq_data.get('no2', 0.0),
-                    temperature=aq_data.get('temperature', 0.0),
-                    humidity=aq_data.get('humidity', 0)
-                )
-            except Exception as e:
-                errors.append(f"AirQuality: {str(e)}")
-        
-        # Store MR007 data if present
-        if 'mr007' in data and data['mr007']:
-            try:
-                mr_data = data['mr007']
-                MR007.objects.create(
-                    voltage=mr_data.get('voltage', 0.0),
-                    rawValue=mr_data.get('rawValue', 0),
-                    lel_concentration=mr_data.get('lel_concentration', 0.0)
-                )
-            except Exception as e:
-                errors.append(f"MR007: {str(e)}")
-        
-        # Store ME4-SO2 data if present
-        if 'me4_so2' in data and data['me4_so2']:
-            try:
-                me4_data = data['me4_so2']
-                ME4SO2.objects.create(
-                    voltage=me4_data.get('voltage', 0.0),
-                    rawValue=me4_data.get('rawValue', 0),
-                    current_ua=me4_data.get('current_ua', 0.0),
-                    so2_concentration=me4_data.get('so2_concentration', 0.0)
-                )
-            except Exception as e:
-                errors.append(f"ME4SO2: {str(e)}")
+        data = _parse_sensor_body(request)
         
-        # Store ZE40 data if present
-        if 'ze40' in data and data['ze40']:
-            try:
-                ze40_data = data['ze40']
-                ZE40.objects.create(
-                    tvoc_ppb=ze40_data.get('tvoc_ppb', 0.0),
-                    tvoc_ppm=ze40_data.get('tvoc_ppm', 0.0),
-                    dac_voltage=ze40_data.get('dac_voltage', 0.0),
-                    dac_ppm=ze40_data.get('dac_ppm', 0.0),
-                    uart_data_valid=ze40_data.get('uart_data_valid', False),
-                    analog_data_valid=ze40_data.get('analog_data_valid', True)
-                )
-            except Exception as e:
-                errors.append(f"ZE40: {str(e)}")
+        readings = data if isinstance(data, list) else [data]
+        stored = 0
+        for reading in readings:
+            if not isinstance(reading, dict):
+                continue
+            reading_sensors, reading_errors = _store_reading(reading, device_ip)
+            for sensor in reading_sensors:
+                if sensor not in sensors_included:
+                    sensors_included.append(sensor)
+            errors.extend(reading_errors)
+            stored += 1
         
-        # Store device info if present
-        if 'ip_address' in data or 'network_mode' in data:
-            try:
-                DeviceInfo.objects.create(
-                    ip_address=data.get('ip_address', device_ip),
-                    network_mode=data.get('network_mode', 'unknown')
-                )
-            except Exception as e:
-                errors.append(f"DeviceInfo: {str(e)}")
+        network_mode = 'unknown'
+        if readings and isinstance(readings[-1], dict):
+            network_mode = readings[-1].get('network_mode', 'unknown')
         
         # Calculate processing time
         processing_time = int((timezone.now() - start_time).total_seconds() * 1000)
@@ -356,7 +405,7 @@ def receive_sensor_data(request):
         # Log ESP32 connection
         SecurityLogger.log_esp32_connection(
             device_ip=device_ip,
-            network_mode=data.get('network_mode', 'unknown'),
+            network_mode=network_mode,
             sensors_included=sensors_included,
             payload_size=payload_size,
             processing_time_ms=processing_time,
@@ -373,12 +422,14 @@ def receive_sensor_data(request):
         return JsonResponse({
             'status': 'success', 
             'message': 'Data stored successfully',
+            'readings_stored': stored,
             'sensors_received': sensors_included,
             'processing_time_ms': processing_time
         })
     
-    except json.JSONDecodeError as e:
-        error_msg = f"Invalid JSON: {str(e)}"
+    except ValueError as e:
+        # JSONDecodeError, CBORDecodeError or an unknown schema ID
+        error_msg = f"Invalid {'CBOR' if request.content_type == 'application/cbor' else 'JSON'}: {str(e)}"
         SecurityLogger.log_security_event(
             request, 'malformed_request', 'medium',
             error_msg
@@ -404,7 +455,7 @@ def receive_sensor_data(request):
         )
         SecurityLogger.log_esp32_connection(
             device_ip=device_ip,
-            network_mode=data.get('network_mode', 'unknown') if 'data' in locals() else 'unknown',
+            network_mode=data.get('network_mode', 'unknown') if isinstance(locals().get('data'), dict) else 'unknown',
             sensors_included=sensors_included,
             payload_size=payload_size,
             errors=error_msg
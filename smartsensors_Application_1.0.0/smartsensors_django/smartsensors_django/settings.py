@@ -96,6 +96,7 @@ MIDDLEWARE = [
     'django.contrib.sessions.middleware.SessionMiddleware',
     'corsheaders.middleware.CorsMiddleware',
     'django.middleware.common.CommonMiddleware',
+    'sensors.middleware.DecompressRequestMiddleware',
     'sensors.middleware.SecurityLoggingMiddleware',
     'sensors.middleware.SuspiciousPatternMiddleware',
     'django.middleware.csrf.CsrfViewMiddleware',
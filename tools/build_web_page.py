@@ -0,0 +1,87 @@
+#!/usr/bin/env python3
+"""
+Compress the dashboard page into a firmware header.
+
+Reads main/web/index.html, gzips it and writes main/web_page.h with the
+compressed bytes (MAIN_PAGE_GZIP, kept in flash) and an ETag derived
+from them. The web server sends those bytes as they are, with
+Content-Encoding: gzip, and answers a matching If-None-Match with 304.
+
+The Arduino IDE has no pre-build step, so the header is committed.
+Run this after every change to index.html:
+
+    python3 tools/build_web_page.py
+    python3 tools/build_web_page.py --check    # fail if the header is stale
+
+The output is deterministic (no timestamp in the gzip header), so an
+unchanged page produces an identical header and the same ETag.
+"""
+
+import argparse
+import gzip
+import hashlib
+import os
+import sys
+
+MAIN_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'main')
+SOURCE = os.path.join(MAIN_DIR, 'web', 'index.html')
+HEADER = os.path.join(MAIN_DIR, 'web_page.h')
+BYTES_PER_LINE = 16
+
+
+def render(page):
+    compressed = gzip.compress(page, compresslevel=9, mtime=0)
+    etag = hashlib.sha256(compressed).hexdigest()[:16]
+
+    lines = [
+        '// Generated by tools/build_web_page.py from web/index.html - do not edit.',
+        '// Rerun the script after changing the page.',
+        '#ifndef WEB_PAGE_H',
+        '#define WEB_PAGE_H',
+        '',
+        '#include <Arduino.h>',
+        '',
+        f'#define MAIN_PAGE_ETAG          "\\"{etag}\\""',
+        f'#define MAIN_PAGE_GZIP_LENGTH   {len(compressed)}',
+        f'#define MAIN_PAGE_SOURCE_LENGTH {len(page)}',
+        '',
+        'static const uint8_t MAIN_PAGE_GZIP[MAIN_PAGE_GZIP_LENGTH] PROGMEM = {',
+    ]
+    for i in range(0, len(compressed), BYTES_PER_LINE):
+        row = compressed[i:i + BYTES_PER_LINE]
+        lines.append('    ' + ', '.join(f'0x{b:02x}' for b in row) + ',')
+    lines += ['};', '', '#endif', '']
+    return '\n'.join(lines), len(compressed), etag
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n\n')[0])
+    parser.add_argument('--check', action='store_true',
+                        help='only verify that web_page.h matches index.html')
+    args = parser.parse_args()
+
+    with open(SOURCE, 'rb') as f:
+        page = f.read()
+    header, compressed_length, etag = render(page)
+
+    current = None
+    if os.path.exists(HEADER):
+        with open(HEADER, encoding='utf-8') as f:
+            current = f.read()
+
+    if args.check:
+        if current != header:
+            print('main/web_page.h is out of date; run tools/build_web_page.py')
+            sys.exit(1)
+        print('main/web_page.h is up to date')
+        return
+
+    if current != header:
+        with open(HEADER, 'w', encoding='utf-8', newline='\n') as f:
+            f.write(header)
+    print(f'index.html: {len(page)} B -> {compressed_length} B gzip '
+          f'({100 * compressed_length / len(page):.0f}%), ETag {etag}')
+
+
+if __name__ == '__main__':
+    main()
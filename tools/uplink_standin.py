@@ -0,0 +1,167 @@
+#!/usr/bin/env python3
+"""
+Local stand-in for the Django sensor endpoint.
+
+Accepts the same POST bodies as sensors.views.receive_sensor_data: one
+reading object from a live send, or an array of buffered readings from
+a backlog replay, as JSON or CBOR. It can simulate an outage, so the
+firmware's store-and-forward path can be exercised without the real
+backend.
+
+Point DJANGO_SERVER_URL at http://<this host>:<port>/api/sensors and run:
+
+    python3 tools/uplink_standin.py --port 8000
+    python3 tools/uplink_standin.py --fail-after 3 --fail-for 20
+    python3 tools/uplink_standin.py --outage 60:600 --delay-ms 300
+
+Every request is logged with its reading count and the backlog ages.
+On Ctrl-C a summary is printed.
+"""
+
+import argparse
+import json
+import os
+import sys
+import time
+import zlib
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+# CBOR bodies are decoded with the Django app's own modules
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), '..',
+                                'smartsensors_Application_1.0.0', 'smartsensors_django'))
+from sensors import cbor  # noqa: E402
+from sensors.sensor_schema import reading_from_cbor  # noqa: E402
+
+
+class Stats:
+    def __init__(self):
+        self.started = time.time()
+        self.requests = 0
+        self.rejected = 0
+        self.live = 0
+        self.replayed = 0
+        self.skipped = 0
+        self.max_batch = 0
+        self.max_age_s = 0
+
+
+def parse_outage(text):
+    start, end = text.split(':')
+    return float(start), float(end)
+
+
+def make_handler(args, stats):
+    class Handler(BaseHTTPRequestHandler):
+        def log_message(self, fmt, *fmt_args):
+            pass
+
+        def reply(self, status, body):
+            data = json.dumps(body).encode()
+            self.send_response(status)
+            self.send_header('Content-Type', 'application/json')
+            self.send_header('Content-Length', str(len(data)))
+            self.end_headers()
+            self.wfile.write(data)
+
+        def in_outage(self):
+            if args.outage:
+                elapsed = time.time() - stats.started
+                start, end = args.outage
+                if start <= elapsed < end:
+                    return True
+            if args.fail_for:
+                index = stats.requests - args.fail_after
+                if 0 < index <= args.fail_for:
+                    return True
+            return False
+
+        def do_POST(self):
+            stats.requests += 1
+            length = int(self.headers.get('Content-Length', 0))
+            body = self.rfile.read(length)
+            wire = len(body)
+
+            encoding = self.headers.get('Content-Encoding', '').strip().lower()
+            if encoding in ('gzip', 'deflate'):
+                try:
+                    body = zlib.decompress(body, 31 if encoding == 'gzip' else 15)
+                except zlib.error as e:
+                    print(f"#{stats.requests:<5} {wire:6d} B  -> 400 bad {encoding}: {e}")
+                    self.reply(400, {'status': 'error', 'message': str(e)})
+                    return
+                print(f"#{stats.requests:<5} {wire:6d} B  {encoding}, {len(body)} B inflated "
+                      f"({100 * wire // max(len(body), 1)}%)")
+
+            if self.in_outage():
+                stats.rejected += 1
+                print(f"#{stats.requests:<5} {len(body):6d} B  -> 503 (simulated outage)")
+                self.reply(503, {'status': 'error', 'message': 'simulated outage'})
+                return
+
+            if args.delay_ms:
+                time.sleep(args.delay_ms / 1000.0)
+
+            is_cbor = self.headers.get('Content-Type', '').startswith('application/cbor')
+            try:
+                if is_cbor:
+                    data = cbor.loads(body)
+                    data = ([reading_from_cbor(r) for r in data] if isinstance(data, list)
+                            else reading_from_cbor(data))
+                else:
+                    data = json.loads(body)
+            except ValueError as e:
+                kind = 'CBOR' if is_cbor else 'JSON'
+                print(f"#{stats.requests:<5} {len(body):6d} B  -> 400 invalid {kind}: {e}")
+                self.reply(400, {'status': 'error', 'message': str(e)})
+                return
+
+            if isinstance(data, list):
+                readings = [r for r in data if isinstance(r, dict)]
+                stats.skipped += len(data) - len(readings)
+                stats.replayed += len(readings)
+                stats.max_batch = max(stats.max_batch, len(data))
+                ages = [r['age_s'] for r in readings if 'age_s' in r]
+                if ages:
+                    stats.max_age_s = max(stats.max_age_s, max(ages))
+                age_text = f"ages {min(ages)}..{max(ages)} s" if ages else "no ages"
+                print(f"#{stats.requests:<5} {len(body):6d} B  batch of {len(data)} ({age_text})"
+                      f"{' cbor' if is_cbor else ''}")
+            else:
+                stats.live += 1
+                print(f"#{stats.requests:<5} {len(body):6d} B  live reading{' (cbor)' if is_cbor else ''}")
+
+            self.reply(200, {'status': 'success', 'readings_stored': stats.live + stats.replayed})
+
+    return Handler
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n\n')[0])
+    parser.add_argument('--host', default='0.0.0.0')
+    parser.add_argument('--port', type=int, default=8000)
+    parser.add_argument('--fail-after', type=int, default=0,
+                        help='requests to accept before the simulated outage')
+    parser.add_argument('--fail-for', type=int, default=0,
+                        help='requests to reject with 503 after --fail-after')
+    parser.add_argument('--outage', type=parse_outage,
+                        help='START:END seconds after launch to reject every request')
+    parser.add_argument('--delay-ms', type=int, default=0,
+                        help='extra processing time per accepted request')
+    args = parser.parse_args()
+
+    stats = Stats()
+    server = ThreadingHTTPServer((args.host, args.port), make_handler(args, stats))
+    print(f"Uplink stand-in listening on {args.host}:{args.port}")
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+
+    print()
+    print(f"requests {stats.requests}, rejected {stats.rejected}")
+    print(f"live readings {stats.live}, replayed {stats.replayed} "
+          f"(largest batch {stats.max_batch}, oldest {stats.max_age_s} s, {stats.skipped} null)")
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,138 @@
+#!/usr/bin/env python3
+"""
+Load generator for the ESP32's built-in web server.
+
+Runs a fixed number of concurrent clients against one path, each
+opening a fresh connection per request (the firmware answers with
+Connection: close), and reports requests per second and latency
+percentiles for every concurrency level:
+
+    python3 tools/web_bench.py 192.168.1.50 --token <API_ACCESS_TOKEN>
+    python3 tools/web_bench.py 192.168.1.50 --path /buffer --clients 1,4,8
+    python3 tools/web_bench.py 192.168.1.50 --slow 2 --duration 20
+
+--slow opens idle connections that send nothing, to check that a
+stalled client no longer holds up everyone else. Refused requests
+(503 when all connection slots are taken) are counted separately.
+"""
+
+import argparse
+import base64
+import socket
+import threading
+import time
+
+
+def fetch(host, port, request, timeout):
+    """One request on a new connection; returns (status, bytes received)"""
+    with socket.create_connection((host, port), timeout=timeout) as sock:
+        sock.sendall(request)
+        received = bytearray()
+        while chunk := sock.recv(4096):
+            received += chunk
+    status_line = bytes(received[:received.find(b'\r\n')]).split()
+    return int(status_line[1]) if len(status_line) > 1 else 0, len(received)
+
+
+def hold_idle(host, port, seconds, stop):
+    """Connect and say nothing; reconnect whenever the server drops us"""
+    while not stop.is_set():
+        try:
+            with socket.create_connection((host, port), timeout=seconds) as sock:
+                sock.recv(1)
+        except OSError:
+            time.sleep(0.1)
+
+
+def percentile(sorted_values, p):
+    if not sorted_values:
+        return 0.0
+    index = min(len(sorted_values) - 1, int(round(p / 100 * (len(sorted_values) - 1))))
+    return sorted_values[index]
+
+
+def run_level(args, request, clients):
+    latencies = []
+    statuses = {}
+    errors = 0
+    total_bytes = 0
+    lock = threading.Lock()
+    deadline = time.monotonic() + args.duration
+
+    def worker():
+        nonlocal errors, total_bytes
+        while time.monotonic() < deadline:
+            started = time.monotonic()
+            try:
+                status, size = fetch(args.host, args.port, request, args.timeout)
+            except OSError:
+                with lock:
+                    errors += 1
+                continue
+            elapsed_ms = (time.monotonic() - started) * 1000
+            with lock:
+                statuses[status] = statuses.get(status, 0) + 1
+                total_bytes += size
+                if status == 200:
+                    latencies.append(elapsed_ms)
+
+    threads = [threading.Thread(target=worker) for _ in range(clients)]
+    started = time.monotonic()
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    elapsed = time.monotonic() - started
+
+    latencies.sort()
+    refused = statuses.get(503, 0)
+    other = sum(count for status, count in statuses.items() if status not in (200, 503))
+    print(f"{clients:7d} {len(latencies) / elapsed:8.1f} "
+          f"{percentile(latencies, 50):8.1f} {percentile(latencies, 99):8.1f} "
+          f"{(latencies[-1] if latencies else 0):8.1f} "
+          f"{total_bytes / elapsed / 1024:7.1f} {refused:7d} {other + errors:7d}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n\n')[0])
+    parser.add_argument('host')
+    parser.add_argument('--port', type=int, default=80)
+    parser.add_argument('--path', default='/data')
+    parser.add_argument('--token', help='API token, sent as X-API-Token')
+    parser.add_argument('--user', help='USER:PASSWORD for basic auth (main page)')
+    parser.add_argument('--clients', default='1,4,8',
+                        help='comma-separated concurrency levels')
+    parser.add_argument('--duration', type=float, default=10.0,
+                        help='seconds per concurrency level')
+    parser.add_argument('--timeout', type=float, default=10.0,
+                        help='socket timeout per request')
+    parser.add_argument('--slow', type=int, default=0,
+                        help='idle connections held open during the run')
+    args = parser.parse_args()
+
+    headers = [f"GET {args.path} HTTP/1.1", f"Host: {args.host}", "Connection: close"]
+    if args.token:
+        headers.append(f"X-API-Token: {args.token}")
+    if args.user:
+        headers.append("Authorization: Basic " + base64.b64encode(args.user.encode()).decode())
+    request = ("\r\n".join(headers) + "\r\n\r\n").encode()
+
+    stop = threading.Event()
+    for _ in range(args.slow):
+        threading.Thread(target=hold_idle, args=(args.host, args.port, args.timeout, stop),
+                         daemon=True).start()
+
+    print(f"GET http://{args.host}:{args.port}{args.path}, {args.duration:g} s per level"
+          f"{f', {args.slow} idle connections' if args.slow else ''}")
+    print(f"{'clients':>7} {'req/s':>8} {'p50 ms':>8} {'p99 ms':>8} {'max ms':>8} "
+          f"{'KiB/s':>7} {'503':>7} {'errors':>7}")
+    try:
+        for clients in (int(c) for c in args.clients.split(',')):
+            run_level(args, request, clients)
+    except KeyboardInterrupt:
+        pass
+    stop.set()
+
+
+if __name__ == '__main__':
+    main()